@@ -155,21 +155,40 @@ static uint32_t _read_sample(xhal_adc_t *self, uint32_t samples,
         }
     }
 
+    /*
+     * 逐帧在环形缓冲区中拆分各通道并立即释放: DMA 中断在溢出时会 xrbuf_skip
+     * 推进读指针, peek 到 release 之间的窗口不能超过一帧.
+     */
+    uint32_t frame = sizeof(uint16_t) * channel_count;
     uint16_t sample[16];
-    for (uint32_t num = 0; num < samples; num++)
+    uint32_t num = 0;
+    for (; num < samples; num++)
     {
-        uint32_t r = xrbuf_read(&adc->data.data_rbuf, sample,
-                                sizeof(uint16_t) * channel_count);
-        if (r != (sizeof(uint16_t) * channel_count))
-            return num;
+        xrbuf_seg_t seg;
+        if (xrbuf_peek_seg(&adc->data.data_rbuf, frame, &seg) < frame)
+        {
+            break;
+        }
+
+        const uint16_t *p = (const uint16_t *)seg.ptr[0];
+        if (seg.len[0] < frame)
+        {
+            /* 跨越缓冲区末尾的帧 */
+            memcpy(sample, seg.ptr[0], seg.len[0]);
+            memcpy((uint8_t *)sample + seg.len[0], seg.ptr[1],
+                   frame - seg.len[0]);
+            p = sample;
+        }
 
         for (uint8_t i = 0; i < write_count; i++)
         {
-            buffers[i][num] = sample[map[i]];
+            buffers[i][num] = p[map[i]];
         }
+
+        xrbuf_release(&adc->data.data_rbuf, frame);
     }
 
-    return samples;
+    return num;
 }
 
 static xhal_err_t _set_config(xhal_adc_t *self, const xhal_adc_config_t *config)
@@ -0,0 +1,93 @@
+#include "drv_util.h"
+#include "xhal_crc.h"
+#include <string.h>
+
+#if XCRC32_ACCEL_THRESHOLD > 0
+
+XLOG_TAG("xDriverCRC");
+
+/*
+ * STM32F1 CRC 单元: 多项式 0x04C11DB7, 按 32 位字高位在前计算, 复位值
+ * 0xFFFFFFFF, 不能写入任意初值. xcrc32 为反射算法, 因此输入字与寄存器
+ * 都做位反转(RBIT)后交给硬件.
+ *
+ * 对 32 位字, 硬件一步等价于 DR' = F(DR ^ W), F 为 32 次零输入移位且可逆.
+ * 复位后写入 W = ~F^-1(T) 即可把寄存器置为任意状态 T, 由此支持续算.
+ */
+
+#define CRC_HW_POLY  (0x04C11DB7U)
+#define CRC_HW_RESET (0xFFFFFFFFU)
+
+/* 每次关中断处理的字节数, 须为 4 的倍数 */
+#define CRC_HW_CHUNK (256U)
+
+/**
+ * @brief  求 F^-1(t): 逆向运行 32 次 LFSR 移位
+ * @param  t  正序寄存器值
+ * @retval 移位前的值
+ */
+static uint32_t _unshift(uint32_t t)
+{
+    for (uint8_t i = 0; i < 32; i++)
+    {
+        if (t & 1U)
+            t = ((t ^ CRC_HW_POLY) >> 1) | 0x80000000U;
+        else
+            t >>= 1;
+    }
+
+    return t;
+}
+
+/**
+ * @brief  用 CRC 单元计算 CRC32, 覆盖 xhal_crc.c 中的弱定义
+ * @param  state  反射寄存器值(未做最终异或)
+ * @param  data   数据
+ * @param  size   字节数, 4 的倍数
+ * @retval XHAL_OK
+ */
+xhal_err_t xcrc32_accel(uint32_t *state, const void *data, uint32_t size)
+{
+    static uint8_t clock_enabled = 0;
+
+    if (!clock_enabled)
+    {
+        RCC_AHBPeriphClockCmd(RCC_AHBPeriph_CRC, ENABLE);
+        clock_enabled = 1;
+    }
+
+    const uint8_t *p = (const uint8_t *)data;
+    uint32_t crc     = __RBIT(*state);
+
+    while (size > 0)
+    {
+        uint32_t n = XHAL_MIN(size, CRC_HW_CHUNK);
+
+        /* CRC 单元全局唯一, 关中断保证中断与多线程下的独占 */
+        uint32_t primask = __get_PRIMASK();
+        __disable_irq();
+
+        CRC_ResetDR();
+        if (crc != CRC_HW_RESET)
+            CRC->DR = ~_unshift(crc);
+
+        for (uint32_t i = 0; i < n; i += 4)
+        {
+            uint32_t w;
+            memcpy(&w, p + i, sizeof(w));
+            CRC->DR = __RBIT(w);
+        }
+        crc = CRC->DR;
+
+        __set_PRIMASK(primask);
+
+        p += n;
+        size -= n;
+    }
+
+    *state = __RBIT(crc);
+
+    return XHAL_OK;
+}
+
+#endif /* XCRC32_ACCEL_THRESHOLD > 0 */
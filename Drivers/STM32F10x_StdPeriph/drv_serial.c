@@ -133,10 +133,14 @@ static xhal_err_t _init(xhal_serial_t *self)
 {
     xassert_name(_check_uart_name_valid(self->data.name), self->data.name);
 
-    xhal_err_t ret                = XHAL_OK;
-    const uart_hw_info_t *info    = _find_uart_info(self->data.name);
-    uart_p[info->id]              = self;
-    uart_ctx[info->id].rx_dma_len = self->data.rx_rbuf.size;
+    xhal_err_t ret             = XHAL_OK;
+    const uart_hw_info_t *info = _find_uart_info(self->data.name);
+    uart_p[info->id]           = self;
+
+    /* 接收 DMA 直接写入预留的第一段空间, 长度不超过缓冲区容量 */
+    xrbuf_seg_t seg;
+    xrbuf_reserve(&self->data.rx_rbuf, UINT16_MAX, &seg);
+    uart_ctx[info->id].rx_dma_len = seg.len[0];
 
     if (info->uart_clk == RCC_APB2Periph_USART1)
     {
@@ -151,8 +155,8 @@ static xhal_err_t _init(xhal_serial_t *self)
     ret = _set_config(self, &self->data.config);
     _uart_dma_irq_msp_init(self);
 
-    _dma_config_transfer(info->dma_rx, (u32)&info->uart->DR,
-                         (u32)self->data.rx_rbuf.buff, self->data.rx_rbuf.size);
+    _dma_config_transfer(info->dma_rx, (u32)&info->uart->DR, (u32)seg.ptr[0],
+                         seg.len[0]);
 
     return ret;
 }
@@ -203,17 +207,17 @@ static uint32_t _transmit(xhal_serial_t *self, const void *buff, uint32_t size)
 
     if (DMA_GetCurrDataCounter(info->dma_tx) == 0)
     {
-        uint16_t len = xrbuf_get_linear_block_read_length(&self->data.tx_rbuf);
-        if (len == 0)
+        xrbuf_seg_t seg;
+        xrbuf_peek_seg(&self->data.tx_rbuf, UINT16_MAX, &seg);
+        if (seg.len[0] == 0)
         {
             return written;
         }
 
-        uart_ctx[info->id].tx_dma_len = len;
+        uart_ctx[info->id].tx_dma_len = seg.len[0];
 
-        void *addr = xrbuf_get_linear_block_read_address(&self->data.tx_rbuf);
-        _dma_config_transfer(info->dma_tx, (u32)&info->uart->DR, (u32)addr,
-                             len);
+        _dma_config_transfer(info->dma_tx, (u32)&info->uart->DR,
+                             (u32)seg.ptr[0], seg.len[0]);
     }
 
     return written;
@@ -376,7 +380,7 @@ void USART1_IRQHandler(void)
         uint16_t remaining = DMA_GetCurrDataCounter(info->dma_rx);
         uint16_t received  = uart_ctx_p->rx_dma_len - remaining;
 
-        xrbuf_advance(&uart->data.rx_rbuf, received);
+        xrbuf_commit(&uart->data.rx_rbuf, received);
         uart_ctx_p->rx_dma_len = 0;
 
 #ifdef XHAL_OS_SUPPORTING
@@ -386,16 +390,16 @@ void USART1_IRQHandler(void)
         }
 #endif
 
-        uint16_t len = xrbuf_get_linear_block_write_length(&uart->data.rx_rbuf);
-        if (len == 0)
+        xrbuf_seg_t seg;
+        xrbuf_reserve(&uart->data.rx_rbuf, UINT16_MAX, &seg);
+        if (seg.len[0] == 0)
         {
             return;
         }
-        uart_ctx_p->rx_dma_len = len;
+        uart_ctx_p->rx_dma_len = seg.len[0];
 
-        void *addr = xrbuf_get_linear_block_write_address(&uart->data.rx_rbuf);
-        _dma_config_transfer(info->dma_rx, (u32)&info->uart->DR, (u32)addr,
-                             len);
+        _dma_config_transfer(info->dma_rx, (u32)&info->uart->DR,
+                             (u32)seg.ptr[0], seg.len[0]);
     }
 }
 
@@ -420,7 +424,7 @@ void DMA1_Channel4_IRQHandler(void)
 
         uart_ctx_p->tx_dma_len = remaining;
 
-        xrbuf_skip(&uart->data.tx_rbuf, sent);
+        xrbuf_release(&uart->data.tx_rbuf, sent);
 
 #ifdef XHAL_OS_SUPPORTING
         osEventFlagsSet(uart->data.event_flag, XSERIAL_EVENT_CAN_WRITE);
@@ -430,23 +434,23 @@ void DMA1_Channel4_IRQHandler(void)
     {
         DMA_ClearITPendingBit(DMAy_IT_TCx);
 
-        xrbuf_skip(&uart->data.tx_rbuf, uart_ctx_p->tx_dma_len);
+        xrbuf_release(&uart->data.tx_rbuf, uart_ctx_p->tx_dma_len);
         uart_ctx_p->tx_dma_len = 0;
 
 #ifdef XHAL_OS_SUPPORTING
         osEventFlagsSet(uart->data.event_flag, XSERIAL_EVENT_CAN_WRITE);
 #endif
-        uint16_t len = xrbuf_get_linear_block_read_length(&uart->data.tx_rbuf);
-        if (len == 0)
+        xrbuf_seg_t seg;
+        xrbuf_peek_seg(&uart->data.tx_rbuf, UINT16_MAX, &seg);
+        if (seg.len[0] == 0)
         {
             return;
         }
 
-        uart_ctx_p->tx_dma_len = len;
+        uart_ctx_p->tx_dma_len = seg.len[0];
 
-        void *addr = xrbuf_get_linear_block_read_address(&uart->data.tx_rbuf);
-        _dma_config_transfer(info->dma_tx, (u32)&info->uart->DR, (u32)addr,
-                             len);
+        _dma_config_transfer(info->dma_tx, (u32)&info->uart->DR,
+                             (u32)seg.ptr[0], seg.len[0]);
     }
 }
 
@@ -471,7 +475,7 @@ void DMA1_Channel5_IRQHandler(void)
 
         uart_ctx_p->rx_dma_len = remaining;
 
-        xrbuf_advance(&uart->data.rx_rbuf, received);
+        xrbuf_commit(&uart->data.rx_rbuf, received);
 
 #ifdef XHAL_OS_SUPPORTING
         if (xrbuf_get_full(&uart->data.rx_rbuf) >= uart->data.rx_expect)
@@ -484,7 +488,7 @@ void DMA1_Channel5_IRQHandler(void)
     {
         DMA_ClearITPendingBit(DMAy_IT_TCx);
 
-        xrbuf_advance(&uart->data.rx_rbuf, uart_ctx_p->rx_dma_len);
+        xrbuf_commit(&uart->data.rx_rbuf, uart_ctx_p->rx_dma_len);
         uart_ctx_p->rx_dma_len = 0;
 
 #ifdef XHAL_OS_SUPPORTING
@@ -493,17 +497,17 @@ void DMA1_Channel5_IRQHandler(void)
             osEventFlagsSet(uart->data.event_flag, XSERIAL_EVENT_CAN_READ);
         }
 #endif
-        uint16_t len = xrbuf_get_linear_block_write_length(&uart->data.rx_rbuf);
-        if (len == 0)
+        xrbuf_seg_t seg;
+        xrbuf_reserve(&uart->data.rx_rbuf, UINT16_MAX, &seg);
+        if (seg.len[0] == 0)
         {
             return;
         }
 
-        uart_ctx_p->rx_dma_len = len;
+        uart_ctx_p->rx_dma_len = seg.len[0];
 
-        void *addr = xrbuf_get_linear_block_write_address(&uart->data.rx_rbuf);
-        _dma_config_transfer(info->dma_rx, (u32)&info->uart->DR, (u32)addr,
-                             len);
+        _dma_config_transfer(info->dma_rx, (u32)&info->uart->DR,
+                             (u32)seg.ptr[0], seg.len[0]);
     }
 }
 
@@ -526,7 +530,7 @@ void USART2_IRQHandler(void)
         uint16_t remaining = DMA_GetCurrDataCounter(info->dma_rx);
         uint16_t received  = uart_ctx_p->rx_dma_len - remaining;
 
-        xrbuf_advance(&uart->data.rx_rbuf, received);
+        xrbuf_commit(&uart->data.rx_rbuf, received);
         uart_ctx_p->rx_dma_len = 0;
 
 #ifdef XHAL_OS_SUPPORTING
@@ -536,16 +540,16 @@ void USART2_IRQHandler(void)
         }
 #endif
 
-        uint16_t len = xrbuf_get_linear_block_write_length(&uart->data.rx_rbuf);
-        if (len == 0)
+        xrbuf_seg_t seg;
+        xrbuf_reserve(&uart->data.rx_rbuf, UINT16_MAX, &seg);
+        if (seg.len[0] == 0)
         {
             return;
         }
-        uart_ctx_p->rx_dma_len = len;
+        uart_ctx_p->rx_dma_len = seg.len[0];
 
-        void *addr = xrbuf_get_linear_block_write_address(&uart->data.rx_rbuf);
-        _dma_config_transfer(info->dma_rx, (u32)&info->uart->DR, (u32)addr,
-                             len);
+        _dma_config_transfer(info->dma_rx, (u32)&info->uart->DR,
+                             (u32)seg.ptr[0], seg.len[0]);
     }
 }
 
@@ -570,7 +574,7 @@ void DMA1_Channel7_IRQHandler(void)
 
         uart_ctx_p->tx_dma_len = remaining;
 
-        xrbuf_skip(&uart->data.tx_rbuf, sent);
+        xrbuf_release(&uart->data.tx_rbuf, sent);
 
 #ifdef XHAL_OS_SUPPORTING
         osEventFlagsSet(uart->data.event_flag, XSERIAL_EVENT_CAN_WRITE);
@@ -580,23 +584,23 @@ void DMA1_Channel7_IRQHandler(void)
     {
         DMA_ClearITPendingBit(DMAy_IT_TCx);
 
-        xrbuf_skip(&uart->data.tx_rbuf, uart_ctx_p->tx_dma_len);
+        xrbuf_release(&uart->data.tx_rbuf, uart_ctx_p->tx_dma_len);
         uart_ctx_p->tx_dma_len = 0;
 
 #ifdef XHAL_OS_SUPPORTING
         osEventFlagsSet(uart->data.event_flag, XSERIAL_EVENT_CAN_WRITE);
 #endif
-        uint16_t len = xrbuf_get_linear_block_read_length(&uart->data.tx_rbuf);
-        if (len == 0)
+        xrbuf_seg_t seg;
+        xrbuf_peek_seg(&uart->data.tx_rbuf, UINT16_MAX, &seg);
+        if (seg.len[0] == 0)
         {
             return;
         }
 
-        uart_ctx_p->tx_dma_len = len;
+        uart_ctx_p->tx_dma_len = seg.len[0];
 
-        void *addr = xrbuf_get_linear_block_read_address(&uart->data.tx_rbuf);
-        _dma_config_transfer(info->dma_tx, (u32)&info->uart->DR, (u32)addr,
-                             len);
+        _dma_config_transfer(info->dma_tx, (u32)&info->uart->DR,
+                             (u32)seg.ptr[0], seg.len[0]);
     }
 }
 
@@ -621,7 +625,7 @@ void DMA1_Channel6_IRQHandler(void)
 
         uart_ctx_p->rx_dma_len = remaining;
 
-        xrbuf_advance(&uart->data.rx_rbuf, received);
+        xrbuf_commit(&uart->data.rx_rbuf, received);
 
 #ifdef XHAL_OS_SUPPORTING
         if (xrbuf_get_full(&uart->data.rx_rbuf) >= uart->data.rx_expect)
@@ -634,7 +638,7 @@ void DMA1_Channel6_IRQHandler(void)
     {
         DMA_ClearITPendingBit(DMAy_IT_TCx);
 
-        xrbuf_advance(&uart->data.rx_rbuf, uart_ctx_p->rx_dma_len);
+        xrbuf_commit(&uart->data.rx_rbuf, uart_ctx_p->rx_dma_len);
         uart_ctx_p->rx_dma_len = 0;
 
 #ifdef XHAL_OS_SUPPORTING
@@ -643,17 +647,17 @@ void DMA1_Channel6_IRQHandler(void)
             osEventFlagsSet(uart->data.event_flag, XSERIAL_EVENT_CAN_READ);
         }
 #endif
-        uint16_t len = xrbuf_get_linear_block_write_length(&uart->data.rx_rbuf);
-        if (len == 0)
+        xrbuf_seg_t seg;
+        xrbuf_reserve(&uart->data.rx_rbuf, UINT16_MAX, &seg);
+        if (seg.len[0] == 0)
         {
             return;
         }
 
-        uart_ctx_p->rx_dma_len = len;
+        uart_ctx_p->rx_dma_len = seg.len[0];
 
-        void *addr = xrbuf_get_linear_block_write_address(&uart->data.rx_rbuf);
-        _dma_config_transfer(info->dma_rx, (u32)&info->uart->DR, (u32)addr,
-                             len);
+        _dma_config_transfer(info->dma_rx, (u32)&info->uart->DR,
+                             (u32)seg.ptr[0], seg.len[0]);
     }
 }
 
@@ -676,7 +680,7 @@ void USART3_IRQHandler(void)
         uint16_t remaining = DMA_GetCurrDataCounter(info->dma_rx);
         uint16_t received  = uart_ctx_p->rx_dma_len - remaining;
 
-        xrbuf_advance(&uart->data.rx_rbuf, received);
+        xrbuf_commit(&uart->data.rx_rbuf, received);
         uart_ctx_p->rx_dma_len = 0;
 
 #ifdef XHAL_OS_SUPPORTING
@@ -686,16 +690,16 @@ void USART3_IRQHandler(void)
         }
 #endif
 
-        uint16_t len = xrbuf_get_linear_block_write_length(&uart->data.rx_rbuf);
-        if (len == 0)
+        xrbuf_seg_t seg;
+        xrbuf_reserve(&uart->data.rx_rbuf, UINT16_MAX, &seg);
+        if (seg.len[0] == 0)
         {
             return;
         }
-        uart_ctx_p->rx_dma_len = len;
+        uart_ctx_p->rx_dma_len = seg.len[0];
 
-        void *addr = xrbuf_get_linear_block_write_address(&uart->data.rx_rbuf);
-        _dma_config_transfer(info->dma_rx, (u32)&info->uart->DR, (u32)addr,
-                             len);
+        _dma_config_transfer(info->dma_rx, (u32)&info->uart->DR,
+                             (u32)seg.ptr[0], seg.len[0]);
     }
 }
 
@@ -720,7 +724,7 @@ void DMA1_Channel2_IRQHandler(void)
 
         uart_ctx_p->tx_dma_len = remaining;
 
-        xrbuf_skip(&uart->data.tx_rbuf, sent);
+        xrbuf_release(&uart->data.tx_rbuf, sent);
 
 #ifdef XHAL_OS_SUPPORTING
         osEventFlagsSet(uart->data.event_flag, XSERIAL_EVENT_CAN_WRITE);
@@ -730,23 +734,23 @@ void DMA1_Channel2_IRQHandler(void)
     {
         DMA_ClearITPendingBit(DMAy_IT_TCx);
 
-        xrbuf_skip(&uart->data.tx_rbuf, uart_ctx_p->tx_dma_len);
+        xrbuf_release(&uart->data.tx_rbuf, uart_ctx_p->tx_dma_len);
         uart_ctx_p->tx_dma_len = 0;
 
 #ifdef XHAL_OS_SUPPORTING
         osEventFlagsSet(uart->data.event_flag, XSERIAL_EVENT_CAN_WRITE);
 #endif
-        uint16_t len = xrbuf_get_linear_block_read_length(&uart->data.tx_rbuf);
-        if (len == 0)
+        xrbuf_seg_t seg;
+        xrbuf_peek_seg(&uart->data.tx_rbuf, UINT16_MAX, &seg);
+        if (seg.len[0] == 0)
         {
             return;
         }
 
-        uart_ctx_p->tx_dma_len = len;
+        uart_ctx_p->tx_dma_len = seg.len[0];
 
-        void *addr = xrbuf_get_linear_block_read_address(&uart->data.tx_rbuf);
-        _dma_config_transfer(info->dma_tx, (u32)&info->uart->DR, (u32)addr,
-                             len);
+        _dma_config_transfer(info->dma_tx, (u32)&info->uart->DR,
+                             (u32)seg.ptr[0], seg.len[0]);
     }
 }
 
@@ -771,7 +775,7 @@ void DMA1_Channel3_IRQHandler(void)
 
         uart_ctx_p->rx_dma_len = remaining;
 
-        xrbuf_advance(&uart->data.rx_rbuf, received);
+        xrbuf_commit(&uart->data.rx_rbuf, received);
 
 #ifdef XHAL_OS_SUPPORTING
         if (xrbuf_get_full(&uart->data.rx_rbuf) >= uart->data.rx_expect)
@@ -784,7 +788,7 @@ void DMA1_Channel3_IRQHandler(void)
     {
         DMA_ClearITPendingBit(DMAy_IT_TCx);
 
-        xrbuf_advance(&uart->data.rx_rbuf, uart_ctx_p->rx_dma_len);
+        xrbuf_commit(&uart->data.rx_rbuf, uart_ctx_p->rx_dma_len);
         uart_ctx_p->rx_dma_len = 0;
 
 #ifdef XHAL_OS_SUPPORTING
@@ -793,16 +797,16 @@ void DMA1_Channel3_IRQHandler(void)
             osEventFlagsSet(uart->data.event_flag, XSERIAL_EVENT_CAN_READ);
         }
 #endif
-        uint16_t len = xrbuf_get_linear_block_write_length(&uart->data.rx_rbuf);
-        if (len == 0)
+        xrbuf_seg_t seg;
+        xrbuf_reserve(&uart->data.rx_rbuf, UINT16_MAX, &seg);
+        if (seg.len[0] == 0)
         {
             return;
         }
 
-        uart_ctx_p->rx_dma_len = len;
+        uart_ctx_p->rx_dma_len = seg.len[0];
 
-        void *addr = xrbuf_get_linear_block_write_address(&uart->data.rx_rbuf);
-        _dma_config_transfer(info->dma_rx, (u32)&info->uart->DR, (u32)addr,
-                             len);
+        _dma_config_transfer(info->dma_rx, (u32)&info->uart->DR,
+                             (u32)seg.ptr[0], seg.len[0]);
     }
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include "xflash.h"
 #include "xhal_assert.h"
 #include "xhal_log.h"
+#include "xhal_malloc.h"
 
 XLOG_TAG("xFLASH");
 
@@ -17,6 +18,7 @@ static const osMutexAttr_t xflash_mutex_attr = {
 
 static inline void _lock(xflash_t *flash);
 static inline void _unlock(xflash_t *flash);
+static void _crc_cache_erased(xflash_t *flash, const xflash_event_t *event);
 
 xhal_err_t xflash_init(xflash_t *flash, const xflash_ops_t *ops, void *inst)
 {
@@ -26,10 +28,11 @@ xhal_err_t xflash_init(xflash_t *flash, const xflash_ops_t *ops, void *inst)
     xassert_ptr_struct_not_null(ops, "xflash_ops is null");
 
     xcoro_event_init(&flash->event);
-    xrbuf_init(&flash->evt_rb, flash->evt_buff, sizeof(flash->evt_buff));
+    xrecbuf_init(&flash->evt_rb, flash->evt_buff, sizeof(flash->evt_buff), 0);
 
-    flash->ops  = ops;
-    flash->inst = inst;
+    flash->ops       = ops;
+    flash->inst      = inst;
+    flash->crc_cache = NULL;
 
 #ifdef XHAL_OS_SUPPORTING
     flash->mutex = osMutexNew(&xflash_mutex_attr);
@@ -45,6 +48,8 @@ xhal_err_t xflash_init(xflash_t *flash, const xflash_ops_t *ops, void *inst)
         return ret;
     }
 
+    xrbuf_register(&flash->evt_rb.rb, "xflash", "evt");
+
     return XHAL_OK;
 }
 
@@ -59,9 +64,10 @@ xhal_err_t xflash_deinit(xflash_t *flash)
 
     xhal_err_t ret = flash->ops->deinit(flash->inst);
 
-    xrbuf_free(&flash->evt_rb);
-    flash->ops  = NULL;
-    flash->inst = NULL;
+    xrecbuf_deinit(&flash->evt_rb);
+    flash->ops       = NULL;
+    flash->inst      = NULL;
+    flash->crc_cache = NULL;
 
 #ifdef XHAL_OS_SUPPORTING
     osMutexDelete(flash->mutex);
@@ -134,6 +140,10 @@ xhal_err_t xflash_write(xflash_t *flash, uint32_t address, const uint8_t *data,
     _lock(flash);
     xhal_err_t ret =
         flash->ops->write(flash->inst, address, data, size, timeout_ms);
+    if (flash->crc_cache != NULL)
+    {
+        xflash_crc_cache_invalidate(flash->crc_cache, address, size);
+    }
     _unlock(flash);
 
     return ret;
@@ -158,15 +168,12 @@ xhal_err_t xflash_erase(xflash_t *flash, xflash_erase_type_t type,
     event.timeout_ms = timeout_ms;
     event.cb         = cb;
 
-    if (xrbuf_get_free(&flash->evt_rb) >= sizeof(event))
+    ret = xrecbuf_push(&flash->evt_rb, &event, sizeof(event));
+    if (ret == XHAL_OK)
     {
-        xrbuf_write(&flash->evt_rb, &event, sizeof(event));
+        _crc_cache_erased(flash, &event);
         XCORO_SET_EVENT(&flash->event, XFLASH_EVENT);
     }
-    else
-    {
-        ret = XHAL_ERR_FULL;
-    }
     _unlock(flash);
 
     return ret;
@@ -187,17 +194,293 @@ void xflash_handler_thread(xcoro_handle_t *handle, xflash_t *flash)
 
         if (XCORO_WAIT_RESULT(handle) & XFLASH_EVENT)
         {
-            while (xrbuf_get_full(&flash->evt_rb) >= sizeof(event))
+            while (xrecbuf_pop(&flash->evt_rb, &event, sizeof(event), NULL) ==
+                   XHAL_OK)
             {
-                xrbuf_read(&flash->evt_rb, &event, sizeof(event));
 
                 XCORO_CALL(handle, flash->ops->erase, flash->inst, &event);
+
+                /* 擦除期间的校验可能缓存了擦除前的 CRC, 完成后再作废一次 */
+                _lock(flash);
+                _crc_cache_erased(flash, &event);
+                _unlock(flash);
             }
         }
     }
     XCORO_END(handle);
 }
 
+xhal_err_t xflash_crc_cache_init(xflash_crc_cache_t *cache, uint32_t *crc,
+                                 uint8_t *valid, uint32_t base,
+                                 uint32_t sector_size, uint32_t count)
+{
+    xassert_not_null(cache);
+    xassert_not_null(crc);
+    xassert_not_null(valid);
+
+    if (sector_size == 0 || count == 0 ||
+        (uint64_t)base + (uint64_t)sector_size * count > 0x100000000ULL)
+    {
+        return XHAL_ERR_INVALID;
+    }
+
+    cache->crc         = crc;
+    cache->valid       = valid;
+    cache->base        = base;
+    cache->sector_size = sector_size;
+    cache->count       = count;
+    cache->epoch       = 0;
+
+    xmemset(valid, 0, (count + 7) / 8);
+
+    return XHAL_OK;
+}
+
+void xflash_crc_cache_invalidate(xflash_crc_cache_t *cache, uint32_t address,
+                                 uint32_t size)
+{
+    xassert_not_null(cache);
+
+    uint64_t start = address;
+    uint64_t end   = (uint64_t)address + size;
+    uint64_t lo    = cache->base;
+    uint64_t hi    = lo + (uint64_t)cache->sector_size * cache->count;
+
+    if (size == 0 || end <= lo || start >= hi)
+    {
+        return;
+    }
+
+    uint32_t sector = cache->sector_size;
+    uint32_t first  = (uint32_t)((XHAL_MAX(start, lo) - lo) / sector);
+    uint32_t last   = (uint32_t)((XHAL_MIN(end, hi) - 1 - lo) / sector);
+
+    for (uint32_t i = first; i <= last; i++)
+    {
+        cache->valid[i / 8] &= (uint8_t)~(1U << (i % 8));
+    }
+    cache->epoch++;
+}
+
+xhal_err_t xflash_set_crc_cache(xflash_t *flash, xflash_crc_cache_t *cache)
+{
+    xassert_not_null(flash);
+
+    if (flash->ops == NULL)
+    {
+        return XHAL_ERR_NO_INIT;
+    }
+
+    _lock(flash);
+    /* 脱离期间的写入无从得知, 重新挂载时全部作废 */
+    if (cache != NULL)
+    {
+        xflash_crc_cache_invalidate(cache, 0, UINT32_MAX);
+    }
+    flash->crc_cache = cache;
+    _unlock(flash);
+
+    return XHAL_OK;
+}
+
+/**
+ * @brief  顺序读取一段区域并续算 CRC32
+ * @param  crc  输入为前序 CRC32, 输出为续算结果
+ */
+static xhal_err_t _crc32_read(xflash_t *flash, uint32_t address, uint32_t size,
+                              uint32_t *crc, uint32_t timeout_ms)
+{
+    uint8_t buff[XFLASH_CRC_CHUNK_SIZE];
+
+    while (size > 0)
+    {
+        uint32_t n = XHAL_MIN(size, (uint32_t)sizeof(buff));
+
+        xhal_err_t ret = xflash_read(flash, address, buff, n, timeout_ms);
+        if (ret != XHAL_OK)
+        {
+            return ret;
+        }
+
+        *crc = xcrc32(*crc, buff, n);
+        address += n;
+        size -= n;
+    }
+
+    return XHAL_OK;
+}
+
+/**
+ * @brief  求从 address 起可一次处理的长度
+ * @param  n       输出长度
+ * @param  sector  输出缓存扇区号
+ * @retval true 表示 [address, address + n) 恰为缓存中的一个扇区
+ */
+static bool _crc_cache_span(const xflash_crc_cache_t *cache, uint32_t address,
+                            uint32_t size, uint32_t *n, uint32_t *sector)
+{
+    uint64_t end = cache->base + (uint64_t)cache->sector_size * cache->count;
+
+    *n = size;
+    if (address < cache->base)
+    {
+        *n = XHAL_MIN(size, cache->base - address);
+        return false;
+    }
+    if (address >= end)
+    {
+        return false;
+    }
+
+    uint32_t off = (address - cache->base) % cache->sector_size;
+    if (off != 0)
+    {
+        *n = XHAL_MIN(size, cache->sector_size - off);
+        return false;
+    }
+    if (size < cache->sector_size)
+    {
+        return false;
+    }
+
+    *n      = cache->sector_size;
+    *sector = (address - cache->base) / cache->sector_size;
+
+    return true;
+}
+
+/**
+ * @brief  取一个扇区的 CRC32, 未命中时读取并写入缓存
+ */
+static xhal_err_t _crc_cache_sector(xflash_t *flash, xflash_crc_cache_t *cache,
+                                    uint32_t sector, uint32_t *crc,
+                                    uint32_t timeout_ms)
+{
+    uint8_t mask = (uint8_t)(1U << (sector % 8));
+
+    _lock(flash);
+    uint32_t epoch = cache->epoch;
+    bool hit       = (cache->valid[sector / 8] & mask) != 0;
+    if (hit)
+    {
+        *crc = cache->crc[sector];
+    }
+    _unlock(flash);
+
+    if (hit)
+    {
+        return XHAL_OK;
+    }
+
+    uint32_t part  = XCRC32_INIT;
+    uint32_t address = cache->base + sector * cache->sector_size;
+    xhal_err_t ret   = _crc32_read(flash, address, cache->sector_size, &part,
+                                   timeout_ms);
+    if (ret != XHAL_OK)
+    {
+        return ret;
+    }
+
+    /* 读取期间有写入或擦除则不缓存, 结果仍可用于本次计算 */
+    _lock(flash);
+    if (cache->epoch == epoch && flash->crc_cache == cache)
+    {
+        cache->crc[sector] = part;
+        cache->valid[sector / 8] |= mask;
+    }
+    _unlock(flash);
+
+    *crc = part;
+
+    return XHAL_OK;
+}
+
+xhal_err_t xflash_crc32(xflash_t *flash, uint32_t address, uint32_t size,
+                        uint32_t *crc, uint32_t timeout_ms)
+{
+    xassert_not_null(flash);
+    xassert_not_null(crc);
+
+    if (flash->ops == NULL)
+    {
+        return XHAL_ERR_NO_INIT;
+    }
+
+    uint32_t total = XCRC32_INIT;
+
+    while (size > 0)
+    {
+        xflash_crc_cache_t *cache = flash->crc_cache;
+        uint32_t n                = size;
+        uint32_t sector           = 0;
+        xhal_err_t ret;
+
+        if (cache != NULL && _crc_cache_span(cache, address, size, &n, &sector))
+        {
+            uint32_t part;
+
+            ret   = _crc_cache_sector(flash, cache, sector, &part, timeout_ms);
+            total = xcrc32_combine(total, part, n);
+        }
+        else
+        {
+            ret = _crc32_read(flash, address, n, &total, timeout_ms);
+        }
+
+        if (ret != XHAL_OK)
+        {
+            return ret;
+        }
+
+        address += n;
+        size -= n;
+    }
+
+    *crc = total;
+
+    return XHAL_OK;
+}
+
+xhal_err_t xflash_verify(xflash_t *flash, uint32_t address, uint32_t size,
+                         uint32_t expect, uint32_t timeout_ms)
+{
+    uint32_t crc;
+
+    xhal_err_t ret = xflash_crc32(flash, address, size, &crc, timeout_ms);
+    if (ret != XHAL_OK)
+    {
+        return ret;
+    }
+
+    return crc == expect ? XHAL_OK : XHAL_ERR_CRC;
+}
+
+static void _crc_cache_erased(xflash_t *flash, const xflash_event_t *event)
+{
+    xflash_crc_cache_t *cache = flash->crc_cache;
+    uint32_t address          = event->address;
+
+    if (cache == NULL)
+    {
+        return;
+    }
+
+    switch (event->type)
+    {
+    case XFLASH_ERASE_SECTOR:
+        address -= address % XFLASH_SECTOR_SIZE;
+        xflash_crc_cache_invalidate(cache, address, XFLASH_SECTOR_SIZE);
+        break;
+    case XFLASH_ERASE_BLOCK:
+        address -= address % XFLASH_BLOCK_SIZE;
+        xflash_crc_cache_invalidate(cache, address, XFLASH_BLOCK_SIZE);
+        break;
+    default:
+        xflash_crc_cache_invalidate(cache, 0, UINT32_MAX);
+        break;
+    }
+}
+
 static inline void _lock(xflash_t *flash)
 {
 #ifdef XHAL_OS_SUPPORTING
@@ -2,11 +2,35 @@
 #define __XFLASH_H
 
 #include "xhal_coro.h"
+#include "xhal_crc.h"
 #include "xhal_def.h"
 #include "xhal_os.h"
-#include "xhal_ringbuf.h"
+#include "xhal_recbuf.h"
 
-#define XFLASH_EVENT_QUEUE_SIZE (sizeof(xflash_event_t) * 3 + 1)
+#define XFLASH_EVENT_QUEUE_SIZE XRECBUF_BUFF_SIZE(sizeof(xflash_event_t), 3)
+
+/* 扇区/块擦除的大小, 用于擦除后作废 CRC 缓存 */
+#ifndef XFLASH_SECTOR_SIZE
+#define XFLASH_SECTOR_SIZE (4 * 1024)
+#endif
+
+#ifndef XFLASH_BLOCK_SIZE
+#define XFLASH_BLOCK_SIZE (64 * 1024)
+#endif
+
+/* 计算 CRC 时每次读取的字节数, 缓冲区位于调用者栈上 */
+#ifndef XFLASH_CRC_CHUNK_SIZE
+#define XFLASH_CRC_CHUNK_SIZE (256)
+#endif
+
+/**
+ * @brief  定义扇区 CRC 缓存的静态存储
+ * @param  name   存储变量名前缀
+ * @param  count  扇区数
+ */
+#define XFLASH_CRC_CACHE_STORAGE(name, count) \
+    static uint32_t name##_crc[count];        \
+    static uint8_t name##_valid[((count) + 7) / 8]
 
 typedef enum
 {
@@ -43,13 +67,29 @@ typedef struct xflash_ops
     void (*erase)(xcoro_handle_t *handle, void *inst, xflash_event_t *event);
 } xflash_ops_t;
 
+/*
+ * 扇区 CRC 缓存: 覆盖 [base, base + sector_size * count) 区域, 记录每个扇区
+ * 的 CRC32. xflash_write/xflash_erase 作废涉及的扇区, 因此重复校验同一镜像
+ * 时只需重新读取改动过的扇区, 其余扇区的 CRC 由 xcrc32_combine 合并.
+ */
+typedef struct xflash_crc_cache
+{
+    uint32_t *crc;        /* 每扇区 CRC32 */
+    uint8_t *valid;       /* 有效位图, 每位对应一个扇区 */
+    uint32_t base;        /* 区域起始地址 */
+    uint32_t sector_size; /* 缓存粒度 */
+    uint32_t count;       /* 扇区数 */
+    uint32_t epoch;       /* 每次作废加一, 防止读取期间被写入的扇区误入缓存 */
+} xflash_crc_cache_t;
+
 typedef struct xflash
 {
-    xrbuf_t evt_rb;
+    xrecbuf_t evt_rb;
     uint8_t evt_buff[XFLASH_EVENT_QUEUE_SIZE];
     xcoro_event_t event;
     void *inst;
     const xflash_ops_t *ops;
+    xflash_crc_cache_t *crc_cache;
 
 #ifdef XHAL_OS_SUPPORTING
     osMutexId_t mutex;
@@ -69,6 +109,18 @@ xhal_err_t xflash_write(xflash_t *flash, uint32_t address, const uint8_t *data,
 xhal_err_t xflash_erase(xflash_t *flash, xflash_erase_type_t type,
                         uint32_t address, xflash_cb_t cb, uint32_t timeout_ms);
 
+xhal_err_t xflash_crc32(xflash_t *flash, uint32_t address, uint32_t size,
+                        uint32_t *crc, uint32_t timeout_ms);
+xhal_err_t xflash_verify(xflash_t *flash, uint32_t address, uint32_t size,
+                         uint32_t expect, uint32_t timeout_ms);
+
+xhal_err_t xflash_crc_cache_init(xflash_crc_cache_t *cache, uint32_t *crc,
+                                 uint8_t *valid, uint32_t base,
+                                 uint32_t sector_size, uint32_t count);
+void xflash_crc_cache_invalidate(xflash_crc_cache_t *cache, uint32_t address,
+                                 uint32_t size);
+xhal_err_t xflash_set_crc_cache(xflash_t *flash, xflash_crc_cache_t *cache);
+
 void xflash_handler_thread(xcoro_handle_t *handle, xflash_t *flash);
 
 #endif /* __XFLASH_H */
@@ -29,13 +29,16 @@ xhal_err_t xkey_manager_init(xkey_manager_t *mgr, const xkey_config_t *config,
     xassert_not_null(config);
     xassert_not_null(event_buf);
 
-    if (event_bufsz < sizeof(xkey_event_t))
+    if (event_bufsz < XRECBUF_BUFF_SIZE(sizeof(xkey_event_t), 1))
     {
         return XHAL_ERR_INVALID;
     }
 
     xlist_init(&mgr->key_list);
-    xrbuf_init(&mgr->evt_rb, event_buf, event_bufsz);
+    /* 事件缓冲满时丢弃最旧的事件, 保留最新的按键操作 */
+    xrecbuf_init(&mgr->evt_rb, event_buf, event_bufsz,
+                 XRECBUF_FLAG_DROP_OLDEST);
+    xrbuf_register(&mgr->evt_rb.rb, "xkey", "evt");
     mgr->last_scan_tick = 0;
     mgr->config         = *config;
 
@@ -51,13 +54,13 @@ xhal_err_t xkey_manager_deinit(xkey_manager_t *mgr)
 {
     xassert_not_null(mgr);
 
-    if (!mgr->evt_rb.buff)
+    if (!xrecbuf_is_ready(&mgr->evt_rb))
     {
         return XHAL_ERR_NO_INIT;
     }
 
     xlist_init(&mgr->key_list);
-    xrbuf_free(&mgr->evt_rb);
+    xrecbuf_deinit(&mgr->evt_rb);
 
 #ifdef XHAL_OS_SUPPORTING
     osStatus_t ret_os = osMutexDelete(mgr->mutex);
@@ -78,7 +81,7 @@ xhal_err_t xkey_register(xkey_manager_t *mgr, xkey_t *key, const char *name,
     xassert_not_null(key);
     xassert_not_null(state_cb);
 
-    if (!mgr->evt_rb.buff)
+    if (!xrecbuf_is_ready(&mgr->evt_rb))
     {
         return XHAL_ERR_NO_INIT;
     }
@@ -104,7 +107,7 @@ xhal_err_t xkey_unregister(xkey_manager_t *mgr, xkey_t *key)
     xassert_not_null(mgr);
     xassert_not_null(key);
 
-    if (!mgr->evt_rb.buff)
+    if (!xrecbuf_is_ready(&mgr->evt_rb))
     {
         return XHAL_ERR_NO_INIT;
     }
@@ -140,7 +143,7 @@ xhal_err_t xkey_poll(xkey_manager_t *mgr, xhal_tick_t now_tick)
 {
     xassert_not_null(mgr);
 
-    if (!mgr->evt_rb.buff)
+    if (!xrecbuf_is_ready(&mgr->evt_rb))
     {
         return XHAL_ERR_NO_INIT;
     }
@@ -220,10 +223,7 @@ xhal_err_t xkey_poll(xkey_manager_t *mgr, xhal_tick_t now_tick)
                 .raw_bits = key->event_bits,
             };
 
-            if (xrbuf_get_free(&mgr->evt_rb) >= sizeof(event))
-            {
-                xrbuf_write(&mgr->evt_rb, &event, sizeof(event));
-            }
+            xrecbuf_push(&mgr->evt_rb, &event, sizeof(event));
 
             /* 重置事件状态 */
             key->event_active = 0;
@@ -257,7 +257,7 @@ xhal_err_t xkey_get_event(xkey_manager_t *mgr, xkey_event_t *evt)
     xassert_not_null(mgr);
     xassert_not_null(evt);
 
-    if (!mgr->evt_rb.buff)
+    if (!xrecbuf_is_ready(&mgr->evt_rb))
     {
         return XHAL_ERR_NO_INIT;
     }
@@ -266,20 +266,12 @@ xhal_err_t xkey_get_event(xkey_manager_t *mgr, xkey_event_t *evt)
     uint32_t read  = 0;
 
     _lock(mgr);
-    if (!xrbuf_get_full(&mgr->evt_rb))
-    {
-        ret = XHAL_ERR_EMPTY;
-        goto exit;
-    }
-
-    read = xrbuf_read(&mgr->evt_rb, evt, sizeof(*evt));
-    if (read != sizeof(*evt))
+    ret = xrecbuf_pop(&mgr->evt_rb, evt, sizeof(*evt), &read);
+    if (ret == XHAL_ERR_NOT_ENOUGH || (ret == XHAL_OK && read != sizeof(*evt)))
     {
         ret = XHAL_ERROR;
-        xrbuf_reset(&mgr->evt_rb);
-        goto exit;
+        xrecbuf_reset(&mgr->evt_rb);
     }
-exit:
     _unlock(mgr);
 
     return ret;
@@ -289,13 +281,13 @@ xhal_err_t xkey_clear_event(xkey_manager_t *mgr)
 {
     xassert_not_null(mgr);
 
-    if (!mgr->evt_rb.buff)
+    if (!xrecbuf_is_ready(&mgr->evt_rb))
     {
         return XHAL_ERR_NO_INIT;
     }
 
     _lock(mgr);
-    xrbuf_reset(&mgr->evt_rb);
+    xrecbuf_reset(&mgr->evt_rb);
     _unlock(mgr);
 
     return XHAL_OK;
@@ -306,7 +298,7 @@ xkey_t *xkey_find_by_name(xkey_manager_t *mgr, const char *name)
     xassert_not_null(mgr);
     xassert_not_null(name);
 
-    if (!mgr->evt_rb.buff)
+    if (!xrecbuf_is_ready(&mgr->evt_rb))
     {
         return NULL;
     }
@@ -331,7 +323,7 @@ xkey_t *xkey_find_by_id(xkey_manager_t *mgr, uint32_t id)
 {
     xassert_not_null(mgr);
 
-    if (!mgr->evt_rb.buff)
+    if (!xrecbuf_is_ready(&mgr->evt_rb))
     {
         return NULL;
     }
@@ -4,7 +4,7 @@
 #include "xhal_def.h"
 #include "xhal_list.h"
 #include "xhal_os.h"
-#include "xhal_ringbuf.h"
+#include "xhal_recbuf.h"
 #include "xhal_time.h"
 
 typedef enum
@@ -71,7 +71,7 @@ typedef struct
 typedef struct
 {
     xhal_list_t key_list;
-    xrbuf_t evt_rb;
+    xrecbuf_t evt_rb;
     xhal_tick_t last_scan_tick;
     xkey_config_t config;
 
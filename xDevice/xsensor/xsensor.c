@@ -28,7 +28,8 @@ xhal_err_t xsensor_init(xsensor_t *sensor, const xsensor_ops_t *ops, void *inst)
     xassert_ptr_struct_not_null(ops, "xsensor_ops is null");
 
     xcoro_event_init(&sensor->event);
-    xrbuf_init(&sensor->evt_rb, sensor->evt_buff, sizeof(sensor->evt_buff));
+    xrecbuf_init(&sensor->evt_rb, sensor->evt_buff, sizeof(sensor->evt_buff),
+                 0);
 
     sensor->ops  = ops;
     sensor->inst = inst;
@@ -47,6 +48,8 @@ xhal_err_t xsensor_init(xsensor_t *sensor, const xsensor_ops_t *ops, void *inst)
         return ret;
     }
 
+    xrbuf_register(&sensor->evt_rb.rb, "xsensor", "evt");
+
     return XHAL_OK;
 }
 
@@ -61,7 +64,7 @@ xhal_err_t xsensor_deinit(xsensor_t *sensor)
 
     xhal_err_t ret = sensor->ops->deinit(sensor->inst);
 
-    xrbuf_free(&sensor->evt_rb);
+    xrecbuf_deinit(&sensor->evt_rb);
     sensor->ops  = NULL;
     sensor->inst = NULL;
 
@@ -122,11 +125,10 @@ void xsensor_handler_thread(xcoro_handle_t *handle, xsensor_t *sensor)
         if (XCORO_WAIT_RESULT(handle) & XSENSOR_EVENT)
         {
 
-            while (xrbuf_get_full(&sensor->evt_rb) >= sizeof(event))
+            while (xrecbuf_pop(&sensor->evt_rb, &event, sizeof(event),
+                               NULL) == XHAL_OK)
             {
 
-                xrbuf_read(&sensor->evt_rb, &event, sizeof(event));
-
                 if (event.type == XSENSOR_RESET)
                 {
                     XCORO_CALL(handle, sensor->ops->reset, sensor->inst,
@@ -136,7 +138,7 @@ void xsensor_handler_thread(xcoro_handle_t *handle, xsensor_t *sensor)
                 {
                     XCORO_CALL(handle, sensor->ops->read, sensor->inst, &event);
                 }
-            } /*  while (xrbuf_get_full(&sensor->evt_rb) >= sizeof(event)) */
+            } /*  while (xrecbuf_pop(&sensor->evt_rb, ...) == XHAL_OK) */
         } /* if (XCORO_WAIT_RESULT(handle) & XSENSOR_EVENT) */
     } /*  while (1) */
     XCORO_END(handle);
@@ -152,15 +154,11 @@ static xhal_err_t _post_event(xsensor_t *sensor, xsensor_event_type_t type,
     event.timeout_ms = timeout_ms;
     event.cb         = cb;
 
-    if (xrbuf_get_free(&sensor->evt_rb) >= sizeof(event))
+    ret = xrecbuf_push(&sensor->evt_rb, &event, sizeof(event));
+    if (ret == XHAL_OK)
     {
-        xrbuf_write(&sensor->evt_rb, &event, sizeof(event));
         XCORO_SET_EVENT(&sensor->event, XSENSOR_EVENT);
     }
-    else
-    {
-        ret = XHAL_ERR_FULL;
-    }
 
     return ret;
 }
@@ -4,9 +4,9 @@
 #include "xhal_coro.h"
 #include "xhal_def.h"
 #include "xhal_os.h"
-#include "xhal_ringbuf.h"
+#include "xhal_recbuf.h"
 
-#define XSENSOR_EVENT_QUEUE_SIZE (sizeof(xsensor_event_t) * 3 + 1)
+#define XSENSOR_EVENT_QUEUE_SIZE XRECBUF_BUFF_SIZE(sizeof(xsensor_event_t), 3)
 
 typedef enum
 {
@@ -38,7 +38,7 @@ typedef struct xsensor_ops
 
 typedef struct xsensor
 {
-    xrbuf_t evt_rb;
+    xrecbuf_t evt_rb;
     uint8_t evt_buff[XSENSOR_EVENT_QUEUE_SIZE];
     xcoro_event_t event;
     void *inst;
@@ -22,6 +22,20 @@
 
 #define XMALLOC_BLOCK_SIZE           (16)
 #define XMALLOC_MAX_SIZE             (10 * 1024)
+#define XMALLOC_USE_TLSF             (0)
+#define XMALLOC_REGION_NUM_MAX       (4)
+#define XMALLOC_USE_MUTEX            (0)
+#define XMALLOC_THREAD_CACHE         (0)
+#define XMEM_ACCEL_THRESHOLD         (0)
+#define XMALLOC_TRACE_ENABLE         (0)
+#define XARENA_SCRATCH_SIZE          (512)
+#define XMPSC_ISR_RETRY_MAX          (4)
+#define XRBUF_STATS_ENABLE           (0)
+#define XHTABLE_LOAD_MAX             (75)
+#define XCRC32_SLICE_BY              (4)
+#define XCRC32_ACCEL_THRESHOLD       (0)
+#define XTWHEEL_SLOT_BITS            (6)
+#define XTWHEEL_LEVELS               (4)
 
 #define XLOG_COLOR_ENABLE            (1)
 #define XLOG_NEWLINE_ENABLE          (1)
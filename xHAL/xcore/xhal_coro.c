@@ -3,6 +3,8 @@
 #include "xhal_log.h"
 #include "xhal_malloc.h"
 #include "xhal_time.h"
+#include "../xlib/xhal_bit.h"
+#include "../xlib/xhal_phash.h"
 #include <string.h>
 
 XLOG_TAG("xCoro");
@@ -20,6 +22,29 @@ static bool in_idle;
 static xcoro_event_t *xcoro_event_table[XCORO_EVENT_NUM_MAX];
 static uint16_t xcoro_event_count = 0;
 
+/* 事件名称索引, 事件表变化时标脏, 下次查找时重建; 未建成时退回逐项比较 */
+XPHASH_STORAGE(xcoro_event_index, XCORO_EVENT_NUM_MAX);
+static xphash_t xcoro_event_hash;
+
+static const char *_event_key(void *ctx, uint32_t index)
+{
+    XHAL_UNUSED(ctx);
+
+    return xcoro_event_table[index] ? xcoro_event_table[index]->name : NULL;
+}
+
+static void _event_reindex(void)
+{
+    if (xcoro_event_hash.slot == NULL)
+    {
+        xphash_init(&xcoro_event_hash, xcoro_event_index_disp,
+                    xcoro_event_index_slot, XCORO_EVENT_NUM_MAX, _event_key,
+                    NULL);
+    }
+
+    xphash_mark_dirty(&xcoro_event_hash, XCORO_EVENT_NUM_MAX);
+}
+
 xhal_err_t xcoro_event_init(xcoro_event_t *event)
 {
     xassert_not_null(event);
@@ -48,6 +73,7 @@ xhal_err_t xcoro_event_add(xcoro_event_t *event)
         {
             xcoro_event_table[i] = event;
             xcoro_event_count++;
+            _event_reindex();
             return XHAL_OK;
         }
     }
@@ -68,6 +94,7 @@ xhal_err_t xcoro_event_remove(xcoro_event_t *event)
             xcoro_event_table[i] = NULL;
             xcoro_event_count--;
             ret = XHAL_OK;
+            _event_reindex();
             break;
         }
     }
@@ -80,17 +107,26 @@ xcoro_event_t *xcoro_event_find(const char *name)
     xassert_not_null(name);
 
     xcoro_event_t *event = NULL;
-    for (uint16_t i = 0; i < XCORO_EVENT_NUM_MAX; i++)
+    if (xphash_refresh(&xcoro_event_hash))
+    {
+        int32_t index = xphash_find(&xcoro_event_hash, name);
+        event         = index < 0 ? NULL : xcoro_event_table[index];
+    }
+    else
     {
-        if (xcoro_event_table[i] ? xcoro_event_table[i]->name == NULL : NULL)
+        for (uint16_t i = 0; i < XCORO_EVENT_NUM_MAX; i++)
         {
-            continue;
-        }
+            if (xcoro_event_table[i] == NULL ||
+                xcoro_event_table[i]->name == NULL)
+            {
+                continue;
+            }
 
-        if (strcmp(xcoro_event_table[i]->name, name) == 0)
-        {
-            event = xcoro_event_table[i];
-            break;
+            if (strcmp(xcoro_event_table[i]->name, name) == 0)
+            {
+                event = xcoro_event_table[i];
+                break;
+            }
         }
     }
 
@@ -120,64 +156,88 @@ bool xcoro_event_of_name(xcoro_event_t *event, const char *name)
     return false;
 }
 
+/*
+ * 就绪队列: 位图选出最高优先级, 入队/出队/取最高优先级均为 O(1).
+ * 取下一个协程时从队头弹出, 再次就绪时追加到队尾, 同优先级轮流运行.
+ */
 static void _ready_list_insert(xcoro_handle_t *handle)
 {
     xassert_not_null(handle);
     xassert_not_null(handle->mgr);
+    xassert((uint32_t)handle->prio < XCORO_PRIO_MAX);
 
-    xcoro_handle_t **pp = &handle->mgr->ready_list;
-
-    /*
-     * 条件：当前节点优先级 >= 新节点优先级时，继续向后
-     *
-     * 1. 更高优先级的协程：插入在链表最前面
-     * 2. 相同优先级的协程：插入在相同优先级段的最后面（先进先出）
-     * 3. 更低优先级的协程：插入在第一个更低优先级节点前面
-     */
-    while (*pp && (*pp)->prio >= handle->prio)
-        pp = &(*pp)->next;
+    xcoro_manager_t *mgr  = handle->mgr;
+    uint32_t prio         = (uint32_t)handle->prio;
+    xcoro_handle_t **tail = &mgr->ready_tail[prio];
 
-    handle->next = *pp;
-    *pp          = handle;
+    if (*tail)
+    {
+        handle->next  = (*tail)->next;
+        (*tail)->next = handle;
+    }
+    else
+    {
+        handle->next = handle;
+        mgr->ready_map[prio / 32] |= 1U << (prio % 32);
+    }
+    *tail = handle;
 }
 
-static void _sleep_list_insert(xcoro_handle_t *handle)
+static void _ready_list_find_remove(xcoro_handle_t *handle)
 {
     xassert_not_null(handle);
     xassert_not_null(handle->mgr);
 
-    xcoro_handle_t **pp = &handle->mgr->sleep_list;
+    xcoro_manager_t *mgr = handle->mgr;
+    uint32_t prio        = (uint32_t)handle->prio;
+    xcoro_handle_t *tail = mgr->ready_tail[prio];
 
-    /*
-     * 条件：当前节点唤醒时间 ≤ 新节点唤醒时间时，继续向后
-     *
-     * 1. 更早唤醒的协程：插入在链表最前面（如果新节点唤醒时间最早）
-     * 2. 相同唤醒时间的协程：插入在相同时间段的最后面（先进先出）
-     * 3. 更晚唤醒的协程：插入在第一个更晚唤醒节点前面
-     */
-    while (*pp && TIME_BEFOR_EQ((*pp)->wakeup_tick_ms, handle->wakeup_tick_ms))
-        pp = &(*pp)->next;
+    if (tail == NULL)
+        return;
+
+    /* 只需遍历本优先级的队列, 找到前驱 */
+    xcoro_handle_t *prev = tail;
+    do
+    {
+        if (prev->next == handle)
+        {
+            if (handle == prev)
+            {
+                mgr->ready_tail[prio] = NULL;
+                mgr->ready_map[prio / 32] &= ~(1U << (prio % 32));
+            }
+            else
+            {
+                prev->next = handle->next;
+                if (handle == tail)
+                    mgr->ready_tail[prio] = prev;
+            }
+            handle->next = NULL;
+            return;
+        }
+        prev = prev->next;
+    } while (prev != tail);
+}
 
-    handle->next = *pp;
-    *pp          = handle;
+/*
+ * 延时与等待超时挂在管理器的分层时间轮上, 启动/取消均为 O(1),
+ * 到期时按槽批量取出.
+ */
+static void _sleep_timer_start(xcoro_handle_t *handle)
+{
+    xassert_not_null(handle);
+    xassert_not_null(handle->mgr);
+
+    xtwheel_add(&handle->mgr->timer, &handle->timer, handle->wakeup_tick_ms);
 }
 
-static void _sleep_list_find_remove(xcoro_handle_t *handle)
+static void _sleep_timer_stop(xcoro_handle_t *handle)
 {
     xassert_not_null(handle);
     xassert_not_null(handle->mgr);
 
-    xcoro_handle_t **pp = &handle->mgr->sleep_list;
-    while (*pp)
-    {
-        if (*pp == handle)
-        {
-            *pp          = handle->next;
-            handle->next = NULL;
-            return;
-        }
-        pp = &(*pp)->next;
-    }
+    handle->wakeup_tick_ms = 0;
+    xtwheel_remove(&handle->mgr->timer, &handle->timer);
 }
 
 static void _event_wait_list_find_remove(xcoro_handle_t *handle)
@@ -197,45 +257,43 @@ static void _event_wait_list_find_remove(xcoro_handle_t *handle)
         pp = &(*pp)->next;
     }
 }
-void _wake_expired_sleepers(xcoro_manager_t *mgr)
+static void _sleep_expired(xtwheel_node_t *node, void *arg)
 {
-    xhal_tick_t now = xtime_get_tick_ms();
-    xcoro_handle_t *handle;
+    xcoro_handle_t *handle = XTWHEEL_ENTRY(node, xcoro_handle_t, timer);
+
+    XHAL_UNUSED(arg);
 
-    while ((handle = mgr->sleep_list) != NULL)
+    if (handle->waiting_event)
     {
-        /* sleep_list 按时间排序，遇到未到期的直接退出 */
-        if (TIME_AFTER(handle->wakeup_tick_ms, now))
-            break;
+        _event_wait_list_find_remove(handle);
+        handle->waiting_event = NULL;
+        handle->wait_result   = (uint32_t)XCORO_WAIT_TIMEOUT;
+        handle->wait_mask     = 0;
+        handle->wait_flags    = 0;
+    }
 
-        mgr->sleep_list = handle->next;
+    handle->wakeup_tick_ms = 0;
 
-        if (handle->waiting_event)
-        {
-            _event_wait_list_find_remove(handle);
-            handle->waiting_event = NULL;
-            handle->wait_result   = (uint32_t)XCORO_WAIT_TIMEOUT;
-            handle->wait_mask     = 0;
-            handle->wait_flags    = 0;
-        }
-
-        handle->next           = NULL;
-        handle->wakeup_tick_ms = 0;
+    handle->state = XCORO_STATE_READY;
+    _ready_list_insert(handle);
+}
 
-        handle->state = XCORO_STATE_READY;
-        _ready_list_insert(handle);
-    }
+void _wake_expired_sleepers(xcoro_manager_t *mgr)
+{
+    xtwheel_advance(&mgr->timer, xtime_get_tick_ms(), _sleep_expired, NULL);
 }
 
 xhal_tick_t _next_wakeup_delay_ms(xcoro_manager_t *mgr)
 {
-    if (mgr->sleep_list == NULL)
+    xhal_tick_t tick;
+
+    /* 远处的定时器给出的是其降级的时刻, 提前醒来不会错过到期 */
+    if (xtwheel_next_expire(&mgr->timer, &tick) != XHAL_OK)
     {
         return 0;
     }
 
-    xhal_tick_t now  = xtime_get_tick_ms();
-    xhal_tick_t tick = mgr->sleep_list->wakeup_tick_ms;
+    xhal_tick_t now = xtime_get_tick_ms();
 
     if (TIME_AFTER_EQ(now, tick))
     {
@@ -247,19 +305,36 @@ xhal_tick_t _next_wakeup_delay_ms(xcoro_manager_t *mgr)
 
 xcoro_handle_t *_get_next_ready(xcoro_manager_t *mgr)
 {
-    xcoro_handle_t *handle = mgr->ready_list;
-
-    if (handle)
+    for (int32_t w = XCORO_READY_MAP_WORDS - 1; w >= 0; w--)
     {
-        mgr->ready_list = handle->next;
-        handle->next    = NULL;
+        if (mgr->ready_map[w] == 0)
+            continue;
+
+        uint32_t prio = (uint32_t)(w * 32 + xbit_fls32(mgr->ready_map[w]));
+        xcoro_handle_t *tail   = mgr->ready_tail[prio];
+        xcoro_handle_t *handle = tail->next;
+
+        if (handle == tail)
+        {
+            mgr->ready_tail[prio] = NULL;
+            mgr->ready_map[w] &= ~(1U << (prio % 32));
+        }
+        else
+        {
+            tail->next = handle->next;
+        }
+
+        handle->next = NULL;
+        return handle;
     }
-    return handle;
+
+    return NULL;
 }
 
 void xcoro_manager_init(xcoro_manager_t *mgr)
 {
     xmemset(mgr, 0, sizeof(*mgr));
+    xtwheel_init(&mgr->timer, xtime_get_tick_ms());
 }
 
 xhal_err_t xcoro_register(xcoro_manager_t *mgr, xcoro_handle_t *handle)
@@ -296,23 +371,9 @@ xhal_err_t xcoro_unregister(xcoro_handle_t *handle)
         return XHAL_OK;
     }
 
-    xcoro_handle_t **pp;
-    pp = &handle->mgr->ready_list;
-    while (*pp)
-    {
-        if (*pp == handle)
-        {
-            *pp = handle->next;
-            break;
-        }
-        pp = &(*pp)->next;
-    }
+    _ready_list_find_remove(handle);
 
-    if (handle->wakeup_tick_ms)
-    {
-        handle->wakeup_tick_ms = 0;
-        _sleep_list_find_remove(handle);
-    }
+    _sleep_timer_stop(handle);
 
     if (handle->waiting_event)
     {
@@ -345,7 +406,7 @@ void xcoro_sleep(xcoro_handle_t *handle, xhal_tick_t delay_ms)
     handle->wakeup_tick_ms = xtime_get_tick_ms() + delay_ms;
     handle->state          = XCORO_STATE_SLEEPING;
 
-    _sleep_list_insert(handle);
+    _sleep_timer_start(handle);
 }
 
 void xcoro_sleep_until(xcoro_handle_t *handle, xhal_tick_t tick_ms)
@@ -356,7 +417,7 @@ void xcoro_sleep_until(xcoro_handle_t *handle, xhal_tick_t tick_ms)
     handle->wakeup_tick_ms = tick_ms;
     handle->state          = XCORO_STATE_SLEEPING;
 
-    _sleep_list_insert(handle);
+    _sleep_timer_start(handle);
 }
 
 void xcoro_wait_event(xcoro_handle_t *handle, xcoro_event_t *event,
@@ -396,11 +457,11 @@ void xcoro_wait_event(xcoro_handle_t *handle, xcoro_event_t *event,
     handle->next     = event->wait_list;
     event->wait_list = handle;
 
-    /* 有超时则加入 sleep_list */
+    /* 有超时则启动超时定时器 */
     if (timeout_ms != XCORO_WAIT_FOREVER)
     {
         handle->wakeup_tick_ms = xtime_get_tick_ms() + timeout_ms;
-        _sleep_list_insert(handle);
+        _sleep_timer_start(handle);
     }
 }
 
@@ -434,11 +495,7 @@ void xcoro_set_event(xcoro_event_t *event, uint32_t bits)
                                     : (~matched);
             }
 
-            if (handle->wakeup_tick_ms)
-            {
-                handle->wakeup_tick_ms = 0;
-                _sleep_list_find_remove(handle);
-            }
+            _sleep_timer_stop(handle);
 
             handle->waiting_event = NULL;
             handle->wait_result   = matched;
@@ -484,11 +541,7 @@ void xcoro_schedule(xcoro_handle_t *handle)
     xassert_not_null(handle);
     xassert_not_null(handle->mgr);
 
-    if (handle->wakeup_tick_ms)
-    {
-        handle->wakeup_tick_ms = 0;
-        _sleep_list_find_remove(handle);
-    }
+    _sleep_timer_stop(handle);
 
     if (handle->waiting_event)
     {
@@ -512,23 +565,9 @@ void xcoro_finish(xcoro_handle_t *handle)
         return;
     }
 
-    xcoro_handle_t **pp;
-    pp = &handle->mgr->ready_list;
-    while (*pp)
-    {
-        if (*pp == handle)
-        {
-            *pp = handle->next;
-            break;
-        }
-        pp = &(*pp)->next;
-    }
+    _ready_list_find_remove(handle);
 
-    if (handle->wakeup_tick_ms)
-    {
-        handle->wakeup_tick_ms = 0;
-        _sleep_list_find_remove(handle);
-    }
+    _sleep_timer_stop(handle);
 
     if (handle->waiting_event)
     {
@@ -651,33 +690,47 @@ void xcoro_dump_all(const xcoro_manager_t *mgr)
 
     /* READY list */
     xlog_printf("[READY LIST]\r\n");
-    if (mgr->ready_list == NULL)
+    bool ready_empty = true;
+    for (int32_t prio = XCORO_PRIO_MAX - 1; prio >= 0; prio--)
     {
-        xlog_printf("  <empty>\r\n");
-    }
-    else
-    {
-        const xcoro_handle_t *handle = mgr->ready_list;
-        while (handle)
+        const xcoro_handle_t *tail = mgr->ready_tail[prio];
+        if (tail == NULL)
         {
-            xcoro_dump_handle(handle);
-            handle = handle->next;
+            continue;
         }
+
+        const xcoro_handle_t *handle = tail;
+        do
+        {
+            handle = handle->next;
+            xcoro_dump_handle(handle);
+        } while (handle != tail);
+        ready_empty = false;
+    }
+    if (ready_empty)
+    {
+        xlog_printf("  <empty>\r\n");
     }
 
-    /* SLEEP list */
+    /* SLEEP timers, 按时间轮的槽排列 */
     xlog_printf("[SLEEP LIST]\r\n");
-    if (mgr->sleep_list == NULL)
+    if (xtwheel_count(&mgr->timer) == 0)
     {
         xlog_printf("  <empty>\r\n");
     }
     else
     {
-        const xcoro_handle_t *handle = mgr->sleep_list;
-        while (handle)
+        for (uint32_t i = 0; i <= XTWHEEL_DUE_SLOT; i++)
         {
-            xcoro_dump_handle(handle);
-            handle = handle->next;
+            const xtwheel_node_t *head = mgr->timer.slot[i];
+            const xtwheel_node_t *node = head;
+
+            while (node)
+            {
+                xcoro_dump_handle(
+                    XTWHEEL_ENTRY(node, const xcoro_handle_t, timer));
+                node = node->next == head ? NULL : node->next;
+            }
         }
     }
 
@@ -745,7 +798,7 @@ void xcoro_scheduler_run(xcoro_manager_t *mgr)
     while (!mgr->shutdown_req)
     {
         /* ------------------------------------------------------------
-         * 1. 处理所有已到期的延时协程（sleep_list → ready_list）
+         * 1. 处理所有已到期的延时协程（时间轮 → 就绪队列）
          * ------------------------------------------------------------ */
         _wake_expired_sleepers(mgr);
 
@@ -771,7 +824,7 @@ void xcoro_scheduler_run(xcoro_manager_t *mgr)
         if (delay == 0)
         {
             /* --------------------------------------------------------
-             * 3.1 没有任何未来的超时事件（sleep_list 为空）
+             * 3.1 没有任何未来的超时事件（时间轮为空）
              *     → 协程系统完全事件驱动
              *
              *     行为：
@@ -785,7 +838,7 @@ void xcoro_scheduler_run(xcoro_manager_t *mgr)
         }
 
         /* ------------------------------------------------------------
-         * 3.2 存在未来的唤醒时间点（sleep_list 非空）
+         * 3.2 存在未来的唤醒时间点（时间轮非空）
          *     → 安排一次定时唤醒以进入下一个协程节点
          *
          *     要做的事：
@@ -3,6 +3,7 @@
 
 #include "xhal_def.h"
 #include "xhal_time.h"
+#include "../xlib/xhal_twheel.h"
 
 #define XCORO_WAIT_FOREVER        0xFFFFFFFFU
 
@@ -71,6 +72,7 @@ typedef struct xcoro_handle
     void *user_data;
 
     xhal_tick_t wakeup_tick_ms;
+    xtwheel_node_t timer; /* 延时/等待超时, 挂在管理器的时间轮上 */
 
     xcoro_event_t *waiting_event;
     uint32_t wait_result;
@@ -90,13 +92,22 @@ typedef struct xcoro_event
     xcoro_handle_t *wait_list;
 } xcoro_event_t;
 
+/* 就绪位图字数, 每个优先级占一位 */
+#define XCORO_READY_MAP_WORDS (XCORO_PRIO_MAX / 32)
+
 /* 管理器 */
 typedef struct xcoro_manager
 {
     uint32_t count;
 
-    xcoro_handle_t *ready_list;
-    xcoro_handle_t *sleep_list;
+    /*
+     * 就绪队列: 每个优先级一条循环单链表, 记录队尾(队头为 tail->next),
+     * 同优先级先进先出; 位图第 n 位表示优先级 n 的队列非空.
+     */
+    xcoro_handle_t *ready_tail[XCORO_PRIO_MAX];
+    uint32_t ready_map[XCORO_READY_MAP_WORDS];
+
+    xtwheel_t timer; /* 延时与等待超时 */
 
     bool shutdown_req;
 } xcoro_manager_t;
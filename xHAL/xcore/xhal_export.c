@@ -4,6 +4,7 @@
 #include "xhal_log.h"
 #include "xhal_malloc.h"
 #include "xhal_time.h"
+#include "../xlib/xhal_arena.h"
 #include <stdio.h>
 
 XLOG_TAG("xExport");
@@ -64,6 +65,10 @@ static void _export_poll_coro_func(void);
 static void null_poll(void)
 {
 #ifdef XHAL_OS_SUPPORTING
+    xarena_scratch_release();
+#if XMALLOC_THREAD_CACHE
+    xmem_cache_flush();
+#endif
     osThreadExit();
 #endif
 }
@@ -229,6 +234,11 @@ void xhal_exit(void)
                           "priority: %d",
                           name ? name : "unknown", state, priority);
 
+                osThreadSuspend(xexport_poll_thread_ids[i]);
+                xarena_scratch_release_thread(xexport_poll_thread_ids[i]);
+#if XMALLOC_THREAD_CACHE
+                xmem_cache_flush_thread(xexport_poll_thread_ids[i]);
+#endif
                 osThreadTerminate(xexport_poll_thread_ids[i]);
                 xexport_poll_thread_ids[i] = NULL;
             }
@@ -484,6 +494,10 @@ static void _entry_start_export(void *para)
     XLOG_INFO("Poll thread ended, Memory usage: %d.%d%%, Free size: %lu bytes",
               perused / 10, perused % 10, free_size);
 
+    xarena_scratch_release();
+#if XMALLOC_THREAD_CACHE
+    xmem_cache_flush();
+#endif
     osThreadExit();
 }
 
@@ -553,6 +567,10 @@ static void _poll_thread(void *arg)
         }
     }
 
+    xarena_scratch_release();
+#if XMALLOC_THREAD_CACHE
+    xmem_cache_flush();
+#endif
     osThreadExit();
 }
 
@@ -1,4 +1,6 @@
+#define XMALLOC_TRACE_IMPL
 #include "xhal_malloc.h"
+#include "../xlib/xhal_bit.h"
 #include "xhal_assert.h"
 #include "xhal_def.h"
 #include "xhal_export.h"
@@ -6,171 +8,2034 @@
 
 XLOG_TAG("xMalloc");
 
+#if XMALLOC_TRACE_ENABLE
+#include "xhal_time.h"
+#include <string.h>
+#endif
+
 #ifdef XHAL_OS_SUPPORTING
 #include "../xos/xhal_os.h"
 
-#include "../xos/FreeRTOS/include/task.h"
-#define XMALLOC_ENTER_CRITICAL() vTaskSuspendAll()
-#define XMALLOC_EXIT_CRITICAL()  (void)xTaskResumeAll()
-#else
-#define XMALLOC_ENTER_CRITICAL()
-#define XMALLOC_EXIT_CRITICAL()
-#endif
+#include "../xos/FreeRTOS/include/task.h"
+#endif
+
+/* 堆锁与线程本地存储可在 xhal_config.h 中重定义, 例如主机端测试 */
+#ifndef XMALLOC_ENTER_CRITICAL
+#if defined(XHAL_OS_SUPPORTING) && XMALLOC_USE_MUTEX
+#define XMEM_OS_MUTEX
+static void _xmem_lock(void);
+static void _xmem_unlock(void);
+#define XMALLOC_ENTER_CRITICAL() _xmem_lock()
+#define XMALLOC_EXIT_CRITICAL()  _xmem_unlock()
+#elif defined(XHAL_OS_SUPPORTING)
+#define XMALLOC_ENTER_CRITICAL() vTaskSuspendAll()
+#define XMALLOC_EXIT_CRITICAL()  (void)xTaskResumeAll()
+#else
+#define XMALLOC_ENTER_CRITICAL()
+#define XMALLOC_EXIT_CRITICAL()
+#endif
+#endif /* XMALLOC_ENTER_CRITICAL */
+
+#if XMALLOC_THREAD_CACHE && !defined(XMALLOC_CACHE_GET)
+#ifndef XHAL_OS_SUPPORTING
+#error "XMALLOC_THREAD_CACHE requires XHAL_OS_SUPPORTING"
+#endif
+#define XMALLOC_CACHE_GET_OF(thread)                    \
+    pvTaskGetThreadLocalStoragePointer((TaskHandle_t)(thread), \
+                                       XMALLOC_CACHE_TLS_INDEX)
+#define XMALLOC_CACHE_SET_OF(thread, cache)                   \
+    vTaskSetThreadLocalStoragePointer((TaskHandle_t)(thread), \
+                                      XMALLOC_CACHE_TLS_INDEX, (cache))
+#define XMALLOC_CACHE_GET()         XMALLOC_CACHE_GET_OF(NULL)
+#define XMALLOC_CACHE_SET(cache)    XMALLOC_CACHE_SET_OF(NULL, (cache))
+#endif
+
+#if XMALLOC_REGION_NUM_MAX < 1
+#error "XMALLOC_REGION_NUM_MAX must be at least 1"
+#endif
+
+static XHAL_USED XHAL_ALIGN(64) uint8_t xmem_internal_ram[XMALLOC_MAX_SIZE];
+
+#if XMALLOC_USE_TLSF == 0
+static uint16_t xmem_internal_map[XMALLOC_ALLOC_TABLE_SIZE];
+
+#define XMALLOC_INTERNAL_CTRL xmem_internal_map
+#else
+/*
+ * TLSF(Two-Level Segregated Fit):
+ * 一级索引按 2 的幂划分空闲块大小, 二级索引再将每个区间线性划分为
+ * TLSF_SL_INDEX_COUNT 份, 两级位图配合 BIT_FFS/BIT_FLS 定位空闲链表,
+ * 分配与释放的耗时与堆大小及已分配块数无关.
+ */
+#define TLSF_ALIGN_SIZE_LOG2     (3)
+#define TLSF_ALIGN_SIZE          (1U << TLSF_ALIGN_SIZE_LOG2)
+#define TLSF_SL_INDEX_COUNT_LOG2 (4)
+#define TLSF_SL_INDEX_COUNT      (1U << TLSF_SL_INDEX_COUNT_LOG2)
+#define TLSF_FL_INDEX_SHIFT \
+    (TLSF_SL_INDEX_COUNT_LOG2 + TLSF_ALIGN_SIZE_LOG2)
+#define TLSF_FL_INDEX_COUNT \
+    (XMALLOC_TLSF_FL_INDEX_MAX - TLSF_FL_INDEX_SHIFT + 1)
+#define TLSF_SMALL_BLOCK_SIZE (1U << TLSF_FL_INDEX_SHIFT)
+
+#if (TLSF_FL_INDEX_COUNT <= 0) || (TLSF_FL_INDEX_COUNT > 32)
+#error "XMALLOC_TLSF_FL_INDEX_MAX out of range"
+#endif
+
+#if XMALLOC_MAX_SIZE >= (1UL << XMALLOC_TLSF_FL_INDEX_MAX)
+#error "XMALLOC_MAX_SIZE too large, increase XMALLOC_TLSF_FL_INDEX_MAX"
+#endif
+
+#define TLSF_BLOCK_FREE      (1U << 0) /* 当前块空闲 */
+#define TLSF_BLOCK_PREV_FREE (1U << 1) /* 物理上前一块空闲 */
+#define TLSF_BLOCK_FLAGS     (TLSF_BLOCK_FREE | TLSF_BLOCK_PREV_FREE)
+
+typedef struct xmem_tlsf_block
+{
+    struct xmem_tlsf_block *prev_phys; /* 物理前一块, 仅前一块空闲时有效 */
+    uint32_t size;                     /* 负载大小, 低两位为状态标志 */
+
+    /* 以下字段仅在块空闲时有效, 与负载区重叠 */
+    struct xmem_tlsf_block *next_free;
+    struct xmem_tlsf_block *prev_free;
+} xmem_tlsf_block_t;
+
+#define TLSF_BLOCK_HEADER (offsetof(xmem_tlsf_block_t, next_free))
+#define TLSF_BLOCK_SIZE_MIN \
+    XHAL_CEIL(sizeof(xmem_tlsf_block_t) - TLSF_BLOCK_HEADER, TLSF_ALIGN_SIZE)
+#define TLSF_BLOCK_SIZE_MAX \
+    ((1UL << XMALLOC_TLSF_FL_INDEX_MAX) - TLSF_SMALL_BLOCK_SIZE)
+
+typedef struct xmem_tlsf
+{
+    uint32_t fl_bitmap;
+    uint32_t sl_bitmap[TLSF_FL_INDEX_COUNT];
+    xmem_tlsf_block_t *blocks[TLSF_FL_INDEX_COUNT][TLSF_SL_INDEX_COUNT];
+    uint32_t free_size; /* 空闲链表中的负载字节数 */
+} xmem_tlsf_t;
+
+static xmem_tlsf_t xmem_internal_tlsf;
+
+#define XMALLOC_INTERNAL_CTRL (&xmem_internal_tlsf)
+#endif /* XMALLOC_USE_TLSF == 0 */
+
+/* 区域 0 固定为内部 RAM, 其余由 xmem_region_add 注册 */
+static xmem_pool_t xmem_regions[XMALLOC_REGION_NUM_MAX] = {
+    [0] = {
+        .name    = "internal",
+        .membase = xmem_internal_ram,
+        .memsize = XMALLOC_MAX_SIZE,
+        .caps    = XMALLOC_INTERNAL_CAPS,
+        .ctrl    = XMALLOC_INTERNAL_CTRL,
+        .memrdy  = 0,
+    },
+};
+static uint8_t xmem_region_num = 1;
+static uint32_t xmem_fail_count = 0; /* 所有区域都无法满足的分配次数 */
+
+#ifdef XMEM_OS_MUTEX
+static osMutexId_t xmem_mutex = NULL;
+
+static const osMutexAttr_t xmem_mutex_attr = {
+    .name      = "xmem_mutex",
+    .attr_bits = osMutexPrioInherit | osMutexRecursive,
+    .cb_mem    = NULL,
+    .cb_size   = 0,
+};
+
+static void _xmem_lock(void)
+{
+    if (xmem_mutex == NULL)
+    {
+        /* 首次使用时创建, 挂起调度器避免重复创建 */
+        int32_t lock = osKernelLock();
+        if (xmem_mutex == NULL)
+            xmem_mutex = osMutexNew(&xmem_mutex_attr);
+        (void)osKernelRestoreLock(lock);
+    }
+
+    (void)osMutexAcquire(xmem_mutex, osWaitForever);
+}
+
+static void _xmem_unlock(void)
+{
+    (void)osMutexRelease(xmem_mutex);
+}
+#endif
+
+/*
+ * 按机器字宽搬运的内存拷贝/填充:
+ * 先逐字节对齐目的地址, 中段按字(展开 4 次)处理, 尾部逐字节收尾.
+ * 源地址与目的地址错位时读取对齐的整字并移位拼接, 不产生非对齐访问.
+ */
+#if defined(__GNUC__) || defined(__clang__)
+typedef xhal_pointer_t __attribute__((__may_alias__)) xmem_word_t;
+#else
+typedef xhal_pointer_t xmem_word_t;
+#endif
+
+#define XMEM_WSIZE      ((uint32_t)sizeof(xmem_word_t))
+#define XMEM_WMASK      (XMEM_WSIZE - 1)
+#define XMEM_BLOCK_SIZE (XMEM_WSIZE * 4)
+
+/* 短于该长度时逐字节处理更快 */
+#define XMEM_SMALL_SIZE (XMEM_WSIZE * 2)
+
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+#define XMEM_MERGE(lo, hi, shl, shr) (((lo) << (shl)) | ((hi) >> (shr)))
+#else
+#define XMEM_MERGE(lo, hi, shl, shr) (((lo) >> (shl)) | ((hi) << (shr)))
+#endif
+
+#if XMEM_ACCEL_THRESHOLD > 0
+/**
+ * @brief  内存拷贝加速器钩子(如 DMA), 由用户重新实现
+ * @note   须同步完成; 返回非 XHAL_OK 时退回 CPU 拷贝
+ */
+XHAL_WEAK xhal_err_t xmem_accel_copy(void *des, const void *src, uint32_t n)
+{
+    XHAL_UNUSED(des);
+    XHAL_UNUSED(src);
+    XHAL_UNUSED(n);
+
+    return XHAL_ERR_NOT_SUPPORT;
+}
+
+/**
+ * @brief  内存填充加速器钩子(如 DMA), 由用户重新实现
+ * @note   须同步完成; 返回非 XHAL_OK 时退回 CPU 填充
+ */
+XHAL_WEAK xhal_err_t xmem_accel_set(void *s, uint8_t c, uint32_t n)
+{
+    XHAL_UNUSED(s);
+    XHAL_UNUSED(c);
+    XHAL_UNUSED(n);
+
+    return XHAL_ERR_NOT_SUPPORT;
+}
+#endif
+
+/**
+ * @brief  正向拷贝, 要求目的地址不高于源地址或两者不重叠
+ */
+static void _xmem_copy_fwd(uint8_t *d, const uint8_t *s, uint32_t n)
+{
+    if (n < XMEM_SMALL_SIZE)
+    {
+        while (n--)
+            *d++ = *s++;
+        return;
+    }
+
+    /* 对齐目的地址 */
+    while ((xhal_pointer_t)d & XMEM_WMASK)
+    {
+        *d++ = *s++;
+        n--;
+    }
+
+    xmem_word_t *wd = (xmem_word_t *)d;
+    uint32_t off    = (uint32_t)((xhal_pointer_t)s & XMEM_WMASK);
+
+    if (off == 0)
+    {
+        const xmem_word_t *ws = (const xmem_word_t *)s;
+
+        for (; n >= XMEM_BLOCK_SIZE; n -= XMEM_BLOCK_SIZE)
+        {
+            xmem_word_t w0 = ws[0], w1 = ws[1], w2 = ws[2], w3 = ws[3];
+            wd[0] = w0;
+            wd[1] = w1;
+            wd[2] = w2;
+            wd[3] = w3;
+            wd += 4;
+            ws += 4;
+        }
+        for (; n >= XMEM_WSIZE; n -= XMEM_WSIZE)
+            *wd++ = *ws++;
+
+        s = (const uint8_t *)ws;
+    }
+    else
+    {
+        /* 源地址错位: 读取对齐整字, 相邻两字移位拼接 */
+        const xmem_word_t *ws = (const xmem_word_t *)(s - off);
+        uint32_t shl          = off * 8;
+        uint32_t shr          = XMEM_WSIZE * 8 - shl;
+        xmem_word_t lo        = *ws++;
+
+        for (; n >= XMEM_WSIZE; n -= XMEM_WSIZE)
+        {
+            xmem_word_t hi = *ws++;
+            *wd++          = XMEM_MERGE(lo, hi, shl, shr);
+            lo             = hi;
+        }
+
+        s = (const uint8_t *)ws - XMEM_WSIZE + off;
+    }
+
+    d = (uint8_t *)wd;
+    while (n--)
+        *d++ = *s++;
+}
+
+/**
+ * @brief  反向拷贝, 用于目的地址高于源地址且重叠的情况
+ */
+static void _xmem_copy_bwd(uint8_t *d, const uint8_t *s, uint32_t n)
+{
+    d += n;
+    s += n;
+
+    /* 两端可同时对齐且距离不小于一个字时按字反向拷贝 */
+    if (n >= XMEM_SMALL_SIZE &&
+        (((xhal_pointer_t)d ^ (xhal_pointer_t)s) & XMEM_WMASK) == 0 &&
+        (xhal_pointer_t)(d - s) >= XMEM_WSIZE)
+    {
+        while ((xhal_pointer_t)d & XMEM_WMASK)
+        {
+            *--d = *--s;
+            n--;
+        }
+
+        xmem_word_t *wd       = (xmem_word_t *)d;
+        const xmem_word_t *ws = (const xmem_word_t *)s;
+        for (; n >= XMEM_WSIZE; n -= XMEM_WSIZE)
+            *--wd = *--ws;
+
+        d = (uint8_t *)wd;
+        s = (const uint8_t *)ws;
+    }
+
+    while (n--)
+        *--d = *--s;
+}
+
+/**
+ * @brief  复制内存, 源与目的区域不得重叠
+ * @param  *des : 目的地址
+ * @param  *src : 源地址
+ * @param  n    : 需要复制的内存长度(字节为单位)
+ * @retval 无
+ */
+void xmemcpy(void *des, const void *src, uint32_t n)
+{
+    xassert_not_null(des);
+    xassert_not_null(src);
+
+#if XMEM_ACCEL_THRESHOLD > 0
+    if (n >= XMEM_ACCEL_THRESHOLD && xmem_accel_copy(des, src, n) == XHAL_OK)
+        return;
+#endif
+
+    _xmem_copy_fwd((uint8_t *)des, (const uint8_t *)src, n);
+}
+
+/**
+ * @brief  复制内存, 允许源与目的区域重叠
+ * @param  *des : 目的地址
+ * @param  *src : 源地址
+ * @param  n    : 需要复制的内存长度(字节为单位)
+ * @retval 无
+ */
+void xmemmove(void *des, const void *src, uint32_t n)
+{
+    xassert_not_null(des);
+    xassert_not_null(src);
+
+    uint8_t *d       = (uint8_t *)des;
+    const uint8_t *s = (const uint8_t *)src;
+
+    if (d == s || n == 0)
+        return;
+
+    if (d + n <= s || s + n <= d)
+    {
+        xmemcpy(des, src, n); /* 不重叠 */
+    }
+    else if (d < s)
+    {
+        /* 正向拷贝先读后写, 距离不足一个展开块时逐字节进行 */
+        if ((xhal_pointer_t)(s - d) >= XMEM_BLOCK_SIZE)
+        {
+            _xmem_copy_fwd(d, s, n);
+        }
+        else
+        {
+            while (n--)
+                *d++ = *s++;
+        }
+    }
+    else
+    {
+        _xmem_copy_bwd(d, s, n);
+    }
+}
+
+/**
+ * @brief  设置内存值
+ * @param  *s    : 内存首地址
+ * @param  c: 要设置的值
+ * @param  count : 需要设置的内存大小(字节为单位)
+ * @retval 无
+ */
+void xmemset(void *s, uint8_t c, uint32_t count)
+{
+    xassert_not_null(s);
+
+#if XMEM_ACCEL_THRESHOLD > 0
+    if (count >= XMEM_ACCEL_THRESHOLD && xmem_accel_set(s, c, count) == XHAL_OK)
+        return;
+#endif
+
+    uint8_t *xs = s;
+
+    if (count >= XMEM_SMALL_SIZE)
+    {
+        while ((xhal_pointer_t)xs & XMEM_WMASK)
+        {
+            *xs++ = c;
+            count--;
+        }
+
+        /* 将字节复制到整字的每个字节 */
+        xmem_word_t w   = ((xmem_word_t)-1 / 0xFF) * c;
+        xmem_word_t *ws = (xmem_word_t *)xs;
+
+        for (; count >= XMEM_BLOCK_SIZE; count -= XMEM_BLOCK_SIZE)
+        {
+            ws[0] = w;
+            ws[1] = w;
+            ws[2] = w;
+            ws[3] = w;
+            ws += 4;
+        }
+        for (; count >= XMEM_WSIZE; count -= XMEM_WSIZE)
+            *ws++ = w;
+
+        xs = (uint8_t *)ws;
+    }
+
+    while (count--)
+        *xs++ = c;
+}
+
+#if XMALLOC_USE_TLSF == 0
+
+/**
+ * @brief  在区域起始处划出分块映射表(需在临界区内调用)
+ * @param  pool : 内存区域
+ * @param  base : 区域起始地址
+ * @param  size : 区域大小(字节)
+ * @retval 无
+ */
+static void _xmem_setup(xmem_pool_t *pool, uint8_t *base, uint32_t size)
+{
+    /* 每个分块需要 XMALLOC_BLOCK_SIZE 字节数据和一个映射表项 */
+    uint32_t nblocks =
+        size / (XMALLOC_BLOCK_SIZE + (uint32_t)sizeof(uint16_t));
+    uint8_t *end     = base + size;
+    uint8_t *membase = (uint8_t *)XHAL_CEIL(
+        (xhal_pointer_t)(base + nblocks * sizeof(uint16_t)),
+        XMALLOC_BLOCK_SIZE);
+
+    /* 映射表之后按块大小对齐, 放不下时逐块缩减 */
+    while (nblocks > 0 && membase + nblocks * XMALLOC_BLOCK_SIZE > end)
+    {
+        nblocks--;
+        membase = (uint8_t *)XHAL_CEIL(
+            (xhal_pointer_t)(base + nblocks * sizeof(uint16_t)),
+            XMALLOC_BLOCK_SIZE);
+    }
+
+    nblocks = XHAL_MIN(nblocks, (uint32_t)UINT16_MAX);
+
+    pool->ctrl    = base;
+    pool->membase = membase;
+    pool->memsize = nblocks * XMALLOC_BLOCK_SIZE;
+    pool->memrdy  = 0;
+}
+
+/**
+ * @brief  初始化分块映射表(需在临界区内调用)
+ * @param  pool : 内存区域
+ * @retval 无
+ */
+static void _xmem_init(xmem_pool_t *pool)
+{
+    uint8_t mttsize  = sizeof(uint16_t); /* 获取memmap数组的类型长度*/
+    uint32_t nblocks = pool->memsize / XMALLOC_BLOCK_SIZE;
+
+    xmemset(pool->ctrl, 0, nblocks * mttsize); /* 内存状态表数据清零 */
+    pool->free_size     = nblocks * XMALLOC_BLOCK_SIZE;
+    pool->free_min      = pool->free_size;
+    pool->largest_free  = pool->free_size;
+    pool->largest_count = pool->free_size ? 1 : 0;
+    pool->largest_dirty = 0;
+    pool->memrdy        = 1; /* 内存管理初始化OK */
+}
+
+/**
+ * @brief  获取包含某空闲块的连续空闲段长度(需在临界区内调用)
+ * @param  memmap  : 分块映射表
+ * @param  nblocks : 分块总数
+ * @param  index   : 空闲块号
+ * @retval 连续空闲块数, 耗时与该段长度成正比
+ */
+static uint32_t _xmem_run_len(const uint16_t *memmap, uint32_t nblocks,
+                              uint32_t index)
+{
+    uint32_t lo = index, hi = index + 1;
+
+    while (lo > 0 && !memmap[lo - 1])
+        lo--;
+    while (hi < nblocks && !memmap[hi])
+        hi++;
+
+    return hi - lo;
+}
+
+/**
+ * @brief  即将占用某空闲段的开头部分时更新最大空闲段(需在临界区内调用)
+ * @note   被切分的是最大段之一时计数减一, 剩余部分必然更短; 切分的是唯一
+ *         的最大段时, 次大段长度未知, 只能标记失效
+ * @param  pool    : 内存区域
+ * @param  memmap  : 分块映射表
+ * @param  nblocks : 分块总数
+ * @param  index   : 将被占用的首个空闲块号
+ * @retval 无
+ */
+static void _xmem_largest_split(xmem_pool_t *pool, const uint16_t *memmap,
+                                uint32_t nblocks, uint32_t index)
+{
+    if (pool->largest_dirty ||
+        _xmem_run_len(memmap, nblocks, index) * XMALLOC_BLOCK_SIZE <
+            pool->largest_free)
+        return;
+
+    if (pool->largest_count > 1)
+        pool->largest_count--;
+    else
+        pool->largest_dirty = 1;
+}
+
+/**
+ * @brief  归还分块并与相邻空闲段合并后更新最大空闲段(需在临界区内调用)
+ * @note   合并只会让所在段变长, 其它段不变
+ * @param  pool    : 内存区域
+ * @param  memmap  : 分块映射表
+ * @param  nblocks : 分块总数
+ * @param  index   : 已归还的空闲块号
+ * @retval 无
+ */
+static void _xmem_largest_merge(xmem_pool_t *pool, const uint16_t *memmap,
+                                uint32_t nblocks, uint32_t index)
+{
+    if (pool->largest_dirty)
+        return;
+
+    uint32_t run = _xmem_run_len(memmap, nblocks, index) * XMALLOC_BLOCK_SIZE;
+
+    if (run > pool->largest_free)
+    {
+        pool->largest_free  = run;
+        pool->largest_count = 1;
+    }
+    else if (run == pool->largest_free)
+    {
+        pool->largest_count++;
+    }
+}
+
+/**
+ * @brief  获取区域最大连续空闲字节数(需在临界区内调用)
+ * @note   分配、释放与原地调整时增量更新, 只有切分了唯一的最大空闲段才使其
+ *         失效; 失效后的首次查询重扫映射表, 耗时 O(分块数), 与一次分配的
+ *         最坏扫描相当
+ */
+static uint32_t _xmem_largest_free(xmem_pool_t *pool)
+{
+    const uint16_t *memmap = (const uint16_t *)pool->ctrl;
+    uint32_t nblocks       = pool->memsize / XMALLOC_BLOCK_SIZE;
+    uint32_t cmemb = 0, largest = 0, count = 0;
+
+    if (!pool->largest_dirty)
+        return pool->largest_free;
+
+    for (uint32_t i = 0; i < nblocks; i++)
+    {
+        cmemb = memmap[i] ? 0 : cmemb + 1;
+        if (cmemb > largest)
+        {
+            largest = cmemb;
+            count   = 0;
+        }
+        /* 在段的末块计数, 段内每块只计一次 */
+        if (cmemb == largest && cmemb > 0 &&
+            (i + 1 == nblocks || memmap[i + 1]))
+            count++;
+    }
+
+    pool->largest_free  = largest * XMALLOC_BLOCK_SIZE;
+    pool->largest_count = (uint16_t)count;
+    pool->largest_dirty = 0;
+
+    return pool->largest_free;
+}
+
+/**
+ * @brief  内存分配(内部调用)
+ * @param  pool  : 所属内存区域
+ * @param  size  : 要分配的内存大小(字节)
+ * @param  align : 首地址对齐要求(字节)
+ * @retval 内存偏移地址
+ *   @arg  0 ~ 0XFFFFFFFE : 有效的内存偏移地址
+ *   @arg  0XFFFFFFFF: 无效的内存偏移地址
+ */
+static uint32_t my_mem_malloc(xmem_pool_t *pool, uint32_t size, uint32_t align)
+{
+    uint16_t *memmap   = (uint16_t *)pool->ctrl;
+    uint32_t nblocks   = pool->memsize / XMALLOC_BLOCK_SIZE;
+    signed long offset = 0;
+    uint32_t nmemb;     /* 需要的内存块数 */
+    uint32_t cmemb = 0; /* 连续空内存块数 */
+    uint32_t i;
+
+    if (size == 0)
+    {
+        return 0xFFFFFFFF; /* 不需要分配 */
+    }
+
+    nmemb = size / XMALLOC_BLOCK_SIZE; /* 获取需要分配的连续内存块数 */
+    if (size % XMALLOC_BLOCK_SIZE)
+        nmemb++;
+
+    if (nmemb > UINT16_MAX || nmemb * XMALLOC_BLOCK_SIZE > pool->free_size)
+        return 0xFFFFFFFF;
+
+    for (offset = nblocks - 1; offset >= 0; offset--) /* 搜索整个内存控制区 */
+    {
+        if (!memmap[offset])
+            cmemb++; /* 连续空内存块数增加 */
+        else
+            cmemb = 0; /* 连续内存块清零 */
+
+        /* 从 offset 开始已有足够的连续空块, 且首地址满足对齐 */
+        uint8_t *addr = pool->membase + offset * XMALLOC_BLOCK_SIZE;
+        if (cmemb >= nmemb && (xhal_pointer_t)addr % align == 0)
+        {
+            _xmem_largest_split(pool, memmap, nblocks, offset);
+
+            for (i = 0; i < nmemb; i++) /* 标注内存块非空 */
+                memmap[offset + i] = nmemb;
+
+            pool->free_size -= nmemb * XMALLOC_BLOCK_SIZE;
+            return (offset * XMALLOC_BLOCK_SIZE); /* 返回偏移地址 */
+        }
+    }
+
+    return 0xFFFFFFFF; /* 未找到符合分配条件的内存块 */
+}
+
+/**
+ * @brief  释放内存(内部调用)
+ * @param  pool   : 所属内存区域
+ * @param  offset : 内存地址偏移
+ * @retval 释放结果
+ *   @arg  0, 释放成功;
+ *   @arg  1, 释放失败;
+ *   @arg  2, 超区域了(失败);
+ */
+static uint8_t my_mem_free(xmem_pool_t *pool, uint32_t offset)
+{
+    uint16_t *memmap = (uint16_t *)pool->ctrl;
+
+    if (!pool->memrdy) /* 未初始化 */
+    {
+        return 1;
+    } /* 未初始化 */
+
+    if (offset < pool->memsize) /* 偏移在内存池内. */
+    {
+        int index = offset / XMALLOC_BLOCK_SIZE; /* 偏移所在内存块号码 */
+        int nmemb = memmap[index];               /* 内存块数量 */
+
+        for (int i = 0; i < nmemb; i++) /* 内存块清零 */
+            memmap[index + i] = 0;
+
+        pool->free_size += nmemb * XMALLOC_BLOCK_SIZE;
+
+        if (nmemb > 0)
+            _xmem_largest_merge(pool, memmap,
+                                pool->memsize / XMALLOC_BLOCK_SIZE, index);
+        return 0;
+    }
+    return 2; /* 偏移超区了. */
+}
+
+/**
+ * @brief  后端分配接口(需在临界区内调用)
+ * @param  pool  : 所属内存区域
+ * @param  size  : 要分配的内存大小(字节)
+ * @param  align : 首地址对齐要求(字节, 2 的幂)
+ * @retval 内存首地址, 失败返回 NULL
+ */
+static void *_xmem_alloc(xmem_pool_t *pool, uint32_t size, uint32_t align)
+{
+    uint32_t offset = my_mem_malloc(pool, size, align);
+
+    if (offset == 0xFFFFFFFF)
+        return NULL;
+
+    return (void *)(pool->membase + offset);
+}
+
+/**
+ * @brief  后端释放接口(需在临界区内调用)
+ * @param  pool : 所属内存区域
+ * @param  ptr  : 内存首地址
+ * @retval 无
+ */
+static void _xmem_release(xmem_pool_t *pool, void *ptr)
+{
+    my_mem_free(pool, (xhal_pointer_t)ptr - (xhal_pointer_t)pool->membase);
+}
+
+/**
+ * @brief  获取已分配内存的可用字节数(需在临界区内调用)
+ * @param  pool : 所属内存区域
+ * @param  ptr  : 内存首地址
+ * @retval 可用字节数
+ */
+static uint32_t _xmem_usable_size(xmem_pool_t *pool, const void *ptr)
+{
+    const uint16_t *memmap = (const uint16_t *)pool->ctrl;
+    uint32_t index =
+        ((xhal_pointer_t)ptr - (xhal_pointer_t)pool->membase) /
+        XMALLOC_BLOCK_SIZE;
+
+    return memmap[index] * XMALLOC_BLOCK_SIZE;
+}
+
+/**
+ * @brief  原地调整已分配内存大小(需在临界区内调用)
+ * @note   缩小时释放尾部分块; 扩大时要求紧随其后的分块均空闲
+ * @param  pool : 所属内存区域
+ * @param  ptr  : 内存首地址
+ * @param  size : 新大小(字节)
+ * @retval 1 原地调整成功, 0 需要重新分配
+ */
+static uint8_t _xmem_resize(xmem_pool_t *pool, void *ptr, uint32_t size)
+{
+    uint16_t *memmap = (uint16_t *)pool->ctrl;
+    uint32_t nblocks = pool->memsize / XMALLOC_BLOCK_SIZE;
+    uint32_t index =
+        ((xhal_pointer_t)ptr - (xhal_pointer_t)pool->membase) /
+        XMALLOC_BLOCK_SIZE;
+    uint32_t omemb = memmap[index];
+    uint32_t nmemb = XHAL_CEIL(size, XMALLOC_BLOCK_SIZE) / XMALLOC_BLOCK_SIZE;
+    uint32_t i;
+
+    if (nmemb == omemb)
+        return 1;
+
+    if (nmemb > UINT16_MAX || index + nmemb > nblocks)
+        return 0;
+
+    /* 扩大: 新增部分必须全部空闲 */
+    for (i = omemb; i < nmemb; i++)
+    {
+        if (memmap[index + i])
+            return 0;
+    }
+
+    if (nmemb > omemb)
+        _xmem_largest_split(pool, memmap, nblocks, index + omemb);
+
+    for (i = 0; i < nmemb; i++)
+        memmap[index + i] = nmemb;
+    for (; i < omemb; i++) /* 缩小: 归还尾部分块 */
+        memmap[index + i] = 0;
+
+    if (nmemb < omemb)
+        _xmem_largest_merge(pool, memmap, nblocks, index + nmemb);
+
+    pool->free_size += omemb * XMALLOC_BLOCK_SIZE;
+    pool->free_size -= nmemb * XMALLOC_BLOCK_SIZE;
+    return 1;
+}
+
+#else /* XMALLOC_USE_TLSF == 0 */
+
+static inline uint32_t _tlsf_block_size(const xmem_tlsf_block_t *block)
+{
+    return block->size & ~TLSF_BLOCK_FLAGS;
+}
+
+static inline void _tlsf_block_set_size(xmem_tlsf_block_t *block, uint32_t size)
+{
+    block->size = size | (block->size & TLSF_BLOCK_FLAGS);
+}
+
+static inline bool _tlsf_block_is_last(const xmem_tlsf_block_t *block)
+{
+    return _tlsf_block_size(block) == 0;
+}
+
+static inline bool _tlsf_block_is_free(const xmem_tlsf_block_t *block)
+{
+    return XHAL_BOOL(block->size & TLSF_BLOCK_FREE);
+}
+
+static inline void _tlsf_block_set_free(xmem_tlsf_block_t *block)
+{
+    block->size |= TLSF_BLOCK_FREE;
+}
+
+static inline void _tlsf_block_set_used(xmem_tlsf_block_t *block)
+{
+    block->size &= ~TLSF_BLOCK_FREE;
+}
+
+static inline bool _tlsf_block_is_prev_free(const xmem_tlsf_block_t *block)
+{
+    return XHAL_BOOL(block->size & TLSF_BLOCK_PREV_FREE);
+}
+
+static inline void _tlsf_block_set_prev_free(xmem_tlsf_block_t *block)
+{
+    block->size |= TLSF_BLOCK_PREV_FREE;
+}
+
+static inline void _tlsf_block_set_prev_used(xmem_tlsf_block_t *block)
+{
+    block->size &= ~TLSF_BLOCK_PREV_FREE;
+}
+
+static inline void *_tlsf_block_to_ptr(const xmem_tlsf_block_t *block)
+{
+    return (uint8_t *)block + TLSF_BLOCK_HEADER;
+}
+
+static inline xmem_tlsf_block_t *_tlsf_block_from_ptr(const void *ptr)
+{
+    return (xmem_tlsf_block_t *)((uint8_t *)ptr - TLSF_BLOCK_HEADER);
+}
+
+static inline xmem_tlsf_block_t *
+_tlsf_block_next(const xmem_tlsf_block_t *block)
+{
+    return (xmem_tlsf_block_t *)((uint8_t *)_tlsf_block_to_ptr(block) +
+                                 _tlsf_block_size(block));
+}
+
+static inline xmem_tlsf_block_t *_tlsf_block_link_next(xmem_tlsf_block_t *block)
+{
+    xmem_tlsf_block_t *next = _tlsf_block_next(block);
+    next->prev_phys         = block;
+    return next;
+}
+
+static inline void _tlsf_block_mark_as_free(xmem_tlsf_block_t *block)
+{
+    xmem_tlsf_block_t *next = _tlsf_block_link_next(block);
+    _tlsf_block_set_prev_free(next);
+    _tlsf_block_set_free(block);
+}
+
+static inline void _tlsf_block_mark_as_used(xmem_tlsf_block_t *block)
+{
+    xmem_tlsf_block_t *next = _tlsf_block_next(block);
+    _tlsf_block_set_prev_used(next);
+    _tlsf_block_set_used(block);
+}
+
+/**
+ * @brief  计算大小对应的一级/二级索引(向下取整, 用于插入空闲块)
+ */
+static void _tlsf_mapping_insert(uint32_t size, int *fli, int *sli)
+{
+    int fl, sl;
+
+    if (size < TLSF_SMALL_BLOCK_SIZE)
+    {
+        /* 小块统一放入一级索引 0, 线性划分 */
+        fl = 0;
+        sl = (int)(size / (TLSF_SMALL_BLOCK_SIZE / TLSF_SL_INDEX_COUNT));
+    }
+    else
+    {
+        fl = BIT_FLS(size);
+        sl = (int)(size >> (fl - TLSF_SL_INDEX_COUNT_LOG2)) ^
+             (int)TLSF_SL_INDEX_COUNT;
+        fl -= (TLSF_FL_INDEX_SHIFT - 1);
+    }
+
+    *fli = fl;
+    *sli = sl;
+}
+
+/**
+ * @brief  计算大小对应的一级/二级索引(向上取整, 用于查找空闲块)
+ */
+static void _tlsf_mapping_search(uint32_t size, int *fli, int *sli)
+{
+    if (size >= TLSF_SMALL_BLOCK_SIZE)
+    {
+        size += (1U << (BIT_FLS(size) - TLSF_SL_INDEX_COUNT_LOG2)) - 1;
+    }
+    _tlsf_mapping_insert(size, fli, sli);
+}
+
+static xmem_tlsf_block_t *_tlsf_search_suitable_block(xmem_tlsf_t *tlsf,
+                                                       int *fli, int *sli)
+{
+    int fl = *fli;
+    int sl = *sli;
+
+    if (fl >= (int)TLSF_FL_INDEX_COUNT)
+        return NULL;
+
+    /* 先在当前一级索引内查找不小于 sl 的二级链表 */
+    uint32_t sl_map = tlsf->sl_bitmap[fl] & (~0U << sl);
+    if (!sl_map)
+    {
+        /* 当前一级索引无可用块, 查找更大的一级索引 */
+        uint32_t fl_map =
+            (fl + 1 < 32) ? (tlsf->fl_bitmap & (~0U << (fl + 1))) : 0;
+        if (!fl_map)
+            return NULL;
+
+        fl     = BIT_FFS(fl_map);
+        *fli   = fl;
+        sl_map = tlsf->sl_bitmap[fl];
+    }
+
+    sl   = BIT_FFS(sl_map);
+    *sli = sl;
+
+    return tlsf->blocks[fl][sl];
+}
+
+static void _tlsf_remove_free_block(xmem_tlsf_t *tlsf, xmem_tlsf_block_t *block,
+                                    int fl, int sl)
+{
+    xmem_tlsf_block_t *prev = block->prev_free;
+    xmem_tlsf_block_t *next = block->next_free;
+
+    if (next)
+        next->prev_free = prev;
+    if (prev)
+        prev->next_free = next;
+
+    tlsf->free_size -= _tlsf_block_size(block);
+
+    if (tlsf->blocks[fl][sl] == block)
+    {
+        tlsf->blocks[fl][sl] = next;
+        if (next == NULL)
+        {
+            tlsf->sl_bitmap[fl] &= ~(1U << sl);
+            if (!tlsf->sl_bitmap[fl])
+                tlsf->fl_bitmap &= ~(1U << fl);
+        }
+    }
+}
+
+static void _tlsf_insert_free_block(xmem_tlsf_t *tlsf, xmem_tlsf_block_t *block,
+                                    int fl, int sl)
+{
+    xmem_tlsf_block_t *current = tlsf->blocks[fl][sl];
+
+    block->next_free = current;
+    block->prev_free = NULL;
+    if (current)
+        current->prev_free = block;
+
+    tlsf->free_size += _tlsf_block_size(block);
+
+    tlsf->blocks[fl][sl] = block;
+    tlsf->fl_bitmap |= (1U << fl);
+    tlsf->sl_bitmap[fl] |= (1U << sl);
+}
+
+static void _tlsf_block_remove(xmem_tlsf_t *tlsf, xmem_tlsf_block_t *block)
+{
+    int fl, sl;
+
+    _tlsf_mapping_insert(_tlsf_block_size(block), &fl, &sl);
+    _tlsf_remove_free_block(tlsf, block, fl, sl);
+}
+
+static void _tlsf_block_insert(xmem_tlsf_t *tlsf, xmem_tlsf_block_t *block)
+{
+    int fl, sl;
+
+    _tlsf_mapping_insert(_tlsf_block_size(block), &fl, &sl);
+    _tlsf_insert_free_block(tlsf, block, fl, sl);
+}
+
+static bool _tlsf_block_can_split(const xmem_tlsf_block_t *block, uint32_t size)
+{
+    return _tlsf_block_size(block) >=
+           TLSF_BLOCK_HEADER + TLSF_BLOCK_SIZE_MIN + size;
+}
+
+/**
+ * @brief  将块切分为 size 与剩余两部分, 返回剩余部分(已标记为空闲)
+ */
+static xmem_tlsf_block_t *_tlsf_block_split(xmem_tlsf_block_t *block,
+                                            uint32_t size)
+{
+    xmem_tlsf_block_t *remaining =
+        (xmem_tlsf_block_t *)((uint8_t *)_tlsf_block_to_ptr(block) + size);
+    uint32_t remain_size =
+        _tlsf_block_size(block) - (size + (uint32_t)TLSF_BLOCK_HEADER);
+
+    remaining->size = remain_size;
+    _tlsf_block_set_size(block, size);
+    _tlsf_block_mark_as_free(remaining);
+
+    return remaining;
+}
+
+/**
+ * @brief  将 block 并入物理上前一块 prev
+ */
+static xmem_tlsf_block_t *_tlsf_block_absorb(xmem_tlsf_block_t *prev,
+                                             xmem_tlsf_block_t *block)
+{
+    prev->size += _tlsf_block_size(block) + (uint32_t)TLSF_BLOCK_HEADER;
+    _tlsf_block_link_next(prev);
+    return prev;
+}
+
+static xmem_tlsf_block_t *_tlsf_block_merge_prev(xmem_tlsf_t *tlsf,
+                                                 xmem_tlsf_block_t *block)
+{
+    if (_tlsf_block_is_prev_free(block))
+    {
+        xmem_tlsf_block_t *prev = block->prev_phys;
+        _tlsf_block_remove(tlsf, prev);
+        block = _tlsf_block_absorb(prev, block);
+    }
+    return block;
+}
+
+static xmem_tlsf_block_t *_tlsf_block_merge_next(xmem_tlsf_t *tlsf,
+                                                 xmem_tlsf_block_t *block)
+{
+    xmem_tlsf_block_t *next = _tlsf_block_next(block);
+
+    if (_tlsf_block_is_free(next))
+    {
+        _tlsf_block_remove(tlsf, next);
+        block = _tlsf_block_absorb(block, next);
+    }
+    return block;
+}
+
+static void _tlsf_block_trim_free(xmem_tlsf_t *tlsf, xmem_tlsf_block_t *block,
+                                  uint32_t size)
+{
+    if (_tlsf_block_can_split(block, size))
+    {
+        xmem_tlsf_block_t *remaining = _tlsf_block_split(block, size);
+        _tlsf_block_link_next(block);
+        _tlsf_block_set_prev_free(remaining);
+        _tlsf_block_insert(tlsf, remaining);
+    }
+}
+
+/**
+ * @brief  切掉空闲块前部 gap 字节放回空闲链表, 返回剩余部分
+ */
+static xmem_tlsf_block_t *_tlsf_block_trim_free_leading(
+    xmem_tlsf_t *tlsf, xmem_tlsf_block_t *block, uint32_t gap)
+{
+    xmem_tlsf_block_t *remaining = block;
+
+    if (_tlsf_block_can_split(block, gap - (uint32_t)TLSF_BLOCK_HEADER))
+    {
+        remaining = _tlsf_block_split(block, gap - (uint32_t)TLSF_BLOCK_HEADER);
+        _tlsf_block_set_prev_free(remaining);
+        _tlsf_block_link_next(block);
+        _tlsf_block_insert(tlsf, block);
+    }
+
+    return remaining;
+}
+
+/**
+ * @brief  切掉已用块尾部多余部分, 与后一空闲块合并后放回空闲链表
+ */
+static void _tlsf_block_trim_used(xmem_tlsf_t *tlsf, xmem_tlsf_block_t *block,
+                                  uint32_t size)
+{
+    if (_tlsf_block_can_split(block, size))
+    {
+        xmem_tlsf_block_t *remaining = _tlsf_block_split(block, size);
+        _tlsf_block_set_prev_used(remaining);
+        remaining = _tlsf_block_merge_next(tlsf, remaining);
+        _tlsf_block_insert(tlsf, remaining);
+    }
+}
+
+/**
+ * @brief  请求大小按对齐粒度向上取整, 超出上限返回 0
+ */
+static uint32_t _tlsf_adjust_request_size(uint32_t size)
+{
+    if (size == 0 || size > TLSF_BLOCK_SIZE_MAX)
+        return 0;
+
+    uint32_t aligned = XHAL_CEIL(size, TLSF_ALIGN_SIZE);
+
+    return XHAL_MAX(aligned, (uint32_t)TLSF_BLOCK_SIZE_MIN);
+}
+
+/**
+ * @brief  在区域起始处划出 TLSF 控制结构(需在临界区内调用)
+ * @param  pool : 内存区域
+ * @param  base : 区域起始地址
+ * @param  size : 区域大小(字节)
+ * @retval 无
+ */
+static void _xmem_setup(xmem_pool_t *pool, uint8_t *base, uint32_t size)
+{
+    uint8_t *end     = base + size;
+    uint8_t *ctrl =
+        (uint8_t *)XHAL_CEIL((xhal_pointer_t)base, TLSF_ALIGN_SIZE);
+    uint8_t *membase = (uint8_t *)XHAL_CEIL(
+        (xhal_pointer_t)(ctrl + sizeof(xmem_tlsf_t)), TLSF_ALIGN_SIZE);
+    uint32_t memsize = 0;
+
+    if (membase < end)
+    {
+        memsize = (uint32_t)(end - membase);
+        memsize = XHAL_MIN(memsize, (uint32_t)TLSF_BLOCK_SIZE_MAX);
+    }
+
+    pool->ctrl    = ctrl;
+    pool->membase = membase;
+    pool->memsize = memsize;
+    pool->memrdy  = 0;
+}
+
+/**
+ * @brief  将整个区域初始化为一个空闲块(需在临界区内调用)
+ * @param  pool : 内存区域
+ * @retval 无
+ */
+static void _xmem_init(xmem_pool_t *pool)
+{
+    xmem_tlsf_t *tlsf = (xmem_tlsf_t *)pool->ctrl;
+
+    xmemset(tlsf, 0, sizeof(xmem_tlsf_t));
+    pool->free_size = 0;
+    pool->free_min  = 0;
+    pool->memrdy    = 1;
+
+    /* 末尾预留哨兵块 */
+    if (pool->memsize < TLSF_BLOCK_HEADER + sizeof(xmem_tlsf_block_t) +
+                            TLSF_BLOCK_SIZE_MIN)
+        return;
+
+    uint32_t pool_bytes =
+        XHAL_FLOOR(pool->memsize - TLSF_BLOCK_HEADER -
+                       sizeof(xmem_tlsf_block_t),
+                   TLSF_ALIGN_SIZE);
+
+    xmem_tlsf_block_t *block = (xmem_tlsf_block_t *)pool->membase;
+    block->size              = pool_bytes;
+    _tlsf_block_set_free(block);
+    _tlsf_block_set_prev_used(block);
+    _tlsf_block_insert(tlsf, block);
+
+    /* 末尾放置大小为 0 的哨兵块, 阻止向后合并越界 */
+    xmem_tlsf_block_t *next = _tlsf_block_link_next(block);
+    next->size              = 0;
+    _tlsf_block_set_used(next);
+    _tlsf_block_set_prev_free(next);
+
+    pool->free_size = tlsf->free_size;
+    pool->free_min  = pool->free_size;
+}
+
+/**
+ * @brief  获取区域最大空闲块字节数(需在临界区内调用)
+ * @note   由位图直接定位最高非空的分级链表, 只遍历该链表
+ */
+static uint32_t _xmem_largest_free(xmem_pool_t *pool)
+{
+    xmem_tlsf_t *tlsf = (xmem_tlsf_t *)pool->ctrl;
+    uint32_t largest  = 0;
+
+    if (!tlsf->fl_bitmap)
+        return 0;
+
+    int fl = BIT_FLS(tlsf->fl_bitmap);
+    int sl = BIT_FLS(tlsf->sl_bitmap[fl]);
+
+    xmem_tlsf_block_t *block = tlsf->blocks[fl][sl];
+    while (block != NULL)
+    {
+        largest = XHAL_MAX(largest, _tlsf_block_size(block));
+        block   = block->next_free;
+    }
+
+    return largest;
+}
+
+/**
+ * @brief  后端分配接口(需在临界区内调用)
+ * @param  pool  : 所属内存区域
+ * @param  size  : 要分配的内存大小(字节)
+ * @param  align : 首地址对齐要求(字节, 2 的幂)
+ * @retval 内存首地址, 失败返回 NULL
+ */
+static void *_xmem_alloc(xmem_pool_t *pool, uint32_t size, uint32_t align)
+{
+    xmem_tlsf_t *tlsf = (xmem_tlsf_t *)pool->ctrl;
+    uint32_t gap_min  = (uint32_t)(TLSF_BLOCK_HEADER + TLSF_BLOCK_SIZE_MIN);
+    uint32_t search;
+    int fl, sl;
+
+    size = _tlsf_adjust_request_size(size);
+    if (size == 0)
+        return NULL;
+
+    /* 超出自然对齐时多申请 align + gap_min, 以便切掉前部对齐间隙 */
+    search = size;
+    if (align > TLSF_ALIGN_SIZE)
+    {
+        search = _tlsf_adjust_request_size(size + align + gap_min);
+        if (search == 0)
+            return NULL;
+    }
+
+    _tlsf_mapping_search(search, &fl, &sl);
+    xmem_tlsf_block_t *block = _tlsf_search_suitable_block(tlsf, &fl, &sl);
+    if (block == NULL)
+        return NULL;
+
+    _tlsf_remove_free_block(tlsf, block, fl, sl);
+
+    if (align > TLSF_ALIGN_SIZE)
+    {
+        uint8_t *ptr     = _tlsf_block_to_ptr(block);
+        uint8_t *aligned = (uint8_t *)XHAL_CEIL((xhal_pointer_t)ptr, align);
+        uint32_t gap     = (uint32_t)(aligned - ptr);
+
+        /* 间隙不足以构成独立空闲块时, 顺延到下一个对齐点 */
+        if (gap && gap < gap_min)
+        {
+            aligned = (uint8_t *)XHAL_CEIL((xhal_pointer_t)(ptr + gap_min),
+                                           align);
+            gap     = (uint32_t)(aligned - ptr);
+        }
+
+        if (gap)
+            block = _tlsf_block_trim_free_leading(tlsf, block, gap);
+    }
+
+    _tlsf_block_trim_free(tlsf, block, size);
+    _tlsf_block_mark_as_used(block);
+
+    pool->free_size = tlsf->free_size;
+    return _tlsf_block_to_ptr(block);
+}
+
+/**
+ * @brief  后端释放接口(需在临界区内调用)
+ * @param  pool : 所属内存区域
+ * @param  ptr  : 内存首地址
+ * @retval 无
+ */
+static void _xmem_release(xmem_pool_t *pool, void *ptr)
+{
+    xmem_tlsf_t *tlsf = (xmem_tlsf_t *)pool->ctrl;
+
+    if (!pool->memrdy)
+        return;
+
+    xmem_tlsf_block_t *block = _tlsf_block_from_ptr(ptr);
+    xassert(!_tlsf_block_is_free(block));
+
+    _tlsf_block_mark_as_free(block);
+    block = _tlsf_block_merge_prev(tlsf, block);
+    block = _tlsf_block_merge_next(tlsf, block);
+    _tlsf_block_insert(tlsf, block);
+
+    pool->free_size = tlsf->free_size;
+}
+
+/**
+ * @brief  获取已分配内存的可用字节数(需在临界区内调用)
+ * @param  pool : 所属内存区域
+ * @param  ptr  : 内存首地址
+ * @retval 可用字节数
+ */
+static uint32_t _xmem_usable_size(xmem_pool_t *pool, const void *ptr)
+{
+    XHAL_UNUSED(pool);
+
+    return _tlsf_block_size(_tlsf_block_from_ptr(ptr));
+}
+
+/**
+ * @brief  原地调整已分配内存大小(需在临界区内调用)
+ * @note   缩小时尾部切回空闲链表; 扩大时吞并物理上后一个空闲块
+ * @param  pool : 所属内存区域
+ * @param  ptr  : 内存首地址
+ * @param  size : 新大小(字节)
+ * @retval 1 原地调整成功, 0 需要重新分配
+ */
+static uint8_t _xmem_resize(xmem_pool_t *pool, void *ptr, uint32_t size)
+{
+    xmem_tlsf_t *tlsf        = (xmem_tlsf_t *)pool->ctrl;
+    xmem_tlsf_block_t *block = _tlsf_block_from_ptr(ptr);
+    xmem_tlsf_block_t *next  = _tlsf_block_next(block);
+    uint32_t cur             = _tlsf_block_size(block);
+
+    size = _tlsf_adjust_request_size(size);
+    if (size == 0)
+        return 0;
+
+    if (size > cur)
+    {
+        if (!_tlsf_block_is_free(next) ||
+            size > cur + _tlsf_block_size(next) + (uint32_t)TLSF_BLOCK_HEADER)
+            return 0;
+
+        _tlsf_block_merge_next(tlsf, block);
+        _tlsf_block_mark_as_used(block);
+    }
+
+    _tlsf_block_trim_used(tlsf, block, size);
+
+    pool->free_size = tlsf->free_size;
+    return 1;
+}
+
+#endif /* XMALLOC_USE_TLSF == 0 */
+
+/**
+ * @brief  查找指针所属的内存区域
+ * @param  ptr : 内存首地址
+ * @retval 内存区域, 不属于任何区域返回 NULL
+ */
+static xmem_pool_t *_xmem_region_of(const void *ptr)
+{
+    const uint8_t *p = (const uint8_t *)ptr;
+
+    for (uint8_t i = 0; i < xmem_region_num; i++)
+    {
+        xmem_pool_t *pool = &xmem_regions[i];
+        if (p >= pool->membase && p < pool->membase + pool->memsize)
+            return pool;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief  注册一块额外的内存区域
+ * @param  name : 区域名称
+ * @param  base : 区域起始地址
+ * @param  size : 区域大小(字节), 管理结构从区域内部划出
+ * @param  caps : 区域属性, XMEM_CAP_xxx 组合
+ * @retval XHAL_OK 成功, 否则返回错误码
+ */
+xhal_err_t xmem_region_add(const char *name, void *base, uint32_t size,
+                           uint32_t caps)
+{
+    xhal_err_t ret = XHAL_OK;
+
+    xassert_not_null(base);
+
+    if (size == 0 || caps == 0)
+        return XHAL_ERR_INVALID;
+
+    XMALLOC_ENTER_CRITICAL(); /* 进入临界区 */
+    if (xmem_region_num >= XMALLOC_REGION_NUM_MAX)
+    {
+        ret = XHAL_ERR_FULL;
+    }
+    else
+    {
+        const uint8_t *start = (const uint8_t *)base;
+        for (uint8_t i = 0; i < xmem_region_num; i++)
+        {
+            const xmem_pool_t *pool = &xmem_regions[i];
+            if (start < pool->membase + pool->memsize &&
+                pool->membase < start + size)
+            {
+                ret = XHAL_ERR_MEM_OVERLAY;
+                break;
+            }
+        }
+    }
+
+    if (ret == XHAL_OK)
+    {
+        xmem_pool_t *pool = &xmem_regions[xmem_region_num];
+
+        _xmem_setup(pool, (uint8_t *)base, size);
+        if (pool->memsize == 0)
+        {
+            ret = XHAL_ERR_NOT_ENOUGH;
+        }
+        else
+        {
+            pool->name = name;
+            pool->caps = caps;
+            _xmem_init(pool);
+            xmem_region_num++;
+        }
+    }
+    XMALLOC_EXIT_CRITICAL(); /* 离开临界区 */
+
+#ifdef XDEBUG
+    if (ret != XHAL_OK)
+        XLOG_PRINT_ERR("xmem_region_add", ret);
+#endif
+
+    return ret;
+}
+
+/**
+ * @brief  获取已注册的内存区域数量
+ */
+uint8_t xmem_region_count(void)
+{
+    return xmem_region_num;
+}
+
+/**
+ * @brief  累加单个区域的统计快照(需在临界区内调用)
+ * @retval 该区域最大空闲块字节数
+ */
+static uint32_t _xmem_stats_add(xmem_pool_t *pool, xmem_stats_t *stats)
+{
+    if (!pool->memrdy)
+        _xmem_init(pool);
+
+    uint32_t largest = _xmem_largest_free(pool);
+
+    stats->total_size += pool->memsize;
+    stats->free_size += pool->free_size;
+    stats->free_min += pool->free_min;
+    stats->largest_free = XHAL_MAX(stats->largest_free, largest);
+    stats->used_blocks += pool->used_blocks;
+    stats->alloc_count += pool->alloc_count;
+    stats->free_count += pool->free_count;
+    stats->fail_count += pool->fail_count;
+
+    return largest;
+}
+
+/**
+ * @brief  由累加结果计算使用率与碎片率
+ * @param  stats       : 统计快照
+ * @param  largest_sum : 各区域最大空闲块之和
+ */
+static void _xmem_stats_finish(xmem_stats_t *stats, uint32_t largest_sum)
+{
+    stats->perused = 0;
+    stats->frag    = 0;
+
+    if (stats->total_size != 0)
+    {
+        stats->perused = (uint16_t)((uint64_t)(stats->total_size -
+                                               stats->free_size) *
+                                    1000 / stats->total_size);
+    }
+
+    /* 碎片率 = 1 - 最大空闲块 / 总空闲, 每个区域的空闲内存都连续时为 0 */
+    if (stats->free_size != 0)
+    {
+        stats->frag = (uint16_t)(1000 - (uint64_t)largest_sum * 1000 /
+                                            stats->free_size);
+    }
+}
+
+/**
+ * @brief  获取单个内存区域的信息与统计
+ * @param  index : 区域下标, 0 为内部 RAM
+ * @param  info  : 输出信息
+ * @retval XHAL_OK 成功, 下标越界返回 XHAL_ERR_INVALID
+ */
+xhal_err_t xmem_region_get_info(uint8_t index, xmem_region_info_t *info)
+{
+    xmem_stats_t stats;
+
+    xassert_not_null(info);
+
+    xhal_err_t ret;
+    XHAL_TRY(ret, xmem_region_get_stats(index, &stats));
+
+    info->name       = xmem_regions[index].name;
+    info->base       = xmem_regions[index].membase;
+    info->caps       = xmem_regions[index].caps;
+    info->total_size = stats.total_size;
+    info->free_size  = stats.free_size;
+    info->perused    = stats.perused;
+
+    return XHAL_OK;
+}
+
+/**
+ * @brief  获取单个内存区域的统计快照
+ * @note   耗时同 xmem_get_stats, 分块映射表后端最坏为 O(分块数)
+ * @param  index : 区域下标, 0 为内部 RAM
+ * @param  stats : 输出统计
+ * @retval XHAL_OK 成功, 下标越界返回 XHAL_ERR_INVALID
+ */
+xhal_err_t xmem_region_get_stats(uint8_t index, xmem_stats_t *stats)
+{
+    xassert_not_null(stats);
+
+    if (index >= xmem_region_num)
+        return XHAL_ERR_INVALID;
+
+    xmemset(stats, 0, sizeof(xmem_stats_t));
+
+    XMALLOC_ENTER_CRITICAL(); /* 进入临界区 */
+    uint32_t largest = _xmem_stats_add(&xmem_regions[index], stats);
+    XMALLOC_EXIT_CRITICAL(); /* 离开临界区 */
+
+    _xmem_stats_finish(stats, largest);
+
+    return XHAL_OK;
+}
+
+/**
+ * @brief  获取通用内存(XMEM_CAP_DEFAULT 区域)的统计快照
+ * @note   计数类统计为 O(1); 分块映射表后端在唯一的最大空闲段被切分后,
+ *         下次查询需重扫映射表求 largest_free/frag, 为 O(分块数), 在临界区内
+ *         完成. TLSF 后端只遍历最高一级链表
+ * @param  stats : 输出统计, largest_free 为各区域最大空闲块的最大值,
+ *                 free_min 为各区域历史最小值之和,
+ *                 fail_count 为所有区域都无法满足的分配次数
+ * @retval 无
+ */
+void xmem_get_stats(xmem_stats_t *stats)
+{
+    uint32_t largest_sum = 0;
+
+    xassert_not_null(stats);
+
+    xmemset(stats, 0, sizeof(xmem_stats_t));
+
+    XMALLOC_ENTER_CRITICAL(); /* 进入临界区 */
+    for (uint8_t i = 0; i < xmem_region_num; i++)
+    {
+        if (xmem_regions[i].caps & XMEM_CAP_DEFAULT)
+            largest_sum += _xmem_stats_add(&xmem_regions[i], stats);
+    }
+    stats->fail_count = xmem_fail_count;
+    XMALLOC_EXIT_CRITICAL(); /* 离开临界区 */
+
+    _xmem_stats_finish(stats, largest_sum);
+}
+
+/**
+ * @brief  获取通用内存(XMEM_CAP_DEFAULT 区域)的空闲字节数
+ */
+uint32_t xmem_free_size(void)
+{
+    uint32_t free_size = 0;
+
+    XMALLOC_ENTER_CRITICAL(); /* 进入临界区 */
+    for (uint8_t i = 0; i < xmem_region_num; i++)
+    {
+        xmem_pool_t *pool = &xmem_regions[i];
+
+        if (!(pool->caps & XMEM_CAP_DEFAULT))
+            continue;
+
+        if (!pool->memrdy)
+            _xmem_init(pool);
+        free_size += pool->free_size;
+    }
+    XMALLOC_EXIT_CRITICAL(); /* 离开临界区 */
+
+    return free_size;
+}
+
+/**
+ * @brief  获取通用内存(XMEM_CAP_DEFAULT 区域)使用率
+ * @retval 使用率(扩大了10倍,0~1000,代表0.0%~100.0%)
+ */
+uint16_t xmem_perused(void)
+{
+    uint32_t perused = 0, used = 0, total = 0;
+
+    for (uint8_t i = 0; i < xmem_region_num; i++)
+    {
+        if (xmem_regions[i].caps & XMEM_CAP_DEFAULT)
+            total += xmem_regions[i].memsize;
+    }
+    if (total == 0)
+        return 0;
+
+    used    = total - xmem_free_size();
+    perused = (uint32_t)((uint64_t)used * 1000 / total);
+
+    return perused; // 放大10倍，0~1000
+}
+
+#if XMALLOC_TRACE_ENABLE
+
+#if (XMALLOC_TRACE_RECORD_NUM & (XMALLOC_TRACE_RECORD_NUM - 1)) != 0
+#error "XMALLOC_TRACE_RECORD_NUM must be a power of 2"
+#endif
+
+#if (XMALLOC_TRACE_TAG_NUM < 2) || (XMALLOC_TRACE_TAG_NUM > 255)
+#error "XMALLOC_TRACE_TAG_NUM must be in [2, 255]"
+#endif
+
+#define XMEM_TRACE_MASK  (XMALLOC_TRACE_RECORD_NUM - 1)
+#define XMEM_TRACE_OTHER (0) /* 标签表满后新标签统一归入 0 号 */
+
+typedef struct xmem_trace_slot
+{
+    void *ptr; /* NULL 表示空槽 */
+    uint32_t size;
+    uint32_t line;
+    uint32_t time;
+    uint32_t seq;
+    uint8_t tag;
+} xmem_trace_slot_t;
+
+/* 以地址为键的开放定址哈希表, 线性探测, 删除时后移补位 */
+static xmem_trace_slot_t xmem_trace_slots[XMALLOC_TRACE_RECORD_NUM];
+static uint32_t xmem_trace_used    = 0;
+static uint32_t xmem_trace_seq     = 0;
+static uint32_t xmem_trace_lost    = 0; /* 因记录表满未能追踪的块数 */
+static xhal_tick_t xmem_trace_tick = 0; /* 统计周期起点 */
+
+static xmem_trace_tag_t xmem_trace_tags[XMALLOC_TRACE_TAG_NUM] = {
+    [XMEM_TRACE_OTHER] = {.tag = "<other>"},
+};
+static uint8_t xmem_trace_tag_num = 1;
+
+static inline uint32_t _xmem_trace_hash(const void *ptr)
+{
+    uint32_t h = (uint32_t)((xhal_pointer_t)ptr >> 2) * 0x9E3779B1U;
+
+    return (h ^ (h >> 16)) & XMEM_TRACE_MASK;
+}
+
+/**
+ * @brief  查找或登记标签(需在临界区内调用)
+ * @retval 标签序号, 标签表满时返回 XMEM_TRACE_OTHER
+ */
+static uint8_t _xmem_trace_tag_of(const char *tag)
+{
+    if (tag == NULL)
+        return XMEM_TRACE_OTHER;
+
+    for (uint8_t i = 1; i < xmem_trace_tag_num; i++)
+    {
+        const char *name = xmem_trace_tags[i].tag;
+        if (name == tag || strcmp(name, tag) == 0)
+            return i;
+    }
+
+    if (xmem_trace_tag_num >= XMALLOC_TRACE_TAG_NUM)
+        return XMEM_TRACE_OTHER;
+
+    xmem_trace_tags[xmem_trace_tag_num].tag = tag;
+    return xmem_trace_tag_num++;
+}
+
+/**
+ * @brief  记录一次分配(需在临界区内调用)
+ */
+static void _xmem_trace_add(void *ptr, uint32_t size, const char *tag,
+                            uint32_t line)
+{
+    uint8_t index         = _xmem_trace_tag_of(tag);
+    xmem_trace_tag_t *cnt = &xmem_trace_tags[index];
+
+    xmem_trace_seq++;
+    cnt->alloc_count++;
+    cnt->alloc_bytes += size;
+
+    /* 保留至少一个空槽, 保证探测能够终止 */
+    if (xmem_trace_used >= XMALLOC_TRACE_RECORD_NUM - 1)
+    {
+        xmem_trace_lost++;
+        return;
+    }
+
+    cnt->live_bytes += size;
+    cnt->live_count++;
+    if (cnt->live_bytes > cnt->peak_bytes)
+        cnt->peak_bytes = cnt->live_bytes;
+
+    uint32_t i = _xmem_trace_hash(ptr);
+    while (xmem_trace_slots[i].ptr != NULL)
+        i = (i + 1) & XMEM_TRACE_MASK;
+
+    xmem_trace_slots[i].ptr  = ptr;
+    xmem_trace_slots[i].size = size;
+    xmem_trace_slots[i].line = line;
+    xmem_trace_slots[i].time = xtime_get_tick_ms();
+    xmem_trace_slots[i].seq  = xmem_trace_seq;
+    xmem_trace_slots[i].tag  = index;
+    xmem_trace_used++;
+}
+
+/**
+ * @brief  删除一次分配的记录(需在临界区内调用), 未记录的块忽略
+ */
+static void _xmem_trace_del(const void *ptr)
+{
+    uint32_t i = _xmem_trace_hash(ptr);
+
+    while (xmem_trace_slots[i].ptr != ptr)
+    {
+        if (xmem_trace_slots[i].ptr == NULL)
+            return;
+        i = (i + 1) & XMEM_TRACE_MASK;
+    }
+
+    xmem_trace_tag_t *cnt = &xmem_trace_tags[xmem_trace_slots[i].tag];
+    cnt->live_bytes -= xmem_trace_slots[i].size;
+    cnt->live_count--;
+    xmem_trace_used--;
+
+    /* 后移补位: 把探测链上可前移的记录搬到空出的槽 */
+    uint32_t j = i;
+    for (;;)
+    {
+        j = (j + 1) & XMEM_TRACE_MASK;
+        if (xmem_trace_slots[j].ptr == NULL)
+            break;
+
+        uint32_t k = _xmem_trace_hash(xmem_trace_slots[j].ptr);
+        if ((i <= j) ? (i < k && k <= j) : (i < k || k <= j))
+            continue;
+
+        xmem_trace_slots[i] = xmem_trace_slots[j];
+        i                   = j;
+    }
+    xmem_trace_slots[i].ptr = NULL;
+}
+
+/**
+ * @brief  获取已登记的标签数
+ * @retval 标签数, 含 "<other>"
+ */
+uint8_t xmem_trace_tag_count(void)
+{
+    return xmem_trace_tag_num;
+}
+
+/**
+ * @brief  获取标签统计
+ * @param  index : 标签序号, 0 ~ xmem_trace_tag_count() - 1
+ * @param  tag   : 输出统计
+ * @retval XHAL_OK 成功, XHAL_ERR_INVALID 序号越界
+ */
+xhal_err_t xmem_trace_get_tag(uint8_t index, xmem_trace_tag_t *tag)
+{
+    xassert_not_null(tag);
 
-static XHAL_USED XHAL_ALIGN(64) uint8_t xmem_internal_ram[XMALLOC_MAX_SIZE];
-static uint16_t xmem_internal_map[XMALLOC_ALLOC_TABLE_SIZE];
+    if (index >= xmem_trace_tag_num)
+        return XHAL_ERR_INVALID;
 
-static xmem_pool_t xmem_pool = {
-    .membase = xmem_internal_ram,
-    .memmap  = xmem_internal_map,
-    .memrdy  = 0,
-};
+    XMALLOC_ENTER_CRITICAL();
+    *tag = xmem_trace_tags[index];
+    XMALLOC_EXIT_CRITICAL();
+
+    xhal_tick_t elapsed = TIME_DIFF(xtime_get_tick_ms(), xmem_trace_tick);
+    tag->rate           = elapsed == 0 ? 0
+                                       : (uint32_t)((uint64_t)tag->alloc_count *
+                                                    1000 / elapsed);
+
+    return XHAL_OK;
+}
 
 /**
- * @brief  复制内存
- * @param  *des : 目的地址
- * @param  *src : 源地址
- * @param  n    : 需要复制的内存长度(字节为单位)
- * @retval 无
+ * @brief  依次获取序号大于 since 且仍未释放的内存块记录
+ * @param  index : 遍历游标, 首次调用前置 0
+ * @param  since : xmem_trace_snapshot 返回的快照, 0 表示全部
+ * @param  rec   : 输出记录
+ * @retval XHAL_OK 获取到一条记录, XHAL_ERR_NOT_FOUND 遍历结束
  */
-void xmemcpy(void *des, const void *src, uint32_t n)
+xhal_err_t xmem_trace_get_rec(uint32_t *index, uint32_t since,
+                              xmem_trace_rec_t *rec)
 {
-    xassert_not_null(des);
-    xassert_not_null(src);
+    xhal_err_t ret = XHAL_ERR_NOT_FOUND;
 
-    uint8_t *xdes = (uint8_t *)des;
-    uint8_t *xsrc = (uint8_t *)src;
-    while (n--)
-        *xdes++ = *xsrc++;
+    xassert_not_null(index);
+    xassert_not_null(rec);
+
+    XMALLOC_ENTER_CRITICAL();
+    for (; *index < XMALLOC_TRACE_RECORD_NUM; (*index)++)
+    {
+        const xmem_trace_slot_t *slot = &xmem_trace_slots[*index];
+        if (slot->ptr == NULL || (int32_t)(slot->seq - since) <= 0)
+            continue;
+
+        rec->ptr  = slot->ptr;
+        rec->size = slot->size;
+        rec->tag  = xmem_trace_tags[slot->tag].tag;
+        rec->line = slot->line;
+        rec->time = slot->time;
+        rec->seq  = slot->seq;
+        (*index)++;
+        ret = XHAL_OK;
+        break;
+    }
+    XMALLOC_EXIT_CRITICAL();
+
+    return ret;
 }
+
 /**
- * @brief  设置内存值
- * @param  *s    : 内存首地址
- * @param  c: 要设置的值
- * @param  count : 需要设置的内存大小(字节为单位)
- * @retval 无
+ * @brief  获取当前分配序号作为快照, 之后分配且未释放的块即为泄漏候选
+ * @retval 快照
  */
-void xmemset(void *s, uint8_t c, uint32_t count)
+uint32_t xmem_trace_snapshot(void)
 {
-    xassert_not_null(s);
+    return xmem_trace_seq;
+}
 
-    uint8_t *xs = s;
-    while (count--)
-        *xs++ = c;
+/**
+ * @brief  获取因记录表满而未被追踪的内存块数
+ */
+uint32_t xmem_trace_dropped(void)
+{
+    return xmem_trace_lost;
 }
 
-uint32_t xmem_free_size(void)
+/**
+ * @brief  开始新的统计周期: 峰值回落到当前占用, 分配次数与速率清零
+ */
+void xmem_trace_reset(void)
+{
+    XMALLOC_ENTER_CRITICAL();
+    for (uint8_t i = 0; i < xmem_trace_tag_num; i++)
+    {
+        xmem_trace_tags[i].peak_bytes  = xmem_trace_tags[i].live_bytes;
+        xmem_trace_tags[i].alloc_count = 0;
+        xmem_trace_tags[i].alloc_bytes = 0;
+    }
+    xmem_trace_lost = 0;
+    xmem_trace_tick = xtime_get_tick_ms();
+    XMALLOC_EXIT_CRITICAL();
+}
+
+#endif /* XMALLOC_TRACE_ENABLE */
+
+/**
+ * @brief  将内存块归还所属区域并更新统计(需在临界区内调用)
+ * @param  ptr : 内存首地址
+ * @retval 所属区域, 不属于任何区域返回 NULL
+ */
+static xmem_pool_t *_xmem_free_block(void *ptr)
 {
-    uint32_t free_blocks = 0;
+    xmem_pool_t *pool = _xmem_region_of(ptr);
 
-    XMALLOC_ENTER_CRITICAL(); /* 进入临界区 */
-    for (uint32_t i = 0; i < XMALLOC_ALLOC_TABLE_SIZE; i++)
+    if (pool != NULL)
     {
-        if (xmem_pool.memmap[i] == 0)
-            free_blocks++;
+#if XMALLOC_TRACE_ENABLE
+        _xmem_trace_del(ptr);
+#endif
+        _xmem_release(pool, ptr); /* 释放内存 */
+        pool->used_blocks--;
+        pool->free_count++;
     }
-    XMALLOC_EXIT_CRITICAL(); /* 离开临界区 */
 
-    return (free_blocks * XMALLOC_BLOCK_SIZE);
+    return pool;
 }
 
-/**
- * @brief  获取内存使用率
- * @retval 使用率(扩大了10倍,0~1000,代表0.0%~100.0%)
+#if XMALLOC_THREAD_CACHE
+
+/* 缓存大小类的最小粒度, 取后端不再向上取整的大小 */
+#if XMALLOC_USE_TLSF == 0
+#define XMEM_CACHE_GRAIN ((uint32_t)XMALLOC_BLOCK_SIZE)
+#else
+#define XMEM_CACHE_GRAIN XHAL_MAX(16U, (uint32_t)TLSF_BLOCK_SIZE_MIN)
+#endif
+
+#define XMEM_CACHE_SIZE(cls) (XMEM_CACHE_GRAIN << (cls))
+
+/*
+ * 每个线程一份, 只被所属线程访问, 因此命中时无需加锁.
+ * 缓存中的块对堆而言仍处于已分配状态.
  */
-uint16_t xmem_perused(void)
+typedef struct xmem_cache
 {
-    uint32_t perused = 0, used = 0;
+    uint8_t count[XMALLOC_CACHE_CLASS_NUM];
+    void *slot[XMALLOC_CACHE_CLASS_NUM][XMALLOC_CACHE_DEPTH];
+} xmem_cache_t;
 
-    used    = XMALLOC_MAX_SIZE - xmem_free_size();
-    perused = (used * 1000) / XMALLOC_MAX_SIZE;
+/**
+ * @brief  将缓存中某一类的前 n 块归还给堆(需在临界区内调用)
+ */
+static void _xmem_cache_release(xmem_cache_t *cache, uint8_t cls, uint8_t n)
+{
+    for (uint8_t i = 0; i < n; i++)
+        _xmem_free_block(cache->slot[cls][i]);
 
-    return perused; // 放大10倍，0~1000
+    cache->count[cls] -= n;
+    for (uint8_t i = 0; i < cache->count[cls]; i++)
+        cache->slot[cls][i] = cache->slot[cls][i + n];
 }
 
 /**
- * @brief  内存分配(内部调用)
- * @param  memx : 所属内存块
- * @param  size : 要分配的内存大小(字节)
- * @retval 内存偏移地址
- *   @arg  0 ~ 0XFFFFFFFE : 有效的内存偏移地址
- *   @arg  0XFFFFFFFF: 无效的内存偏移地址
+ * @brief  将当前线程缓存的全部块归还给堆(需在临界区内调用)
+ * @retval 归还的块数
  */
-static uint32_t my_mem_malloc(uint32_t size)
+static uint32_t _xmem_cache_drain(xmem_cache_t *cache)
 {
-    signed long offset = 0;
-    uint32_t nmemb;     /* 需要的内存块数 */
-    uint32_t cmemb = 0; /* 连续空内存块数 */
-    uint32_t i;
+    uint32_t n = 0;
+
+    if (cache == NULL)
+        return 0;
 
-    if (!xmem_pool.memrdy) /* 未初始化,先执行初始化 */
+    for (uint8_t cls = 0; cls < XMALLOC_CACHE_CLASS_NUM; cls++)
     {
-        uint8_t mttsize = sizeof(uint16_t); /* 获取memmap数组的类型长度*/
-        xmemset(xmem_pool.memmap, 0,
-                XMALLOC_ALLOC_TABLE_SIZE * mttsize); /* 内存状态表数据清零 */
-        xmem_pool.memrdy = 1; /* 内存管理初始化OK */
+        n += cache->count[cls];
+        _xmem_cache_release(cache, cls, cache->count[cls]);
     }
 
-    if (size == 0)
+    return n;
+}
+
+/**
+ * @brief  获取能容纳 size 的最小大小类
+ * @retval 大小类, 超出缓存范围返回 -1
+ */
+static inline int8_t _xmem_cache_class(uint32_t size)
+{
+    for (uint8_t cls = 0; cls < XMALLOC_CACHE_CLASS_NUM; cls++)
     {
-        return 0xFFFFFFFF; /* 不需要分配 */
+        if (size <= XMEM_CACHE_SIZE(cls))
+            return (int8_t)cls;
     }
 
-    nmemb = size / XMALLOC_BLOCK_SIZE; /* 获取需要分配的连续内存块数 */
-    if (size % XMALLOC_BLOCK_SIZE)
-        nmemb++;
+    return -1;
+}
 
-    for (offset = XMALLOC_ALLOC_TABLE_SIZE - 1; offset >= 0;
-         offset--) /* 搜索整个内存控制区 */
-    {
-        if (!xmem_pool.memmap[offset])
-            cmemb++; /* 连续空内存块数增加 */
-        else
-            cmemb = 0; /* 连续内存块清零 */
+/**
+ * @brief  从当前线程缓存取出一块
+ * @retval 内存首地址, 未命中返回 NULL
+ */
+static void *_xmem_cache_pop(uint8_t cls)
+{
+    xmem_cache_t *cache = XMALLOC_CACHE_GET();
 
-        if (cmemb == nmemb) /* 标注内存块非空 */
-        {
-            for (i = 0; i < nmemb; i++)
-                xmem_pool.memmap[offset + i] = nmemb;
-            return (offset * XMALLOC_BLOCK_SIZE); /* 返回偏移地址 */
-        }
-    }
+    if (cache == NULL || cache->count[cls] == 0)
+        return NULL;
 
-    return 0xFFFFFFFF; /* 未找到符合分配条件的内存块 */
+    return cache->slot[cls][--cache->count[cls]];
 }
 
 /**
- * @brief  释放内存(内部调用)
- * @param  memx   : 所属内存块
- * @param  offset : 内存地址偏移
- * @retval 释放结果
- *   @arg  0, 释放成功;
- *   @arg  1, 释放失败;
- *   @arg  2, 超区域了(失败);
+ * @brief  尝试将释放的块放入当前线程缓存
+ * @note   只缓存通用区域中大小恰好为某一类的块, 这样取出时无需再确认
+ *         属性与容量. 块属于调用者, 读取其大小无需加锁.
+ * @retval 1 已缓存, 0 需正常释放
  */
-static uint8_t my_mem_free(uint32_t offset)
+static uint8_t _xmem_cache_push(void *ptr)
 {
-    if (!xmem_pool.memrdy) /* 未初始化 */
+    xmem_pool_t *pool = _xmem_region_of(ptr);
+    int8_t cls        = -1;
+
+    if (pool == NULL || !(pool->caps & XMEM_CAP_DEFAULT))
+        return 0;
+
+    uint32_t size = _xmem_usable_size(pool, ptr);
+    for (uint8_t i = 0; i < XMALLOC_CACHE_CLASS_NUM; i++)
     {
-        return 1;
-    } /* 未初始化 */
+        if (size == XMEM_CACHE_SIZE(i))
+            cls = (int8_t)i;
+    }
+    if (cls < 0)
+        return 0;
 
-    if (offset < XMALLOC_MAX_SIZE) /* 偏移在内存池内. */
+    xmem_cache_t *cache = XMALLOC_CACHE_GET();
+    if (cache == NULL)
     {
-        int index = offset / XMALLOC_BLOCK_SIZE; /* 偏移所在内存块号码 */
-        int nmemb = xmem_pool.memmap[index];    /* 内存块数量 */
+        cache = xmalloc_aligned_caps(sizeof(xmem_cache_t), 0,
+                                     XMEM_CAP_DEFAULT);
+        if (cache == NULL)
+            return 0;
 
-        for (int i = 0; i < nmemb; i++) /* 内存块清零 */
-            xmem_pool.memmap[index + i] = 0;
+        xmemset(cache, 0, sizeof(xmem_cache_t));
+        XMALLOC_CACHE_SET(cache);
+    }
 
-        return 0;
+    /* 已满时一次加锁归还一半 */
+    if (cache->count[cls] >= XMALLOC_CACHE_DEPTH)
+    {
+        XMALLOC_ENTER_CRITICAL();
+        _xmem_cache_release(cache, (uint8_t)cls,
+                            (XMALLOC_CACHE_DEPTH + 1) / 2);
+        XMALLOC_EXIT_CRITICAL();
     }
-    return 2; /* 偏移超区了. */
+
+    cache->slot[cls][cache->count[cls]++] = ptr;
+    return 1;
+}
+
+/**
+ * @brief  将当前线程缓存的块全部归还给堆并释放缓存, 线程退出前调用
+ * @retval 无
+ */
+void xmem_cache_flush(void)
+{
+    xmem_cache_t *cache = XMALLOC_CACHE_GET();
+
+    if (cache == NULL)
+        return;
+
+    /* 缓存结构本身也直接还给堆, 不经过 xfree 以免再次进入缓存 */
+    XMALLOC_ENTER_CRITICAL();
+    _xmem_cache_drain(cache);
+    _xmem_free_block(cache);
+    XMALLOC_EXIT_CRITICAL();
+
+    XMALLOC_CACHE_SET(NULL);
+}
+
+#ifdef XMALLOC_CACHE_GET_OF
+/**
+ * @brief  将另一线程缓存的块全部归还给堆并释放缓存, 在 osThreadTerminate
+ *         之前调用
+ * @note   目标线程须已挂起, 保证它不在使用缓存, 也不会再运行
+ * @param  thread : 线程 ID
+ * @retval 无
+ */
+void xmem_cache_flush_thread(void *thread)
+{
+    xmem_cache_t *cache;
+
+    xassert_not_null(thread);
+
+    cache = XMALLOC_CACHE_GET_OF(thread);
+    if (cache == NULL)
+        return;
+
+    XMALLOC_ENTER_CRITICAL();
+    _xmem_cache_drain(cache);
+    _xmem_free_block(cache);
+    XMALLOC_EXIT_CRITICAL();
+
+    XMALLOC_CACHE_SET_OF(thread, NULL);
 }
+#endif
+
+#endif /* XMALLOC_THREAD_CACHE */
 
 /**
  * @brief  释放内存(外部调用)
- * @param  memx : 所属内存块
  * @param  ptr  : 内存首地址
  * @retval 无
  */
@@ -184,21 +2049,38 @@ void xfree(void *ptr)
         return; /* 地址为0. */
     }
 
-    uint32_t offset = (uint32_t)ptr - (uint32_t)xmem_pool.membase;
+#if XMALLOC_THREAD_CACHE
+#if XMALLOC_TRACE_ENABLE
+    XMALLOC_ENTER_CRITICAL();
+    _xmem_trace_del(ptr);
+    XMALLOC_EXIT_CRITICAL();
+#endif
+    if (_xmem_cache_push(ptr))
+        return;
+#endif
 
     XMALLOC_ENTER_CRITICAL(); /* 进入临界区 */
-    my_mem_free(offset);      /* 释放内存 */
-    XMALLOC_EXIT_CRITICAL();  /* 离开临界区 */
+    xmem_pool_t *pool = _xmem_free_block(ptr);
+    XMALLOC_EXIT_CRITICAL(); /* 离开临界区 */
+
+#ifdef XDEBUG
+    if (pool == NULL)
+        XLOG_ERROR("xfree invalid pointer: %p", ptr);
+#else
+    XHAL_UNUSED(pool);
+#endif
 }
+
 /**
- * @brief  分配内存(外部调用)
- * @param  memx : 所属内存块
- * @param  size : 要分配的内存大小(字节)
- * @retval 分配到的内存首地址.
+ * @brief  按属性与对齐要求分配内存(外部调用)
+ * @param  size  : 要分配的内存大小(字节)
+ * @param  align : 首地址对齐要求(字节, 2 的幂), 0 表示默认对齐
+ * @param  caps  : 区域须具备的属性, XMEM_CAP_xxx 组合
+ * @retval 分配到的内存首地址, 失败返回 NULL
  */
-void *xmalloc(uint32_t size)
+void *xmalloc_aligned_caps(uint32_t size, uint32_t align, uint32_t caps)
 {
-    void *ptr;
+    void *ptr = NULL;
 
     if (size == 0)
     {
@@ -208,22 +2090,76 @@ void *xmalloc(uint32_t size)
         return NULL; /* 不需要分配 */
     }
 
+    if (align == 0)
+        align = 1;
+
+    if (align & (align - 1))
+    {
+#ifdef XDEBUG
+        XLOG_ERROR("xmalloc invalid align: %lu", (unsigned long)align);
+#endif
+        return NULL;
+    }
+
+#if XMALLOC_THREAD_CACHE
+    /* 通用小块先查线程缓存, 未命中时按类大小申请以便释放后可被缓存 */
+    if (caps == XMEM_CAP_DEFAULT && align <= sizeof(void *))
+    {
+        int8_t cls = _xmem_cache_class(size);
+        if (cls >= 0)
+        {
+            ptr = _xmem_cache_pop((uint8_t)cls);
+            if (ptr != NULL)
+                return ptr;
+
+            size = XMEM_CACHE_SIZE(cls);
+        }
+    }
+#endif
+
     XMALLOC_ENTER_CRITICAL(); /* 进入临界区 */
-    uint32_t offset = my_mem_malloc(size);
+#if XMALLOC_THREAD_CACHE
+retry:
+#endif
+    for (uint8_t i = 0; i < xmem_region_num && ptr == NULL; i++)
+    {
+        xmem_pool_t *pool = &xmem_regions[i];
+
+        if ((pool->caps & caps) != caps)
+            continue;
+
+        if (!pool->memrdy)
+            _xmem_init(pool);
+
+        ptr = _xmem_alloc(pool, size, align);
+        if (ptr == NULL)
+        {
+            pool->fail_count++;
+            continue;
+        }
+
+        pool->used_blocks++;
+        pool->alloc_count++;
+        if (pool->free_size < pool->free_min)
+            pool->free_min = pool->free_size;
+    }
+#if XMALLOC_THREAD_CACHE
+    /* 本线程缓存的块可能正是所缺的连续空间 */
+    if (ptr == NULL && _xmem_cache_drain(XMALLOC_CACHE_GET()) > 0)
+        goto retry;
+#endif
+    if (ptr == NULL)
+        xmem_fail_count++;
     XMALLOC_EXIT_CRITICAL(); /* 离开临界区 */
 
-    if (offset == 0xFFFFFFFF)
+    if (ptr == NULL)
     {
 #ifdef XDEBUG
         XLOG_ERROR("No memory");
 #endif
-        ptr = NULL; /* 申请出错 */
     }
     else
     {
-        /* 申请没问题, 返回首地址 */
-        ptr = (void *)((uint32_t)xmem_pool.membase + offset);
-
 #ifdef XDEBUG
         uint16_t perused = xmem_perused();
         if (perused > 990)
@@ -241,6 +2177,38 @@ void *xmalloc(uint32_t size)
     return ptr;
 }
 
+/**
+ * @brief  分配内存(外部调用)
+ * @param  size : 要分配的内存大小(字节)
+ * @retval 分配到的内存首地址.
+ */
+void *xmalloc(uint32_t size)
+{
+    return xmalloc_aligned_caps(size, 0, XMEM_CAP_DEFAULT);
+}
+
+/**
+ * @brief  从具备指定属性的区域分配内存, 如 XMEM_CAP_DMA
+ * @param  size : 要分配的内存大小(字节)
+ * @param  caps : 区域须具备的属性, XMEM_CAP_xxx 组合
+ * @retval 分配到的内存首地址, 失败返回 NULL
+ */
+void *xmalloc_caps(uint32_t size, uint32_t caps)
+{
+    return xmalloc_aligned_caps(size, 0, caps);
+}
+
+/**
+ * @brief  分配首地址按 align 对齐的通用内存
+ * @param  size  : 要分配的内存大小(字节)
+ * @param  align : 首地址对齐要求(字节, 2 的幂)
+ * @retval 分配到的内存首地址, 失败返回 NULL
+ */
+void *xmalloc_aligned(uint32_t size, uint32_t align)
+{
+    return xmalloc_aligned_caps(size, align, XMEM_CAP_DEFAULT);
+}
+
 /**
  * @brief  分配并清零内存
  * @param  n    : 元素个数
@@ -259,25 +2227,123 @@ void *xcalloc(uint32_t n, uint32_t size)
 }
 
 /**
- * @brief  重新分配内存(外部调用)
- * @param  memx : 所属内存块
- * @param  *ptr : 旧内存首地址
- * @param  size : 要分配的内存大小(字节)
- * @retval 新分配到的内存首地址.
+ * @brief  重新分配内存(外部调用), 优先原地缩小/扩大, 否则在与原内存属性
+ *         相同的区域重新分配并拷贝原有内容
+ * @param  *ptr : 旧内存首地址, 为 NULL 时等同 xmalloc
+ * @param  size : 要分配的内存大小(字节), 为 0 时等同 xfree 并返回 NULL
+ * @retval 新分配到的内存首地址, 失败返回 NULL 且旧内存保持不变
  */
 void *xrealloc(void *ptr, uint32_t size)
 {
-    xassert_not_null(ptr);
+    uint32_t old_size = 0;
+    uint8_t resized   = 0;
+
+    if (ptr == NULL)
+        return xmalloc(size);
+
+    if (size == 0)
+    {
+        xfree(ptr);
+        return NULL;
+    }
+
+    XMALLOC_ENTER_CRITICAL(); /* 进入临界区 */
+    xmem_pool_t *pool = _xmem_region_of(ptr);
+    if (pool != NULL)
+    {
+        old_size = _xmem_usable_size(pool, ptr);
+        resized  = _xmem_resize(pool, ptr, size);
+        if (resized && pool->free_size < pool->free_min)
+            pool->free_min = pool->free_size;
+    }
+    XMALLOC_EXIT_CRITICAL(); /* 离开临界区 */
+
+    if (pool == NULL)
+    {
+#ifdef XDEBUG
+        XLOG_ERROR("xrealloc invalid pointer: %p", ptr);
+#endif
+        return NULL;
+    }
+
+    if (resized)
+        return ptr;
+
+    void *new_ptr = xmalloc_caps(size, pool->caps);
 
-    uint32_t offset = my_mem_malloc(size);
     /* 申请出错 */
-    if (offset == 0xFFFFFFFF)
+    if (new_ptr == NULL)
         return NULL; /* 返回空(0) */
 
-    void *new_ptr = (void *)((uint32_t)xmem_pool.membase + offset);
-
-    xmemcpy(new_ptr, ptr, size); /* 拷贝旧内存内容到新内存 */
-    xfree(ptr);                  /* 释放旧内存 */
+    /* 只拷贝旧内存中有效的部分 */
+    xmemcpy(new_ptr, ptr, XHAL_MIN(old_size, size));
+    xfree(ptr); /* 释放旧内存 */
 
     return new_ptr; /* 返回新内存首地址 */
 }
+
+#if XMALLOC_TRACE_ENABLE
+/**
+ * @brief  带调用位置的分配, 由 xmalloc 等宏调用
+ * @param  size  : 要分配的内存大小(字节)
+ * @param  align : 首地址对齐要求(字节, 2 的幂), 0 表示默认对齐
+ * @param  caps  : 区域须具备的属性, XMEM_CAP_xxx 组合
+ * @param  tag   : 调用位置标签
+ * @param  line  : 调用位置行号
+ * @retval 分配到的内存首地址, 失败返回 NULL
+ */
+void *xmalloc_trace(uint32_t size, uint32_t align, uint32_t caps,
+                    const char *tag, uint32_t line)
+{
+    void *ptr = xmalloc_aligned_caps(size, align, caps);
+
+    if (ptr != NULL)
+    {
+        XMALLOC_ENTER_CRITICAL();
+        _xmem_trace_add(ptr, size, tag, line);
+        XMALLOC_EXIT_CRITICAL();
+    }
+
+    return ptr;
+}
+
+/**
+ * @brief  带调用位置的 xcalloc, 由 xcalloc 宏调用
+ */
+void *xcalloc_trace(uint32_t n, uint32_t size, const char *tag,
+                    uint32_t line)
+{
+    void *ptr = xcalloc(n, size);
+
+    if (ptr != NULL)
+    {
+        XMALLOC_ENTER_CRITICAL();
+        _xmem_trace_add(ptr, n * size, tag, line);
+        XMALLOC_EXIT_CRITICAL();
+    }
+
+    return ptr;
+}
+
+/**
+ * @brief  带调用位置的 xrealloc, 由 xrealloc 宏调用
+ * @note   内存块归属到本次调用位置
+ */
+void *xrealloc_trace(void *ptr, uint32_t size, const char *tag,
+                     uint32_t line)
+{
+    void *new_ptr = xrealloc(ptr, size);
+
+    if (new_ptr != NULL)
+    {
+        XMALLOC_ENTER_CRITICAL();
+        /* 搬迁时旧记录已随 xfree 删除, 原地调整时在此删除 */
+        if (new_ptr == ptr)
+            _xmem_trace_del(ptr);
+        _xmem_trace_add(new_ptr, size, tag, line);
+        XMALLOC_EXIT_CRITICAL();
+    }
+
+    return new_ptr;
+}
+#endif /* XMALLOC_TRACE_ENABLE */
@@ -2,6 +2,7 @@
 #define __XHAL_MALLOC_H
 
 #include "xhal_config.h"
+#include "xhal_def.h"
 #include "xhal_std.h"
 
 #ifndef XMALLOC_BLOCK_SIZE
@@ -12,24 +13,225 @@
 #define XMALLOC_MAX_SIZE (15 * 1024)
 #endif
 
+/* 分配器后端: 0 = 分块映射表, 1 = TLSF(两级分离适配, O(1) 分配/释放) */
+#ifndef XMALLOC_USE_TLSF
+#define XMALLOC_USE_TLSF (0)
+#endif
+
+/* TLSF 一级索引上限, 单个内存块须小于 2^XMALLOC_TLSF_FL_INDEX_MAX 字节 */
+#ifndef XMALLOC_TLSF_FL_INDEX_MAX
+#define XMALLOC_TLSF_FL_INDEX_MAX (16)
+#endif
+
+/* OS 模式下的堆锁: 0 = 挂起调度器, 1 = 优先级继承互斥锁, 只阻塞竞争堆的线程 */
+#ifndef XMALLOC_USE_MUTEX
+#define XMALLOC_USE_MUTEX (0)
+#endif
+
+/* 线程本地小块缓存(magazine), 命中时分配/释放无需加锁 */
+#ifndef XMALLOC_THREAD_CACHE
+#define XMALLOC_THREAD_CACHE (0)
+#endif
+
+#if XMALLOC_THREAD_CACHE
+/* 缓存的大小类数, 第 k 类为最小粒度的 2^k 倍 */
+#ifndef XMALLOC_CACHE_CLASS_NUM
+#define XMALLOC_CACHE_CLASS_NUM (3)
+#endif
+
+/* 每个大小类每线程最多缓存的块数 */
+#ifndef XMALLOC_CACHE_DEPTH
+#define XMALLOC_CACHE_DEPTH (4)
+#endif
+
+/*
+ * 存放缓存指针的 FreeRTOS 线程本地存储序号. 内核删除线程时不会释放缓存,
+ * 线程在 osThreadExit 前调用 xmem_cache_flush; 被 osThreadTerminate 结束
+ * 的线程先挂起, 再交给 xmem_cache_flush_thread.
+ */
+#ifndef XMALLOC_CACHE_TLS_INDEX
+#define XMALLOC_CACHE_TLS_INDEX (0)
+#endif
+#endif /* XMALLOC_THREAD_CACHE */
+
+/* 不小于该长度的 xmemcpy/xmemset 先尝试加速器钩子, 0 表示不使用 */
+#ifndef XMEM_ACCEL_THRESHOLD
+#define XMEM_ACCEL_THRESHOLD (0)
+#endif
+
+/* 最多可注册的内存区域数(含内部 RAM) */
+#ifndef XMALLOC_REGION_NUM_MAX
+#define XMALLOC_REGION_NUM_MAX (4)
+#endif
+
+/* 分配追踪: 记录每个内存块的调用位置与时间, 按标签统计; 0 时不产生任何开销 */
+#ifndef XMALLOC_TRACE_ENABLE
+#define XMALLOC_TRACE_ENABLE (0)
+#endif
+
+#if XMALLOC_TRACE_ENABLE
+/* 可同时追踪的内存块数(2 的幂), 超出的块不记录 */
+#ifndef XMALLOC_TRACE_RECORD_NUM
+#define XMALLOC_TRACE_RECORD_NUM (128)
+#endif
+
+/* 可统计的标签数, 超出后归入 "<other>" */
+#ifndef XMALLOC_TRACE_TAG_NUM
+#define XMALLOC_TRACE_TAG_NUM (16)
+#endif
+
+/* 调用位置标签, 默认为源文件名, 可改为其他字符串表达式 */
+#ifndef XMALLOC_TRACE_SITE
+#define XMALLOC_TRACE_SITE __FILE__
+#endif
+#endif /* XMALLOC_TRACE_ENABLE */
+
+/* 内存区域属性 */
+#define XMEM_CAP_DEFAULT  (1U << 0) /* 通用内存, xmalloc 默认从此类区域分配 */
+#define XMEM_CAP_FAST     (1U << 1) /* 高速内存(零等待/紧耦合) */
+#define XMEM_CAP_DMA      (1U << 2) /* DMA 可访问 */
+#define XMEM_CAP_RETAINED (1U << 3) /* 复位/低功耗保持 */
+
+/* 内部 RAM 区域属性 */
+#ifndef XMALLOC_INTERNAL_CAPS
+#define XMALLOC_INTERNAL_CAPS (XMEM_CAP_DEFAULT | XMEM_CAP_FAST | XMEM_CAP_DMA)
+#endif
+
 #define XMALLOC_ALLOC_TABLE_SIZE (XMALLOC_MAX_SIZE / XMALLOC_BLOCK_SIZE)
 
 typedef struct xmem_pool
 {
-    uint8_t *const membase;
-    uint16_t *const memmap;
+    const char *name;
+    uint8_t *membase; /* 可分配区起始地址 */
+    uint32_t memsize; /* 可分配区大小 */
+    uint32_t caps;    /* XMEM_CAP_xxx */
+    void *ctrl;       /* 后端控制块: 分块映射表或 TLSF 控制结构 */
     uint8_t memrdy;
+
+    /* 增量维护的统计量, 查询无需遍历堆 */
+    uint32_t free_size;    /* 当前空闲字节数 */
+    uint32_t free_min;     /* 空闲字节数历史最小值 */
+    uint32_t used_blocks;  /* 当前已分配块数 */
+    uint32_t alloc_count;  /* 累计分配次数 */
+    uint32_t free_count;   /* 累计释放次数 */
+    uint32_t fail_count;   /* 本区域无法满足的分配次数 */
+    uint32_t largest_free;  /* 最大空闲块(分块映射表后端), 见 largest_dirty */
+    uint16_t largest_count; /* 长度等于 largest_free 的空闲段数 */
+    uint8_t largest_dirty;  /* 置位后下次查询重扫映射表, O(分块数) */
 } xmem_pool_t;
 
+typedef struct xmem_stats
+{
+    uint32_t total_size;   /* 可分配总字节数 */
+    uint32_t free_size;    /* 当前空闲字节数 */
+    uint32_t free_min;     /* 空闲字节数历史最小值 */
+    uint32_t largest_free; /* 最大连续空闲块字节数 */
+    uint32_t used_blocks;  /* 当前已分配块数 */
+    uint32_t alloc_count;  /* 累计分配次数 */
+    uint32_t free_count;   /* 累计释放次数 */
+    uint32_t fail_count;   /* 分配失败次数 */
+    uint16_t perused;      /* 使用率(扩大10倍, 0~1000) */
+    uint16_t frag;         /* 碎片率(扩大10倍, 0~1000), 1 - 最大空闲块/总空闲 */
+} xmem_stats_t;
+
+#if XMALLOC_TRACE_ENABLE
+typedef struct xmem_trace_tag
+{
+    const char *tag;      /* 标签 */
+    uint32_t live_bytes;  /* 当前占用字节数 */
+    uint32_t peak_bytes;  /* 占用字节数峰值 */
+    uint32_t live_count;  /* 当前占用块数 */
+    uint32_t alloc_count; /* 统计周期内分配次数 */
+    uint32_t alloc_bytes; /* 统计周期内分配字节数 */
+    uint32_t rate;        /* 统计周期内平均分配速率(次/秒) */
+} xmem_trace_tag_t;
+
+typedef struct xmem_trace_rec
+{
+    void *ptr;     /* 内存首地址 */
+    uint32_t size; /* 请求大小(字节) */
+    const char *tag;
+    uint32_t line;
+    uint32_t time; /* 分配时刻(ms) */
+    uint32_t seq;  /* 分配序号, 与 xmem_trace_snapshot 比较 */
+} xmem_trace_rec_t;
+#endif
+
+typedef struct xmem_region_info
+{
+    const char *name;
+    void *base;
+    uint32_t caps;
+    uint32_t total_size;
+    uint32_t free_size;
+    uint16_t perused;
+} xmem_region_info_t;
+
+xhal_err_t xmem_region_add(const char *name, void *base, uint32_t size,
+                           uint32_t caps);
+uint8_t xmem_region_count(void);
+xhal_err_t xmem_region_get_info(uint8_t index, xmem_region_info_t *info);
+xhal_err_t xmem_region_get_stats(uint8_t index, xmem_stats_t *stats);
+
+void xmem_get_stats(xmem_stats_t *stats);
+
 uint32_t xmem_free_size(void);
 uint16_t xmem_perused(void);
 
 void xmemset(void *s, uint8_t c, uint32_t count);
 void xmemcpy(void *des, const void *src, uint32_t n);
+void xmemmove(void *des, const void *src, uint32_t n);
+
+#if XMEM_ACCEL_THRESHOLD > 0
+xhal_err_t xmem_accel_copy(void *des, const void *src, uint32_t n);
+xhal_err_t xmem_accel_set(void *s, uint8_t c, uint32_t n);
+#endif
 
 void xfree(void *ptr);
 void *xmalloc(uint32_t size);
+void *xmalloc_caps(uint32_t size, uint32_t caps);
+void *xmalloc_aligned(uint32_t size, uint32_t align);
+void *xmalloc_aligned_caps(uint32_t size, uint32_t align, uint32_t caps);
 void *xcalloc(uint32_t n, uint32_t size);
 void *xrealloc(void *ptr, uint32_t size);
 
-#endif /* __XHAL_MALLOC_H */
\ No newline at end of file
+#if XMALLOC_THREAD_CACHE
+void xmem_cache_flush(void);
+void xmem_cache_flush_thread(void *thread);
+#endif
+
+#if XMALLOC_TRACE_ENABLE
+void *xmalloc_trace(uint32_t size, uint32_t align, uint32_t caps,
+                    const char *tag, uint32_t line);
+void *xcalloc_trace(uint32_t n, uint32_t size, const char *tag,
+                    uint32_t line);
+void *xrealloc_trace(void *ptr, uint32_t size, const char *tag,
+                     uint32_t line);
+
+uint8_t xmem_trace_tag_count(void);
+xhal_err_t xmem_trace_get_tag(uint8_t index, xmem_trace_tag_t *tag);
+xhal_err_t xmem_trace_get_rec(uint32_t *index, uint32_t since,
+                              xmem_trace_rec_t *rec);
+uint32_t xmem_trace_snapshot(void);
+uint32_t xmem_trace_dropped(void);
+void xmem_trace_reset(void);
+
+/* 使用方通过以下宏记录调用位置, xhal_malloc.c 自身除外 */
+#ifndef XMALLOC_TRACE_IMPL
+#define xmalloc(size) \
+    xmalloc_trace((size), 0, XMEM_CAP_DEFAULT, XMALLOC_TRACE_SITE, __LINE__)
+#define xmalloc_caps(size, caps) \
+    xmalloc_trace((size), 0, (caps), XMALLOC_TRACE_SITE, __LINE__)
+#define xmalloc_aligned(size, align)                                     \
+    xmalloc_trace((size), (align), XMEM_CAP_DEFAULT, XMALLOC_TRACE_SITE, \
+                  __LINE__)
+#define xmalloc_aligned_caps(size, align, caps) \
+    xmalloc_trace((size), (align), (caps), XMALLOC_TRACE_SITE, __LINE__)
+#define xcalloc(n, size) \
+    xcalloc_trace((n), (size), XMALLOC_TRACE_SITE, __LINE__)
+#define xrealloc(ptr, size) \
+    xrealloc_trace((ptr), (size), XMALLOC_TRACE_SITE, __LINE__)
+#endif
+#endif /* XMALLOC_TRACE_ENABLE */
+
+#endif /* __XHAL_MALLOC_H */
@@ -0,0 +1,304 @@
+#include "xhal_arena.h"
+#include "../xcore/xhal_assert.h"
+#include "../xcore/xhal_log.h"
+#include "../xcore/xhal_malloc.h"
+
+XLOG_TAG("xArena");
+
+#ifdef XHAL_OS_SUPPORTING
+#include "../xos/xhal_os.h"
+
+#include "../xos/FreeRTOS/include/task.h"
+#endif
+
+/* Where the calling thread keeps its scratch arena. */
+#ifndef XARENA_SCRATCH_GET
+#ifdef XHAL_OS_SUPPORTING
+#define XARENA_SCRATCH_GET_OF(thread)                \
+    ((xarena_t *)pvTaskGetThreadLocalStoragePointer( \
+        (TaskHandle_t)(thread), XARENA_SCRATCH_TLS_INDEX))
+#define XARENA_SCRATCH_SET_OF(thread, arena)                           \
+    vTaskSetThreadLocalStoragePointer((TaskHandle_t)(thread),          \
+                                      XARENA_SCRATCH_TLS_INDEX, (arena))
+#define XARENA_SCRATCH_GET()      XARENA_SCRATCH_GET_OF(NULL)
+#define XARENA_SCRATCH_SET(arena) XARENA_SCRATCH_SET_OF(NULL, (arena))
+#else
+static xarena_t *xarena_scratch_arena = NULL;
+
+#define XARENA_SCRATCH_GET()      xarena_scratch_arena
+#define XARENA_SCRATCH_SET(arena) (xarena_scratch_arena = (arena))
+#endif
+#endif
+
+/**
+ * @brief  Initialize one arena on the given storage.
+ * @param  self    The arena handle.
+ * @param  name    The arena name, used by logs.
+ * @param  buff    Storage of `size` bytes.
+ * @param  size    Storage size in bytes.
+ * @retval See xhal_err_t.
+ */
+xhal_err_t xarena_init(xarena_t *const self, const char *name, void *buff,
+                       uint32_t size)
+{
+    xassert_not_null(self);
+    xassert_not_null(buff);
+
+    if (size == 0)
+        return XHAL_ERR_INVALID;
+
+    self->name       = name;
+    self->buff       = (uint8_t *)buff;
+    self->size       = size;
+    self->used       = 0;
+    self->used_max   = 0;
+    self->alloc_fail = 0;
+    self->flags      = 0;
+
+    return XHAL_OK;
+}
+
+/**
+ * @brief  Newly create one arena carved out of the xmalloc heap. The arena
+ * handle and its storage share one allocation.
+ * @param  name    The arena name.
+ * @param  size    Storage size in bytes.
+ * @retval The arena handle, NULL if out of memory.
+ */
+xarena_t *xarena_new(const char *name, uint32_t size)
+{
+    uint32_t head_size = XHAL_CEIL(sizeof(xarena_t), XARENA_ALIGN);
+
+    if (size == 0)
+        return NULL;
+
+    uint8_t *mem = xmalloc(head_size + size);
+    if (mem == NULL)
+    {
+#ifdef XDEBUG
+        XLOG_ERROR("Arena %s: no memory", name == NULL ? "<none>" : name);
+#endif
+        return NULL;
+    }
+
+    xarena_t *self = (xarena_t *)mem;
+    xarena_init(self, name, mem + head_size, size);
+    self->flags |= XARENA_FLAG_HEAP;
+
+    return self;
+}
+
+/**
+ * @brief  Destroy the arena which is generated by the function xarena_new.
+ * @param  self    The arena handle.
+ * @retval None.
+ */
+void xarena_destroy(xarena_t *const self)
+{
+    xassert_not_null(self);
+    xassert(self->flags & XARENA_FLAG_HEAP);
+
+    xfree(self);
+}
+
+/**
+ * @brief  Bump-allocate pointer-aligned memory from the arena. It is given
+ * back by xarena_reset, never individually.
+ * @param  self    The arena handle.
+ * @param  size    Size in bytes.
+ * @retval The memory, NULL if the arena is exhausted.
+ */
+void *xarena_alloc(xarena_t *const self, uint32_t size)
+{
+    return xarena_alloc_aligned(self, size, XARENA_ALIGN);
+}
+
+/**
+ * @brief  Bump-allocate memory aligned to `align` from the arena.
+ * @param  self    The arena handle.
+ * @param  size    Size in bytes.
+ * @param  align   Alignment in bytes, a power of two.
+ * @retval The memory, NULL if the arena is exhausted.
+ */
+void *xarena_alloc_aligned(xarena_t *const self, uint32_t size,
+                           uint32_t align)
+{
+    xassert_not_null(self);
+    xassert(align != 0 && (align & (align - 1)) == 0);
+
+    xhal_pointer_t base  = (xhal_pointer_t)self->buff;
+    xhal_pointer_t start = XHAL_CEIL(base + self->used, (xhal_pointer_t)align);
+    uint32_t offset      = (uint32_t)(start - base);
+
+    if (size == 0 || offset > self->size || size > self->size - offset)
+    {
+        self->alloc_fail++;
+        return NULL;
+    }
+
+    self->used = offset + size;
+    if (self->used > self->used_max)
+        self->used_max = self->used;
+
+    return (void *)start;
+}
+
+/**
+ * @brief  Remember the current position of the arena.
+ * @param  self    The arena handle.
+ * @retval The mark to be passed to xarena_reset.
+ */
+xarena_mark_t xarena_mark(const xarena_t *const self)
+{
+    xassert_not_null(self);
+
+    return self->used;
+}
+
+/**
+ * @brief  Release everything allocated since `mark`. Marks must be reset in
+ * the reverse order they were taken, 0 empties the arena.
+ * @param  self    The arena handle.
+ * @param  mark    The mark returned by xarena_mark.
+ * @retval None.
+ */
+void xarena_reset(xarena_t *const self, xarena_mark_t mark)
+{
+    xassert_not_null(self);
+    xassert(mark <= self->used);
+
+    self->used = mark;
+}
+
+/**
+ * @brief  Get the bytes still available, ignoring alignment padding.
+ * @param  self    The arena handle.
+ * @retval The free size in bytes.
+ */
+uint32_t xarena_free_size(const xarena_t *const self)
+{
+    xassert_not_null(self);
+
+    return self->size - self->used;
+}
+
+/**
+ * @brief  Check whether the memory was allocated from the arena.
+ * @param  self    The arena handle.
+ * @param  ptr     The memory.
+ * @retval 1 if owned, otherwise 0.
+ */
+uint8_t xarena_contains(const xarena_t *const self, const void *ptr)
+{
+    xassert_not_null(self);
+
+    const uint8_t *p = (const uint8_t *)ptr;
+
+    return p >= self->buff && p < self->buff + self->size;
+}
+
+/**
+ * @brief  Get the scratch arena of the calling thread, created on first use
+ * with XARENA_SCRATCH_SIZE bytes. Callers take a mark, allocate and reset to
+ * the mark before returning, so nested users share the same arena.
+ * @note   Without XHAL_OS_SUPPORTING one arena is shared by the whole
+ * program and must not be used from interrupts.
+ * @retval The scratch arena, NULL if out of memory.
+ */
+xarena_t *xarena_scratch(void)
+{
+    xarena_t *arena = XARENA_SCRATCH_GET();
+
+    if (arena == NULL)
+    {
+        arena = xarena_new("scratch", XARENA_SCRATCH_SIZE);
+        if (arena != NULL)
+            XARENA_SCRATCH_SET(arena);
+    }
+
+    return arena;
+}
+
+/**
+ * @brief  Destroy the scratch arena of the calling thread, called before
+ * the thread exits, see XARENA_SCRATCH_TLS_INDEX.
+ * @retval None.
+ */
+void xarena_scratch_release(void)
+{
+    xarena_t *arena = XARENA_SCRATCH_GET();
+
+    if (arena == NULL)
+        return;
+
+    XARENA_SCRATCH_SET(NULL);
+    xarena_destroy(arena);
+}
+
+#ifdef XARENA_SCRATCH_GET_OF
+/**
+ * @brief  Destroy the scratch arena of another thread that is about to be
+ * terminated. The thread must be suspended so it cannot be using the arena
+ * or run again before osThreadTerminate.
+ * @param  thread  The thread ID.
+ * @retval None.
+ */
+void xarena_scratch_release_thread(void *thread)
+{
+    xassert_not_null(thread);
+
+    xarena_t *arena = XARENA_SCRATCH_GET_OF(thread);
+
+    if (arena == NULL)
+        return;
+
+    XARENA_SCRATCH_SET_OF(thread, NULL);
+    xarena_destroy(arena);
+}
+#endif
+
+/**
+ * @brief  Take a transient buffer from the scratch arena of the calling
+ * thread, falling back to the xmalloc heap when it does not fit.
+ * @param  size    Size in bytes.
+ * @param  mark    Output, to be passed to xarena_scratch_free.
+ * @retval The buffer, NULL if out of memory.
+ */
+void *xarena_scratch_alloc(uint32_t size, xarena_mark_t *mark)
+{
+    xarena_t *arena = xarena_scratch();
+    void *ptr       = NULL;
+
+    xassert_not_null(mark);
+
+    *mark = 0;
+    if (arena != NULL)
+    {
+        *mark = xarena_mark(arena);
+        ptr   = xarena_alloc(arena, size);
+    }
+
+    if (ptr == NULL)
+        ptr = xmalloc(size);
+
+    return ptr;
+}
+
+/**
+ * @brief  Give back a buffer obtained by xarena_scratch_alloc.
+ * @param  ptr     The buffer.
+ * @param  mark    The mark output by xarena_scratch_alloc.
+ * @retval None.
+ */
+void xarena_scratch_free(void *ptr, xarena_mark_t mark)
+{
+    xarena_t *arena = XARENA_SCRATCH_GET();
+
+    if (ptr == NULL)
+        return;
+
+    if (arena != NULL && xarena_contains(arena, ptr))
+        xarena_reset(arena, mark);
+    else
+        xfree(ptr);
+}
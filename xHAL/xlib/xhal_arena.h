@@ -0,0 +1,66 @@
+#ifndef __XHAL_ARENA_H
+#define __XHAL_ARENA_H
+
+#include "xhal_config.h"
+#include "../xcore/xhal_def.h"
+#include "../xcore/xhal_std.h"
+
+#define XARENA_FLAG_HEAP (1U << 0) /* Arena is carved from the xmalloc heap */
+
+#define XARENA_ALIGN     (sizeof(void *))
+
+/* Capacity of the scratch arena returned by xarena_scratch(). */
+#ifndef XARENA_SCRATCH_SIZE
+#define XARENA_SCRATCH_SIZE (512)
+#endif
+
+/*
+ * FreeRTOS thread-local storage slot holding each thread's scratch arena.
+ * The kernel does not free it when the thread is deleted (no TLS delete
+ * callback, and xfree may block), so a thread that used xarena_scratch
+ * calls xarena_scratch_release before osThreadExit, and a thread killed
+ * with osThreadTerminate is suspended and handed to
+ * xarena_scratch_release_thread first.
+ */
+#ifndef XARENA_SCRATCH_TLS_INDEX
+#define XARENA_SCRATCH_TLS_INDEX (1)
+#endif
+
+/* Position inside an arena, everything allocated after it is released
+ * together by xarena_reset. */
+typedef uint32_t xarena_mark_t;
+
+typedef struct xarena
+{
+    const char *name;
+    uint8_t *buff;
+    uint32_t size;
+    uint32_t used;
+    uint32_t used_max;   /* High-water mark of `used` */
+    uint32_t alloc_fail; /* Allocations refused because the arena was full */
+    uint8_t flags;
+} xarena_t;
+
+xhal_err_t xarena_init(xarena_t *const self, const char *name, void *buff,
+                       uint32_t size);
+xarena_t *xarena_new(const char *name, uint32_t size);
+void xarena_destroy(xarena_t *const self);
+
+void *xarena_alloc(xarena_t *const self, uint32_t size);
+void *xarena_alloc_aligned(xarena_t *const self, uint32_t size,
+                           uint32_t align);
+
+xarena_mark_t xarena_mark(const xarena_t *const self);
+void xarena_reset(xarena_t *const self, xarena_mark_t mark);
+uint32_t xarena_free_size(const xarena_t *const self);
+uint8_t xarena_contains(const xarena_t *const self, const void *ptr);
+
+xarena_t *xarena_scratch(void);
+void xarena_scratch_release(void);
+#ifdef XHAL_OS_SUPPORTING
+void xarena_scratch_release_thread(void *thread);
+#endif
+void *xarena_scratch_alloc(uint32_t size, xarena_mark_t *mark);
+void xarena_scratch_free(void *ptr, xarena_mark_t mark);
+
+#endif /* __XHAL_ARENA_H */
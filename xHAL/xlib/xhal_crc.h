@@ -1,8 +1,23 @@
 #ifndef __XHAL_CRC_H
 #define __XHAL_CRC_H
 
+#include "../xcore/xhal_def.h"
 #include "../xcore/xhal_std.h"
 
+/*
+ * Tables xcrc32 consults per step: 1 is one byte per lookup; 4 and 8 read
+ * a word at a time (slice-by-N). Every table past the first is const data
+ * and costs 1 KB of flash.
+ */
+#ifndef XCRC32_SLICE_BY
+#define XCRC32_SLICE_BY (4)
+#endif
+
+/* xcrc32 hands blocks of at least this size to xcrc32_accel, 0 is off. */
+#ifndef XCRC32_ACCEL_THRESHOLD
+#define XCRC32_ACCEL_THRESHOLD (0)
+#endif
+
 #define XCRC32_INIT   (0U)
 #define XCRC32_XOROUT (0xFFFFFFFFU)
 
@@ -10,7 +25,64 @@
 #define XCRC8_POLY    (0x31U)
 #define XCRC8_XOROUT  (0x00U)
 
+/*
+ * Parameters of an 8 or 16 bit CRC in the usual catalogue form: `poly` and
+ * `init` are written MSB first, and `reflect` sets both refin and refout.
+ */
+typedef struct xcrc_param
+{
+    uint16_t poly;
+    uint16_t init;
+    uint16_t xorout;
+    uint8_t width;   /* 8 or 16 */
+    uint8_t reflect;
+} xcrc_param_t;
+
+/* CRC-8/NRSC-5, the xcrc8 algorithm (Sensirion sensors) */
+extern const xcrc_param_t xcrc8_param;
+/* CRC-16/CCITT-FALSE */
+extern const xcrc_param_t xcrc16_ccitt_param;
+/* CRC-16/MODBUS */
+extern const xcrc_param_t xcrc16_modbus_param;
+
+/* A table-driven CRC built from an xcrc_param_t. */
+typedef struct xcrc8
+{
+    uint8_t table[256];
+    uint8_t init;
+    uint8_t xorout;
+    uint8_t reflect;
+} xcrc8_t;
+
+typedef struct xcrc16
+{
+    uint16_t table[256];
+    uint16_t init;
+    uint16_t xorout;
+    uint8_t reflect;
+} xcrc16_t;
+
 uint32_t xcrc32(uint32_t crc, const void *data, uint32_t size);
+uint32_t xcrc32_combine(uint32_t crc_a, uint32_t crc_b, uint32_t len_b);
 uint8_t xcrc8(uint8_t crc, const void *data, uint32_t size);
 
+#if XCRC32_ACCEL_THRESHOLD > 0
+xhal_err_t xcrc32_accel(uint32_t *state, const void *data, uint32_t size);
+#endif
+
+xhal_err_t xcrc8_init(xcrc8_t *const self, const xcrc_param_t *param);
+uint8_t xcrc8_start(const xcrc8_t *const self);
+uint8_t xcrc8_update(const xcrc8_t *const self, uint8_t crc, const void *data,
+                     uint32_t size);
+uint8_t xcrc8_final(const xcrc8_t *const self, uint8_t crc);
+uint8_t xcrc8_calc(const xcrc8_t *const self, const void *data, uint32_t size);
+
+xhal_err_t xcrc16_init(xcrc16_t *const self, const xcrc_param_t *param);
+uint16_t xcrc16_start(const xcrc16_t *const self);
+uint16_t xcrc16_update(const xcrc16_t *const self, uint16_t crc,
+                       const void *data, uint32_t size);
+uint16_t xcrc16_final(const xcrc16_t *const self, uint16_t crc);
+uint16_t xcrc16_calc(const xcrc16_t *const self, const void *data,
+                     uint32_t size);
+
 #endif /* __XHAL_CRC_H */
@@ -0,0 +1,333 @@
+#include "xhal_heap.h"
+#include "../xcore/xhal_assert.h"
+#include "../xcore/xhal_log.h"
+#include "../xcore/xhal_malloc.h"
+
+XLOG_TAG("xHeap");
+
+/*
+ * Binary min-heap over an array of node pointers: the children of slot i
+ * are slots 2i+1 and 2i+2. Every move writes the new slot back into the
+ * node, so a node can be found from itself and removed or re-keyed in
+ * O(log n). The heap does no locking; callers serialize access.
+ */
+
+#define HEAP_PARENT(i) (((i) - 1U) >> 1)
+#define HEAP_LEFT(i)   (((i) << 1) + 1U)
+
+/**
+ * @brief  Place a node into a slot.
+ * @param  self    The heap handle.
+ * @param  i       Slot index.
+ * @param  node    The node.
+ * @retval None.
+ */
+static inline void _set(xheap_t *const self, uint32_t i, xheap_node_t *node)
+{
+    self->nodes[i] = node;
+    node->index    = i;
+}
+
+/**
+ * @brief  Move a node from slot i towards the root until its parent is not
+ * greater. Parents are shifted down into the hole instead of swapped.
+ * @param  self    The heap handle.
+ * @param  i       Slot index of the node.
+ * @retval The final slot index.
+ */
+static uint32_t _sift_up(xheap_t *const self, uint32_t i)
+{
+    xheap_node_t *node = self->nodes[i];
+
+    while (i > 0)
+    {
+        uint32_t parent = HEAP_PARENT(i);
+        if (!self->less(node, self->nodes[parent]))
+            break;
+
+        _set(self, i, self->nodes[parent]);
+        i = parent;
+    }
+    _set(self, i, node);
+
+    return i;
+}
+
+/**
+ * @brief  Move a node from slot i towards the leaves until no child is
+ * less than it.
+ * @param  self    The heap handle.
+ * @param  i       Slot index of the node.
+ * @retval None.
+ */
+static void _sift_down(xheap_t *const self, uint32_t i)
+{
+    xheap_node_t *node = self->nodes[i];
+    uint32_t count     = self->count;
+
+    for (;;)
+    {
+        uint32_t child = HEAP_LEFT(i);
+        if (child >= count)
+            break;
+
+        if (child + 1U < count &&
+            self->less(self->nodes[child + 1U], self->nodes[child]))
+            child++;
+
+        if (!self->less(self->nodes[child], node))
+            break;
+
+        _set(self, i, self->nodes[child]);
+        i = child;
+    }
+    _set(self, i, node);
+}
+
+/**
+ * @brief  Restore the heap order around slot i after its node changed.
+ * @param  self    The heap handle.
+ * @param  i       Slot index.
+ * @retval None.
+ */
+static inline void _fix(xheap_t *const self, uint32_t i)
+{
+    if (_sift_up(self, i) == i)
+        _sift_down(self, i);
+}
+
+/**
+ * @brief  Initialize one heap on the given storage.
+ * @param  self        The heap handle.
+ * @param  buff        Storage of `capacity` node pointers, see
+ *                     XHEAP_STORAGE.
+ * @param  capacity    Maximum node count.
+ * @param  less        The ordering function.
+ * @retval See xhal_err_t.
+ */
+xhal_err_t xheap_init(xheap_t *const self, xheap_node_t **buff,
+                      uint32_t capacity, xheap_less_t less)
+{
+    xassert_not_null(self);
+    xassert_not_null(buff);
+    xassert_not_null(less);
+
+    if (capacity == 0 || capacity == XHEAP_INDEX_NONE)
+        return XHAL_ERR_INVALID;
+
+    self->nodes    = buff;
+    self->less     = less;
+    self->count    = 0;
+    self->capacity = capacity;
+    self->flags    = 0;
+
+    return XHAL_OK;
+}
+
+/**
+ * @brief  Newly create one heap carved out of the xmalloc heap. The heap
+ * handle and its storage share one allocation.
+ * @param  capacity    Maximum node count.
+ * @param  less        The ordering function.
+ * @retval The heap handle, NULL if out of memory.
+ */
+xheap_t *xheap_new(uint32_t capacity, xheap_less_t less)
+{
+    uint32_t head_size = XHAL_CEIL(sizeof(xheap_t), sizeof(void *));
+
+    if (capacity == 0 || capacity == XHEAP_INDEX_NONE ||
+        capacity > (UINT32_MAX - head_size) / sizeof(xheap_node_t *))
+        return NULL;
+
+    uint8_t *mem = xmalloc(head_size + XHEAP_BUFF_SIZE(capacity));
+    if (mem == NULL)
+    {
+#ifdef XDEBUG
+        XLOG_ERROR("Heap of %u nodes: no memory", (unsigned)capacity);
+#endif
+        return NULL;
+    }
+
+    xheap_t *self = (xheap_t *)mem;
+    xheap_init(self, (xheap_node_t **)(mem + head_size), capacity, less);
+    self->flags = XHEAP_FLAG_HEAP;
+
+    return self;
+}
+
+/**
+ * @brief  Destroy the heap which is generated by the function xheap_new.
+ * Nodes still in it are detached.
+ * @param  self    The heap handle.
+ * @retval None.
+ */
+void xheap_destroy(xheap_t *const self)
+{
+    xassert_not_null(self);
+    xassert(self->flags & XHEAP_FLAG_HEAP);
+
+    xheap_clear(self);
+    xfree(self);
+}
+
+/**
+ * @brief  Mark a node as detached. Call once before its first push.
+ * @param  node    The node.
+ * @retval None.
+ */
+void xheap_node_init(xheap_node_t *const node)
+{
+    xassert_not_null(node);
+
+    node->index = XHEAP_INDEX_NONE;
+}
+
+/**
+ * @brief  Insert a detached node.
+ * @param  self    The heap handle.
+ * @param  node    The node.
+ * @retval XHAL_OK, XHAL_ERR_FULL if the heap is full, XHAL_ERR_BUSY if the
+ *         node is already in a heap.
+ */
+xhal_err_t xheap_push(xheap_t *const self, xheap_node_t *node)
+{
+    xassert_not_null(self);
+    xassert_not_null(node);
+
+    if (node->index != XHEAP_INDEX_NONE)
+        return XHAL_ERR_BUSY;
+
+    if (self->count >= self->capacity)
+        return XHAL_ERR_FULL;
+
+    self->nodes[self->count] = node;
+    _sift_up(self, self->count++);
+
+    return XHAL_OK;
+}
+
+/**
+ * @brief  Get the least node without removing it.
+ * @param  self    The heap handle.
+ * @retval The node, NULL if the heap is empty.
+ */
+xheap_node_t *xheap_peek(const xheap_t *const self)
+{
+    xassert_not_null(self);
+
+    return self->count == 0 ? NULL : self->nodes[0];
+}
+
+/**
+ * @brief  Remove and return the least node.
+ * @param  self    The heap handle.
+ * @retval The node, NULL if the heap is empty.
+ */
+xheap_node_t *xheap_pop(xheap_t *const self)
+{
+    xassert_not_null(self);
+
+    if (self->count == 0)
+        return NULL;
+
+    xheap_node_t *top = self->nodes[0];
+    xheap_remove(self, top);
+
+    return top;
+}
+
+/**
+ * @brief  Remove a node from any position.
+ * @param  self    The heap handle.
+ * @param  node    The node.
+ * @retval XHAL_OK, XHAL_ERR_NOT_FOUND if the node is not in this heap.
+ */
+xhal_err_t xheap_remove(xheap_t *const self, xheap_node_t *node)
+{
+    xassert_not_null(self);
+    xassert_not_null(node);
+
+    if (!xheap_contains(self, node))
+        return XHAL_ERR_NOT_FOUND;
+
+    uint32_t i    = node->index;
+    uint32_t last = --self->count;
+
+    node->index = XHEAP_INDEX_NONE;
+    if (i != last)
+    {
+        /* Fill the hole with the last node and restore the order there */
+        self->nodes[i] = self->nodes[last];
+        _fix(self, i);
+    }
+
+    return XHAL_OK;
+}
+
+/**
+ * @brief  Restore the order after the key of a node changed, in either
+ * direction. Nodes not in this heap are ignored.
+ * @param  self    The heap handle.
+ * @param  node    The node.
+ * @retval None.
+ */
+void xheap_update(xheap_t *const self, xheap_node_t *node)
+{
+    xassert_not_null(self);
+    xassert_not_null(node);
+
+    if (xheap_contains(self, node))
+        _fix(self, node->index);
+}
+
+/**
+ * @brief  Detach every node.
+ * @param  self    The heap handle.
+ * @retval None.
+ */
+void xheap_clear(xheap_t *const self)
+{
+    xassert_not_null(self);
+
+    for (uint32_t i = 0; i < self->count; i++)
+        self->nodes[i]->index = XHEAP_INDEX_NONE;
+    self->count = 0;
+}
+
+/**
+ * @brief  Get the node count.
+ * @param  self    The heap handle.
+ * @retval Node count.
+ */
+uint32_t xheap_count(const xheap_t *const self)
+{
+    xassert_not_null(self);
+
+    return self->count;
+}
+
+/**
+ * @brief  Check whether the heap is empty.
+ * @param  self    The heap handle.
+ * @retval 1 if empty, otherwise 0.
+ */
+uint8_t xheap_is_empty(const xheap_t *const self)
+{
+    xassert_not_null(self);
+
+    return self->count == 0;
+}
+
+/**
+ * @brief  Check whether a node is in this heap.
+ * @param  self    The heap handle.
+ * @param  node    The node.
+ * @retval 1 if it is, otherwise 0.
+ */
+uint8_t xheap_contains(const xheap_t *const self, const xheap_node_t *node)
+{
+    xassert_not_null(self);
+    xassert_not_null(node);
+
+    return node->index < self->count && self->nodes[node->index] == node;
+}
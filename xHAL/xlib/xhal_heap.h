@@ -0,0 +1,67 @@
+#ifndef __XHAL_HEAP_H
+#define __XHAL_HEAP_H
+
+#include "../xcore/xhal_def.h"
+#include "../xcore/xhal_std.h"
+
+#define XHEAP_FLAG_HEAP  (1U << 0)      /* Storage is from the xmalloc heap */
+
+#define XHEAP_INDEX_NONE (0xFFFFFFFFU)  /* Node is not in any heap */
+
+/* Bytes of storage needed by a heap of `capacity` nodes. */
+#define XHEAP_BUFF_SIZE(capacity) (sizeof(xheap_node_t *) * (capacity))
+
+/**
+ * @brief  Define the static storage for one heap.
+ * @param  name        Storage variable name.
+ * @param  capacity    Node count.
+ */
+#define XHEAP_STORAGE(name, capacity) static xheap_node_t *name[capacity]
+
+/**
+ * @brief  Get the struct that embeds the node.
+ * @param  node    The node pointer.
+ * @param  type    The embedding struct type.
+ * @param  member  The node member name within the struct.
+ */
+#define XHEAP_ENTRY(node, type, member) xhal_container_of(node, type, member)
+
+/*
+ * Node embedded in each element. It records the element's slot in the heap
+ * array, which makes remove and key updates O(log n) without a search.
+ */
+typedef struct xheap_node
+{
+    uint32_t index; /* Slot in the heap array, XHEAP_INDEX_NONE if detached */
+} xheap_node_t;
+
+/* Returns nonzero if `a` must come out of the heap before `b`. */
+typedef uint8_t (*xheap_less_t)(const xheap_node_t *a, const xheap_node_t *b);
+
+typedef struct xheap
+{
+    xheap_node_t **nodes;
+    xheap_less_t less;
+    uint32_t count;
+    uint32_t capacity;
+    uint8_t flags;
+} xheap_t;
+
+xhal_err_t xheap_init(xheap_t *const self, xheap_node_t **buff,
+                      uint32_t capacity, xheap_less_t less);
+xheap_t *xheap_new(uint32_t capacity, xheap_less_t less);
+void xheap_destroy(xheap_t *const self);
+
+void xheap_node_init(xheap_node_t *const node);
+xhal_err_t xheap_push(xheap_t *const self, xheap_node_t *node);
+xheap_node_t *xheap_peek(const xheap_t *const self);
+xheap_node_t *xheap_pop(xheap_t *const self);
+xhal_err_t xheap_remove(xheap_t *const self, xheap_node_t *node);
+void xheap_update(xheap_t *const self, xheap_node_t *node);
+void xheap_clear(xheap_t *const self);
+
+uint32_t xheap_count(const xheap_t *const self);
+uint8_t xheap_is_empty(const xheap_t *const self);
+uint8_t xheap_contains(const xheap_t *const self, const xheap_node_t *node);
+
+#endif /* __XHAL_HEAP_H */
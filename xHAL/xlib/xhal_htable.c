@@ -2,31 +2,80 @@
 #include "../xcore/xhal_assert.h"
 #include "../xcore/xhal_log.h"
 #include "../xcore/xhal_malloc.h"
+#include <string.h>
 
 XLOG_TAG("xHashTable");
 
-static uint32_t _get_prime_max(uint32_t capacity);
-static uint32_t _hash_time33(char *str);
-static uint32_t _hash_bkdr(char *str);
-static uint32_t _hash_elf(char *str);
+/*
+ * Open addressing with linear probing, see xhal_oatable.c for the load,
+ * tombstone and rehash rules. Each slot caches the hash of its key, so a
+ * probe only calls strcmp when the hashes match.
+ */
 
 /**
- * @brief  Newly create one hash table in the given capacity.
- * @param  size    The given capacity size.
- * @retval The hash table handle.
+ * @brief  Get the home slot of an entry.
+ * @param  self    The table.
+ * @param  slot    The entry.
+ * @retval The slot index.
  */
-xhal_htable_t *xhtable_new(uint32_t capacity)
+static uint32_t _home(const xoatable_t *self, const void *slot)
+{
+    return ((const xhal_htable_data_t *)slot)->hash & (self->capacity - 1U);
+}
+
+static const xoatable_ops_t _ops = {
+    .slot_size   = sizeof(xhal_htable_data_t),
+    .data_offset = offsetof(xhal_htable_data_t, data),
+    .home        = _home,
+};
+
+/**
+ * @brief  Find the slot of a key.
+ * @param  self    The hash table handle.
+ * @param  name    The key.
+ * @param  hash    The hash of the key.
+ * @retval The slot index, -1 if the key is absent.
+ */
+static int32_t _find(const xhal_htable_t *const self, const char *name,
+                     uint32_t hash)
 {
-    xhal_htable_t *self       = NULL;
-    xhal_htable_data_t *table = NULL;
+    const xhal_htable_data_t *table = self->base.table;
+    uint32_t mask                   = self->base.capacity - 1U;
+    uint32_t i                      = hash & mask;
+
+    for (uint32_t n = 0; n <= mask; n++)
+    {
+        const xhal_htable_data_t *slot = &table[i];
 
-    self = xmalloc(sizeof(xhal_htable_t));
-    xassert(self != NULL);
+        if (slot->data == NULL)
+            break;
+
+        if (slot->hash == hash && slot->data != XOATABLE_TOMBSTONE &&
+            (slot->key == name || strcmp(slot->key, name) == 0))
+            return (int32_t)i;
+
+        i = (i + 1U) & mask;
+    }
+
+    return -1;
+}
 
-    table = xmalloc(sizeof(xhal_htable_data_t) * capacity);
-    xassert(table != NULL);
+/**
+ * @brief  Newly create one hash table that grows as entries are added.
+ * @param  capacity    The expected entry count.
+ * @retval The hash table handle, NULL if out of memory.
+ */
+xhal_htable_t *xhtable_new(uint32_t capacity)
+{
+    xhal_htable_t *self = xmalloc(sizeof(xhal_htable_t));
+    if (self == NULL)
+        return NULL;
 
-    xhtable_init(self, table, capacity);
+    if (xoatable_init_heap(&self->base, &_ops, capacity) != XHAL_OK)
+    {
+        xfree(self);
+        return NULL;
+    }
 
     return self;
 }
@@ -40,83 +89,63 @@ xhal_htable_t *xhtable_new(uint32_t capacity)
 void xhtable_destroy(xhal_htable_t *const self)
 {
     xassert_not_null(self);
+    xassert(self->base.flags & XHTABLE_FLAG_HEAP);
 
-    xfree(self->table);
-    self->table = NULL;
+    xoatable_deinit(&self->base);
     xfree(self);
 }
 
 /**
- * @brief  Initialize one hash table in the static mode.
- * @param  self          The hash table handle.
- * @param  data        The hash table data.
- * @param  capacity    The hash table capacity.
- * @retval None.
+ * @brief  Initialize one hash table in the static mode. A static table
+ * never grows and holds at most XHTABLE_LOAD_MAX percent of its capacity.
+ * @param  self        The hash table handle.
+ * @param  table       The slots.
+ * @param  capacity    The slot count, a power of two.
+ * @retval See xhal_err_t.
  */
-void xhtable_init(xhal_htable_t *const self, xhal_htable_data_t *data,
-                  uint32_t capacity)
+xhal_err_t xhtable_init(xhal_htable_t *const self, xhal_htable_data_t *table,
+                        uint32_t capacity)
 {
     xassert_not_null(self);
-    xassert_not_null(data);
-
-    self->table    = data;
-    self->capacity = capacity;
-
-    for (uint32_t i = 0; i < capacity; i++)
-    {
-        self->table[i].hash_time33 = UINT32_MAX;
-        self->table[i].hash_elf    = UINT32_MAX;
-        self->table[i].hash_bkdr   = UINT32_MAX;
-        self->table[i].data        = NULL;
-    }
 
-    self->prime_max = _get_prime_max(capacity);
+    return xoatable_init(&self->base, &_ops, table, capacity);
 }
 
 /**
- * @brief  Add one data block into hash table by the given name .
- * @param  self          The hash table handle.
- * @param  name        The given key name.
+ * @brief  Add one data block into hash table by the given name. The data
+ * of an existing name is replaced.
+ * @param  self        The hash table handle.
+ * @param  name        The given key name, referenced rather than copied.
  * @param  data        The data block.
  * @retval See xhal_err_t.
  */
-xhal_err_t xhtable_add(xhal_htable_t *const self, char *name, void *data)
+xhal_err_t xhtable_add(xhal_htable_t *const self, const char *name,
+                       void *data)
 {
     xassert_not_null(self);
     xassert_not_null(name);
     xassert_not_null(data);
 
-    uint32_t hash_time33 = _hash_time33(name);
-    uint32_t hash_elf    = _hash_elf(name);
-    uint32_t hash_bkdr   = _hash_bkdr(name);
+    xhal_htable_data_t entry = {
+        .key  = name,
+        .data = data,
+        .hash = xhtable_hash(name),
+    };
 
-    uint32_t index_start = hash_time33 % self->prime_max;
-    uint32_t index;
-    uint32_t times_count = 0;
-    for (uint32_t i = 0; i < self->capacity; i++)
+    int32_t index = _find(self, name, entry.hash);
+    if (index >= 0)
     {
-        index = (index_start + i) % self->capacity;
-        if (self->table[index].data == NULL)
-        {
-            self->table[index].data        = data;
-            self->table[index].hash_time33 = hash_time33;
-            self->table[index].hash_elf    = hash_elf;
-            self->table[index].hash_bkdr   = hash_bkdr;
-            return XHAL_OK;
-        }
-        else
-        {
-            times_count++;
-            if (times_count > XHASH_SEEK_TIMES_MAX)
-            {
-                break;
-            }
-        }
+        ((xhal_htable_data_t *)self->base.table)[index].data = data;
+        return XHAL_OK;
     }
+
+    xhal_err_t ret = xoatable_insert(&self->base, &entry);
 #ifdef XDEBUG
-    XLOG_ERROR("XHAL_ERR_FULL");
+    if (ret != XHAL_OK)
+        XLOG_ERROR("Add %s failed: %d", name, ret);
 #endif
-    return XHAL_ERR_FULL;
+
+    return ret;
 }
 
 /**
@@ -125,45 +154,35 @@ xhal_err_t xhtable_add(xhal_htable_t *const self, char *name, void *data)
  * @param  name        The given key name.
  * @retval See xhal_err_t.
  */
-xhal_err_t xhtable_remove(xhal_htable_t *const self, char *name)
+xhal_err_t xhtable_remove(xhal_htable_t *const self, const char *name)
 {
     xassert_not_null(self);
     xassert_not_null(name);
 
-    int32_t ret = xhtable_index(self, name);
+    int32_t index = _find(self, name, xhtable_hash(name));
+    if (index < 0)
+        return XHAL_ERR_NOT_FOUND;
 
-    if (ret != (int32_t)XHAL_ERROR)
-    {
-        self->table[ret].data = NULL;
-        return XHAL_OK;
-    }
-#ifdef XDEBUG
-    XLOG_ERROR("XHAL_ERROR");
-#endif
-    return XHAL_ERROR;
+    xoatable_remove_at(&self->base, (uint32_t)index);
+
+    return XHAL_OK;
 }
 
 /**
  * @brief  Get the data block from hash table by the given name .
  * @param  self          The hash table handle.
  * @param  name        The given key name.
- * @retval The data block pointer.
+ * @retval The data block pointer, NULL if absent.
  */
-void *xhtable_get(xhal_htable_t *const self, char *name)
+void *xhtable_get(xhal_htable_t *const self, const char *name)
 {
     xassert_not_null(self);
     xassert_not_null(name);
 
-    int32_t ret = xhtable_index(self, name);
+    int32_t index = _find(self, name, xhtable_hash(name));
 
-    if (ret != (int32_t)XHAL_ERROR)
-    {
-        return self->table[ret].data;
-    }
-#ifdef XDEBUG
-    XLOG_ERROR("XHAL_ERROR");
-#endif
-    return NULL;
+    return index < 0 ? NULL
+                     : ((xhal_htable_data_t *)self->base.table)[index].data;
 }
 
 /**
@@ -173,155 +192,73 @@ void *xhtable_get(xhal_htable_t *const self, char *name)
  * @param  name        The given key name.
  * @retval True or false.
  */
-uint8_t xhtable_existent(xhal_htable_t *const self, char *name)
+uint8_t xhtable_existent(xhal_htable_t *const self, const char *name)
 {
     xassert_not_null(self);
     xassert_not_null(name);
 
-    return (xhtable_index(self, name) == (int32_t)XHAL_ERROR) ? false : true;
+    return _find(self, name, xhtable_hash(name)) < 0 ? false : true;
 }
 
 /**
  * @brief  Get the data block's index from hash table by the given name.
+ * The index is valid until the next add or remove.
  * @param  self          The hash table handle.
  * @param  name        The given key name.
- * @retval The data block pointer.
+ * @retval The slot index, XHAL_ERROR if absent.
  */
-int32_t xhtable_index(xhal_htable_t *const self, char *name)
+int32_t xhtable_index(xhal_htable_t *const self, const char *name)
 {
     xassert_not_null(self);
     xassert_not_null(name);
 
-    uint32_t hash_time33 = _hash_time33(name);
-    uint32_t hash_elf    = _hash_elf(name);
-    uint32_t hash_bkdr   = _hash_bkdr(name);
-
-    uint32_t index_start = hash_time33 % self->prime_max;
-    uint32_t index;
-    uint32_t times_count = 0;
-    for (uint32_t i = 0; i < self->capacity; i++)
-    {
-        index = (index_start + i) % self->capacity;
-        if (self->table[index].data == NULL)
-        {
-            continue;
-        }
-        else if (self->table[index].hash_time33 == hash_time33 &&
-                 self->table[index].hash_elf == hash_elf &&
-                 self->table[index].hash_bkdr == hash_bkdr)
-        {
-            return (int32_t)index;
-        }
-        else
-        {
-            times_count++;
-            if (times_count > XHASH_SEEK_TIMES_MAX)
-            {
-                break;
-            }
-        }
-    }
-#ifdef XDEBUG
-    XLOG_ERROR("XHAL_ERROR");
-#endif
-    return (int32_t)XHAL_ERROR;
-}
-
-/**
- * @brief  Get the maximum prime number in the specific range.
- * @param  capacity  The given range size.
- * @retval The maximum prime number.
- */
-static uint32_t _get_prime_max(uint32_t capacity)
-{
-    uint32_t prime_max = 0;
-
-    for (int64_t i = capacity; i > 0; i--)
-    {
-        uint8_t is_prime = true;
-        for (uint32_t j = 2; j < capacity; j++)
-        {
-            if (i <= j)
-            {
-                break;
-            }
-            if ((i % j) == 0)
-            {
-                is_prime = false;
-                break;
-            }
-        }
-        if (is_prime)
-        {
-            prime_max = i;
-            break;
-        }
-    }
+    int32_t index = _find(self, name, xhtable_hash(name));
 
-    return prime_max;
+    return index < 0 ? (int32_t)XHAL_ERROR : index;
 }
 
 /**
- * @brief  Calculate the time33 hash value of one string.
- * @param  str  The input string.
- * @retval The time33 hash value.
+ * @brief  Get the live entry count.
+ * @param  self          The hash table handle.
+ * @retval Entry count.
  */
-static uint32_t _hash_time33(char *str)
+uint32_t xhtable_count(const xhal_htable_t *const self)
 {
-    xassert_not_null(str);
-
-    uint32_t hash = 5381;
-
-    while (*str)
-    {
-        /* hash *= 33 */
-        hash = (*str++) + (hash << 5) + hash;
-    }
+    xassert_not_null(self);
 
-    return hash;
+    return self->base.count;
 }
 
 /**
- * @brief  Calculate the ELF hash value of one string.
- * @param  str  The input string.
- * @retval The ELF hash value.
+ * @brief  Get the table statistics. The probe figures walk the whole table.
+ * @param  self    The hash table handle.
+ * @param  stats   The statistics output.
+ * @retval None.
  */
-uint32_t _hash_elf(char *str)
+void xhtable_get_stats(const xhal_htable_t *const self,
+                       xhal_htable_stats_t *stats)
 {
-    xassert_not_null(str);
-
-    uint32_t hash = 0;
-    uint32_t x    = 0;
-
-    while (*str)
-    {
-        hash = (hash << 4) + (*str++);
-        if ((x = hash & 0xF0000000L) != 0)
-        {
-            hash ^= (x >> 24);
-            hash &= ~x;
-        }
-    }
+    xassert_not_null(self);
 
-    return (hash & 0x7FFFFFFF);
+    xoatable_get_stats(&self->base, stats);
 }
 
 /**
- * @brief  Calculate the BKDR hash value of one string.
+ * @brief  Calculate the hash value of one string (32-bit FNV-1a).
  * @param  str  The input string.
- * @retval The BKDR hash value.
+ * @retval The hash value.
  */
-uint32_t _hash_bkdr(char *str)
+uint32_t xhtable_hash(const char *str)
 {
     xassert_not_null(str);
 
-    uint32_t seed = 131; /* 31 131 1313 13131 131313 etc.. */
-    uint32_t hash = 0;
+    uint32_t hash = 2166136261U;
 
     while (*str)
     {
-        hash = hash * seed + (*str++);
+        hash ^= (uint8_t)*str++;
+        hash *= 16777619U;
     }
 
-    return (hash & 0x7FFFFFFF);
+    return hash;
 }
@@ -3,32 +3,44 @@
 
 #include "../xcore/xhal_def.h"
 #include "../xcore/xhal_std.h"
+#include "xhal_oatable.h"
 
-#define XHASH_SEEK_TIMES_MAX (32)
+#define XHTABLE_FLAG_HEAP     XOATABLE_FLAG_HEAP
 
+#define XHTABLE_CAPACITY_MIN  XOATABLE_CAPACITY_MIN
+
+/*
+ * One slot. `key` references the caller's string, which must stay valid and
+ * unchanged while it is in the table. The slot state lives in `data`, see
+ * xoatable_ops_t.
+ */
 typedef struct xhal_htable_data
 {
-    uint32_t hash_time33;
-    uint32_t hash_elf;
-    uint32_t hash_bkdr;
+    const char *key;
     void *data;
+    uint32_t hash; /* Cached hash of `key` */
 } xhal_htable_data_t;
 
+typedef xoatable_stats_t xhal_htable_stats_t;
+
 typedef struct hash_table
 {
-    uint32_t capacity;
-    uint32_t prime_max;
-    xhal_htable_data_t *table;
+    xoatable_t base;
 } xhal_htable_t;
 
 xhal_htable_t *xhtable_new(uint32_t capacity);
 void xhtable_destroy(xhal_htable_t *const self);
-void xhtable_init(xhal_htable_t *const self, xhal_htable_data_t *table,
-                  uint32_t capacity);
-xhal_err_t xhtable_add(xhal_htable_t *const self, char *name, void *data);
-xhal_err_t xhtable_remove(xhal_htable_t *const self, char *name);
-void *xhtable_get(xhal_htable_t *const self, char *name);
-uint8_t xhtable_existent(xhal_htable_t *const self, char *name);
-int32_t xhtable_index(xhal_htable_t *const self, char *name);
+xhal_err_t xhtable_init(xhal_htable_t *const self, xhal_htable_data_t *table,
+                        uint32_t capacity);
+xhal_err_t xhtable_add(xhal_htable_t *const self, const char *name,
+                       void *data);
+xhal_err_t xhtable_remove(xhal_htable_t *const self, const char *name);
+void *xhtable_get(xhal_htable_t *const self, const char *name);
+uint8_t xhtable_existent(xhal_htable_t *const self, const char *name);
+int32_t xhtable_index(xhal_htable_t *const self, const char *name);
+uint32_t xhtable_count(const xhal_htable_t *const self);
+void xhtable_get_stats(const xhal_htable_t *const self,
+                       xhal_htable_stats_t *stats);
+uint32_t xhtable_hash(const char *str);
 
 #endif /* __XHAL_HTABLE_H */
@@ -0,0 +1,228 @@
+#include "xhal_itable.h"
+#include "../xcore/xhal_assert.h"
+#include "../xcore/xhal_log.h"
+#include "../xcore/xhal_malloc.h"
+
+XLOG_TAG("xIntTable");
+
+/*
+ * Open addressing with linear probing, see xhal_oatable.c for the load,
+ * tombstone and rehash rules. The home slot comes from a multiplicative
+ * (Fibonacci) hash: the key times 2^32 / phi, of which the top
+ * log2(capacity) bits are kept. Sequential IDs therefore spread over the
+ * whole table.
+ */
+
+/**
+ * @brief  Get the home slot of a key.
+ * @param  key     The key.
+ * @param  bits    log2(capacity).
+ * @retval The slot index.
+ */
+static inline uint32_t _hash(uint32_t key, uint8_t bits)
+{
+    return (uint32_t)(key * 0x9E3779B9U) >> (32U - bits);
+}
+
+/**
+ * @brief  Get the home slot of an entry.
+ * @param  self    The table.
+ * @param  slot    The entry.
+ * @retval The slot index.
+ */
+static uint32_t _home(const xoatable_t *self, const void *slot)
+{
+    return _hash(((const xhal_itable_data_t *)slot)->key, self->bits);
+}
+
+static const xoatable_ops_t _ops = {
+    .slot_size   = sizeof(xhal_itable_data_t),
+    .data_offset = offsetof(xhal_itable_data_t, data),
+    .home        = _home,
+};
+
+/**
+ * @brief  Find the slot of a key.
+ * @param  self    The table handle.
+ * @param  key     The key.
+ * @retval The slot index, -1 if the key is absent.
+ */
+static int32_t _find(const xhal_itable_t *const self, uint32_t key)
+{
+    const xhal_itable_data_t *table = self->base.table;
+    uint32_t mask                   = self->base.capacity - 1U;
+    uint32_t i                      = _hash(key, self->base.bits);
+
+    for (uint32_t n = 0; n <= mask; n++)
+    {
+        const xhal_itable_data_t *slot = &table[i];
+
+        if (slot->data == NULL)
+            break;
+
+        if (slot->key == key && slot->data != XOATABLE_TOMBSTONE)
+            return (int32_t)i;
+
+        i = (i + 1U) & mask;
+    }
+
+    return -1;
+}
+
+/**
+ * @brief  Newly create one table that grows as entries are added.
+ * @param  capacity    The expected entry count.
+ * @retval The table handle, NULL if out of memory.
+ */
+xhal_itable_t *xitable_new(uint32_t capacity)
+{
+    xhal_itable_t *self = xmalloc(sizeof(xhal_itable_t));
+    if (self == NULL)
+        return NULL;
+
+    if (xoatable_init_heap(&self->base, &_ops, capacity) != XHAL_OK)
+    {
+        xfree(self);
+        return NULL;
+    }
+
+    return self;
+}
+
+/**
+ * @brief  Destroy the table which is generated by the function xitable_new.
+ * @param  self    The table handle.
+ * @retval None.
+ */
+void xitable_destroy(xhal_itable_t *const self)
+{
+    xassert_not_null(self);
+    xassert(self->base.flags & XITABLE_FLAG_HEAP);
+
+    xoatable_deinit(&self->base);
+    xfree(self);
+}
+
+/**
+ * @brief  Initialize one table in the static mode. A static table never
+ * grows and holds at most XHTABLE_LOAD_MAX percent of its capacity.
+ * @param  self        The table handle.
+ * @param  table       The slots.
+ * @param  capacity    The slot count, a power of two.
+ * @retval See xhal_err_t.
+ */
+xhal_err_t xitable_init(xhal_itable_t *const self, xhal_itable_data_t *table,
+                        uint32_t capacity)
+{
+    xassert_not_null(self);
+
+    return xoatable_init(&self->base, &_ops, table, capacity);
+}
+
+/**
+ * @brief  Add one data block by the given key. The data of an existing key
+ * is replaced.
+ * @param  self    The table handle.
+ * @param  key     The key.
+ * @param  data    The data block, not NULL.
+ * @retval See xhal_err_t.
+ */
+xhal_err_t xitable_add(xhal_itable_t *const self, uint32_t key, void *data)
+{
+    xassert_not_null(self);
+    xassert_not_null(data);
+
+    int32_t index = _find(self, key);
+    if (index >= 0)
+    {
+        ((xhal_itable_data_t *)self->base.table)[index].data = data;
+        return XHAL_OK;
+    }
+
+    xhal_itable_data_t entry = {
+        .key  = key,
+        .data = data,
+    };
+
+    xhal_err_t ret = xoatable_insert(&self->base, &entry);
+#ifdef XDEBUG
+    if (ret != XHAL_OK)
+        XLOG_ERROR("Add %lu failed: %d", (unsigned long)key, ret);
+#endif
+
+    return ret;
+}
+
+/**
+ * @brief  Remove one data block by the given key.
+ * @param  self    The table handle.
+ * @param  key     The key.
+ * @retval See xhal_err_t.
+ */
+xhal_err_t xitable_remove(xhal_itable_t *const self, uint32_t key)
+{
+    xassert_not_null(self);
+
+    int32_t index = _find(self, key);
+    if (index < 0)
+        return XHAL_ERR_NOT_FOUND;
+
+    xoatable_remove_at(&self->base, (uint32_t)index);
+
+    return XHAL_OK;
+}
+
+/**
+ * @brief  Get the data block by the given key.
+ * @param  self    The table handle.
+ * @param  key     The key.
+ * @retval The data block pointer, NULL if absent.
+ */
+void *xitable_get(xhal_itable_t *const self, uint32_t key)
+{
+    xassert_not_null(self);
+
+    int32_t index = _find(self, key);
+
+    return index < 0 ? NULL
+                     : ((xhal_itable_data_t *)self->base.table)[index].data;
+}
+
+/**
+ * @brief  Check whether the key is in the table.
+ * @param  self    The table handle.
+ * @param  key     The key.
+ * @retval True or false.
+ */
+uint8_t xitable_existent(xhal_itable_t *const self, uint32_t key)
+{
+    xassert_not_null(self);
+
+    return _find(self, key) < 0 ? false : true;
+}
+
+/**
+ * @brief  Get the live entry count.
+ * @param  self    The table handle.
+ * @retval Entry count.
+ */
+uint32_t xitable_count(const xhal_itable_t *const self)
+{
+    xassert_not_null(self);
+
+    return self->base.count;
+}
+
+/**
+ * @brief  Get the table statistics. The probe figures walk the whole table.
+ * @param  self    The table handle.
+ * @param  stats   The statistics output.
+ * @retval None.
+ */
+void xitable_get_stats(const xhal_itable_t *const self,
+                       xhal_itable_stats_t *stats)
+{
+    xassert_not_null(self);
+
+    xoatable_get_stats(&self->base, stats);
+}
@@ -0,0 +1,41 @@
+#ifndef __XHAL_ITABLE_H
+#define __XHAL_ITABLE_H
+
+#include "../xcore/xhal_def.h"
+#include "../xcore/xhal_std.h"
+#include "xhal_oatable.h"
+
+#define XITABLE_FLAG_HEAP     XOATABLE_FLAG_HEAP
+
+#define XITABLE_CAPACITY_MIN  XOATABLE_CAPACITY_MIN
+
+/*
+ * One slot of the integer-keyed table. Every key value is valid; the slot
+ * state lives in `data`, see xoatable_ops_t.
+ */
+typedef struct xhal_itable_data
+{
+    uint32_t key;
+    void *data;
+} xhal_itable_data_t;
+
+typedef xoatable_stats_t xhal_itable_stats_t;
+
+typedef struct xhal_itable
+{
+    xoatable_t base;
+} xhal_itable_t;
+
+xhal_itable_t *xitable_new(uint32_t capacity);
+void xitable_destroy(xhal_itable_t *const self);
+xhal_err_t xitable_init(xhal_itable_t *const self, xhal_itable_data_t *table,
+                        uint32_t capacity);
+xhal_err_t xitable_add(xhal_itable_t *const self, uint32_t key, void *data);
+xhal_err_t xitable_remove(xhal_itable_t *const self, uint32_t key);
+void *xitable_get(xhal_itable_t *const self, uint32_t key);
+uint8_t xitable_existent(xhal_itable_t *const self, uint32_t key);
+uint32_t xitable_count(const xhal_itable_t *const self);
+void xitable_get_stats(const xhal_itable_t *const self,
+                       xhal_itable_stats_t *stats);
+
+#endif /* __XHAL_ITABLE_H */
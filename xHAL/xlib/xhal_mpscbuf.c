@@ -0,0 +1,432 @@
+#include "xhal_mpscbuf.h"
+#include "../xcore/xhal_assert.h"
+#include "../xcore/xhal_log.h"
+#include "../xcore/xhal_malloc.h"
+
+XLOG_TAG("xMpscBuf");
+
+/*
+ * `state` holds the reserve head in its low 24 bits and the count of
+ * writers between reserve and commit in its top 8 bits. A writer reserves
+ * by bumping both in one compare-and-swap, and commits by decrementing the
+ * count. Whoever drops the count to zero copies the head into `commit`,
+ * which the consumer reads. A writer therefore never waits for another: an
+ * interrupt that preempts a thread mid-write commits at once, and its bytes
+ * become visible when the thread commits too.
+ *
+ * On a single core a compare-and-swap only fails when a higher-priority
+ * context updated `state` in between, so an interrupt retries at most once
+ * per nesting level; xmpsc_reserve_isr also caps the attempts outright.
+ */
+
+#define WRITER_ONE       (1UL << XMPSC_POS_BITS)
+#define STATE_POS(s)     ((s) & XMPSC_POS_MASK)
+#define STATE_WRITERS(s) ((s) >> XMPSC_POS_BITS)
+#define POS_DIFF(a, b)   (((a) - (b)) & XMPSC_POS_MASK)
+
+#ifndef XMPSC_DISABLE_ATOMIC
+#define LOAD(var, order)        atomic_load_explicit(&(var), (order))
+#define STORE(var, val, order)  atomic_store_explicit(&(var), (val), (order))
+#define CAS(var, exp, val, order)                                        \
+    atomic_compare_exchange_weak_explicit(&(var), (exp), (val), (order), \
+                                          memory_order_relaxed)
+#define ADD(var, val)                                                    \
+    (void)atomic_fetch_add_explicit(&(var), (val), memory_order_relaxed)
+#define ATOMIC_INIT(var, val)   atomic_init(&(var), (val))
+#else
+/* Interrupt masking that stands in for the atomic read-modify-writes. */
+#ifndef XMPSC_IRQ_DISABLE
+#include XHAL_DEVICE_HEADER
+
+static inline uint32_t _xmpsc_irq_disable(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    return primask;
+}
+
+#define XMPSC_IRQ_DISABLE()         _xmpsc_irq_disable()
+#define XMPSC_IRQ_RESTORE(primask)  __set_PRIMASK(primask)
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define XMPSC_BARRIER() __asm__ volatile("" ::: "memory")
+#elif defined(__CC_ARM)
+#define XMPSC_BARRIER() __schedule_barrier()
+#else
+#define XMPSC_BARRIER()
+#endif
+
+static inline uint32_t _load(xmpsc_atomic_t *var)
+{
+    uint32_t val = *var;
+    XMPSC_BARRIER();
+    return val;
+}
+
+static inline void _store(xmpsc_atomic_t *var, uint32_t val)
+{
+    XMPSC_BARRIER();
+    *var = val;
+}
+
+static inline uint8_t _cas(xmpsc_atomic_t *var, uint32_t *exp, uint32_t val)
+{
+    uint8_t ok;
+    uint32_t primask = XMPSC_IRQ_DISABLE();
+
+    ok = (*var == *exp);
+    if (ok)
+        *var = val;
+    else
+        *exp = *var;
+
+    XMPSC_IRQ_RESTORE(primask);
+    return ok;
+}
+
+static inline void _add(xmpsc_atomic_t *var, uint32_t val)
+{
+    uint32_t primask = XMPSC_IRQ_DISABLE();
+    *var += val;
+    XMPSC_IRQ_RESTORE(primask);
+}
+
+#define LOAD(var, order)          _load(&(var))
+#define STORE(var, val, order)    _store(&(var), (val))
+#define CAS(var, exp, val, order) _cas(&(var), (exp), (val))
+#define ADD(var, val)             _add(&(var), (val))
+#define ATOMIC_INIT(var, val)     ((var) = (val))
+#endif
+
+/**
+ * @brief  Describe `len` bytes starting at `pos` as at most two segments.
+ * @param  self    The ring handle.
+ * @param  pos     Free-running start position.
+ * @param  len     Byte count, at most the ring size.
+ * @param  seg     The segments output, unused ones are NULL/0.
+ * @retval None.
+ */
+static void _fill_seg(const xmpsc_t *const self, uint32_t pos, uint32_t len,
+                      xrbuf_seg_t *seg)
+{
+    uint32_t off   = pos & (self->size - 1U);
+    uint32_t first = XHAL_MIN(len, self->size - off);
+
+    seg->ptr[0] = self->buff + off;
+    seg->len[0] = first;
+    seg->ptr[1] = (len > first) ? self->buff : NULL;
+    seg->len[1] = len - first;
+}
+
+/**
+ * @brief  Claim `len` bytes for the calling writer.
+ * @param  self    The ring handle.
+ * @param  len     Byte count.
+ * @param  seg     The segments output.
+ * @param  tries   Compare-and-swap attempts allowed, 0 for unlimited.
+ * @retval `len` on success, 0 if there is no room or the attempts ran out.
+ */
+static uint32_t _reserve(xmpsc_t *const self, uint32_t len, xrbuf_seg_t *seg,
+                         uint32_t tries)
+{
+    xassert_not_null(self);
+    xassert_not_null(seg);
+    xassert(len > 0);
+
+    uint32_t state = LOAD(self->state, memory_order_relaxed);
+    uint32_t head;
+
+    for (;;)
+    {
+        head = STATE_POS(state);
+
+        /* Acquire the tail so the consumer is done with the space reused */
+        uint32_t tail = LOAD(self->tail, memory_order_acquire);
+        if (len > self->size - POS_DIFF(head, tail) ||
+            STATE_WRITERS(state) == XMPSC_WRITER_MAX)
+            break;
+
+        uint32_t next = (state + WRITER_ONE) & ~XMPSC_POS_MASK;
+        next |= (head + len) & XMPSC_POS_MASK;
+        if (CAS(self->state, &state, next, memory_order_relaxed))
+        {
+            _fill_seg(self, head, len, seg);
+            return len;
+        }
+
+        ADD(self->retry_count, 1U);
+        if (tries != 0 && --tries == 0)
+            break;
+    }
+
+    ADD(self->drop_count, 1U);
+    seg->ptr[0] = seg->ptr[1] = NULL;
+    seg->len[0] = seg->len[1] = 0;
+
+    return 0;
+}
+
+/**
+ * @brief  Initialize one ring on the given storage.
+ * @param  self    The ring handle.
+ * @param  buff    Storage of `size` bytes.
+ * @param  size    A power of two, at most XMPSC_SIZE_MAX. All of it is
+ *                 usable.
+ * @retval See xhal_err_t.
+ */
+xhal_err_t xmpsc_init(xmpsc_t *const self, void *buff, uint32_t size)
+{
+    xassert_not_null(self);
+    xassert_not_null(buff);
+
+    if (size < 2 || size > XMPSC_SIZE_MAX || (size & (size - 1U)) != 0)
+        return XHAL_ERR_INVALID;
+
+    self->buff = (uint8_t *)buff;
+    self->size = size;
+    ATOMIC_INIT(self->state, 0);
+    ATOMIC_INIT(self->commit, 0);
+    ATOMIC_INIT(self->tail, 0);
+    ATOMIC_INIT(self->drop_count, 0);
+    ATOMIC_INIT(self->retry_count, 0);
+
+    return XHAL_OK;
+}
+
+/**
+ * @brief  Check whether the ring is initialized.
+ * @param  self    The ring handle.
+ * @retval 1 if ready, otherwise 0.
+ */
+uint8_t xmpsc_is_ready(const xmpsc_t *const self)
+{
+    xassert_not_null(self);
+
+    return self->buff != NULL && self->size > 0;
+}
+
+/**
+ * @brief  Reserve `len` contiguous stream bytes for the calling writer.
+ * The space may wrap, so it is returned as up to two segments. Every
+ * successful reserve must be followed by exactly one xmpsc_commit from
+ * the same context, after the whole space has been filled.
+ * @param  self    The ring handle.
+ * @param  len     Byte count, greater than 0.
+ * @param  seg     The segments output.
+ * @retval `len` on success, 0 if there is no room.
+ */
+uint32_t xmpsc_reserve(xmpsc_t *const self, uint32_t len, xrbuf_seg_t *seg)
+{
+    return _reserve(self, len, seg, 0);
+}
+
+/**
+ * @brief  Reserve like xmpsc_reserve, but give up after
+ * XMPSC_ISR_RETRY_MAX lost races so the call time is bounded.
+ * @param  self    The ring handle.
+ * @param  len     Byte count, greater than 0.
+ * @param  seg     The segments output.
+ * @retval `len` on success, 0 if there is no room or the attempts ran out.
+ */
+uint32_t xmpsc_reserve_isr(xmpsc_t *const self, uint32_t len,
+                           xrbuf_seg_t *seg)
+{
+    return _reserve(self, len, seg, XMPSC_ISR_RETRY_MAX);
+}
+
+/**
+ * @brief  Finish the calling writer's reservation. The bytes become
+ * visible once every writer that reserved earlier has committed too.
+ * @param  self    The ring handle.
+ * @retval None.
+ */
+void xmpsc_commit(xmpsc_t *const self)
+{
+    xassert_not_null(self);
+
+    uint32_t state = LOAD(self->state, memory_order_relaxed);
+    uint32_t next;
+
+    /* Release our data and acquire that of writers committed before */
+    do
+    {
+        xassert(STATE_WRITERS(state) > 0);
+        next = state - WRITER_ONE;
+    } while (!CAS(self->state, &state, next, memory_order_acq_rel));
+
+    if (STATE_WRITERS(next) != 0)
+        return;
+
+    /*
+     * Publish the head. A later writer may have published a newer head in
+     * the meantime, so only ever move `commit` forward.
+     */
+    uint32_t head   = STATE_POS(next);
+    uint32_t commit = LOAD(self->commit, memory_order_relaxed);
+    while (POS_DIFF(head, commit) != 0 &&
+           POS_DIFF(head, commit) <= self->size)
+    {
+        if (CAS(self->commit, &commit, head, memory_order_release))
+            break;
+    }
+}
+
+/**
+ * @brief  Copy `len` bytes into the ring as one unit.
+ * @param  self    The ring handle.
+ * @param  data    The bytes to write.
+ * @param  len     Byte count.
+ * @retval `len` on success, 0 if there is no room.
+ */
+uint32_t xmpsc_write(xmpsc_t *const self, const void *data, uint32_t len)
+{
+    xrbuf_seg_t seg;
+
+    xassert(data != NULL || len == 0);
+
+    if (len == 0 || xmpsc_reserve(self, len, &seg) == 0)
+        return 0;
+
+    xmemcpy(seg.ptr[0], data, seg.len[0]);
+    if (seg.len[1] > 0)
+        xmemcpy(seg.ptr[1], (const uint8_t *)data + seg.len[0], seg.len[1]);
+    xmpsc_commit(self);
+
+    return len;
+}
+
+/**
+ * @brief  Copy `len` bytes into the ring from an interrupt, with bounded
+ * retries. See xmpsc_reserve_isr.
+ * @param  self    The ring handle.
+ * @param  data    The bytes to write.
+ * @param  len     Byte count.
+ * @retval `len` on success, otherwise 0.
+ */
+uint32_t xmpsc_write_isr(xmpsc_t *const self, const void *data, uint32_t len)
+{
+    xrbuf_seg_t seg;
+
+    xassert(data != NULL || len == 0);
+
+    if (len == 0 || xmpsc_reserve_isr(self, len, &seg) == 0)
+        return 0;
+
+    xmemcpy(seg.ptr[0], data, seg.len[0]);
+    if (seg.len[1] > 0)
+        xmemcpy(seg.ptr[1], (const uint8_t *)data + seg.len[0], seg.len[1]);
+    xmpsc_commit(self);
+
+    return len;
+}
+
+/**
+ * @brief  Get up to `btp` committed bytes in place, without removing them.
+ * @param  self    The ring handle.
+ * @param  btp     Maximum byte count.
+ * @param  seg     The segments output, unused ones are NULL/0.
+ * @retval Byte count described by `seg`.
+ */
+uint32_t xmpsc_peek_seg(xmpsc_t *const self, uint32_t btp, xrbuf_seg_t *seg)
+{
+    xassert_not_null(self);
+    xassert_not_null(seg);
+
+    uint32_t tail   = LOAD(self->tail, memory_order_relaxed);
+    uint32_t commit = LOAD(self->commit, memory_order_acquire);
+    uint32_t len    = XHAL_MIN(btp, POS_DIFF(commit, tail));
+
+    _fill_seg(self, tail, len, seg);
+
+    return len;
+}
+
+/**
+ * @brief  Remove `len` bytes after they have been consumed in place.
+ * @param  self    The ring handle.
+ * @param  len     Byte count, at most what xmpsc_peek_seg returned.
+ * @retval None.
+ */
+void xmpsc_release(xmpsc_t *const self, uint32_t len)
+{
+    xassert_not_null(self);
+
+    uint32_t tail   = LOAD(self->tail, memory_order_relaxed);
+    uint32_t commit = LOAD(self->commit, memory_order_relaxed);
+
+    len = XHAL_MIN(len, POS_DIFF(commit, tail));
+    STORE(self->tail, (tail + len) & XMPSC_POS_MASK, memory_order_release);
+}
+
+/**
+ * @brief  Copy out and remove up to `len` committed bytes.
+ * @param  self    The ring handle.
+ * @param  data    The output.
+ * @param  len     Capacity of `data` in bytes.
+ * @retval Byte count read.
+ */
+uint32_t xmpsc_read(xmpsc_t *const self, void *data, uint32_t len)
+{
+    xrbuf_seg_t seg;
+
+    xassert(data != NULL || len == 0);
+
+    uint32_t n = xmpsc_peek_seg(self, len, &seg);
+    if (n == 0)
+        return 0;
+
+    xmemcpy(data, seg.ptr[0], seg.len[0]);
+    if (seg.len[1] > 0)
+        xmemcpy((uint8_t *)data + seg.len[0], seg.ptr[1], seg.len[1]);
+    xmpsc_release(self, n);
+
+    return n;
+}
+
+/**
+ * @brief  Get the count of committed bytes waiting for the consumer.
+ * @param  self    The ring handle.
+ * @retval Byte count.
+ */
+uint32_t xmpsc_get_full(xmpsc_t *const self)
+{
+    xassert_not_null(self);
+
+    uint32_t tail   = LOAD(self->tail, memory_order_acquire);
+    uint32_t commit = LOAD(self->commit, memory_order_acquire);
+
+    return POS_DIFF(commit, tail);
+}
+
+/**
+ * @brief  Get the count of bytes a writer could reserve now.
+ * @param  self    The ring handle.
+ * @retval Byte count.
+ */
+uint32_t xmpsc_get_free(xmpsc_t *const self)
+{
+    xassert_not_null(self);
+
+    uint32_t state = LOAD(self->state, memory_order_relaxed);
+    uint32_t tail  = LOAD(self->tail, memory_order_acquire);
+
+    return self->size - POS_DIFF(STATE_POS(state), tail);
+}
+
+/**
+ * @brief  Get the ring statistics.
+ * @param  self    The ring handle.
+ * @param  stats   The statistics output.
+ * @retval None.
+ */
+void xmpsc_get_stats(xmpsc_t *const self, xmpsc_stats_t *stats)
+{
+    xassert_not_null(self);
+    xassert_not_null(stats);
+
+    stats->size        = self->size;
+    stats->used        = self->size - xmpsc_get_free(self);
+    stats->drop_count  = LOAD(self->drop_count, memory_order_relaxed);
+    stats->retry_count = LOAD(self->retry_count, memory_order_relaxed);
+}
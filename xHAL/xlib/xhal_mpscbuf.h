@@ -0,0 +1,80 @@
+#ifndef __XHAL_MPSCBUF_H
+#define __XHAL_MPSCBUF_H
+
+#include "../xcore/xhal_def.h"
+#include "../xcore/xhal_std.h"
+#include "xhal_ringbuf.h"
+
+/*
+ * Multi-producer, single-consumer byte ring.
+ *
+ * Writers claim space with a compare-and-swap on a word that packs the
+ * reserve head with the count of writers still filling their space. The
+ * last writer to commit publishes everything reserved so far, so the
+ * consumer always sees whole reservations in the order they were made.
+ * Without C11 atomics every atomic step runs with interrupts masked.
+ */
+#if !defined(XMPSC_DISABLE_ATOMIC) &&                                         \
+    (!defined(__STDC_VERSION__) || __STDC_VERSION__ < 201112L ||              \
+     defined(__STDC_NO_ATOMICS__))
+#define XMPSC_DISABLE_ATOMIC
+#endif
+
+#ifndef XMPSC_DISABLE_ATOMIC
+#include <stdatomic.h>
+typedef atomic_uint xmpsc_atomic_t;
+#else
+typedef volatile uint32_t xmpsc_atomic_t;
+#endif
+
+/* Attempts xmpsc_reserve_isr makes before giving up. */
+#ifndef XMPSC_ISR_RETRY_MAX
+#define XMPSC_ISR_RETRY_MAX (4)
+#endif
+
+/* Positions run freely modulo 2^24; the top 8 bits count active writers. */
+#define XMPSC_POS_BITS   (24U)
+#define XMPSC_POS_MASK   ((1UL << XMPSC_POS_BITS) - 1U)
+#define XMPSC_SIZE_MAX   (1UL << (XMPSC_POS_BITS - 1U))
+#define XMPSC_WRITER_MAX (0xFFU)
+
+typedef struct xmpsc_stats
+{
+    uint32_t size;        /* Storage size in bytes */
+    uint32_t used;        /* Bytes reserved or waiting for the consumer */
+    uint32_t drop_count;  /* Reservations refused */
+    uint32_t retry_count; /* Failed compare-and-swap attempts */
+} xmpsc_stats_t;
+
+typedef struct xmpsc
+{
+    uint8_t *buff;
+    uint32_t size;               /* Power of two, at most XMPSC_SIZE_MAX */
+    xmpsc_atomic_t state;        /* Reserve head | active writers << 24 */
+    xmpsc_atomic_t commit;       /* Published head, read by the consumer */
+    xmpsc_atomic_t tail;         /* Consumer position */
+    xmpsc_atomic_t drop_count;
+    xmpsc_atomic_t retry_count;
+} xmpsc_t;
+
+xhal_err_t xmpsc_init(xmpsc_t *const self, void *buff, uint32_t size);
+uint8_t xmpsc_is_ready(const xmpsc_t *const self);
+
+/* Producer side, any thread or interrupt */
+uint32_t xmpsc_reserve(xmpsc_t *const self, uint32_t len, xrbuf_seg_t *seg);
+uint32_t xmpsc_reserve_isr(xmpsc_t *const self, uint32_t len,
+                           xrbuf_seg_t *seg);
+void xmpsc_commit(xmpsc_t *const self);
+uint32_t xmpsc_write(xmpsc_t *const self, const void *data, uint32_t len);
+uint32_t xmpsc_write_isr(xmpsc_t *const self, const void *data, uint32_t len);
+
+/* Consumer side, one context only */
+uint32_t xmpsc_peek_seg(xmpsc_t *const self, uint32_t btp, xrbuf_seg_t *seg);
+void xmpsc_release(xmpsc_t *const self, uint32_t len);
+uint32_t xmpsc_read(xmpsc_t *const self, void *data, uint32_t len);
+
+uint32_t xmpsc_get_full(xmpsc_t *const self);
+uint32_t xmpsc_get_free(xmpsc_t *const self);
+void xmpsc_get_stats(xmpsc_t *const self, xmpsc_stats_t *stats);
+
+#endif /* __XHAL_MPSCBUF_H */
@@ -0,0 +1,372 @@
+#include "xhal_oatable.h"
+#include "../xcore/xhal_assert.h"
+#include "../xcore/xhal_log.h"
+#include "../xcore/xhal_malloc.h"
+
+XLOG_TAG("xOATable");
+
+/*
+ * Shared engine of the open-addressing tables (xhtable, xitable): linear
+ * probing over a power-of-two table, where removal leaves a tombstone that
+ * lookups step over and inserts reuse. Heap tables double once the live
+ * entries pass XHTABLE_LOAD_MAX percent; static ones refuse more. When
+ * tombstones fill half of the remaining headroom they are dropped in place,
+ * or a heap table that is over half loaded grows instead.
+ *
+ * Lookups stay with each table type so the key compare inlines; only the
+ * insert, remove, rehash and statistics paths come through here.
+ */
+
+const uint8_t xoatable_tombstone;
+
+#define SLOT_OVER_LOAD(n, cap) \
+    ((uint64_t)(n) * 100U > (uint64_t)(cap) * XHTABLE_LOAD_MAX)
+/* Tombstones may fill half the headroom left above the load limit. */
+#define SLOT_OVER_USED(n, cap) \
+    ((uint64_t)(n) * 200U > (uint64_t)(cap) * (XHTABLE_LOAD_MAX + 100U))
+
+/**
+ * @brief  Get one slot.
+ * @param  self    The table handle.
+ * @param  index   The slot index.
+ * @retval The slot.
+ */
+static inline void *_slot(const xoatable_t *const self, uint32_t index)
+{
+    return (uint8_t *)self->table + (size_t)index * self->ops->slot_size;
+}
+
+/**
+ * @brief  Get the data member of one slot.
+ * @param  self    The table handle.
+ * @param  slot    The slot.
+ * @retval The data member.
+ */
+static inline void **_data(const xoatable_t *const self, void *slot)
+{
+    return (void **)((uint8_t *)slot + self->ops->data_offset);
+}
+
+/**
+ * @brief  Check whether a slot holds a live entry.
+ * @param  self    The table handle.
+ * @param  slot    The slot.
+ * @retval True or false.
+ */
+static inline bool _is_live(const xoatable_t *const self, void *slot)
+{
+    void *data = *_data(self, slot);
+
+    return data != NULL && data != XOATABLE_TOMBSTONE;
+}
+
+/**
+ * @brief  Get log2 of a power of two.
+ * @param  capacity    A power of two.
+ * @retval log2(capacity).
+ */
+static uint8_t _bits(uint32_t capacity)
+{
+    uint8_t bits = 0;
+
+    while (capacity > 1)
+    {
+        capacity >>= 1;
+        bits++;
+    }
+
+    return bits;
+}
+
+/**
+ * @brief  Get the first slot of a probe chain that holds no live entry.
+ * @param  self    The table handle.
+ * @param  home    The home slot of the entry.
+ * @retval The slot, empty or a tombstone.
+ */
+static void *_free_slot(const xoatable_t *const self, uint32_t home)
+{
+    uint32_t mask = self->capacity - 1U;
+    uint32_t i    = home;
+
+    while (_is_live(self, _slot(self, i)))
+        i = (i + 1U) & mask;
+
+    return _slot(self, i);
+}
+
+/**
+ * @brief  Drop every tombstone and re-pack the entries without extra
+ * memory. The walk starts after a slot that was empty before, which no
+ * probe chain crosses. Each entry is lifted out and placed again from its
+ * home; everything before it in its chain is already final, so it can
+ * only move back towards home.
+ * @param  self    The table handle.
+ * @retval None.
+ */
+static void _rehash_in_place(xoatable_t *const self)
+{
+    uint32_t mask  = self->capacity - 1U;
+    uint32_t start = 0;
+    uint32_t size  = self->ops->slot_size;
+
+    for (uint32_t i = 0; i < self->capacity; i++)
+    {
+        void **data = _data(self, _slot(self, i));
+
+        if (*data == NULL)
+            start = i;
+        else if (*data == XOATABLE_TOMBSTONE)
+            *data = NULL;
+    }
+
+    for (uint32_t n = 1; n <= self->capacity; n++)
+    {
+        void *slot  = _slot(self, (start + n) & mask);
+        void **data = _data(self, slot);
+        void *keep  = *data;
+        if (keep == NULL)
+            continue;
+
+        /* Lift the entry out, it may land back in its own slot */
+        *data    = NULL;
+        void *dst = _free_slot(self, self->ops->home(self, slot));
+        if (dst != slot)
+            xmemcpy(dst, slot, size);
+        *_data(self, dst) = keep;
+    }
+
+    self->tombstones = 0;
+    self->rehashes++;
+}
+
+/**
+ * @brief  Move every entry into a new heap table.
+ * @param  self        The table handle.
+ * @param  capacity    The new slot count, a power of two.
+ * @retval See xhal_err_t.
+ */
+static xhal_err_t _resize(xoatable_t *const self, uint32_t capacity)
+{
+    uint32_t size = self->ops->slot_size;
+    xoatable_t next;
+
+    next.table = xmalloc(size * capacity);
+    if (next.table == NULL)
+        return XHAL_ERR_NO_MEMORY;
+
+    next.ops      = self->ops;
+    next.capacity = capacity;
+    next.bits     = _bits(capacity);
+
+    xmemset(next.table, 0, size * capacity);
+    for (uint32_t i = 0; i < self->capacity; i++)
+    {
+        void *slot = _slot(self, i);
+        if (_is_live(self, slot))
+            xmemcpy(_free_slot(&next, self->ops->home(&next, slot)), slot,
+                    size);
+    }
+
+    xfree(self->table);
+    self->table      = next.table;
+    self->capacity   = capacity;
+    self->bits       = next.bits;
+    self->tombstones = 0;
+    self->rehashes++;
+
+    return XHAL_OK;
+}
+
+/**
+ * @brief  Check whether the table may double.
+ * @param  self    The table handle.
+ * @retval True or false.
+ */
+static bool _can_grow(const xoatable_t *const self)
+{
+    return (self->flags & XOATABLE_FLAG_HEAP) &&
+           self->capacity <= (UINT32_MAX >> 1) / self->ops->slot_size;
+}
+
+/**
+ * @brief  Make room for one more entry within the load limit.
+ * @param  self    The table handle.
+ * @retval See xhal_err_t.
+ */
+static xhal_err_t _reserve_one(xoatable_t *const self)
+{
+    if (SLOT_OVER_LOAD(self->count + 1U, self->capacity))
+        return _can_grow(self) ? _resize(self, self->capacity * 2U)
+                               : XHAL_ERR_FULL;
+
+    if (!SLOT_OVER_USED(self->count + self->tombstones + 1U, self->capacity))
+        return XHAL_OK;
+
+    /* Heap tables more than half loaded grow rather than rehash again soon */
+    if (!_can_grow(self) ||
+        !SLOT_OVER_LOAD((self->count + 1U) * 2U, self->capacity) ||
+        _resize(self, self->capacity * 2U) != XHAL_OK)
+        _rehash_in_place(self);
+
+    return XHAL_OK;
+}
+
+/**
+ * @brief  Initialize one table in the static mode. A static table never
+ * grows and holds at most XHTABLE_LOAD_MAX percent of its capacity.
+ * @param  self        The table handle.
+ * @param  ops         The slot layout.
+ * @param  table       The slots.
+ * @param  capacity    The slot count, a power of two.
+ * @retval See xhal_err_t.
+ */
+xhal_err_t xoatable_init(xoatable_t *const self, const xoatable_ops_t *ops,
+                         void *table, uint32_t capacity)
+{
+    xassert_not_null(self);
+    xassert_not_null(ops);
+    xassert_not_null(table);
+
+    if (capacity < 2 || (capacity & (capacity - 1U)) != 0)
+        return XHAL_ERR_INVALID;
+
+    self->ops        = ops;
+    self->table      = table;
+    self->capacity   = capacity;
+    self->count      = 0;
+    self->tombstones = 0;
+    self->rehashes   = 0;
+    self->bits       = _bits(capacity);
+    self->flags      = 0;
+
+    xmemset(table, 0, (size_t)ops->slot_size * capacity);
+
+    return XHAL_OK;
+}
+
+/**
+ * @brief  Initialize one table on the heap that grows as entries are added.
+ * @param  self        The table handle.
+ * @param  ops         The slot layout.
+ * @param  expected    The expected entry count.
+ * @retval See xhal_err_t.
+ */
+xhal_err_t xoatable_init_heap(xoatable_t *const self,
+                              const xoatable_ops_t *ops, uint32_t expected)
+{
+    xassert_not_null(self);
+    xassert_not_null(ops);
+
+    uint32_t slots = XOATABLE_CAPACITY_MIN;
+
+    while (SLOT_OVER_LOAD(expected, slots) &&
+           slots <= (UINT32_MAX >> 2) / ops->slot_size)
+        slots <<= 1;
+
+    void *table = xmalloc(ops->slot_size * slots);
+    if (table == NULL)
+        return XHAL_ERR_NO_MEMORY;
+
+    xoatable_init(self, ops, table, slots);
+    self->flags = XOATABLE_FLAG_HEAP;
+
+    return XHAL_OK;
+}
+
+/**
+ * @brief  Free the slots of a heap table.
+ * @param  self    The table handle.
+ * @retval None.
+ */
+void xoatable_deinit(xoatable_t *const self)
+{
+    xassert_not_null(self);
+
+    if (self->flags & XOATABLE_FLAG_HEAP)
+        xfree(self->table);
+    self->table = NULL;
+}
+
+/**
+ * @brief  Insert one entry whose key is not in the table yet.
+ * @param  self    The table handle.
+ * @param  entry   The slot to copy in, with non-NULL data.
+ * @retval See xhal_err_t.
+ */
+xhal_err_t xoatable_insert(xoatable_t *const self, const void *entry)
+{
+    xhal_err_t ret = _reserve_one(self);
+    if (ret != XHAL_OK)
+        return ret;
+
+    void *slot = _free_slot(self, self->ops->home(self, entry));
+    if (*_data(self, slot) == XOATABLE_TOMBSTONE)
+        self->tombstones--;
+    xmemcpy(slot, entry, self->ops->slot_size);
+    self->count++;
+
+    return XHAL_OK;
+}
+
+/**
+ * @brief  Remove the entry at one slot.
+ * @param  self    The table handle.
+ * @param  index   The slot index of a live entry.
+ * @retval None.
+ */
+void xoatable_remove_at(xoatable_t *const self, uint32_t index)
+{
+    uint32_t mask = self->capacity - 1U;
+    uint32_t i    = index;
+
+    *_data(self, _slot(self, i)) = XOATABLE_TOMBSTONE;
+    self->count--;
+    self->tombstones++;
+
+    /* A run of tombstones before an empty slot ends no chain, clear it */
+    if (*_data(self, _slot(self, (i + 1U) & mask)) == NULL)
+    {
+        void **data;
+
+        while (*(data = _data(self, _slot(self, i))) == XOATABLE_TOMBSTONE)
+        {
+            *data = NULL;
+            self->tombstones--;
+            i = (i - 1U) & mask;
+        }
+    }
+}
+
+/**
+ * @brief  Get the table statistics. The probe figures walk the whole table.
+ * @param  self    The table handle.
+ * @param  stats   The statistics output.
+ * @retval None.
+ */
+void xoatable_get_stats(const xoatable_t *const self,
+                        xoatable_stats_t *stats)
+{
+    xassert_not_null(self);
+    xassert_not_null(stats);
+
+    uint32_t mask = self->capacity - 1U;
+
+    stats->capacity    = self->capacity;
+    stats->count       = self->count;
+    stats->tombstones  = self->tombstones;
+    stats->probe_max   = 0;
+    stats->probe_total = 0;
+    stats->rehashes    = self->rehashes;
+
+    for (uint32_t i = 0; i < self->capacity; i++)
+    {
+        void *slot = _slot(self, i);
+        if (!_is_live(self, slot))
+            continue;
+
+        uint32_t dist = (i - self->ops->home(self, slot)) & mask;
+        stats->probe_total += dist;
+        stats->probe_max = XHAL_MAX(stats->probe_max, dist);
+    }
+}
@@ -0,0 +1,68 @@
+#ifndef __XHAL_OATABLE_H
+#define __XHAL_OATABLE_H
+
+#include "../xcore/xhal_def.h"
+#include "../xcore/xhal_std.h"
+
+/* Maximum load, in percent, of live entries before a heap table grows. */
+#ifndef XHTABLE_LOAD_MAX
+#define XHTABLE_LOAD_MAX (75)
+#endif
+
+#define XOATABLE_FLAG_HEAP    (1U << 0) /* Slots are from the xmalloc heap */
+
+#define XOATABLE_CAPACITY_MIN (8)
+
+struct xoatable;
+
+/*
+ * Slot layout of one table type. Every slot has a `void *data` member: NULL
+ * marks an empty slot and XOATABLE_TOMBSTONE a deleted one, so live data
+ * may not be NULL. Only the key differs between types, and the engine
+ * reaches it through `home` alone, which lookups never call.
+ */
+typedef struct xoatable_ops
+{
+    uint32_t slot_size;
+    uint32_t data_offset; /* offsetof the `data` member */
+    /* Home slot of a live entry in the table `self` */
+    uint32_t (*home)(const struct xoatable *self, const void *slot);
+} xoatable_ops_t;
+
+typedef struct xoatable_stats
+{
+    uint32_t capacity;    /* Slot count */
+    uint32_t count;       /* Live entries */
+    uint32_t tombstones;  /* Deleted slots not yet reclaimed */
+    uint32_t probe_max;   /* Longest distance of an entry from its home */
+    uint32_t probe_total; /* Sum of those distances over all entries */
+    uint32_t rehashes;    /* Resizes and in-place rehashes so far */
+} xoatable_stats_t;
+
+typedef struct xoatable
+{
+    const xoatable_ops_t *ops;
+    void *table;
+    uint32_t capacity; /* Slot count, a power of two */
+    uint32_t count;
+    uint32_t tombstones;
+    uint32_t rehashes;
+    uint8_t bits;      /* log2(capacity) */
+    uint8_t flags;
+} xoatable_t;
+
+extern const uint8_t xoatable_tombstone;
+
+#define XOATABLE_TOMBSTONE ((void *)&xoatable_tombstone)
+
+xhal_err_t xoatable_init(xoatable_t *const self, const xoatable_ops_t *ops,
+                         void *table, uint32_t capacity);
+xhal_err_t xoatable_init_heap(xoatable_t *const self,
+                              const xoatable_ops_t *ops, uint32_t expected);
+void xoatable_deinit(xoatable_t *const self);
+xhal_err_t xoatable_insert(xoatable_t *const self, const void *entry);
+void xoatable_remove_at(xoatable_t *const self, uint32_t index);
+void xoatable_get_stats(const xoatable_t *const self,
+                        xoatable_stats_t *stats);
+
+#endif /* __XHAL_OATABLE_H */
@@ -0,0 +1,418 @@
+#include "xhal_phash.h"
+#include "xhal_htable.h"
+#include "../xcore/xhal_assert.h"
+#include "../xcore/xhal_log.h"
+#include "../xcore/xhal_malloc.h"
+#include <string.h>
+
+XLOG_TAG("xPerfectHash");
+
+/*
+ * Hash and displace: each key hashes into a bucket, and each bucket stores
+ * the displacement that sends all of its keys to distinct positions among
+ * the `size` slots. Buckets are placed largest first, trying displacements
+ * 0, 1, 2, ... until every key of the bucket lands on a free slot.
+ */
+
+#define PHASH_DISP_MAX (0xFFFFU)
+
+/**
+ * @brief  Scramble a hash so all of its bits affect the top ones (the
+ * finalizer of MurmurHash3). The low bits of a string hash are too
+ * regular to be used directly.
+ * @param  x       The hash.
+ * @retval The scrambled hash.
+ */
+static inline uint32_t _mix(uint32_t x)
+{
+    x ^= x >> 16;
+    x *= 0x85EBCA6BU;
+    x ^= x >> 13;
+    x *= 0xC2B2AE35U;
+    x ^= x >> 16;
+
+    return x;
+}
+
+/**
+ * @brief  Scale a well mixed 32-bit value into [0, n) without a division.
+ * @param  x       The value.
+ * @param  n       The range.
+ * @retval The scaled value.
+ */
+static inline uint32_t _range(uint32_t x, uint32_t n)
+{
+    return (uint32_t)(((uint64_t)x * n) >> 32);
+}
+
+/**
+ * @brief  Map a key hash to its bucket.
+ * @param  hash    The key hash.
+ * @param  buckets Bucket count.
+ * @retval The bucket.
+ */
+static inline uint32_t _bucket(uint32_t hash, uint32_t buckets)
+{
+    return _range(_mix(hash), buckets);
+}
+
+/**
+ * @brief  Map a key hash and a displacement to a slot position.
+ * @param  hash    The key hash.
+ * @param  disp    The displacement of the key's bucket.
+ * @param  size    Slot count.
+ * @retval The position.
+ */
+static inline uint32_t _pos(uint32_t hash, uint32_t disp, uint32_t size)
+{
+    return _range(_mix(hash ^ ((disp + 1U) * 0x9E3779B9U)), size);
+}
+
+/**
+ * @brief  Find a displacement for one bucket and claim its slots.
+ * @param  self    The perfect hash handle.
+ * @param  hash    Hashes of the bucket's keys.
+ * @param  index   Registry indexes of the bucket's keys.
+ * @param  n       Key count of the bucket.
+ * @param  disp    The displacement output.
+ * @retval See xhal_err_t.
+ */
+static xhal_err_t _place(xphash_t *const self, const uint32_t *hash,
+                         const uint16_t *index, uint32_t n, uint16_t *disp)
+{
+    uint32_t pos[XPHASH_BUCKET_MAX];
+
+    for (uint32_t d = 0; d < PHASH_DISP_MAX; d++)
+    {
+        uint32_t j;
+
+        for (j = 0; j < n; j++)
+        {
+            pos[j] = _pos(hash[j], d, self->size);
+            if (self->slot[pos[j]] != XPHASH_SLOT_NONE)
+                break;
+
+            /* Claim now so later keys of the bucket see it taken */
+            self->slot[pos[j]] = index[j];
+        }
+
+        if (j == n)
+        {
+            *disp = (uint16_t)d;
+            return XHAL_OK;
+        }
+
+        while (j-- > 0)
+            self->slot[pos[j]] = XPHASH_SLOT_NONE;
+    }
+
+    return XHAL_ERR_FULL;
+}
+
+/**
+ * @brief  Initialize one perfect hash on the given storage.
+ * @param  self        The perfect hash handle.
+ * @param  disp        XPHASH_BUCKETS(capacity) displacements.
+ * @param  slot        `capacity` slots.
+ * @param  capacity    Maximum key count, at most XPHASH_CAPACITY_MAX.
+ * @param  key         The key callback.
+ * @param  ctx         The callback context.
+ * @retval See xhal_err_t.
+ */
+xhal_err_t xphash_init(xphash_t *const self, uint16_t *disp, uint16_t *slot,
+                       uint16_t capacity, xphash_key_t key, void *ctx)
+{
+    xassert_not_null(self);
+    xassert_not_null(disp);
+    xassert_not_null(slot);
+    xassert_not_null(key);
+
+    if (capacity == 0 || capacity > XPHASH_CAPACITY_MAX)
+        return XHAL_ERR_INVALID;
+
+    self->disp     = disp;
+    self->slot     = slot;
+    self->key      = key;
+    self->ctx      = ctx;
+    self->capacity = capacity;
+    self->size     = 0;
+    self->count    = 0;
+    self->buckets  = 0;
+    self->flags    = 0;
+
+    return XHAL_OK;
+}
+
+/**
+ * @brief  Newly create one perfect hash carved out of the xmalloc heap. The
+ * handle and its storage share one allocation.
+ * @param  capacity    Maximum key count, at most XPHASH_CAPACITY_MAX.
+ * @param  key         The key callback.
+ * @param  ctx         The callback context.
+ * @retval The handle, NULL if out of memory.
+ */
+xphash_t *xphash_new(uint16_t capacity, xphash_key_t key, void *ctx)
+{
+    uint32_t head_size = XHAL_CEIL(sizeof(xphash_t), sizeof(void *));
+    uint32_t disp_size = sizeof(uint16_t) * XPHASH_BUCKETS(capacity);
+
+    if (capacity == 0 || capacity > XPHASH_CAPACITY_MAX)
+        return NULL;
+
+    uint8_t *mem = xmalloc(head_size + disp_size + sizeof(uint16_t) * capacity);
+    if (mem == NULL)
+        return NULL;
+
+    xphash_t *self = (xphash_t *)mem;
+    xphash_init(self, (uint16_t *)(mem + head_size),
+                (uint16_t *)(mem + head_size + disp_size), capacity, key, ctx);
+    self->flags = XPHASH_FLAG_HEAP;
+
+    return self;
+}
+
+/**
+ * @brief  Destroy the perfect hash which is generated by the function
+ * xphash_new.
+ * @param  self    The perfect hash handle.
+ * @retval None.
+ */
+void xphash_destroy(xphash_t *const self)
+{
+    xassert_not_null(self);
+    xassert(self->flags & XPHASH_FLAG_HEAP);
+
+    xfree(self);
+}
+
+/**
+ * @brief  Build the hash over registry indexes 0 .. count - 1. A name that
+ * appears more than once resolves to its lowest index, as a linear scan
+ * would. On failure the hash is left unbuilt and lookups must fall back
+ * to a scan.
+ * @param  self    The perfect hash handle.
+ * @param  count   Registry entry count.
+ * @retval See xhal_err_t. XHAL_ERR_INVALID if two names share a hash.
+ */
+xhal_err_t xphash_build(xphash_t *const self, uint32_t count)
+{
+    xassert_not_null(self);
+
+    uint32_t n = 0;
+
+    self->size = 0;
+    if (count > XPHASH_CAPACITY_MAX)
+        return XHAL_ERR_NOT_ENOUGH;
+
+    for (uint32_t i = 0; i < count; i++)
+        n += (self->key(self->ctx, i) != NULL);
+
+    if (n == 0)
+        return XHAL_OK;
+    if (n > self->capacity)
+        return XHAL_ERR_NOT_ENOUGH;
+
+    /*
+     * Keys grouped by bucket with a counting sort: hashes and registry
+     * indexes in scan order, then the same sorted by bucket, then the end
+     * and the key count of each bucket. Two keys with one hash share a
+     * bucket, so duplicates are found within it.
+     */
+    uint32_t buckets = XPHASH_BUCKETS(n);
+    uint8_t *mem     = xmalloc((sizeof(uint32_t) + sizeof(uint16_t)) * 2U * n +
+                               sizeof(uint16_t) * (2U * buckets + 1U));
+    if (mem == NULL)
+        return XHAL_ERR_NO_MEMORY;
+
+    uint32_t *hash   = (uint32_t *)mem;
+    uint32_t *bhash  = hash + n;
+    uint16_t *index  = (uint16_t *)(bhash + n);
+    uint16_t *bindex = index + n;
+    uint16_t *start  = bindex + n;
+    uint16_t *fill   = start + buckets + 1U;
+    xhal_err_t ret   = XHAL_OK;
+    uint32_t max     = 0;
+    uint32_t size    = 0;
+
+    xmemset(start, 0, sizeof(uint16_t) * (2U * buckets + 1U));
+    n = 0;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        const char *name = self->key(self->ctx, i);
+        if (name == NULL)
+            continue;
+
+        hash[n]  = xhtable_hash(name);
+        index[n] = (uint16_t)i;
+        start[_bucket(hash[n], buckets) + 1U]++;
+        n++;
+    }
+
+    for (uint32_t b = 0; b < buckets; b++)
+        start[b + 1U] += start[b];
+
+    /* Stable, so each bucket keeps its keys in registry order */
+    for (uint32_t k = 0; k < n; k++)
+    {
+        uint32_t b = _bucket(hash[k], buckets);
+        uint32_t j = start[b]++;
+
+        bhash[j]  = hash[k];
+        bindex[j] = index[k];
+    }
+
+    /* The scatter moved every start to the next one, so bucket b now ends
+     * at start[b]. Drop repeated names, keeping the first. */
+    for (uint32_t b = 0, lo = 0; b < buckets && ret == XHAL_OK; b++)
+    {
+        uint32_t hi  = start[b];
+        uint32_t out = lo;
+
+        for (uint32_t k = lo; k < hi; k++)
+        {
+            uint32_t j = lo;
+            while (j < out && bhash[j] != bhash[k])
+                j++;
+
+            if (j < out)
+            {
+                /* Same name again: keep the first. A true collision fails. */
+                if (strcmp(self->key(self->ctx, bindex[j]),
+                           self->key(self->ctx, bindex[k])) != 0)
+                    ret = XHAL_ERR_INVALID;
+                continue;
+            }
+
+            bhash[out]  = bhash[k];
+            bindex[out] = bindex[k];
+            out++;
+        }
+
+        fill[b] = (uint16_t)(out - lo);
+        size += fill[b];
+        max = XHAL_MAX(max, fill[b]);
+        lo  = hi;
+    }
+
+    if (max > XPHASH_BUCKET_MAX)
+        ret = XHAL_ERR_FULL;
+
+    self->size    = (uint16_t)size;
+    self->buckets = (uint16_t)buckets;
+    xmemset(self->slot, 0xFF, sizeof(uint16_t) * size);
+
+    for (uint32_t s = max; s > 0 && ret == XHAL_OK; s--)
+    {
+        for (uint32_t b = 0; b < buckets && ret == XHAL_OK; b++)
+        {
+            uint32_t lo = b == 0 ? 0 : start[b - 1U];
+
+            if (fill[b] == s)
+                ret = _place(self, &bhash[lo], &bindex[lo], s, &self->disp[b]);
+        }
+    }
+
+    for (uint32_t b = 0; b < buckets; b++)
+    {
+        if (fill[b] == 0)
+            self->disp[b] = 0;
+    }
+
+    xfree(mem);
+
+    if (ret != XHAL_OK)
+    {
+        self->size = 0;
+#ifdef XDEBUG
+        XLOG_WARN("Build over %u names failed: %d", (unsigned)n, ret);
+#endif
+    }
+
+    return ret;
+}
+
+/**
+ * @brief  Drop the last build, so lookups fall back to a scan until the
+ * next build.
+ * @param  self    The perfect hash handle.
+ * @retval None.
+ */
+void xphash_invalidate(xphash_t *const self)
+{
+    xassert_not_null(self);
+
+    self->size = 0;
+}
+
+/**
+ * @brief  Note that the registry changed. The last build is dropped and
+ * the next xphash_refresh rebuilds, so a burst of registrations costs one
+ * build instead of one each.
+ * @param  self    The perfect hash handle.
+ * @param  count   Registry entry count to build over.
+ * @retval None.
+ */
+void xphash_mark_dirty(xphash_t *const self, uint32_t count)
+{
+    xassert_not_null(self);
+
+    self->size  = 0;
+    self->count = (uint16_t)XHAL_MIN(count, XPHASH_CAPACITY_MAX + 1U);
+    self->flags |= XPHASH_FLAG_DIRTY;
+}
+
+/**
+ * @brief  Rebuild the hash if the registry changed since the last build.
+ * A failed build is not retried until the registry changes again.
+ * @param  self    The perfect hash handle.
+ * @retval 1 if built, otherwise 0 and lookups must fall back to a scan.
+ */
+uint8_t xphash_refresh(xphash_t *const self)
+{
+    xassert_not_null(self);
+
+    if (self->flags & XPHASH_FLAG_DIRTY)
+    {
+        self->flags &= (uint8_t)~XPHASH_FLAG_DIRTY;
+        xphash_build(self, self->count);
+    }
+
+    return self->size != 0;
+}
+
+/**
+ * @brief  Check whether the hash holds a usable build.
+ * @param  self    The perfect hash handle.
+ * @retval 1 if built, otherwise 0.
+ */
+uint8_t xphash_is_built(const xphash_t *const self)
+{
+    xassert_not_null(self);
+
+    return self->size != 0;
+}
+
+/**
+ * @brief  Find the registry index of a name.
+ * @param  self    The perfect hash handle, built.
+ * @param  name    The name.
+ * @retval The registry index, -1 if the name is absent.
+ */
+int32_t xphash_find(const xphash_t *const self, const char *name)
+{
+    xassert_not_null(self);
+    xassert_not_null(name);
+
+    if (self->size == 0)
+        return -1;
+
+    uint32_t hash  = xhtable_hash(name);
+    uint32_t disp  = self->disp[_bucket(hash, self->buckets)];
+    uint16_t index = self->slot[_pos(hash, disp, self->size)];
+
+    const char *key = self->key(self->ctx, index);
+    if (key == NULL || strcmp(key, name) != 0)
+        return -1;
+
+    return index;
+}
@@ -0,0 +1,66 @@
+#ifndef __XHAL_PHASH_H
+#define __XHAL_PHASH_H
+
+#include "../xcore/xhal_def.h"
+#include "../xcore/xhal_std.h"
+
+/*
+ * Minimal perfect hash over the names of a registry that rarely changes.
+ *
+ * The registry is any table the caller can read by index; a key callback
+ * returns the name at an index, or NULL for an unused entry. After a build,
+ * finding a name costs one hash, two table reads and one strcmp. Builds
+ * take O(n) time and a temporary xmalloc block; registries mark the hash
+ * dirty on every change and rebuild on the next lookup.
+ */
+
+#define XPHASH_FLAG_HEAP   (1U << 0) /* Storage is from the xmalloc heap */
+#define XPHASH_FLAG_DIRTY  (1U << 1) /* Registry changed since the build */
+
+#define XPHASH_SLOT_NONE   (0xFFFFU)
+#define XPHASH_CAPACITY_MAX (0xFFFEU)
+
+/* Keys sharing one bucket a build can place; more fails the build. */
+#define XPHASH_BUCKET_MAX  (16)
+
+/* Bucket count for a capacity, two keys per bucket on average. */
+#define XPHASH_BUCKETS(capacity) ((capacity) / 2U + 1U)
+
+/**
+ * @brief  Define the static storage for one perfect hash.
+ * @param  name        Storage variable name prefix.
+ * @param  capacity    Maximum key count.
+ */
+#define XPHASH_STORAGE(name, capacity)                   \
+    static uint16_t name##_disp[XPHASH_BUCKETS(capacity)]; \
+    static uint16_t name##_slot[capacity]
+
+/* Returns the name at `index`, NULL if that entry holds no key. */
+typedef const char *(*xphash_key_t)(void *ctx, uint32_t index);
+
+typedef struct xphash
+{
+    uint16_t *disp;     /* Displacement per bucket */
+    uint16_t *slot;     /* Position -> registry index */
+    xphash_key_t key;
+    void *ctx;
+    uint16_t capacity;  /* Maximum key count */
+    uint16_t size;      /* Keys in the last build, 0 if not built */
+    uint16_t count;     /* Registry entries to build over when dirty */
+    uint16_t buckets;
+    uint8_t flags;
+} xphash_t;
+
+xhal_err_t xphash_init(xphash_t *const self, uint16_t *disp, uint16_t *slot,
+                       uint16_t capacity, xphash_key_t key, void *ctx);
+xphash_t *xphash_new(uint16_t capacity, xphash_key_t key, void *ctx);
+void xphash_destroy(xphash_t *const self);
+
+xhal_err_t xphash_build(xphash_t *const self, uint32_t count);
+void xphash_invalidate(xphash_t *const self);
+void xphash_mark_dirty(xphash_t *const self, uint32_t count);
+uint8_t xphash_refresh(xphash_t *const self);
+uint8_t xphash_is_built(const xphash_t *const self);
+int32_t xphash_find(const xphash_t *const self, const char *name);
+
+#endif /* __XHAL_PHASH_H */
@@ -0,0 +1,327 @@
+#include "xhal_pool.h"
+#include "../xcore/xhal_assert.h"
+#include "../xcore/xhal_log.h"
+#include "../xcore/xhal_malloc.h"
+
+XLOG_TAG("xObjPool");
+
+#ifdef XHAL_OS_SUPPORTING
+#include "../xos/xhal_os.h"
+#endif
+
+/* Interrupt masking used by pools created with XOBJ_POOL_FLAG_ISR. */
+#ifndef XOBJ_POOL_IRQ_DISABLE
+#include XHAL_DEVICE_HEADER
+
+static inline uint32_t _xobj_pool_irq_disable(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    return primask;
+}
+
+#define XOBJ_POOL_IRQ_DISABLE()         _xobj_pool_irq_disable()
+#define XOBJ_POOL_IRQ_RESTORE(primask)  __set_PRIMASK(primask)
+#endif
+
+/**
+ * @brief  Enter the pool critical section.
+ * @param  self    The pool handle.
+ * @retval The state to be passed to _pool_unlock.
+ */
+static inline int32_t _pool_lock(const xobj_pool_t *const self)
+{
+    if (self->flags & XOBJ_POOL_FLAG_ISR)
+        return (int32_t)XOBJ_POOL_IRQ_DISABLE();
+
+#ifdef XHAL_OS_SUPPORTING
+    return osKernelLock();
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief  Leave the pool critical section.
+ * @param  self    The pool handle.
+ * @param  state   The state returned by _pool_lock.
+ * @retval None.
+ */
+static inline void _pool_unlock(const xobj_pool_t *const self, int32_t state)
+{
+    if (self->flags & XOBJ_POOL_FLAG_ISR)
+    {
+        XOBJ_POOL_IRQ_RESTORE((uint32_t)state);
+        return;
+    }
+
+#ifdef XHAL_OS_SUPPORTING
+    (void)osKernelRestoreLock(state);
+#else
+    (void)state;
+#endif
+}
+
+/**
+ * @brief  Initialize one object pool on the given storage.
+ * @param  self        The pool handle.
+ * @param  name        The pool name, used by logs and statistics.
+ * @param  buff        Storage of at least XOBJ_POOL_BUFF_SIZE(obj_size,
+ *                     capacity) bytes, aligned to a pointer.
+ * @param  obj_size    Object size in bytes.
+ * @param  capacity    Object count.
+ * @param  flags       XOBJ_POOL_FLAG_xxx.
+ * @retval See xhal_err_t.
+ */
+xhal_err_t xobj_pool_init(xobj_pool_t *const self, const char *name,
+                          void *buff, uint32_t obj_size, uint32_t capacity,
+                          uint8_t flags)
+{
+    xassert_not_null(self);
+    xassert_not_null(buff);
+
+    if (obj_size == 0 || capacity == 0)
+        return XHAL_ERR_INVALID;
+
+    if ((xhal_pointer_t)buff % XOBJ_POOL_ALIGN)
+        return XHAL_ERR_INVALID;
+
+    self->name       = name;
+    self->buff       = (uint8_t *)buff;
+    self->obj_size   = XOBJ_POOL_SLOT_SIZE(obj_size);
+    self->capacity   = capacity;
+    self->used       = 0;
+    self->used_max   = 0;
+    self->alloc_fail = 0;
+    self->flags      = flags;
+
+    /* Thread every slot onto the free list, lowest address first. */
+    self->free_list = NULL;
+    for (uint32_t i = capacity; i > 0; i--)
+    {
+        void **slot     = (void **)(self->buff + (i - 1) * self->obj_size);
+        *slot           = self->free_list;
+        self->free_list = slot;
+    }
+
+    return XHAL_OK;
+}
+
+/**
+ * @brief  Newly create one object pool carved out of the xmalloc heap. The
+ * pool handle and its storage share one allocation.
+ * @param  name        The pool name.
+ * @param  obj_size    Object size in bytes.
+ * @param  capacity    Object count.
+ * @param  flags       XOBJ_POOL_FLAG_xxx.
+ * @retval The pool handle, NULL if out of memory.
+ */
+xobj_pool_t *xobj_pool_new(const char *name, uint32_t obj_size,
+                           uint32_t capacity, uint8_t flags)
+{
+    uint32_t head_size = XHAL_CEIL(sizeof(xobj_pool_t), XOBJ_POOL_ALIGN);
+    uint32_t buff_size = XOBJ_POOL_BUFF_SIZE(obj_size, capacity);
+
+    if (obj_size == 0 || capacity == 0)
+        return NULL;
+
+    uint8_t *mem = xmalloc(head_size + buff_size);
+    if (mem == NULL)
+    {
+#ifdef XDEBUG
+        XLOG_ERROR("Pool %s: no memory", name == NULL ? "<none>" : name);
+#endif
+        return NULL;
+    }
+
+    xobj_pool_t *self = (xobj_pool_t *)mem;
+    xobj_pool_init(self, name, mem + head_size, obj_size, capacity,
+                   flags | XOBJ_POOL_FLAG_HEAP);
+
+    return self;
+}
+
+/**
+ * @brief  Destroy the pool which is generated by the function xobj_pool_new.
+ * Objects still allocated from it become invalid.
+ * @param  self    The pool handle.
+ * @retval None.
+ */
+void xobj_pool_destroy(xobj_pool_t *const self)
+{
+    xassert_not_null(self);
+    xassert(self->flags & XOBJ_POOL_FLAG_HEAP);
+
+#ifdef XDEBUG
+    if (self->used != 0)
+    {
+        XLOG_WARN("Pool %s destroyed with %u objects in use",
+                  self->name == NULL ? "<none>" : self->name,
+                  (unsigned)self->used);
+    }
+#endif
+
+    xfree(self);
+}
+
+/**
+ * @brief  Take one object from the pool.
+ * @param  self    The pool handle.
+ * @retval The object, NULL if the pool is exhausted.
+ */
+void *xobj_pool_alloc(xobj_pool_t *const self)
+{
+    xassert_not_null(self);
+
+    int32_t state = _pool_lock(self);
+
+    void **obj = (void **)self->free_list;
+    if (obj != NULL)
+    {
+        self->free_list = *obj;
+        self->used++;
+        if (self->used > self->used_max)
+            self->used_max = self->used;
+    }
+    else
+    {
+        self->alloc_fail++;
+    }
+
+    _pool_unlock(self, state);
+
+    return obj;
+}
+
+/**
+ * @brief  Take one zero-filled object from the pool.
+ * @param  self    The pool handle.
+ * @retval The object, NULL if the pool is exhausted.
+ */
+void *xobj_pool_calloc(xobj_pool_t *const self)
+{
+    void *obj = xobj_pool_alloc(self);
+
+    if (obj != NULL)
+        xmemset(obj, 0, self->obj_size);
+
+    return obj;
+}
+
+/**
+ * @brief  Give one object back to the pool.
+ * @param  self    The pool handle.
+ * @param  obj     The object obtained by xobj_pool_alloc.
+ * @retval XHAL_ERR_INVALID if the object is not a slot of the pool, or with
+ *         XOBJ_POOL_FREE_CHECK_ENABLE, if it is already free.
+ */
+xhal_err_t xobj_pool_free(xobj_pool_t *const self, void *obj)
+{
+    xassert_not_null(self);
+
+    if (obj == NULL)
+        return XHAL_ERR_INVALID;
+
+    if (!xobj_pool_contains(self, obj))
+    {
+#ifdef XDEBUG
+        XLOG_ERROR("Pool %s: object %p not owned",
+                   self->name == NULL ? "<none>" : self->name, obj);
+#endif
+        return XHAL_ERR_INVALID;
+    }
+
+    int32_t state = _pool_lock(self);
+
+#if XOBJ_POOL_FREE_CHECK_ENABLE != 0
+    for (void *slot = self->free_list; slot != NULL; slot = *(void **)slot)
+    {
+        if (slot == obj)
+        {
+            _pool_unlock(self, state);
+#ifdef XDEBUG
+            XLOG_ERROR("Pool %s: object %p freed twice",
+                       self->name == NULL ? "<none>" : self->name, obj);
+#endif
+            return XHAL_ERR_INVALID;
+        }
+    }
+#endif
+
+    xassert(self->used > 0);
+    *(void **)obj   = self->free_list;
+    self->free_list = obj;
+    self->used--;
+
+    _pool_unlock(self, state);
+
+    return XHAL_OK;
+}
+
+/**
+ * @brief  Check whether the object is a slot of the pool.
+ * @param  self    The pool handle.
+ * @param  obj     The object.
+ * @retval 1 if owned, otherwise 0.
+ */
+uint8_t xobj_pool_contains(const xobj_pool_t *const self, const void *obj)
+{
+    xassert_not_null(self);
+
+    const uint8_t *p = (const uint8_t *)obj;
+    if (p < self->buff || p >= self->buff + self->obj_size * self->capacity)
+        return 0;
+
+    return ((xhal_pointer_t)(p - self->buff) % self->obj_size) == 0;
+}
+
+/**
+ * @brief  Get the count of objects still available.
+ * @param  self    The pool handle.
+ * @retval The free object count.
+ */
+uint32_t xobj_pool_free_count(const xobj_pool_t *const self)
+{
+    xassert_not_null(self);
+
+    return self->capacity - self->used;
+}
+
+/**
+ * @brief  Get a consistent snapshot of the pool statistics.
+ * @param  self    The pool handle.
+ * @param  stats   The statistics output.
+ * @retval None.
+ */
+void xobj_pool_get_stats(xobj_pool_t *const self, xobj_pool_stats_t *stats)
+{
+    xassert_not_null(self);
+    xassert_not_null(stats);
+
+    int32_t state = _pool_lock(self);
+
+    stats->obj_size   = self->obj_size;
+    stats->capacity   = self->capacity;
+    stats->used       = self->used;
+    stats->used_max   = self->used_max;
+    stats->alloc_fail = self->alloc_fail;
+
+    _pool_unlock(self, state);
+}
+
+/**
+ * @brief  Restart the high-water mark and failure counter from now on.
+ * @param  self    The pool handle.
+ * @retval None.
+ */
+void xobj_pool_reset_stats(xobj_pool_t *const self)
+{
+    xassert_not_null(self);
+
+    int32_t state = _pool_lock(self);
+
+    self->used_max   = self->used;
+    self->alloc_fail = 0;
+
+    _pool_unlock(self, state);
+}
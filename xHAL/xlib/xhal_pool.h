@@ -0,0 +1,76 @@
+#ifndef __XHAL_POOL_H
+#define __XHAL_POOL_H
+
+#include "xhal_config.h"
+#include "../xcore/xhal_def.h"
+#include "../xcore/xhal_std.h"
+
+/*
+ * Walk the free list on every xobj_pool_free to refuse double frees. The
+ * walk costs O(free objects), so it is meant for debug builds.
+ */
+#ifndef XOBJ_POOL_FREE_CHECK_ENABLE
+#define XOBJ_POOL_FREE_CHECK_ENABLE (0)
+#endif
+
+#define XOBJ_POOL_FLAG_ISR  (1U << 0) /* Pool can be used from ISR context */
+#define XOBJ_POOL_FLAG_HEAP (1U << 1) /* Pool is carved from the xmalloc heap */
+
+#define XOBJ_POOL_ALIGN     (sizeof(void *))
+
+/* Size of one slot, every free slot stores the free-list link in place. */
+#define XOBJ_POOL_SLOT_SIZE(obj_size) \
+    XHAL_CEIL(XHAL_MAX((obj_size), sizeof(void *)), XOBJ_POOL_ALIGN)
+
+/* Bytes of storage needed by a pool of `count` objects of `obj_size`. */
+#define XOBJ_POOL_BUFF_SIZE(obj_size, count) \
+    (XOBJ_POOL_SLOT_SIZE(obj_size) * (count))
+
+/**
+ * @brief  Define the static storage for one object pool.
+ * @param  name    Storage variable name.
+ * @param  type    Object type.
+ * @param  count   Object count.
+ */
+#define XOBJ_POOL_STORAGE(name, type, count) \
+    static void *name[XOBJ_POOL_BUFF_SIZE(sizeof(type), count) / sizeof(void *)]
+
+typedef struct xobj_pool_stats
+{
+    uint32_t obj_size;   /* Slot size in bytes */
+    uint32_t capacity;   /* Total object count */
+    uint32_t used;       /* Objects currently allocated */
+    uint32_t used_max;   /* High-water mark of `used` */
+    uint32_t alloc_fail; /* Allocations refused because the pool was empty */
+} xobj_pool_stats_t;
+
+typedef struct xobj_pool
+{
+    const char *name;
+    uint8_t *buff;
+    void *free_list;
+    uint32_t obj_size;
+    uint32_t capacity;
+    uint32_t used;
+    uint32_t used_max;
+    uint32_t alloc_fail;
+    uint8_t flags;
+} xobj_pool_t;
+
+xhal_err_t xobj_pool_init(xobj_pool_t *const self, const char *name,
+                          void *buff, uint32_t obj_size, uint32_t capacity,
+                          uint8_t flags);
+xobj_pool_t *xobj_pool_new(const char *name, uint32_t obj_size,
+                           uint32_t capacity, uint8_t flags);
+void xobj_pool_destroy(xobj_pool_t *const self);
+
+void *xobj_pool_alloc(xobj_pool_t *const self);
+void *xobj_pool_calloc(xobj_pool_t *const self);
+xhal_err_t xobj_pool_free(xobj_pool_t *const self, void *obj);
+uint8_t xobj_pool_contains(const xobj_pool_t *const self, const void *obj);
+
+uint32_t xobj_pool_free_count(const xobj_pool_t *const self);
+void xobj_pool_get_stats(xobj_pool_t *const self, xobj_pool_stats_t *stats);
+void xobj_pool_reset_stats(xobj_pool_t *const self);
+
+#endif /* __XHAL_POOL_H */
@@ -1,131 +1,445 @@
 #include "xhal_queue.h"
-#include "../xcore/xhal_def.h"
+#include "../xcore/xhal_assert.h"
+#include "../xcore/xhal_log.h"
+#include "../xcore/xhal_malloc.h"
+#include "../xcore/xhal_time.h"
+
+XLOG_TAG("xQueue");
+
+/*
+ * Elements live in a circular array of `capacity` slots. A transfer of n
+ * elements touches at most two runs of slots, one up to the end of the
+ * array and one from its start, so it costs at most two memcpy calls.
+ *
+ * In OS mode every operation runs with the scheduler locked, so threads may
+ * share a queue; interrupts may not use it. A blocking caller that finds too
+ * few slots or elements counts itself as a waiter of that side before the
+ * lock is dropped. The opposite side takes that count under the lock and
+ * releases one semaphore token per waiter, so no wakeup is lost however many
+ * threads wait on the same side. A waiter that times out leaves its count
+ * behind; the token released for it later only makes a future waiter check
+ * the queue once more.
+ */
+
+#ifdef XHAL_OS_SUPPORTING
+#define XQUEUE_WAKE_MAX (0xFFFFU)
+
+static const osSemaphoreAttr_t xqueue_wake_attr[2] = {
+    [XQUEUE_WAIT_PUSH] = {.name = "xqueue_can_push"},
+    [XQUEUE_WAIT_PULL] = {.name = "xqueue_can_pull"},
+};
+#endif
+
+/**
+ * @brief  Enter the queue critical section.
+ * @retval The state to be passed to _queue_unlock.
+ */
+static inline int32_t _queue_lock(void)
+{
+#ifdef XHAL_OS_SUPPORTING
+    return osKernelLock();
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief  Leave the queue critical section.
+ * @param  state   The state returned by _queue_lock.
+ * @retval None.
+ */
+static inline void _queue_unlock(int32_t state)
+{
+#ifdef XHAL_OS_SUPPORTING
+    (void)osKernelRestoreLock(state);
+#else
+    XHAL_UNUSED(state);
+#endif
+}
+
+/**
+ * @brief  Count the caller as a waiter of one side. Call with the lock held.
+ * @param  self    this pointer
+ * @param  side    XQUEUE_WAIT_xxx.
+ * @retval None.
+ */
+static inline void _queue_wait_prepare(xhal_queue_t *const self, uint32_t side)
+{
+#ifdef XHAL_OS_SUPPORTING
+    self->waiters[side]++;
+#else
+    XHAL_UNUSED(self);
+    XHAL_UNUSED(side);
+#endif
+}
+
+/**
+ * @brief  Block until woken from one side or the time is up. Without an OS
+ *         this returns at once and the caller polls.
+ * @param  self    this pointer
+ * @param  side    XQUEUE_WAIT_xxx.
+ * @param  wait_ms Maximum wait time.
+ * @retval None.
+ */
+static inline void _queue_wait(xhal_queue_t *const self, uint32_t side,
+                               uint32_t wait_ms)
+{
+#ifdef XHAL_OS_SUPPORTING
+    osSemaphoreAcquire(self->wake[side], XOS_MS_TO_TICKS(wait_ms));
+#else
+    XHAL_UNUSED(self);
+    XHAL_UNUSED(side);
+    XHAL_UNUSED(wait_ms);
+#endif
+}
+
+/**
+ * @brief  Take the waiters of one side. Call with the lock held.
+ * @param  self    this pointer
+ * @param  side    XQUEUE_WAIT_xxx.
+ * @retval The waiter count to pass to _queue_wake.
+ */
+static inline uint32_t _queue_take_waiters(xhal_queue_t *const self,
+                                           uint32_t side)
+{
+#ifdef XHAL_OS_SUPPORTING
+    uint32_t n          = self->waiters[side];
+    self->waiters[side] = 0;
+    return n;
+#else
+    XHAL_UNUSED(self);
+    XHAL_UNUSED(side);
+    return 0;
+#endif
+}
+
+/**
+ * @brief  Wake the waiters taken by _queue_take_waiters, after unlocking.
+ * @param  self    this pointer
+ * @param  side    XQUEUE_WAIT_xxx.
+ * @param  n       Waiter count.
+ * @retval None.
+ */
+static inline void _queue_wake(xhal_queue_t *const self, uint32_t side,
+                               uint32_t n)
+{
+#ifdef XHAL_OS_SUPPORTING
+    while (n-- > 0)
+        osSemaphoreRelease(self->wake[side]);
+#else
+    XHAL_UNUSED(self);
+    XHAL_UNUSED(side);
+    XHAL_UNUSED(n);
+#endif
+}
+
+/**
+ * @brief  Advance a slot index by n slots, wrapping at the capacity.
+ * @param  self    this pointer
+ * @param  slot    Slot index.
+ * @param  n       Slot count, at most the capacity.
+ * @retval The new slot index.
+ */
+static inline uint32_t _slot_add(const xhal_queue_t *const self,
+                                 uint32_t slot, uint32_t n)
+{
+    slot += n;
+    if (slot >= self->capacity)
+        slot -= self->capacity;
+
+    return slot;
+}
+
+/**
+ * @brief  Copy n elements into the slots starting at the head.
+ * @param  self    this pointer
+ * @param  src     The elements.
+ * @param  n       Element count, at most the free slots.
+ * @retval None.
+ */
+static void _copy_in(xhal_queue_t *const self, const uint8_t *src, uint32_t n)
+{
+    uint32_t first = XHAL_MIN(n, self->capacity - self->head);
+
+    if (n == 0)
+        return;
+
+    xmemcpy(self->buffer + self->head * self->elem_size, src,
+            first * self->elem_size);
+    if (n > first)
+        xmemcpy(self->buffer, src + first * self->elem_size,
+                (n - first) * self->elem_size);
+
+    self->head = _slot_add(self, self->head, n);
+    self->count += n;
+}
+
+/**
+ * @brief  Copy n elements out of the slots starting at the tail.
+ * @param  self    this pointer
+ * @param  dst     The output.
+ * @param  n       Element count, at most the stored elements.
+ * @retval None.
+ */
+static void _copy_out(const xhal_queue_t *const self, uint8_t *dst,
+                      uint32_t n)
+{
+    uint32_t first = XHAL_MIN(n, self->capacity - self->tail);
+
+    if (n == 0)
+        return;
+
+    xmemcpy(dst, self->buffer + self->tail * self->elem_size,
+            first * self->elem_size);
+    if (n > first)
+        xmemcpy(dst + first * self->elem_size, self->buffer,
+                (n - first) * self->elem_size);
+}
 
 /**
- * @brief  Queue initialization.
+ * @brief  Byte queue initialization, each element is one byte.
  * @param  self          this pointer
  * @param  buffer      Queue's buffer memory.
- * @param  capacity    Queue's capacity.
+ * @param  capacity    Queue's capacity in bytes.
  * @retval None
  */
-void xqueue_init(xhal_queue_t *const self, void *buffer, uint16_t capacity)
+void xqueue_init(xhal_queue_t *const self, void *buffer, uint32_t capacity)
 {
+    xqueue_init_elem(self, buffer, 1, capacity);
+}
+
+/**
+ * @brief  Element queue initialization.
+ * @param  self          this pointer
+ * @param  buffer      Queue's buffer memory, elem_size * capacity bytes.
+ * @param  elem_size   Element size in bytes.
+ * @param  capacity    Queue's capacity in elements.
+ * @retval None
+ */
+void xqueue_init_elem(xhal_queue_t *const self, void *buffer,
+                      uint32_t elem_size, uint32_t capacity)
+{
+    xassert_not_null(self);
+    xassert_not_null(buffer);
+    xassert(elem_size > 0 && capacity > 0);
+    xassert(capacity <= UINT32_MAX / elem_size);
+    xassert(capacity <= INT32_MAX); /* xqueue_push returns the count */
+
     self->buffer    = (uint8_t *)buffer;
+    self->elem_size = elem_size;
     self->capacity  = capacity;
-    self->size_free = capacity;
+    self->count     = 0;
     self->head      = 0;
     self->tail      = 0;
+
+#ifdef XHAL_OS_SUPPORTING
+    for (uint32_t side = 0; side < 2; side++)
+    {
+        self->waiters[side] = 0;
+        self->wake[side] =
+            osSemaphoreNew(XQUEUE_WAKE_MAX, 0, &xqueue_wake_attr[side]);
+        xassert_not_null(self->wake[side]);
+    }
+#endif
 }
 
 /**
- * @brief  Push data into queue.
+ * @brief  Release the OS resources of the queue.
+ * @param  self          this pointer
+ * @retval None
+ */
+void xqueue_deinit(xhal_queue_t *const self)
+{
+    xassert_not_null(self);
+
+#ifdef XHAL_OS_SUPPORTING
+    for (uint32_t side = 0; side < 2; side++)
+    {
+        osSemaphoreDelete(self->wake[side]);
+        self->wake[side] = NULL;
+    }
+#endif
+    self->buffer = NULL;
+}
+
+/**
+ * @brief  Push elements, all of them or none.
  * @param  self      this pointer
- * @param  buffer  data buffer memory.
- * @param  size    data's size.
- * @retval if > 0, the data size; if < 0, error id.
+ * @param  buffer  Elements to push.
+ * @param  count   Element count.
+ * @param  wait    Count the caller as a pusher waiter if they do not fit.
+ * @retval if >= 0, the element count; if < 0, error id.
  */
-int32_t xqueue_push(xhal_queue_t *const self, void *buffer, uint16_t size)
+static int32_t _push(xhal_queue_t *const self, const void *buffer,
+                     uint32_t count, uint8_t wait)
 {
-    int32_t ret = (int32_t)size;
+    int32_t ret   = XHAL_ERR_NOT_ENOUGH;
+    uint32_t wake = 0;
+    int32_t state = _queue_lock();
 
-    if (size > self->size_free)
+    /* count <= capacity <= INT32_MAX on success, so the cast is exact */
+    if (count <= self->capacity - self->count)
     {
-        ret = XHAL_ERR_NOT_ENOUGH;
+        _copy_in(self, (const uint8_t *)buffer, count);
+        if (count > 0)
+            wake = _queue_take_waiters(self, XQUEUE_WAIT_PULL);
+        ret = (int32_t)count;
     }
-    else
+    else if (wait)
     {
-        for (uint16_t i = 0; i < size; i++)
-        {
-            self->buffer[self->head] = ((uint8_t *)buffer)[i];
-            self->head               = (self->head + 1) % self->capacity;
-            self->size_free--;
-        }
+        _queue_wait_prepare(self, XQUEUE_WAIT_PUSH);
     }
 
+    _queue_unlock(state);
+    _queue_wake(self, XQUEUE_WAIT_PULL, wake);
+
     return ret;
 }
 
 /**
- * @brief  Pull data from queue, but the data is not poped.
+ * @brief  Pull and pop elements.
  * @param  self      this pointer
- * @param  buffer  data buffer memory.
- * @param  size    data's size.
- * @retval Actual pulled data size.
+ * @param  buffer  Output for the elements.
+ * @param  count   Maximum element count.
+ * @param  wait    Count the caller as a puller waiter if fewer are stored.
+ * @retval Actual pulled & poped element count.
  */
-uint16_t xqueue_pull(xhal_queue_t *const self, void *buffer, uint16_t size)
+static uint32_t _pull_pop(xhal_queue_t *const self, void *buffer,
+                          uint32_t count, uint8_t wait)
 {
-    uint16_t size_data = self->capacity - self->size_free;
-    uint16_t size_pull = size > size_data ? size_data : size;
+    uint32_t wake = 0;
+    int32_t state = _queue_lock();
+    uint32_t n    = XHAL_MIN(count, self->count);
 
-    for (uint16_t i = 0; i < size_pull; i++)
-    {
-        ((uint8_t *)buffer)[i] =
-            self->buffer[(self->tail + i) % self->capacity];
-    }
+    _copy_out(self, (uint8_t *)buffer, n);
+    self->tail = _slot_add(self, self->tail, n);
+    self->count -= n;
+    if (n > 0)
+        wake = _queue_take_waiters(self, XQUEUE_WAIT_PUSH);
+    if (wait && n < count)
+        _queue_wait_prepare(self, XQUEUE_WAIT_PULL);
+
+    _queue_unlock(state);
+    _queue_wake(self, XQUEUE_WAIT_PUSH, wake);
+
+    return n;
+}
+
+/**
+ * @brief  Push elements into queue, all of them or none.
+ * @param  self      this pointer
+ * @param  buffer  Elements to push.
+ * @param  count   Element count.
+ * @retval if >= 0, the element count; if < 0, error id.
+ */
+int32_t xqueue_push(xhal_queue_t *const self, const void *buffer,
+                    uint32_t count)
+{
+    xassert_not_null(self);
+    xassert(buffer != NULL || count == 0);
 
-    return size_pull;
+    return _push(self, buffer, count, false);
 }
 
 /**
- * @brief  Pop data from queue.
+ * @brief  Pull elements from queue, but the elements are not poped.
  * @param  self      this pointer
- * @param  size    data's size.
- * @retval Actual poped data size.
+ * @param  buffer  Output for the elements.
+ * @param  count   Maximum element count.
+ * @retval Actual pulled element count.
  */
-uint16_t xqueue_pop(xhal_queue_t *const self, uint16_t size)
+uint32_t xqueue_pull(xhal_queue_t *const self, void *buffer, uint32_t count)
 {
-    uint16_t size_data = self->capacity - self->size_free;
-    uint16_t size_pop  = size > size_data ? size_data : size;
+    xassert_not_null(self);
+    xassert(buffer != NULL || count == 0);
 
-    self->tail = (self->tail + size_pop) % self->capacity;
-    self->size_free += size_pop;
+    int32_t state = _queue_lock();
+    uint32_t n    = XHAL_MIN(count, self->count);
 
-    return size_pop;
+    _copy_out(self, (uint8_t *)buffer, n);
+    _queue_unlock(state);
+
+    return n;
 }
 
 /**
- * @brief  Pull and pop data from queue, and the data is poped.
+ * @brief  Pop elements from queue.
  * @param  self      this pointer
- * @param  buffer  data buffer memory.
- * @param  size    data's size.
- * @retval Actual pulled & poped data size.
+ * @param  count   Maximum element count.
+ * @retval Actual poped element count.
  */
-uint16_t xqueue_pull_pop(xhal_queue_t *const self, void *buffer, uint16_t size)
+uint32_t xqueue_pop(xhal_queue_t *const self, uint32_t count)
 {
-    uint16_t size_data = self->capacity - self->size_free;
-    uint16_t size_pop  = size > size_data ? size_data : size;
+    xassert_not_null(self);
 
-    for (uint16_t i = 0; i < size_pop; i++)
-    {
-        ((uint8_t *)buffer)[i] =
-            self->buffer[(self->tail + i) % self->capacity];
-    }
-    self->tail = (self->tail + size_pop) % self->capacity;
-    self->size_free += size_pop;
+    uint32_t wake = 0;
+    int32_t state = _queue_lock();
+    uint32_t n    = XHAL_MIN(count, self->count);
+
+    self->tail = _slot_add(self, self->tail, n);
+    self->count -= n;
+    if (n > 0)
+        wake = _queue_take_waiters(self, XQUEUE_WAIT_PUSH);
+    _queue_unlock(state);
 
-    return size_pop;
+    _queue_wake(self, XQUEUE_WAIT_PUSH, wake);
+
+    return n;
 }
 
 /**
- * @brief  Clear all the data of the queue.
+ * @brief  Pull and pop elements from queue, and the elements are poped.
+ * @param  self      this pointer
+ * @param  buffer  Output for the elements.
+ * @param  count   Maximum element count.
+ * @retval Actual pulled & poped element count.
+ */
+uint32_t xqueue_pull_pop(xhal_queue_t *const self, void *buffer,
+                         uint32_t count)
+{
+    xassert_not_null(self);
+    xassert(buffer != NULL || count == 0);
+
+    return _pull_pop(self, buffer, count, false);
+}
+
+/**
+ * @brief  Clear all the elements of the queue.
  * @param  self          this pointer
- * @retval Free size.
+ * @retval None.
  */
 void xqueue_clear(xhal_queue_t *const self)
 {
-    self->size_free = self->capacity;
-    self->head      = 0;
-    self->tail      = 0;
+    xassert_not_null(self);
+
+    int32_t state = _queue_lock();
+    self->count   = 0;
+    self->head    = 0;
+    self->tail    = 0;
+    uint32_t wake = _queue_take_waiters(self, XQUEUE_WAIT_PUSH);
+    _queue_unlock(state);
+
+    _queue_wake(self, XQUEUE_WAIT_PUSH, wake);
 }
 
 /**
- * @brief  Get the free size of the queue.
+ * @brief  Get the free element count of the queue.
  * @param  self          this pointer
- * @retval Free size.
+ * @retval Free element count.
  */
-uint16_t xqueue_free_size(xhal_queue_t *const self)
+uint32_t xqueue_free_size(xhal_queue_t *const self)
 {
-    return self->size_free;
+    return self->capacity - self->count;
+}
+
+/**
+ * @brief  Get the stored element count of the queue.
+ * @param  self          this pointer
+ * @retval Stored element count.
+ */
+uint32_t xqueue_count(xhal_queue_t *const self)
+{
+    return self->count;
 }
 
 /**
@@ -135,7 +449,7 @@ uint16_t xqueue_free_size(xhal_queue_t *const self)
  */
 uint8_t xqueue_is_empty(xhal_queue_t *const self)
 {
-    return self->size_free == self->capacity ? true : false;
+    return self->count == 0 ? true : false;
 }
 
 /**
@@ -145,5 +459,74 @@ uint8_t xqueue_is_empty(xhal_queue_t *const self)
  */
 uint8_t xqueue_is_full(xhal_queue_t *const self)
 {
-    return self->size_free == 0 ? true : false;
+    return self->count == self->capacity ? true : false;
+}
+
+/**
+ * @brief  Push elements into queue, waiting until they all fit.
+ * @param  self        this pointer
+ * @param  buffer      Elements to push.
+ * @param  count       Element count, at most the capacity.
+ * @param  timeout_ms  Maximum wait time, XHAL_WAIT_FOREVER to wait forever.
+ * @retval XHAL_OK, XHAL_ERR_TIMEOUT, or XHAL_ERR_INVALID if count exceeds
+ *         the capacity.
+ */
+xhal_err_t xqueue_push_wait(xhal_queue_t *const self, const void *buffer,
+                            uint32_t count, uint32_t timeout_ms)
+{
+    xassert_not_null(self);
+
+    if (count > self->capacity)
+        return XHAL_ERR_INVALID;
+
+    xhal_tick_t start_tick_ms = xtime_get_tick_ms();
+
+    while (1)
+    {
+        uint32_t elapsed_ms = TIME_DIFF(xtime_get_tick_ms(), start_tick_ms);
+        uint8_t can_wait    = elapsed_ms < timeout_ms;
+
+        /* Checked and counted as a waiter under one lock, see above */
+        if (_push(self, buffer, count, can_wait) >= 0)
+            return XHAL_OK;
+
+        if (!can_wait)
+            return XHAL_ERR_TIMEOUT;
+
+        _queue_wait(self, XQUEUE_WAIT_PUSH, timeout_ms - elapsed_ms);
+    }
+}
+
+/**
+ * @brief  Pull and pop elements from queue, waiting until count elements
+ *         have been taken or the timeout expires.
+ * @param  self        this pointer
+ * @param  buffer      Output for the elements.
+ * @param  count       Element count.
+ * @param  timeout_ms  Maximum wait time, XHAL_WAIT_FOREVER to wait forever.
+ * @retval Actual pulled & poped element count.
+ */
+uint32_t xqueue_pull_pop_wait(xhal_queue_t *const self, void *buffer,
+                              uint32_t count, uint32_t timeout_ms)
+{
+    xassert_not_null(self);
+    xassert(buffer != NULL || count == 0);
+
+    xhal_tick_t start_tick_ms = xtime_get_tick_ms();
+    uint32_t read             = 0;
+
+    while (read < count)
+    {
+        uint32_t elapsed_ms = TIME_DIFF(xtime_get_tick_ms(), start_tick_ms);
+        uint8_t can_wait    = elapsed_ms < timeout_ms;
+
+        read += _pull_pop(self, (uint8_t *)buffer + read * self->elem_size,
+                          count - read, can_wait);
+        if (read >= count || !can_wait)
+            break;
+
+        _queue_wait(self, XQUEUE_WAIT_PULL, timeout_ms - elapsed_ms);
+    }
+
+    return read;
 }
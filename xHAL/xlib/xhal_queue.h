@@ -1,25 +1,49 @@
 #ifndef __XHAL_QUEUE_H
 #define __XHAL_QUEUE_H
 
+#include "../xcore/xhal_def.h"
 #include "../xcore/xhal_std.h"
 
+#ifdef XHAL_OS_SUPPORTING
+#include "../xos/xhal_os.h"
+#endif
+
+#define XQUEUE_WAIT_PUSH (0) /* Waiting for free slots */
+#define XQUEUE_WAIT_PULL (1) /* Waiting for elements */
+
 typedef struct xhal_queue
 {
     uint8_t *buffer;
-    uint16_t head;
-    uint16_t tail;
-    uint16_t capacity;
-    uint16_t size_free;
+    uint32_t head;      /* Slot the next element is pushed to */
+    uint32_t tail;      /* Slot the next element is pulled from */
+    uint32_t capacity;  /* Capacity in elements */
+    uint32_t count;     /* Elements stored */
+    uint32_t elem_size; /* Element size in bytes */
+#ifdef XHAL_OS_SUPPORTING
+    osSemaphoreId_t wake[2]; /* XQUEUE_WAIT_xxx, one token per woken waiter */
+    uint32_t waiters[2];     /* Blocked callers of each side */
+#endif
 } xhal_queue_t;
 
-void xqueue_init(xhal_queue_t *const self, void *buffer, uint16_t capacity);
-int32_t xqueue_push(xhal_queue_t *const self, void *buffer, uint16_t size);
-uint16_t xqueue_pull(xhal_queue_t *const self, void *buffer, uint16_t size);
-uint16_t xqueue_pop(xhal_queue_t *const self, uint16_t size);
+void xqueue_init(xhal_queue_t *const self, void *buffer, uint32_t capacity);
+void xqueue_init_elem(xhal_queue_t *const self, void *buffer,
+                      uint32_t elem_size, uint32_t capacity);
+void xqueue_deinit(xhal_queue_t *const self);
+int32_t xqueue_push(xhal_queue_t *const self, const void *buffer,
+                    uint32_t count);
+uint32_t xqueue_pull(xhal_queue_t *const self, void *buffer, uint32_t count);
+uint32_t xqueue_pop(xhal_queue_t *const self, uint32_t count);
 void xqueue_clear(xhal_queue_t *const self);
-uint16_t xqueue_pull_pop(xhal_queue_t *const self, void *buffer, uint16_t size);
-uint16_t xqueue_free_size(xhal_queue_t *const self);
+uint32_t xqueue_pull_pop(xhal_queue_t *const self, void *buffer,
+                         uint32_t count);
+uint32_t xqueue_free_size(xhal_queue_t *const self);
+uint32_t xqueue_count(xhal_queue_t *const self);
 uint8_t xqueue_is_empty(xhal_queue_t *const self);
 uint8_t xqueue_is_full(xhal_queue_t *const self);
 
+xhal_err_t xqueue_push_wait(xhal_queue_t *const self, const void *buffer,
+                            uint32_t count, uint32_t timeout_ms);
+uint32_t xqueue_pull_pop_wait(xhal_queue_t *const self, void *buffer,
+                              uint32_t count, uint32_t timeout_ms);
+
 #endif /* __XHAL_QUEUE_H */
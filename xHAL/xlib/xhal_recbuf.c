@@ -0,0 +1,249 @@
+#include "xhal_recbuf.h"
+#include "../xcore/xhal_assert.h"
+#include "../xcore/xhal_log.h"
+#include "../xcore/xhal_malloc.h"
+
+XLOG_TAG("xRecBuf");
+
+/*
+ * A record is reserved, filled and committed in one step, so the consumer
+ * never sees a header without its payload. Without XRECBUF_FLAG_DROP_OLDEST
+ * the ring runs in SPSC mode and one producer may push while one consumer
+ * pops, without a lock; every counter below has a single writer. Dropping
+ * the oldest record moves the read pointer from the producer side, so both
+ * sides must then hold the same lock.
+ */
+
+/**
+ * @brief  Copy bytes into reserved segments, starting `offset` bytes in.
+ * @param  seg     The segments returned by xrbuf_reserve.
+ * @param  offset  Offset from the start of the reservation.
+ * @param  src     The source bytes.
+ * @param  len     Byte count.
+ * @retval None.
+ */
+static void _seg_put(const xrbuf_seg_t *seg, uint32_t offset,
+                     const void *src, uint32_t len)
+{
+    const uint8_t *s = (const uint8_t *)src;
+
+    if (offset < seg->len[0])
+    {
+        uint32_t n = XHAL_MIN(len, seg->len[0] - offset);
+        xmemcpy(seg->ptr[0] + offset, s, n);
+        s += n;
+        len -= n;
+        offset = 0;
+    }
+    else
+    {
+        offset -= seg->len[0];
+    }
+
+    if (len > 0)
+        xmemcpy(seg->ptr[1] + offset, s, len);
+}
+
+/**
+ * @brief  Discard the oldest record.
+ * @param  self    The record buffer handle.
+ * @retval 1 if one record was dropped, 0 if the buffer is empty.
+ */
+static uint8_t _drop_oldest(xrecbuf_t *const self)
+{
+    uint16_t hdr = 0;
+
+    if (xrbuf_peek(&self->rb, 0, &hdr, sizeof(hdr)) != sizeof(hdr))
+        return 0;
+
+    xrbuf_skip(&self->rb, XRECBUF_HDR_SIZE + hdr);
+    self->drop_count++;
+
+    return 1;
+}
+
+/**
+ * @brief  Initialize one record buffer on the given storage.
+ * @param  self    The record buffer handle.
+ * @param  buff    Storage, XRECBUF_BUFF_SIZE(len, count) bytes hold `count`
+ *                 records of `len` bytes.
+ * @param  size    Storage size in bytes.
+ * @param  flags   XRECBUF_FLAG_xxx.
+ * @retval See xhal_err_t.
+ */
+xhal_err_t xrecbuf_init(xrecbuf_t *const self, void *buff, uint32_t size,
+                        uint8_t flags)
+{
+    xassert_not_null(self);
+    xassert_not_null(buff);
+
+    if (size <= XRECBUF_HDR_SIZE + 1)
+        return XHAL_ERR_INVALID;
+
+    uint8_t mode = (flags & XRECBUF_FLAG_DROP_OLDEST) ? 0 : XRBUF_MODE_SPSC;
+    xrbuf_init_ex(&self->rb, buff, size, mode);
+
+    self->used_max   = 0;
+    self->push_count = 0;
+    self->pop_count  = 0;
+    self->drop_count = 0;
+    self->fail_count = 0;
+    self->flags      = flags;
+
+    return XHAL_OK;
+}
+
+/**
+ * @brief  Detach the record buffer from its storage.
+ * @param  self    The record buffer handle.
+ * @retval None.
+ */
+void xrecbuf_deinit(xrecbuf_t *const self)
+{
+    xassert_not_null(self);
+
+    xrbuf_free(&self->rb);
+}
+
+/**
+ * @brief  Check whether the record buffer is initialized.
+ * @param  self    The record buffer handle.
+ * @retval 1 if ready, otherwise 0.
+ */
+uint8_t xrecbuf_is_ready(const xrecbuf_t *const self)
+{
+    xassert_not_null(self);
+
+    return self->rb.buff != NULL && self->rb.size > 0;
+}
+
+/**
+ * @brief  Append one record. Either the whole record is stored or nothing.
+ * @param  self    The record buffer handle.
+ * @param  data    The payload, may be NULL when `len` is 0.
+ * @param  len     Payload size in bytes.
+ * @retval XHAL_OK on success, XHAL_ERR_FULL if there is no room and oldest
+ *         records may not be dropped, XHAL_ERR_INVALID if the record can
+ *         never fit.
+ */
+xhal_err_t xrecbuf_push(xrecbuf_t *const self, const void *data, uint32_t len)
+{
+    xassert_not_null(self);
+    xassert(data != NULL || len == 0);
+
+    uint32_t need = XRECBUF_HDR_SIZE + len;
+    if (len > XRECBUF_LEN_MAX || need > self->rb.size - 1)
+    {
+        self->fail_count++;
+        return XHAL_ERR_INVALID;
+    }
+
+    while (xrbuf_get_free(&self->rb) < need)
+    {
+        if (!(self->flags & XRECBUF_FLAG_DROP_OLDEST) || !_drop_oldest(self))
+        {
+            self->fail_count++;
+            return XHAL_ERR_FULL;
+        }
+    }
+
+    uint16_t hdr = (uint16_t)len;
+    xrbuf_seg_t seg;
+    xrbuf_reserve(&self->rb, need, &seg);
+    _seg_put(&seg, 0, &hdr, sizeof(hdr));
+    if (len > 0)
+        _seg_put(&seg, sizeof(hdr), data, len);
+    xrbuf_commit(&self->rb, need);
+
+    self->push_count++;
+    uint32_t used = xrbuf_get_full(&self->rb);
+    if (used > self->used_max)
+        self->used_max = used;
+
+    return XHAL_OK;
+}
+
+/**
+ * @brief  Remove the oldest record and copy out its payload.
+ * @param  self    The record buffer handle.
+ * @param  data    The payload output, may be NULL when `size` is 0.
+ * @param  size    Capacity of `data` in bytes.
+ * @param  len     Optional, receives the payload size. On XHAL_ERR_NOT_ENOUGH
+ *                 it receives the size needed and the record is kept.
+ * @retval XHAL_OK on success, XHAL_ERR_EMPTY if there is no record,
+ *         XHAL_ERR_NOT_ENOUGH if `size` is too small.
+ */
+xhal_err_t xrecbuf_pop(xrecbuf_t *const self, void *data, uint32_t size,
+                       uint32_t *len)
+{
+    xassert_not_null(self);
+    xassert(data != NULL || size == 0);
+
+    uint16_t hdr = 0;
+    if (xrbuf_peek(&self->rb, 0, &hdr, sizeof(hdr)) != sizeof(hdr))
+        return XHAL_ERR_EMPTY;
+
+    if (len != NULL)
+        *len = hdr;
+
+    if (hdr > size)
+        return XHAL_ERR_NOT_ENOUGH;
+
+    if (hdr > 0)
+        xrbuf_peek(&self->rb, XRECBUF_HDR_SIZE, data, hdr);
+    xrbuf_skip(&self->rb, XRECBUF_HDR_SIZE + hdr);
+    self->pop_count++;
+
+    return XHAL_OK;
+}
+
+/**
+ * @brief  Discard every record and restart the statistics. Not safe against
+ * a concurrent push or pop.
+ * @param  self    The record buffer handle.
+ * @retval None.
+ */
+void xrecbuf_reset(xrecbuf_t *const self)
+{
+    xassert_not_null(self);
+
+    xrbuf_reset(&self->rb);
+
+    self->used_max   = 0;
+    self->push_count = 0;
+    self->pop_count  = 0;
+    self->drop_count = 0;
+    self->fail_count = 0;
+}
+
+/**
+ * @brief  Get the count of records currently stored.
+ * @param  self    The record buffer handle.
+ * @retval The record count.
+ */
+uint32_t xrecbuf_count(const xrecbuf_t *const self)
+{
+    xassert_not_null(self);
+
+    return self->push_count - self->pop_count - self->drop_count;
+}
+
+/**
+ * @brief  Get the record buffer statistics.
+ * @param  self    The record buffer handle.
+ * @param  stats   The statistics output.
+ * @retval None.
+ */
+void xrecbuf_get_stats(const xrecbuf_t *const self, xrecbuf_stats_t *stats)
+{
+    xassert_not_null(self);
+    xassert_not_null(stats);
+
+    stats->count      = xrecbuf_count(self);
+    stats->used       = xrbuf_get_full(&self->rb);
+    stats->used_max   = self->used_max;
+    stats->push_count = self->push_count;
+    stats->pop_count  = self->pop_count;
+    stats->drop_count = self->drop_count;
+    stats->fail_count = self->fail_count;
+}
@@ -0,0 +1,54 @@
+#ifndef __XHAL_RECBUF_H
+#define __XHAL_RECBUF_H
+
+#include "../xcore/xhal_def.h"
+#include "../xcore/xhal_std.h"
+#include "xhal_ringbuf.h"
+
+#define XRECBUF_FLAG_DROP_OLDEST (1U << 0) /* Drop oldest records when full */
+
+/* Every record is stored as a 16-bit length followed by its payload. */
+#define XRECBUF_HDR_SIZE         (sizeof(uint16_t))
+#define XRECBUF_LEN_MAX          (0xFFFFU)
+
+/* Bytes of storage needed to hold `count` records of `len` bytes. */
+#define XRECBUF_BUFF_SIZE(len, count) \
+    ((XRECBUF_HDR_SIZE + (len)) * (count) + 1)
+
+typedef struct xrecbuf_stats
+{
+    uint32_t count;      /* Records currently stored */
+    uint32_t used;       /* Bytes currently stored, headers included */
+    uint32_t used_max;   /* High-water mark of `used` */
+    uint32_t push_count; /* Records pushed */
+    uint32_t pop_count;  /* Records popped */
+    uint32_t drop_count; /* Oldest records dropped to make room */
+    uint32_t fail_count; /* Pushes refused */
+} xrecbuf_stats_t;
+
+typedef struct xrecbuf
+{
+    xrbuf_t rb;
+    uint32_t used_max;
+    uint32_t push_count;
+    uint32_t pop_count;
+    uint32_t drop_count;
+    uint32_t fail_count;
+    uint8_t flags;
+} xrecbuf_t;
+
+xhal_err_t xrecbuf_init(xrecbuf_t *const self, void *buff, uint32_t size,
+                        uint8_t flags);
+void xrecbuf_deinit(xrecbuf_t *const self);
+uint8_t xrecbuf_is_ready(const xrecbuf_t *const self);
+
+xhal_err_t xrecbuf_push(xrecbuf_t *const self, const void *data,
+                        uint32_t len);
+xhal_err_t xrecbuf_pop(xrecbuf_t *const self, void *data, uint32_t size,
+                       uint32_t *len);
+void xrecbuf_reset(xrecbuf_t *const self);
+
+uint32_t xrecbuf_count(const xrecbuf_t *const self);
+void xrecbuf_get_stats(const xrecbuf_t *const self, xrecbuf_stats_t *stats);
+
+#endif /* __XHAL_RECBUF_H */
@@ -28,6 +28,12 @@
  */
 #include "xhal_ringbuf.h"
 #include "../xcore/xhal_malloc.h"
+#if XRBUF_STATS_ENABLE
+#include "../xcore/xhal_time.h"
+#ifdef XHAL_OS_SUPPORTING
+#include "../xos/xhal_os.h"
+#endif
+#endif
 
 /* Memory set and copy functions */
 #define BUF_MEMSET      xmemset
@@ -43,16 +49,188 @@
         }                                                                                                              \
     } while (0)
 
-/* Optional atomic opeartions */
+#define BUF_IS_SPSC(b)  (((b)->mode & XRBUF_MODE_SPSC) != 0)
+#define BUF_IS_POW2(b)  (((b)->mode & XRBUF_MODE_POW2) != 0)
+
+/*
+ * Index arithmetic.
+ *
+ * Default instances keep both pointers in `[0, size)` and leave one byte unused to tell full from empty.
+ * \ref XRBUF_MODE_POW2 instances let the pointers run freely and mask them on access,
+ * so the fill level is the plain difference and all `size` bytes are usable.
+ */
+#define BUF_IDX(b, ptr) (BUF_IS_POW2(b) ? ((ptr) & ((b)->size - 1U)) : (ptr))
+#define BUF_CAP(b)      (BUF_IS_POW2(b) ? (b)->size : (b)->size - 1U)
+
+/*
+ * Read/write pointer access.
+ *
+ * Default instances only need each access to be atomic; external locking provides ordering.
+ * \ref XRBUF_MODE_SPSC instances additionally order the access against the data copy:
+ * the producer observes `r_ptr` with acquire and publishes `w_ptr` with release,
+ * the consumer does the opposite. Accesses to its own pointer are relaxed.
+ */
 #ifdef XRBUF_DISABLE_ATOMIC
-#define XRBUF_INIT(var, val)        (var) = (val)
-#define XRBUF_LOAD(var, type)       (var)
-#define XRBUF_STORE(var, val, type) (var) = (val)
+#if defined(__GNUC__) || defined(__clang__)
+#define XRBUF_BARRIER() __asm__ volatile("" ::: "memory")
+#elif defined(__CC_ARM)
+#define XRBUF_BARRIER() __schedule_barrier()
+#else
+#define XRBUF_BARRIER()
+#endif
+
+/* Without C11 atomics, SPSC ordering relies on a compiler barrier (single-core only) */
+static inline unsigned long
+prv_load_spsc(const xrbuf_sz_atomic_t* var) {
+    unsigned long val = *(const volatile xrbuf_sz_atomic_t*)var;
+    XRBUF_BARRIER();
+    return val;
+}
+
+#define XRBUF_INIT(var, val)           (var) = (val)
+#define XRBUF_LOAD(b, var, type)       (BUF_IS_SPSC(b) ? prv_load_spsc(&(b)->var) : (b)->var)
+#define XRBUF_STORE(b, var, val, type)                                                                                 \
+    do {                                                                                                               \
+        if (BUF_IS_SPSC(b)) {                                                                                          \
+            XRBUF_BARRIER();                                                                                           \
+            *(volatile xrbuf_sz_atomic_t*)&(b)->var = (val);                                                           \
+        } else {                                                                                                       \
+            (b)->var = (val);                                                                                          \
+        }                                                                                                              \
+    } while (0)
+#else
+#define XRBUF_INIT(var, val) atomic_init(&(var), (val))
+#define XRBUF_LOAD(b, var, type)                                                                                       \
+    (BUF_IS_SPSC(b) ? atomic_load_explicit(&(b)->var, (type))                                                          \
+                    : atomic_load_explicit(&(b)->var, memory_order_relaxed))
+#define XRBUF_STORE(b, var, val, type)                                                                                 \
+    do {                                                                                                               \
+        if (BUF_IS_SPSC(b)) {                                                                                          \
+            atomic_store_explicit(&(b)->var, (val), (type));                                                           \
+        } else {                                                                                                       \
+            atomic_store_explicit(&(b)->var, (val), memory_order_relaxed);                                             \
+        }                                                                                                              \
+    } while (0)
+#endif
+
+/**
+ * \brief           Move a read or write pointer forward
+ * \param[in]       buff: Ring buffer instance
+ * \param[in]       ptr: Current pointer value
+ * \param[in]       len: Number of bytes to move, at most `size`
+ * \return          New pointer value
+ */
+static inline uint32_t
+prv_ptr_add(const xrbuf_t* buff, uint32_t ptr, uint32_t len) {
+    ptr += len;
+    if (!BUF_IS_POW2(buff) && ptr >= buff->size) {
+        ptr -= buff->size;
+    }
+    return ptr;
+}
+
+/**
+ * \brief           Get number of bytes between read and write pointer
+ * \param[in]       buff: Ring buffer instance
+ * \param[in]       w_ptr: Write pointer value
+ * \param[in]       r_ptr: Read pointer value
+ * \return          Number of bytes stored
+ */
+static inline uint32_t
+prv_full(const xrbuf_t* buff, uint32_t w_ptr, uint32_t r_ptr) {
+    if (BUF_IS_POW2(buff) || w_ptr >= r_ptr) {
+        return w_ptr - r_ptr;
+    }
+    return buff->size - (r_ptr - w_ptr);
+}
+
+#if XRBUF_STATS_ENABLE
+static xrbuf_t* prv_registry; /*!< Registered buffers, newest first */
+
+/**
+ * \brief           Enter the registry critical section
+ * \return          State to be passed to \ref prv_registry_unlock
+ */
+static inline int32_t
+prv_registry_lock(void) {
+#ifdef XHAL_OS_SUPPORTING
+    return osKernelLock();
+#else
+    return 0;
+#endif
+}
+
+/**
+ * \brief           Leave the registry critical section
+ * \param[in]       state: State returned by \ref prv_registry_lock
+ */
+static inline void
+prv_registry_unlock(int32_t state) {
+#ifdef XHAL_OS_SUPPORTING
+    (void)osKernelRestoreLock(state);
 #else
-#define XRBUF_INIT(var, val)        atomic_init(&(var), (val))
-#define XRBUF_LOAD(var, type)       atomic_load_explicit(&(var), (type))
-#define XRBUF_STORE(var, val, type) atomic_store_explicit(&(var), (val), (type))
+    (void)state;
 #endif
+}
+
+/**
+ * \brief           Account for a producer operation
+ *
+ * The producer opens a full period by stamping `full_since` and bumping `full_count`.
+ * It opens no new one until the consumer has caught up with `full_seen`.
+ *
+ * \param[in]       buff: Ring buffer instance
+ * \param[in]       req: Number of bytes requested
+ * \param[in]       len: Number of bytes actually written
+ */
+static void
+prv_stats_in(xrbuf_t* buff, uint32_t req, uint32_t len) {
+    uint32_t full = xrbuf_get_full(buff);
+
+    buff->stats.bytes_in += len;
+    if (len < req) {
+        ++buff->stats.overflow;
+    }
+    if (full > buff->stats.used_max) {
+        buff->stats.used_max = full;
+    }
+    if (full == BUF_CAP(buff) && buff->stats.full_count == buff->stats.full_seen) {
+        buff->stats.full_since = xtime_get_tick_ms();
+        ++buff->stats.full_count;
+    }
+}
+
+/**
+ * \brief           Account for a consumer operation
+ *
+ * The consumer closes an open full period by adding it to `full_ms` and catching
+ * `full_seen` up with `full_count`.
+ *
+ * \param[in]       buff: Ring buffer instance
+ * \param[in]       len: Number of bytes actually read, `0` when buffer was empty
+ */
+static void
+prv_stats_out(xrbuf_t* buff, uint32_t len) {
+    uint32_t count;
+
+    if (len == 0) {
+        ++buff->stats.underflow;
+        return;
+    }
+    buff->stats.bytes_out += len;
+    count = buff->stats.full_count;
+    if (count != buff->stats.full_seen) {
+        buff->stats.full_ms += TIME_DIFF(xtime_get_tick_ms(), buff->stats.full_since);
+        buff->stats.full_seen = count;
+    }
+}
+
+#define BUF_STATS_IN(b, req, len) prv_stats_in((b), (req), (len))
+#define BUF_STATS_OUT(b, len)     prv_stats_out((b), (len))
+#else
+#define BUF_STATS_IN(b, req, len) ((void)(req))
+#define BUF_STATS_OUT(b, len)
+#endif /* XRBUF_STATS_ENABLE */
 
 /**
  * \brief           Initialize buffer handle to default values with size and buffer data array
@@ -64,15 +242,40 @@
  */
 uint8_t
 xrbuf_init(xrbuf_t* buff, void* buffdata, uint32_t size) {
+    return xrbuf_init_ex(buff, buffdata, size, 0);
+}
+
+/**
+ * \brief           Initialize buffer handle with operating mode
+ * \param[in]       buff: Ring buffer instance
+ * \param[in]       buffdata: Pointer to memory to use as buffer data
+ * \param[in]       size: Size of `buffdata` in units of bytes
+ *                      Maximum number of bytes buffer can hold is `size - 1`
+ * \param[in]       mode: Bitwise OR of `XRBUF_MODE_xxx`, `0` for default mode
+ *                      \ref XRBUF_MODE_SPSC: One producer and one consumer may run
+ *                          concurrently without locks
+ *                      \ref XRBUF_MODE_POW2: `size` is a power of two, indices wrap by mask
+ *                          and the buffer can hold all `size` bytes
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+xrbuf_init_ex(xrbuf_t* buff, void* buffdata, uint32_t size, uint8_t mode) {
     if (buff == NULL || buffdata == NULL || size == 0) {
         return 0;
     }
+    if ((mode & XRBUF_MODE_POW2) && (size & (size - 1U)) != 0) {
+        return 0;
+    }
 
     buff->evt_fn = NULL;
     buff->size = size;
     buff->buff = buffdata;
+    buff->mode = mode;
     XRBUF_INIT(buff->w_ptr, 0);
     XRBUF_INIT(buff->r_ptr, 0);
+#if XRBUF_STATS_ENABLE
+    BUF_MEMSET(&buff->stats, 0, sizeof(buff->stats));
+#endif
     return 1;
 }
 
@@ -95,6 +298,7 @@ xrbuf_is_ready(xrbuf_t* buff) {
 void
 xrbuf_free(xrbuf_t* buff) {
     if (BUF_IS_VALID(buff)) {
+        xrbuf_unregister(buff);
         buff->buff = NULL;
     }
 }
@@ -174,7 +378,7 @@ xrbuf_write(xrbuf_t* buff, const void* data, uint32_t btw) {
  */
 uint8_t
 xrbuf_write_ex(xrbuf_t* buff, const void* data, uint32_t btw, uint32_t* bwritten, uint16_t flags) {
-    uint32_t tocopy = 0, free = 0, w_ptr = 0;
+    uint32_t tocopy = 0, free = 0, w_ptr = 0, w_idx = 0, req = btw;
     const uint8_t* d_ptr = data;
 
     if (!BUF_IS_VALID(buff) || data == NULL || btw == 0) {
@@ -185,34 +389,33 @@ xrbuf_write_ex(xrbuf_t* buff, const void* data, uint32_t btw, uint32_t* bwritten
     free = xrbuf_get_free(buff);
     /* If no memory, or if user wants to write ALL data but no enough space, exit early */
     if (free == 0 || (free < btw && (flags & XRBUF_FLAG_WRITE_ALL))) {
+        BUF_STATS_IN(buff, req, 0);
         return 0;
     }
     btw = BUF_MIN(free, btw);
-    w_ptr = XRBUF_LOAD(buff->w_ptr, memory_order_acquire);
+    w_ptr = XRBUF_LOAD(buff, w_ptr, memory_order_relaxed);
+    w_idx = BUF_IDX(buff, w_ptr);
 
     /* Step 1: Write data to linear part of buffer */
-    tocopy = BUF_MIN(buff->size - w_ptr, btw);
-    BUF_MEMCPY(&buff->buff[w_ptr], d_ptr, tocopy);
+    tocopy = BUF_MIN(buff->size - w_idx, btw);
+    BUF_MEMCPY(&buff->buff[w_idx], d_ptr, tocopy);
     d_ptr += tocopy;
-    w_ptr += tocopy;
     btw -= tocopy;
 
     /* Step 2: Write data to beginning of buffer (overflow part) */
     if (btw > 0) {
         BUF_MEMCPY(buff->buff, d_ptr, btw);
-        w_ptr = btw;
     }
 
-    /* Step 3: Check end of buffer */
-    if (w_ptr >= buff->size) {
-        w_ptr = 0;
-    }
+    /* Step 3: Move pointer, wrapping at end of buffer */
+    w_ptr = prv_ptr_add(buff, w_ptr, tocopy + btw);
 
     /*
      * Write final value to the actual running variable.
      * This is to ensure no read operation can access intermediate data
      */
-    XRBUF_STORE(buff->w_ptr, w_ptr, memory_order_release);
+    XRBUF_STORE(buff, w_ptr, w_ptr, memory_order_release);
+    BUF_STATS_IN(buff, req, tocopy + btw);
 
     BUF_SEND_EVT(buff, XRBUF_EVT_WRITE, tocopy + btw);
     if (bwritten != NULL) {
@@ -259,7 +462,7 @@ xrbuf_read(xrbuf_t* buff, void* data, uint32_t btr) {
  */
 uint8_t
 xrbuf_read_ex(xrbuf_t* buff, void* data, uint32_t btr, uint32_t* bread, uint16_t flags) {
-    uint32_t tocopy = 0, full = 0, r_ptr = 0;
+    uint32_t tocopy = 0, full = 0, r_ptr = 0, r_idx = 0;
     uint8_t* d_ptr = data;
 
     if (!BUF_IS_VALID(buff) || data == NULL || btr == 0) {
@@ -269,34 +472,35 @@ xrbuf_read_ex(xrbuf_t* buff, void* data, uint32_t btr, uint32_t* bread, uint16_t
     /* Calculate maximum number of bytes available to read */
     full = xrbuf_get_full(buff);
     if (full == 0 || (full < btr && (flags & XRBUF_FLAG_READ_ALL))) {
+        if (full == 0) {
+            BUF_STATS_OUT(buff, 0);
+        }
         return 0;
     }
     btr = BUF_MIN(full, btr);
-    r_ptr = XRBUF_LOAD(buff->r_ptr, memory_order_acquire);
+    r_ptr = XRBUF_LOAD(buff, r_ptr, memory_order_relaxed);
+    r_idx = BUF_IDX(buff, r_ptr);
 
     /* Step 1: Read data from linear part of buffer */
-    tocopy = BUF_MIN(buff->size - r_ptr, btr);
-    BUF_MEMCPY(d_ptr, &buff->buff[r_ptr], tocopy);
+    tocopy = BUF_MIN(buff->size - r_idx, btr);
+    BUF_MEMCPY(d_ptr, &buff->buff[r_idx], tocopy);
     d_ptr += tocopy;
-    r_ptr += tocopy;
     btr -= tocopy;
 
     /* Step 2: Read data from beginning of buffer (overflow part) */
     if (btr > 0) {
         BUF_MEMCPY(d_ptr, buff->buff, btr);
-        r_ptr = btr;
     }
 
-    /* Step 3: Check end of buffer */
-    if (r_ptr >= buff->size) {
-        r_ptr = 0;
-    }
+    /* Step 3: Move pointer, wrapping at end of buffer */
+    r_ptr = prv_ptr_add(buff, r_ptr, tocopy + btr);
 
     /*
      * Write final value to the actual running variable.
      * This is to ensure no write operation can access intermediate data
      */
-    XRBUF_STORE(buff->r_ptr, r_ptr, memory_order_release);
+    XRBUF_STORE(buff, r_ptr, r_ptr, memory_order_release);
+    BUF_STATS_OUT(buff, tocopy + btr);
 
     BUF_SEND_EVT(buff, XRBUF_EVT_READ, tocopy + btr);
     if (bread != NULL) {
@@ -330,12 +534,9 @@ xrbuf_peek(const xrbuf_t* buff, uint32_t skip_count, void* data, uint32_t btp) {
     if (skip_count >= full) {
         return 0;
     }
-    r_ptr = XRBUF_LOAD(buff->r_ptr, memory_order_relaxed);
-    r_ptr += skip_count;
+    r_ptr = XRBUF_LOAD(buff, r_ptr, memory_order_relaxed);
+    r_ptr = BUF_IDX(buff, prv_ptr_add(buff, r_ptr, skip_count));
     full -= skip_count;
-    if (r_ptr >= buff->size) {
-        r_ptr -= buff->size;
-    }
 
     /* Check maximum number of bytes available to read after skip */
     btp = BUF_MIN(full, btp);
@@ -386,18 +587,16 @@ xrbuf_get_free(const xrbuf_t* buff) {
      * - buff->r pointer may change by another process. If it gets changed after buff->r has been loaded to local variable,
      *    buffer will see "free size" less than it actually is. This is not a problem, application can
      *    always try again to write more data to remaining free memory that was read just during copy operation
+     *
+     * In \ref XRBUF_MODE_SPSC, buff->r is loaded with acquire, so the consumer
+     * has finished copying out all bytes it released before the producer reuses them.
      */
-    w_ptr = XRBUF_LOAD(buff->w_ptr, memory_order_relaxed);
-    r_ptr = XRBUF_LOAD(buff->r_ptr, memory_order_relaxed);
-
-    if (w_ptr >= r_ptr) {
-        size = buff->size - (w_ptr - r_ptr);
-    } else {
-        size = r_ptr - w_ptr;
-    }
+    w_ptr = XRBUF_LOAD(buff, w_ptr, memory_order_relaxed);
+    r_ptr = XRBUF_LOAD(buff, r_ptr, memory_order_acquire);
 
-    /* Buffer free size is always 1 less than actual size */
-    return size - 1;
+    /* Default buffer free size is always 1 less than actual size */
+    size = BUF_CAP(buff) - prv_full(buff, w_ptr, r_ptr);
+    return size;
 }
 
 /**
@@ -430,15 +629,14 @@ xrbuf_get_full(const xrbuf_t* buff) {
      * - buff->w pointer may change by another process. If it gets changed after buff->w has been loaded to local variable,
      *    buffer will see "full size" less than it really is. This is not a problem, application can
      *    always try again to read more data from remaining full memory that was written just during copy operation
+     *
+     * In \ref XRBUF_MODE_SPSC, buff->w is loaded with acquire, so all bytes
+     * published by the producer are visible before the consumer copies them out.
      */
-    w_ptr = XRBUF_LOAD(buff->w_ptr, memory_order_relaxed);
-    r_ptr = XRBUF_LOAD(buff->r_ptr, memory_order_relaxed);
+    w_ptr = XRBUF_LOAD(buff, w_ptr, memory_order_acquire);
+    r_ptr = XRBUF_LOAD(buff, r_ptr, memory_order_relaxed);
 
-    if (w_ptr >= r_ptr) {
-        size = w_ptr - r_ptr;
-    } else {
-        size = buff->size - (r_ptr - w_ptr);
-    }
+    size = prv_full(buff, w_ptr, r_ptr);
     return size;
 }
 
@@ -451,8 +649,14 @@ xrbuf_get_full(const xrbuf_t* buff) {
 void
 xrbuf_reset(xrbuf_t* buff) {
     if (BUF_IS_VALID(buff)) {
-        XRBUF_STORE(buff->w_ptr, 0, memory_order_release);
-        XRBUF_STORE(buff->r_ptr, 0, memory_order_release);
+        XRBUF_STORE(buff, w_ptr, 0, memory_order_release);
+        XRBUF_STORE(buff, r_ptr, 0, memory_order_release);
+#if XRBUF_STATS_ENABLE
+        if (buff->stats.full_count != buff->stats.full_seen) {
+            buff->stats.full_ms += TIME_DIFF(xtime_get_tick_ms(), buff->stats.full_since);
+            buff->stats.full_seen = buff->stats.full_count;
+        }
+#endif
         BUF_SEND_EVT(buff, XRBUF_EVT_RESET, 0);
     }
 }
@@ -469,8 +673,8 @@ xrbuf_get_linear_block_read_address(const xrbuf_t* buff) {
     if (!BUF_IS_VALID(buff)) {
         return NULL;
     }
-    ptr = XRBUF_LOAD(buff->r_ptr, memory_order_relaxed);
-    return &buff->buff[ptr];
+    ptr = XRBUF_LOAD(buff, r_ptr, memory_order_relaxed);
+    return &buff->buff[BUF_IDX(buff, ptr)];
 }
 
 /**
@@ -490,10 +694,12 @@ xrbuf_get_linear_block_read_length(const xrbuf_t* buff) {
      * Use temporary values in case they are changed during operations.
      * See xrbuf_buff_free or xrbuf_buff_full functions for more information why this is OK.
      */
-    w_ptr = XRBUF_LOAD(buff->w_ptr, memory_order_relaxed);
-    r_ptr = XRBUF_LOAD(buff->r_ptr, memory_order_relaxed);
+    w_ptr = XRBUF_LOAD(buff, w_ptr, memory_order_acquire);
+    r_ptr = XRBUF_LOAD(buff, r_ptr, memory_order_relaxed);
 
-    if (w_ptr > r_ptr) {
+    if (BUF_IS_POW2(buff)) {
+        len = BUF_MIN(w_ptr - r_ptr, buff->size - BUF_IDX(buff, r_ptr));
+    } else if (w_ptr > r_ptr) {
         len = w_ptr - r_ptr;
     } else if (r_ptr > w_ptr) {
         len = buff->size - r_ptr;
@@ -522,12 +728,10 @@ xrbuf_skip(xrbuf_t* buff, uint32_t len) {
 
     full = xrbuf_get_full(buff);
     len = BUF_MIN(len, full);
-    r_ptr = XRBUF_LOAD(buff->r_ptr, memory_order_acquire);
-    r_ptr += len;
-    if (r_ptr >= buff->size) {
-        r_ptr -= buff->size;
-    }
-    XRBUF_STORE(buff->r_ptr, r_ptr, memory_order_release);
+    r_ptr = XRBUF_LOAD(buff, r_ptr, memory_order_relaxed);
+    r_ptr = prv_ptr_add(buff, r_ptr, len);
+    XRBUF_STORE(buff, r_ptr, r_ptr, memory_order_release);
+    BUF_STATS_OUT(buff, len);
     BUF_SEND_EVT(buff, XRBUF_EVT_READ, len);
     return len;
 }
@@ -544,8 +748,8 @@ xrbuf_get_linear_block_write_address(const xrbuf_t* buff) {
     if (!BUF_IS_VALID(buff)) {
         return NULL;
     }
-    ptr = XRBUF_LOAD(buff->w_ptr, memory_order_relaxed);
-    return &buff->buff[ptr];
+    ptr = XRBUF_LOAD(buff, w_ptr, memory_order_relaxed);
+    return &buff->buff[BUF_IDX(buff, ptr)];
 }
 
 /**
@@ -565,10 +769,12 @@ xrbuf_get_linear_block_write_length(const xrbuf_t* buff) {
      * Use temporary values in case they are changed during operations.
      * See xrbuf_buff_free or xrbuf_buff_full functions for more information why this is OK.
      */
-    w_ptr = XRBUF_LOAD(buff->w_ptr, memory_order_relaxed);
-    r_ptr = XRBUF_LOAD(buff->r_ptr, memory_order_relaxed);
+    w_ptr = XRBUF_LOAD(buff, w_ptr, memory_order_relaxed);
+    r_ptr = XRBUF_LOAD(buff, r_ptr, memory_order_acquire);
 
-    if (w_ptr >= r_ptr) {
+    if (BUF_IS_POW2(buff)) {
+        len = BUF_MIN(buff->size - (w_ptr - r_ptr), buff->size - BUF_IDX(buff, w_ptr));
+    } else if (w_ptr >= r_ptr) {
         len = buff->size - w_ptr;
         /*
          * When read pointer is 0,
@@ -601,7 +807,7 @@ xrbuf_get_linear_block_write_length(const xrbuf_t* buff) {
  */
 uint32_t
 xrbuf_advance(xrbuf_t* buff, uint32_t len) {
-    uint32_t free = 0, w_ptr = 0;
+    uint32_t free = 0, w_ptr = 0, req = len;
 
     if (!BUF_IS_VALID(buff) || len == 0) {
         return 0;
@@ -610,16 +816,195 @@ xrbuf_advance(xrbuf_t* buff, uint32_t len) {
     /* Use local variables before writing back to main structure */
     free = xrbuf_get_free(buff);
     len = BUF_MIN(len, free);
-    w_ptr = XRBUF_LOAD(buff->w_ptr, memory_order_acquire);
-    w_ptr += len;
-    if (w_ptr >= buff->size) {
-        w_ptr -= buff->size;
-    }
-    XRBUF_STORE(buff->w_ptr, w_ptr, memory_order_release);
+    w_ptr = XRBUF_LOAD(buff, w_ptr, memory_order_relaxed);
+    w_ptr = prv_ptr_add(buff, w_ptr, len);
+    XRBUF_STORE(buff, w_ptr, w_ptr, memory_order_release);
+    BUF_STATS_IN(buff, req, len);
     BUF_SEND_EVT(buff, XRBUF_EVT_WRITE, len);
     return len;
 }
 
+/**
+ * \brief           Reserve up to `btw` bytes of free memory for in-place write
+ *
+ * The region starts at the write pointer and is described by up to two segments,
+ * the second one starting at the beginning of the buffer when the region wraps.
+ * The producer fills the segments directly (CPU or DMA) and publishes the data
+ * with \ref xrbuf_commit. Nothing is visible to the consumer before that.
+ *
+ * \param[in]       buff: Ring buffer instance
+ * \param[in]       btw: Maximum number of bytes to reserve
+ * \param[out]      seg: Reserved segments, unused segment has `NULL` pointer and `0` length
+ * \return          Number of bytes reserved, sum of both segment lengths
+ */
+uint32_t
+xrbuf_reserve(xrbuf_t* buff, uint32_t btw, xrbuf_seg_t* seg) {
+    uint32_t free = 0, w_ptr = 0;
+
+    if (seg == NULL) {
+        return 0;
+    }
+    seg->ptr[0] = seg->ptr[1] = NULL;
+    seg->len[0] = seg->len[1] = 0;
+
+    if (!BUF_IS_VALID(buff)) {
+        return 0;
+    }
+
+    free = xrbuf_get_free(buff);
+    btw = BUF_MIN(free, btw);
+    if (btw == 0) {
+        return 0;
+    }
+    w_ptr = BUF_IDX(buff, XRBUF_LOAD(buff, w_ptr, memory_order_relaxed));
+
+    seg->ptr[0] = &buff->buff[w_ptr];
+    seg->len[0] = BUF_MIN(buff->size - w_ptr, btw);
+    if (btw > seg->len[0]) {
+        seg->ptr[1] = buff->buff;
+        seg->len[1] = btw - seg->len[0];
+    }
+    return btw;
+}
+
+/**
+ * \brief           Publish bytes written into memory obtained by \ref xrbuf_reserve
+ * \note            `len` may be less than reserved, remaining reservation is dropped
+ * \param[in]       buff: Ring buffer instance
+ * \param[in]       len: Number of bytes written, from the start of first segment
+ * \return          Number of bytes committed
+ */
+uint32_t
+xrbuf_commit(xrbuf_t* buff, uint32_t len) {
+    return xrbuf_advance(buff, len);
+}
+
+/**
+ * \brief           Get up to `btp` bytes of buffered data for in-place read
+ *
+ * Data starts at the read pointer and is described by up to two segments,
+ * the second one starting at the beginning of the buffer when the data wraps.
+ * The consumer reads the segments directly (CPU or DMA) and frees the memory
+ * with \ref xrbuf_release. Memory is not reused by the producer before that.
+ *
+ * \param[in]       buff: Ring buffer instance
+ * \param[in]       btp: Maximum number of bytes to get
+ * \param[out]      seg: Data segments, unused segment has `NULL` pointer and `0` length
+ * \return          Number of bytes available, sum of both segment lengths
+ */
+uint32_t
+xrbuf_peek_seg(const xrbuf_t* buff, uint32_t btp, xrbuf_seg_t* seg) {
+    uint32_t full = 0, r_ptr = 0;
+
+    if (seg == NULL) {
+        return 0;
+    }
+    seg->ptr[0] = seg->ptr[1] = NULL;
+    seg->len[0] = seg->len[1] = 0;
+
+    if (!BUF_IS_VALID(buff)) {
+        return 0;
+    }
+
+    full = xrbuf_get_full(buff);
+    btp = BUF_MIN(full, btp);
+    if (btp == 0) {
+        return 0;
+    }
+    r_ptr = BUF_IDX(buff, XRBUF_LOAD(buff, r_ptr, memory_order_relaxed));
+
+    seg->ptr[0] = &buff->buff[r_ptr];
+    seg->len[0] = BUF_MIN(buff->size - r_ptr, btp);
+    if (btp > seg->len[0]) {
+        seg->ptr[1] = buff->buff;
+        seg->len[1] = btp - seg->len[0];
+    }
+    return btp;
+}
+
+/**
+ * \brief           Free bytes consumed from memory obtained by \ref xrbuf_peek_seg
+ * \param[in]       buff: Ring buffer instance
+ * \param[in]       len: Number of bytes consumed, from the start of first segment
+ * \return          Number of bytes released
+ */
+uint32_t
+xrbuf_release(xrbuf_t* buff, uint32_t len) {
+    return xrbuf_skip(buff, len);
+}
+
+/**
+ * \brief           Compare buffered bytes against an array
+ * \param[in]       seg: Buffered data as returned by \ref xrbuf_peek_seg
+ * \param[in]       offset: Offset of the first byte to compare, relative to the read pointer
+ * \param[in]       data: Bytes to compare with
+ * \param[in]       len: Number of bytes, `offset + len` must not exceed the data length
+ * \return          `1` if equal, `0` otherwise
+ */
+static uint8_t
+prv_seg_equal(const xrbuf_seg_t* seg, uint32_t offset, const uint8_t* data, uint32_t len) {
+    if (offset < seg->len[0]) {
+        uint32_t n = BUF_MIN(len, seg->len[0] - offset);
+        if (memcmp(seg->ptr[0] + offset, data, n) != 0) {
+            return 0;
+        }
+        data += n;
+        len -= n;
+        offset = 0;
+    } else {
+        offset -= seg->len[0];
+    }
+    return len == 0 || memcmp(seg->ptr[1] + offset, data, len) == 0;
+}
+
+/**
+ * \brief           Search buffered data for a needle
+ *
+ * Each linear segment is scanned with `memchr` for the first byte of the needle and the
+ * candidates are verified with `memcmp`. The scan runs at `memchr` speed whatever the
+ * needle length, which a byte-wise Horspool loop does not reach for the needle lengths
+ * used by line and boundary protocols.
+ *
+ * \param[in]       seg: Buffered data as returned by \ref xrbuf_peek_seg
+ * \param[in]       full: Number of bytes described by `seg`
+ * \param[in]       needle: Bytes to search for
+ * \param[in]       len: Length of `needle`, greater than `0`
+ * \param[in]       pos: First offset to test
+ * \param[out]      found_idx: Offset of the first match
+ * \return          `1` if found, `0` otherwise
+ */
+static uint8_t
+prv_find(const xrbuf_seg_t* seg, uint32_t full, const uint8_t* needle, uint32_t len, uint32_t pos,
+         uint32_t* found_idx) {
+    uint32_t last = full - len; /* Last offset where needle still fits */
+
+    while (pos <= last) {
+        const uint8_t *start, *hit;
+        uint32_t n;
+
+        /* Find first byte within current linear segment */
+        if (pos < seg->len[0]) {
+            start = seg->ptr[0] + pos;
+            n = BUF_MIN(seg->len[0], last + 1) - pos;
+        } else {
+            start = seg->ptr[1] + (pos - seg->len[0]);
+            n = last + 1 - pos;
+        }
+        hit = memchr(start, needle[0], n);
+        if (hit == NULL) {
+            pos += n;
+            continue;
+        }
+        pos += (uint32_t)(hit - start);
+        if (prv_seg_equal(seg, pos + 1, needle + 1, len - 1)) {
+            *found_idx = pos;
+            return 1;
+        }
+        ++pos;
+    }
+    return 0;
+}
+
 /**
  * \brief           Searches for a *needle* in an array, starting from given offset.
  * 
@@ -635,50 +1020,51 @@ xrbuf_advance(xrbuf_t* buff, uint32_t len) {
  */
 uint8_t
 xrbuf_find(const xrbuf_t* buff, const void* bts, uint32_t len, uint32_t start_offset, uint32_t* found_idx) {
-    uint32_t full = 0, r_ptr = 0, buff_r_ptr = 0, max_x = 0;
-    uint8_t found = 0;
-    const uint8_t* needle = bts;
+    uint32_t cursor = start_offset;
+
+    return xrbuf_find_next(buff, bts, len, &cursor, found_idx);
+}
+
+/**
+ * \brief           Search for a *needle*, resuming where the previous search stopped
+ *
+ * When the needle is not found, `cursor` moves past every offset already ruled out,
+ * so polling a growing buffer for a terminator only scans the newly written bytes.
+ * When found, `cursor` is set to the match offset.
+ *
+ * \note            `cursor` is relative to the read pointer. After removing `n` bytes
+ *                      from the buffer, subtract `n` from it (or reset it to `0`).
+ *                      Searching for another needle also requires a reset.
+ *
+ * \param           buff: Ring buffer to search for needle in
+ * \param           bts: Constant byte array sequence to search for in a buffer
+ * \param           len: Length of the \arg bts array
+ * \param           cursor: In: first offset to test. Out: offset to resume from
+ * \param           found_idx: Pointer to variable to write index in array where bts has been found
+ * \return          `1` if \arg bts found, `0` otherwise
+ */
+uint8_t
+xrbuf_find_next(const xrbuf_t* buff, const void* bts, uint32_t len, uint32_t* cursor, uint32_t* found_idx) {
+    xrbuf_seg_t seg;
+    uint32_t full = 0;
 
-    if (!BUF_IS_VALID(buff) || needle == NULL || len == 0 || found_idx == NULL) {
+    if (!BUF_IS_VALID(buff) || bts == NULL || len == 0 || cursor == NULL || found_idx == NULL) {
         return 0;
     }
     *found_idx = 0;
 
-    full = xrbuf_get_full(buff);
+    full = xrbuf_peek_seg(buff, UINT32_MAX, &seg);
     /* Verify initial conditions */
-    if (full < (len + start_offset)) {
+    if (full < len || *cursor > full - len) {
         return 0;
     }
 
-    /* Get actual buffer read pointer for this search */
-    buff_r_ptr = XRBUF_LOAD(buff->r_ptr, memory_order_relaxed);
-
-    /* Max number of for loops is buff_full - input_len - start_offset of buffer length */
-    max_x = full - len;
-    for (uint32_t skip_x = start_offset; !found && skip_x <= max_x; ++skip_x) {
-        found = 1; /* Found by default */
-
-        /* Prepare the starting point for reading */
-        r_ptr = buff_r_ptr + skip_x;
-        if (r_ptr >= buff->size) {
-            r_ptr -= buff->size;
-        }
-
-        /* Search in the buffer */
-        for (uint32_t idx = 0; idx < len; ++idx) {
-            if (buff->buff[r_ptr] != needle[idx]) {
-                found = 0;
-                break;
-            }
-            if (++r_ptr >= buff->size) {
-                r_ptr = 0;
-            }
-        }
-        if (found) {
-            *found_idx = skip_x;
-        }
+    if (prv_find(&seg, full, bts, len, *cursor, found_idx)) {
+        *cursor = *found_idx;
+        return 1;
     }
-    return found;
+    *cursor = full - len + 1;
+    return 0;
 }
 
 #define BUF_IS_VALID(b) ((b) != NULL && (b)->buff != NULL && (b)->size > 0)
@@ -707,7 +1093,7 @@ xrbuf_overwrite(xrbuf_t* buff, const void* data, uint32_t btw) {
     }
 
     /* Process complete input array */
-    max_cap = buff->size - 1; /* Maximum capacity buffer can hold */
+    max_cap = BUF_CAP(buff); /* Maximum capacity buffer can hold */
     if (btw > max_cap) {
         /*
          * When data to write is larger than max buffer capacity,
@@ -731,6 +1117,9 @@ xrbuf_overwrite(xrbuf_t* buff, const void* data, uint32_t btw) {
         uint32_t f = xrbuf_get_free(buff);
         if (f < btw) {
             xrbuf_skip(buff, btw - f);
+#if XRBUF_STATS_ENABLE
+            ++buff->stats.overflow;
+#endif
         }
     }
     xrbuf_write(buff, d, btw);
@@ -792,3 +1181,130 @@ xrbuf_move(xrbuf_t* dest, xrbuf_t* src) {
     }
     return len_to_copy_orig;
 }
+
+#if XRBUF_STATS_ENABLE
+
+/**
+ * \brief           Get buffer statistics
+ * \param[in]       buff: Ring buffer instance
+ * \param[out]      stats: Statistics output. `full_ms` includes the current full period
+ */
+void
+xrbuf_get_stats(const xrbuf_t* buff, xrbuf_stats_t* stats) {
+    if (buff == NULL || stats == NULL) {
+        return;
+    }
+    *stats = buff->stats;
+    if (stats->full_count != stats->full_seen) {
+        stats->full_ms += TIME_DIFF(xtime_get_tick_ms(), stats->full_since);
+    }
+}
+
+/**
+ * \brief           Restart buffer statistics
+ * \note            Not safe against a concurrent read or write
+ * \param[in]       buff: Ring buffer instance
+ */
+void
+xrbuf_reset_stats(xrbuf_t* buff) {
+    if (BUF_IS_VALID(buff)) {
+        BUF_MEMSET(&buff->stats, 0, sizeof(buff->stats));
+        buff->stats.used_max = xrbuf_get_full(buff);
+    }
+}
+
+/**
+ * \brief           Add buffer to the registry listed by the `rbuf` shell command
+ * \note            Not for interrupt context. \ref xrbuf_free removes the buffer again
+ * \param[in]       buff: Ring buffer instance, initialized
+ * \param[in]       owner: Owner name, e.g. peripheral name. Must stay valid
+ * \param[in]       name: Buffer name within the owner. Must stay valid
+ */
+void
+xrbuf_register(xrbuf_t* buff, const char* owner, const char* name) {
+    int32_t state;
+
+    if (!BUF_IS_VALID(buff)) {
+        return;
+    }
+    state = prv_registry_lock();
+    buff->owner = owner;
+    buff->name = name;
+    for (xrbuf_t* b = prv_registry; b != NULL; b = b->next) {
+        if (b == buff) {
+            prv_registry_unlock(state);
+            return;
+        }
+    }
+    buff->next = prv_registry;
+    prv_registry = buff;
+    prv_registry_unlock(state);
+}
+
+/**
+ * \brief           Remove buffer from the registry
+ * \note            Not for interrupt context
+ * \param[in]       buff: Ring buffer instance
+ */
+void
+xrbuf_unregister(xrbuf_t* buff) {
+    int32_t state = prv_registry_lock();
+
+    for (xrbuf_t** pp = &prv_registry; *pp != NULL; pp = &(*pp)->next) {
+        if (*pp == buff) {
+            *pp = buff->next;
+            buff->next = NULL;
+            break;
+        }
+    }
+    prv_registry_unlock(state);
+}
+
+/**
+ * \brief           Take a snapshot of one registered buffer
+ *
+ * The registry stays locked only while copying, so callers may print between calls.
+ * A buffer registered or removed meanwhile may shift the later indices by one.
+ *
+ * \param[in]       index: Position in the registry, newest first
+ * \param[out]      info: Snapshot output
+ * \return          `1` if `index` exists, `0` at the end
+ */
+uint8_t
+xrbuf_registry_get(uint32_t index, xrbuf_info_t* info) {
+    int32_t state;
+    xrbuf_t* b;
+
+    if (info == NULL) {
+        return 0;
+    }
+    state = prv_registry_lock();
+    for (b = prv_registry; b != NULL && index > 0; b = b->next) {
+        --index;
+    }
+    if (b != NULL) {
+        info->owner = b->owner;
+        info->name = b->name;
+        info->size = b->size;
+        info->used = xrbuf_get_full(b);
+        xrbuf_get_stats(b, &info->stats);
+    }
+    prv_registry_unlock(state);
+    return b != NULL;
+}
+
+/**
+ * \brief           Restart the statistics of every registered buffer
+ * \note            Not safe against a concurrent read or write, see \ref xrbuf_reset_stats
+ */
+void
+xrbuf_registry_reset_stats(void) {
+    int32_t state = prv_registry_lock();
+
+    for (xrbuf_t* b = prv_registry; b != NULL; b = b->next) {
+        xrbuf_reset_stats(b);
+    }
+    prv_registry_unlock(state);
+}
+
+#endif /* XRBUF_STATS_ENABLE */
@@ -33,7 +33,17 @@
 #include <stdint.h>
 #include <string.h>
 
+#include "xhal_config.h"
+
+/*
+ * Pointer access uses C11 atomics when the compiler provides them.
+ * Define XRBUF_DISABLE_ATOMIC to force plain accesses.
+ */
+#if !defined(XRBUF_DISABLE_ATOMIC) &&                                         \
+    (!defined(__STDC_VERSION__) || __STDC_VERSION__ < 201112L ||              \
+     defined(__STDC_NO_ATOMICS__))
 #define XRBUF_DISABLE_ATOMIC
+#endif
 
 /**
  * \defgroup        LWRB Lightweight ring buffer manager
@@ -82,6 +92,62 @@ typedef void (*xrbuf_evt_fn)(struct lwrb *buff, xrbuf_evt_type_t evt,
 #define XRBUF_FLAG_READ_ALL  ((uint16_t)0x0001)
 #define XRBUF_FLAG_WRITE_ALL ((uint16_t)0x0001)
 
+/*
+ * Per-instance statistics and a registry of named buffers for the `rbuf`
+ * shell command. Adds a few counters to every write and read when enabled.
+ */
+#ifndef XRBUF_STATS_ENABLE
+#define XRBUF_STATS_ENABLE (0)
+#endif
+
+/* List of modes */
+#define XRBUF_MODE_SPSC ((uint8_t)0x01) /*!< Lock-free 1 producer, 1 consumer */
+#define XRBUF_MODE_POW2 ((uint8_t)0x02) /*!< Power-of-two size, mask wrapping */
+
+/**
+ * \brief           Buffer memory region for in-place access.
+ * Second segment is used only when the region wraps to the buffer start
+ */
+typedef struct
+{
+    uint8_t *ptr[2]; /*!< Segment start addresses */
+    uint32_t len[2]; /*!< Segment lengths in units of bytes */
+} xrbuf_seg_t;
+
+#if XRBUF_STATS_ENABLE || __DOXYGEN__
+/**
+ * \brief           Buffer statistics.
+ * Producer-side fields are only written by the producer and consumer-side
+ * fields only by the consumer, so \ref XRBUF_MODE_SPSC needs no lock. A full
+ * period is open while `full_count` differs from `full_seen`
+ */
+typedef struct
+{
+    uint32_t used_max;   /*!< Highest fill level seen by the producer */
+    uint32_t bytes_in;   /*!< Bytes written (producer) */
+    uint32_t bytes_out;  /*!< Bytes read or skipped (consumer) */
+    uint32_t overflow;   /*!< Writes that could not store every byte */
+    uint32_t underflow;  /*!< Reads that found the buffer empty */
+    uint32_t full_ms;    /*!< Total time the buffer was full, in ms */
+    uint32_t full_since; /*!< Tick the buffer last became full (producer) */
+    uint32_t full_count; /*!< Times the buffer became full (producer) */
+    uint32_t full_seen;  /*!< `full_count` already added to `full_ms`
+                            (consumer) */
+} xrbuf_stats_t;
+
+/**
+ * \brief           Snapshot of one registered buffer
+ */
+typedef struct
+{
+    const char *owner;   /*!< Owner name, e.g. peripheral name */
+    const char *name;    /*!< Buffer name within the owner */
+    uint32_t size;       /*!< Size of buffer data */
+    uint32_t used;       /*!< Bytes stored when taken */
+    xrbuf_stats_t stats; /*!< Statistics, see \ref xrbuf_get_stats */
+} xrbuf_info_t;
+#endif
+
 /**
  * \brief           Buffer structure
  */
@@ -90,18 +156,31 @@ typedef struct lwrb
     uint8_t *buff; /*!< Pointer to buffer data. Buffer is considered initialized
                       when `buff != NULL` and `size > 0` */
     uint32_t size; /*!< Size of buffer data. Size of actual buffer is `1` byte
-                        less than value holds */
+                        less than value holds, except in
+                        \ref XRBUF_MODE_POW2 */
     xrbuf_sz_atomic_t r_ptr; /*!< Next read pointer.
                                 Buffer is considered empty when `r == w` and
-                                full when `w == r - 1` */
+                                full when `w == r - 1`. In
+                                \ref XRBUF_MODE_POW2 it runs freely and the
+                                buffer is full when `w - r == size` */
     xrbuf_sz_atomic_t w_ptr; /*!< Next write pointer.
                                 Buffer is considered empty when `r == w` and
-                                full when `w == r - 1` */
+                                full when `w == r - 1`. In
+                                \ref XRBUF_MODE_POW2 it runs freely */
     xrbuf_evt_fn evt_fn;     /*!< Pointer to event callback function */
     void *arg;               /*!< Event custom user argument */
+    uint8_t mode;            /*!< Operating mode, `XRBUF_MODE_xxx` */
+#if XRBUF_STATS_ENABLE || __DOXYGEN__
+    xrbuf_stats_t stats; /*!< Statistics, reset by \ref xrbuf_init_ex */
+    const char *owner;   /*!< Registry owner name, e.g. peripheral name */
+    const char *name;    /*!< Registry buffer name within the owner */
+    struct lwrb *next;   /*!< Next registered buffer */
+#endif
 } xrbuf_t;
 
 uint8_t xrbuf_init(xrbuf_t *buff, void *buffdata, uint32_t size);
+uint8_t xrbuf_init_ex(xrbuf_t *buff, void *buffdata, uint32_t size,
+                      uint8_t mode);
 uint8_t xrbuf_is_ready(xrbuf_t *buff);
 void xrbuf_free(xrbuf_t *buff);
 void xrbuf_reset(xrbuf_t *buff);
@@ -140,11 +219,34 @@ void *xrbuf_get_linear_block_write_address(const xrbuf_t *buff);
 uint32_t xrbuf_get_linear_block_write_length(const xrbuf_t *buff);
 uint32_t xrbuf_advance(xrbuf_t *buff, uint32_t len);
 
+/* Zero-copy access */
+
+uint32_t xrbuf_reserve(xrbuf_t *buff, uint32_t btw, xrbuf_seg_t *seg);
+uint32_t xrbuf_commit(xrbuf_t *buff, uint32_t len);
+uint32_t xrbuf_peek_seg(const xrbuf_t *buff, uint32_t btp, xrbuf_seg_t *seg);
+uint32_t xrbuf_release(xrbuf_t *buff, uint32_t len);
+
 /* Search in buffer */
 
 uint8_t xrbuf_find(const xrbuf_t *buff, const void *bts, uint32_t len,
                    uint32_t start_offset, uint32_t *found_idx);
+uint8_t xrbuf_find_next(const xrbuf_t *buff, const void *bts, uint32_t len,
+                        uint32_t *cursor, uint32_t *found_idx);
 uint32_t xrbuf_overwrite(xrbuf_t *buff, const void *data, uint32_t btw);
 uint32_t xrbuf_move(xrbuf_t *dest, xrbuf_t *src);
 
+/* Statistics and registry */
+
+#if XRBUF_STATS_ENABLE
+void xrbuf_get_stats(const xrbuf_t *buff, xrbuf_stats_t *stats);
+void xrbuf_reset_stats(xrbuf_t *buff);
+void xrbuf_register(xrbuf_t *buff, const char *owner, const char *name);
+void xrbuf_unregister(xrbuf_t *buff);
+uint8_t xrbuf_registry_get(uint32_t index, xrbuf_info_t *info);
+void xrbuf_registry_reset_stats(void);
+#else
+#define xrbuf_register(buff, owner, name) ((void)(buff))
+#define xrbuf_unregister(buff)            ((void)(buff))
+#endif
+
 #endif /* __XRBUF_H */
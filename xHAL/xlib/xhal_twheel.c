@@ -0,0 +1,434 @@
+#include "xhal_twheel.h"
+#include "../xcore/xhal_assert.h"
+#include "../xcore/xhal_log.h"
+#include "../xcore/xhal_malloc.h"
+#include "xhal_bit.h"
+
+XLOG_TAG("xTimeWheel");
+
+/*
+ * Hierarchical timing wheel. With B = XTWHEEL_SLOT_BITS, level k slot i
+ * holds the timers that were between 2^(B*k) and 2^(B*(k+1)) ticks away
+ * when added and whose expire tick has i in bits B*k .. B*(k+1)-1. When
+ * the low B*k bits of the current tick are all zero, the matching level k
+ * slot is due: its timers are placed again, now on a lower level. Level 0
+ * slots hold single ticks and expire as a whole.
+ *
+ * The slot of a timer depends only on its expire tick, so the wheel can
+ * jump over ticks in which no busy slot is due. A timer added with an
+ * expire tick that was already advanced over waits in the due list and
+ * fires at the start of the next advance, whatever tick it is given. All
+ * arithmetic is modulo 2^32 and the tick counter may wrap, as long as no
+ * timer is set more than 2^31 - 1 ticks ahead.
+ */
+
+#define WHEEL_MASK       (XTWHEEL_SLOTS - 1U)
+#define WHEEL_BITS_TOTAL (XTWHEEL_SLOT_BITS * XTWHEEL_LEVELS)
+
+/**
+ * @brief  Get the slot index of a tick on one level.
+ * @param  tick    The tick.
+ * @param  level   The level.
+ * @retval The index within the level.
+ */
+static inline uint32_t _index(xhal_tick_t tick, uint32_t level)
+{
+    return (tick >> (level * XTWHEEL_SLOT_BITS)) & WHEEL_MASK;
+}
+
+/**
+ * @brief  Get the distance from one slot to the next busy slot, counting
+ * upwards and wrapping around.
+ * @param  map     The busy bitmap of the level.
+ * @param  from    The slot to start from.
+ * @retval 0 if `from` is busy, XTWHEEL_SLOTS if no slot is.
+ */
+static uint32_t _map_dist(const uint32_t *map, uint32_t from)
+{
+    uint32_t first = from >> 5;
+
+    for (uint32_t n = 0; n <= XTWHEEL_MAP_WORDS; n++)
+    {
+        uint32_t w    = (first + n) % XTWHEEL_MAP_WORDS;
+        uint32_t bits = map[w];
+
+        /* The first word from `from` upwards, after wrapping the rest */
+        if (n == 0)
+            bits &= ~0U << (from & 31U);
+        else if (n == XTWHEEL_MAP_WORDS)
+            bits &= ~(~0U << (from & 31U));
+
+        if (bits != 0)
+        {
+            uint32_t slot = w * 32U + (uint32_t)xbit_ffs32(bits);
+            return (slot - from) & WHEEL_MASK;
+        }
+    }
+
+    return XTWHEEL_SLOTS;
+}
+
+/**
+ * @brief  Mark a level slot busy or free. The due list has no bitmap.
+ * @param  self    The wheel handle.
+ * @param  slot    level * XTWHEEL_SLOTS + index, or XTWHEEL_DUE_SLOT.
+ * @param  busy    True to mark busy.
+ * @retval None.
+ */
+static void _map_mark(xtwheel_t *const self, uint32_t slot, uint8_t busy)
+{
+    uint32_t index = slot & WHEEL_MASK;
+    uint32_t *word;
+
+    if (slot == XTWHEEL_DUE_SLOT)
+        return;
+
+    word = &self->map[slot >> XTWHEEL_SLOT_BITS][index >> 5];
+    if (busy)
+        *word |= 1U << (index & 31U);
+    else
+        *word &= ~(1U << (index & 31U));
+}
+
+/**
+ * @brief  Append a node to the tail of a slot list.
+ * @param  self    The wheel handle.
+ * @param  node    The node.
+ * @param  slot    level * XTWHEEL_SLOTS + index, or XTWHEEL_DUE_SLOT.
+ * @retval None.
+ */
+static void _link(xtwheel_t *const self, xtwheel_node_t *node, uint32_t slot)
+{
+    xtwheel_node_t *head = self->slot[slot];
+
+    node->slot = (uint16_t)slot;
+    if (head == NULL)
+    {
+        node->next       = node;
+        node->prev       = node;
+        self->slot[slot] = node;
+        _map_mark(self, slot, 1);
+    }
+    else
+    {
+        node->next       = head;
+        node->prev       = head->prev;
+        head->prev->next = node;
+        head->prev       = node;
+    }
+}
+
+/**
+ * @brief  Take a node out of its slot list.
+ * @param  self    The wheel handle.
+ * @param  node    The node, linked.
+ * @retval None.
+ */
+static void _unlink(xtwheel_t *const self, xtwheel_node_t *node)
+{
+    uint32_t slot = node->slot;
+
+    if (node->next == node)
+    {
+        self->slot[slot] = NULL;
+        _map_mark(self, slot, 0);
+    }
+    else
+    {
+        node->prev->next = node->next;
+        node->next->prev = node->prev;
+        if (self->slot[slot] == node)
+            self->slot[slot] = node->next;
+    }
+
+    node->next = NULL;
+    node->prev = NULL;
+}
+
+/**
+ * @brief  Detach a whole slot list.
+ * @param  self    The wheel handle.
+ * @param  slot    level * XTWHEEL_SLOTS + index, or XTWHEEL_DUE_SLOT.
+ * @retval The first node of a NULL terminated list, in insertion order.
+ */
+static xtwheel_node_t *_take(xtwheel_t *const self, uint32_t slot)
+{
+    xtwheel_node_t *head = self->slot[slot];
+
+    if (head == NULL)
+        return NULL;
+
+    self->slot[slot] = NULL;
+    _map_mark(self, slot, 0);
+    head->prev->next = NULL;
+
+    return head;
+}
+
+/**
+ * @brief  Put a node into the slot its expire tick falls in, seen from the
+ * current tick. Timers due before the current tick go to the due list.
+ * @param  self    The wheel handle.
+ * @param  node    The node, unlinked.
+ * @retval None.
+ */
+static void _place(xtwheel_t *const self, xtwheel_node_t *node)
+{
+    xhal_tick_t expire = node->expire;
+    uint32_t delta     = TIME_DIFF(expire, self->current);
+    uint32_t level     = 0;
+
+    if ((int32_t)delta < 0)
+    {
+        _link(self, node, XTWHEEL_DUE_SLOT);
+        return;
+    }
+#if WHEEL_BITS_TOTAL < 32
+    if ((delta >> WHEEL_BITS_TOTAL) != 0)
+    {
+        /* Beyond the wheel: wait in the last top level slot */
+        delta  = (1U << WHEEL_BITS_TOTAL) - 1U;
+        expire = self->current + delta;
+    }
+#endif
+
+    while (level + 1U < XTWHEEL_LEVELS &&
+           (delta >> ((level + 1U) * XTWHEEL_SLOT_BITS)) != 0)
+        level++;
+
+    _link(self, node, level * XTWHEEL_SLOTS + _index(expire, level));
+}
+
+/**
+ * @brief  Hand out a detached list of expired timers.
+ * @param  self    The wheel handle.
+ * @param  node    The first node of a NULL terminated list.
+ * @param  expire  Called for each expired timer.
+ * @param  arg     Passed to the callback.
+ * @retval Number of expired timers.
+ */
+static uint32_t _fire(xtwheel_t *const self, xtwheel_node_t *node,
+                      xtwheel_expire_t expire, void *arg)
+{
+    uint32_t fired = 0;
+
+    while (node != NULL)
+    {
+        xtwheel_node_t *next = node->next;
+
+        node->next = NULL;
+        node->prev = NULL;
+        self->count--;
+        fired++;
+        expire(node, arg);
+
+        node = next;
+    }
+
+    return fired;
+}
+
+/**
+ * @brief  Get the earliest tick at which a level slot is due.
+ * @param  self    The wheel handle.
+ * @param  tick    The tick output.
+ * @retval XHAL_ERR_EMPTY if every level slot is free.
+ */
+static xhal_err_t _next_slot(const xtwheel_t *const self, xhal_tick_t *tick)
+{
+    xhal_tick_t cur = self->current;
+    uint32_t best   = UINT32_MAX;
+
+    for (uint32_t level = 0; level < XTWHEEL_LEVELS; level++)
+    {
+        uint32_t shift = level * XTWHEEL_SLOT_BITS;
+        uint32_t index = _index(cur, level);
+
+        /* Past the first tick of its turn, this slot waits a full turn */
+        uint32_t passed = (cur & ((1U << shift) - 1U)) != 0;
+        uint32_t dist   = _map_dist(self->map[level],
+                                    (index + passed) & WHEEL_MASK);
+        if (dist == XTWHEEL_SLOTS)
+            continue;
+
+        xhal_tick_t due = ((cur >> shift) + dist + passed) << shift;
+        best            = XHAL_MIN(best, TIME_DIFF(due, cur));
+    }
+
+    if (best == UINT32_MAX)
+        return XHAL_ERR_EMPTY;
+
+    *tick = cur + best;
+
+    return XHAL_OK;
+}
+
+/**
+ * @brief  Initialize one wheel.
+ * @param  self    The wheel handle.
+ * @param  now     The current tick.
+ * @retval None.
+ */
+void xtwheel_init(xtwheel_t *const self, xhal_tick_t now)
+{
+    xassert_not_null(self);
+
+    xmemset(self, 0, sizeof(*self));
+    self->current = now;
+}
+
+/**
+ * @brief  Initialize one node as not running.
+ * @param  node    The node.
+ * @retval None.
+ */
+void xtwheel_node_init(xtwheel_node_t *const node)
+{
+    xassert_not_null(node);
+
+    node->next   = NULL;
+    node->prev   = NULL;
+    node->expire = 0;
+    node->slot   = 0;
+}
+
+/**
+ * @brief  Start a timer, or restart it if it is running. O(1).
+ * @param  self    The wheel handle.
+ * @param  node    The node.
+ * @param  expire  The tick to expire at, less than 2^31 ticks ahead.
+ * @retval None.
+ */
+void xtwheel_add(xtwheel_t *const self, xtwheel_node_t *node,
+                 xhal_tick_t expire)
+{
+    xassert_not_null(self);
+    xassert_not_null(node);
+
+    if (node->next != NULL)
+        _unlink(self, node);
+    else
+        self->count++;
+
+    node->expire = expire;
+    _place(self, node);
+}
+
+/**
+ * @brief  Stop a timer. O(1), nothing happens if it is not running.
+ * @param  self    The wheel handle.
+ * @param  node    The node.
+ * @retval None.
+ */
+void xtwheel_remove(xtwheel_t *const self, xtwheel_node_t *node)
+{
+    xassert_not_null(self);
+    xassert_not_null(node);
+
+    if (node->next == NULL)
+        return;
+
+    _unlink(self, node);
+    self->count--;
+}
+
+/**
+ * @brief  Expire every timer due at or before `now`. Each due slot is
+ * detached as a whole before its timers are handed out, so the callback
+ * may add or remove timers. Timers of the same tick come out in the order
+ * they reached level 0. Timers added already due fire first; ones the
+ * callback adds already due wait for the next call.
+ * @param  self    The wheel handle.
+ * @param  now     The current tick.
+ * @param  expire  Called for each expired timer.
+ * @param  arg     Passed to the callback.
+ * @retval Number of expired timers.
+ */
+uint32_t xtwheel_advance(xtwheel_t *const self, xhal_tick_t now,
+                         xtwheel_expire_t expire, void *arg)
+{
+    xassert_not_null(self);
+    xassert_not_null(expire);
+
+    uint32_t fired = _fire(self, _take(self, XTWHEEL_DUE_SLOT), expire, arg);
+    xhal_tick_t tick;
+
+    while (_next_slot(self, &tick) == XHAL_OK && TIME_BEFOR_EQ(tick, now))
+    {
+        /* Nothing is due in between, jump straight to the tick */
+        self->current = tick;
+
+        for (uint32_t level = 1;
+             level < XTWHEEL_LEVELS && _index(tick, level - 1U) == 0; level++)
+        {
+            xtwheel_node_t *node = _take(self, level * XTWHEEL_SLOTS +
+                                                   _index(tick, level));
+            while (node != NULL)
+            {
+                xtwheel_node_t *next = node->next;
+                _place(self, node);
+                node = next;
+            }
+        }
+
+        xtwheel_node_t *node = _take(self, _index(tick, 0));
+        self->current        = tick + 1U;
+
+        fired += _fire(self, node, expire, arg);
+    }
+
+    if (TIME_BEFOR_EQ(self->current, now))
+        self->current = now + 1U;
+
+    return fired;
+}
+
+/**
+ * @brief  Get the earliest tick at which xtwheel_advance has work to do.
+ * It is exact for timers less than XTWHEEL_SLOTS ticks away; for later
+ * ones it is the tick their slot moves down a level, never after expiry.
+ * Timers added already due report the last tick advanced over.
+ * @param  self    The wheel handle.
+ * @param  tick    The tick output.
+ * @retval XHAL_ERR_EMPTY if no timer is running.
+ */
+xhal_err_t xtwheel_next_expire(const xtwheel_t *const self, xhal_tick_t *tick)
+{
+    xassert_not_null(self);
+    xassert_not_null(tick);
+
+    if (self->count == 0)
+        return XHAL_ERR_EMPTY;
+
+    if (self->slot[XTWHEEL_DUE_SLOT] != NULL)
+    {
+        *tick = self->current - 1U;
+        return XHAL_OK;
+    }
+
+    return _next_slot(self, tick);
+}
+
+/**
+ * @brief  Get the running timer count.
+ * @param  self    The wheel handle.
+ * @retval Timer count.
+ */
+uint32_t xtwheel_count(const xtwheel_t *const self)
+{
+    xassert_not_null(self);
+
+    return self->count;
+}
+
+/**
+ * @brief  Check whether a timer is running.
+ * @param  node    The node.
+ * @retval True or false.
+ */
+uint8_t xtwheel_is_active(const xtwheel_node_t *const node)
+{
+    xassert_not_null(node);
+
+    return node->next != NULL;
+}
@@ -0,0 +1,79 @@
+#ifndef __XHAL_TWHEEL_H
+#define __XHAL_TWHEEL_H
+
+#include "../xcore/xhal_def.h"
+#include "../xcore/xhal_std.h"
+#include "../xcore/xhal_time.h"
+
+/*
+ * Every level has 2^XTWHEEL_SLOT_BITS slots, one pointer each. The wheel
+ * spans 2^(XTWHEEL_SLOT_BITS * XTWHEEL_LEVELS) ticks; later timers wait in
+ * the top level and are placed again when it turns.
+ */
+#ifndef XTWHEEL_SLOT_BITS
+#define XTWHEEL_SLOT_BITS (6)
+#endif
+
+#ifndef XTWHEEL_LEVELS
+#define XTWHEEL_LEVELS (4)
+#endif
+
+#if XTWHEEL_SLOT_BITS < 5 || XTWHEEL_SLOT_BITS > 8
+#error "XTWHEEL_SLOT_BITS must be 5 to 8"
+#endif
+
+#if XTWHEEL_LEVELS < 1 || XTWHEEL_SLOT_BITS * XTWHEEL_LEVELS > 32
+#error "XTWHEEL_LEVELS must be 1 to 32 / XTWHEEL_SLOT_BITS"
+#endif
+
+#define XTWHEEL_SLOTS     (1U << XTWHEEL_SLOT_BITS)
+#define XTWHEEL_MAP_WORDS (XTWHEEL_SLOTS / 32)
+
+/* Extra list after the level slots for timers added when already due */
+#define XTWHEEL_DUE_SLOT  (XTWHEEL_LEVELS * XTWHEEL_SLOTS)
+
+/**
+ * @brief  Get the struct that embeds the node.
+ * @param  node    The node pointer.
+ * @param  type    The embedding struct type.
+ * @param  member  The node member name within the struct.
+ */
+#define XTWHEEL_ENTRY(node, type, member) xhal_container_of(node, type, member)
+
+/*
+ * Node embedded in each timer. The slot lists are circular and doubly
+ * linked, so a timer is removed in O(1) from its recorded slot.
+ */
+typedef struct xtwheel_node
+{
+    struct xtwheel_node *next; /* NULL if the timer is not running */
+    struct xtwheel_node *prev;
+    xhal_tick_t expire;
+    uint16_t slot; /* level * XTWHEEL_SLOTS + index, or XTWHEEL_DUE_SLOT */
+} xtwheel_node_t;
+
+/* Called for each expired timer, which is already detached. */
+typedef void (*xtwheel_expire_t)(xtwheel_node_t *node, void *arg);
+
+typedef struct xtwheel
+{
+    xtwheel_node_t *slot[XTWHEEL_DUE_SLOT + 1];      /* List heads */
+    uint32_t map[XTWHEEL_LEVELS][XTWHEEL_MAP_WORDS]; /* Busy level slots */
+    xhal_tick_t current; /* Next tick to process */
+    uint32_t count;
+} xtwheel_t;
+
+void xtwheel_init(xtwheel_t *const self, xhal_tick_t now);
+void xtwheel_node_init(xtwheel_node_t *const node);
+void xtwheel_add(xtwheel_t *const self, xtwheel_node_t *node,
+                 xhal_tick_t expire);
+void xtwheel_remove(xtwheel_t *const self, xtwheel_node_t *node);
+uint32_t xtwheel_advance(xtwheel_t *const self, xhal_tick_t now,
+                         xtwheel_expire_t expire, void *arg);
+xhal_err_t xtwheel_next_expire(const xtwheel_t *const self,
+                               xhal_tick_t *tick);
+
+uint32_t xtwheel_count(const xtwheel_t *const self);
+uint8_t xtwheel_is_active(const xtwheel_node_t *const node);
+
+#endif /* __XHAL_TWHEEL_H */
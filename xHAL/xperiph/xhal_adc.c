@@ -76,6 +76,8 @@ xhal_err_t xadc_inst(xhal_adc_t *self, const char *name,
 
     adc->peri.is_inited = XPERIPH_INITED;
 
+    xrbuf_register(&adc->data.data_rbuf, name, "data");
+
     return XHAL_OK;
 }
 
@@ -2,6 +2,7 @@
 #include "../xcore/xhal_assert.h"
 #include "../xcore/xhal_log.h"
 #include "../xcore/xhal_malloc.h"
+#include "../xlib/xhal_phash.h"
 #include <string.h>
 
 XLOG_TAG("xPeriph");
@@ -13,6 +14,10 @@ XLOG_TAG("xPeriph");
 static xhal_periph_t *xperiph_table[XHAL_PERI_NUM_MAX];
 static uint16_t xperiph_count = 0;
 
+/* 名称索引, 注册表变化时标脏, 下次查找时重建; 未建成时退回逐项比较 */
+XPHASH_STORAGE(xperiph_index, XHAL_PERI_NUM_MAX);
+static xphash_t xperiph_hash;
+
 #ifdef XHAL_OS_SUPPORTING
 static osMutexId_t _xperiph_mutex(void);
 static osMutexId_t xperiph_mutex              = NULL;
@@ -24,6 +29,50 @@ static const osMutexAttr_t xperiph_mutex_attr = {
 };
 #endif
 
+static const char *_xperiph_key(void *ctx, uint32_t index)
+{
+    XHAL_UNUSED(ctx);
+
+    return xperiph_table[index] ? xperiph_table[index]->attr.name : NULL;
+}
+
+/**
+ * @brief 标记设备名称索引待重建, 调用者需持有注册表锁。
+ */
+static void _xperiph_reindex(void)
+{
+    if (xperiph_hash.slot == NULL)
+    {
+        xphash_init(&xperiph_hash, xperiph_index_disp, xperiph_index_slot,
+                    XHAL_PERI_NUM_MAX, _xperiph_key, NULL);
+    }
+
+    xphash_mark_dirty(&xperiph_hash, XHAL_PERI_NUM_MAX);
+}
+
+/**
+ * @brief 逐项比较查找设备, 调用者需持有注册表锁。
+ * @param name    设备名称
+ * @return 设备句柄。如果未找到，返回NULL
+ */
+static xhal_periph_t *_xperiph_scan(const char *name)
+{
+    for (uint32_t i = 0; i < XHAL_PERI_NUM_MAX; i++)
+    {
+        if (xperiph_table[i] == NULL || xperiph_table[i]->attr.name == NULL)
+        {
+            continue;
+        }
+
+        if (strcmp(xperiph_table[i]->attr.name, name) == 0)
+        {
+            return xperiph_table[i];
+        }
+    }
+
+    return NULL;
+}
+
 /**
  * @brief 此函数使用设备属性注册一个设备。
  * @param self    设备句柄
@@ -34,7 +83,6 @@ xhal_err_t xperiph_register(xhal_periph_t *self, xhal_periph_attr_t *attr)
     xassert_not_null(self);
     xassert_not_null(attr);
     xassert_not_null(attr->name);
-    xassert_name(xperiph_find(attr->name) == NULL, attr->name);
 
     xhal_err_t ret = XHAL_OK;
 
@@ -43,7 +91,11 @@ xhal_err_t xperiph_register(xhal_periph_t *self, xhal_periph_attr_t *attr)
     osMutexId_t mutex = _xperiph_mutex();
     ret_os = osMutexAcquire(mutex, osWaitForever);
     xassert(ret_os == osOK);
+#endif
+    /* 逐项比较查重, 注册期间不触发索引重建 */
+    xassert_name(_xperiph_scan(attr->name) == NULL, attr->name);
 
+#ifdef XHAL_OS_SUPPORTING
     self->mutex = osMutexNew(&xperiph_mutex_attr);
     xassert_not_null(self->mutex);
 #endif
@@ -59,6 +111,7 @@ xhal_err_t xperiph_register(xhal_periph_t *self, xhal_periph_attr_t *attr)
             xperiph_table[i] = self;
             xperiph_count++;
             inserted = 1;
+            _xperiph_reindex();
             break;
         }
     }
@@ -110,6 +163,7 @@ xhal_err_t xperiph_unregister(xhal_periph_t *self)
             xperiph_table[i] = NULL;
             xperiph_count--;
             ret = XHAL_OK;
+            _xperiph_reindex();
             break;
         }
     }
@@ -160,18 +214,14 @@ xhal_periph_t *xperiph_find(const char *name)
     xassert(ret == osOK);
 #endif
     xhal_periph_t *self = NULL;
-    for (uint32_t i = 0; i < XHAL_PERI_NUM_MAX; i++)
+    if (xphash_refresh(&xperiph_hash))
     {
-        if (xperiph_table[i] ? xperiph_table[i]->attr.name == NULL : NULL)
-        {
-            continue;
-        }
-
-        if (strcmp(xperiph_table[i]->attr.name, name) == 0)
-        {
-            self = xperiph_table[i];
-            break;
-        }
+        int32_t index = xphash_find(&xperiph_hash, name);
+        self          = index < 0 ? NULL : xperiph_table[index];
+    }
+    else
+    {
+        self = _xperiph_scan(name);
     }
 
 #ifdef XHAL_OS_SUPPORTING
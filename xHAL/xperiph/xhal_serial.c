@@ -1,8 +1,8 @@
 #include "xhal_serial.h"
 #include "../xcore/xhal_assert.h"
 #include "../xcore/xhal_log.h"
-#include "../xcore/xhal_malloc.h"
 #include "../xcore/xhal_time.h"
+#include "../xlib/xhal_arena.h"
 #include <stdarg.h>
 #include <stdio.h>
 
@@ -64,8 +64,9 @@ xhal_err_t xserial_inst(xhal_serial_t *self, const char *name,
     serial->data.config = *config;
     serial->data.name   = serial_name;
 
-    xrbuf_init(&serial->data.tx_rbuf, tx_buff, tx_bufsz);
-    xrbuf_init(&serial->data.rx_rbuf, rx_buff, rx_bufsz);
+    /* 中断与线程各占缓冲区一端, SPSC 模式保证两端无锁访问的内存顺序 */
+    xrbuf_init_ex(&serial->data.tx_rbuf, tx_buff, tx_bufsz, XRBUF_MODE_SPSC);
+    xrbuf_init_ex(&serial->data.rx_rbuf, rx_buff, rx_bufsz, XRBUF_MODE_SPSC);
 
 #ifdef XHAL_OS_SUPPORTING
     serial->data.rx_expect = 1;
@@ -91,6 +92,9 @@ xhal_err_t xserial_inst(xhal_serial_t *self, const char *name,
 
     serial->peri.is_inited = XPERIPH_INITED;
 
+    xrbuf_register(&serial->data.tx_rbuf, name, "tx");
+    xrbuf_register(&serial->data.rx_rbuf, name, "rx");
+
     return XHAL_OK;
 }
 
@@ -242,9 +246,18 @@ uint32_t xserial_discard(xhal_periph_t *self, uint32_t size)
 
 uint8_t xserial_find(xhal_periph_t *self, const void *data, uint32_t size,
                      uint32_t offset, uint32_t *index)
+{
+    uint32_t cursor = offset;
+
+    return xserial_find_next(self, data, size, &cursor, index);
+}
+
+uint8_t xserial_find_next(xhal_periph_t *self, const void *data, uint32_t size,
+                          uint32_t *cursor, uint32_t *index)
 {
     xassert_not_null(self);
     xassert_not_null(data);
+    xassert_not_null(cursor);
     xassert_not_null(index);
     XPERIPH_CHECK_INIT(self, 0);
     XPERIPH_CHECK_TYPE(self, XHAL_PERIPH_UART);
@@ -259,7 +272,7 @@ uint8_t xserial_find(xhal_periph_t *self, const void *data, uint32_t size,
     ret_os            = osMutexAcquire(serial->data.rx_mutex, osWaitForever);
     xassert(ret_os == osOK);
 #endif
-    found = xrbuf_find(&serial->data.rx_rbuf, data, size, offset, index);
+    found = xrbuf_find_next(&serial->data.rx_rbuf, data, size, cursor, index);
 
 #ifdef XHAL_OS_SUPPORTING
     ret_os = osMutexRelease(serial->data.rx_mutex);
@@ -297,34 +310,63 @@ xhal_err_t xserial_clear(xhal_periph_t *self)
 
 uint32_t xserial_printf(xhal_periph_t *self, const char *fmt, ...)
 {
+    xassert_not_null(self);
     xassert_not_null(fmt);
+    XPERIPH_CHECK_INIT(self, 0);
+    XPERIPH_CHECK_TYPE(self, XHAL_PERIPH_UART);
 
+    xhal_serial_t *serial = XSERIAL_CAST(self);
+    uint32_t written      = 0;
+    int32_t len           = 0;
     char stack_buf[XSERIAL_PRINTF_BUF_SIZE];
-
+    char *buf          = stack_buf;
+    xarena_mark_t mark = 0;
+    xrbuf_seg_t seg;
     va_list args;
+
+#ifdef XHAL_OS_SUPPORTING
+    osStatus_t ret_os = osOK;
+    ret_os            = osMutexAcquire(serial->data.tx_mutex, osWaitForever);
+    xassert(ret_os == osOK);
+#endif
+    /* 优先直接格式化到发送缓冲区的第一段空闲空间, 省去中间缓冲与拷贝 */
+    xrbuf_reserve(&serial->data.tx_rbuf, UINT32_MAX, &seg);
+
     va_start(args, fmt);
-    int32_t len = vsnprintf(stack_buf, sizeof(stack_buf), fmt, args);
+    len = vsnprintf((char *)seg.ptr[0], seg.len[0], fmt, args);
     va_end(args);
     if (len < 0)
-        return 0;
+        goto exit;
 
-    if (len < sizeof(stack_buf))
+    if ((uint32_t)len < seg.len[0])
     {
-        return xserial_write(self, stack_buf, len, XHAL_WAIT_FOREVER);
+        written = xrbuf_commit(&serial->data.tx_rbuf, len);
+        serial->ops->transmit(serial, NULL, 0);
+        goto exit;
     }
 
-    char *heap_buf = (char *)xmalloc(len + 1);
-    if (heap_buf == NULL)
-        return 0;
+    /* 空闲段放不下时格式化到临时缓冲, 再按普通写入等待空间 */
+    if ((uint32_t)len >= sizeof(stack_buf))
+    {
+        buf = (char *)xarena_scratch_alloc(len + 1, &mark);
+        if (buf == NULL)
+            goto exit;
+    }
 
     va_start(args, fmt);
-    vsnprintf(heap_buf, len + 1, fmt, args);
+    vsnprintf(buf, len + 1, fmt, args);
     va_end(args);
 
-    uint32_t written = xserial_write(self, heap_buf, len, XHAL_WAIT_FOREVER);
+    written = xserial_write(self, buf, len, XHAL_WAIT_FOREVER);
 
-    xfree(heap_buf);
+    if (buf != stack_buf)
+        xarena_scratch_free(buf, mark);
 
+exit:
+#ifdef XHAL_OS_SUPPORTING
+    ret_os = osMutexRelease(serial->data.tx_mutex);
+    xassert(ret_os == osOK);
+#endif
     return written;
 }
 
@@ -343,13 +385,14 @@ uint32_t xserial_scanf(xhal_periph_t *self, const char *fmt, ...)
     ret_os            = osMutexAcquire(serial->data.rx_mutex, osWaitForever);
     xassert(ret_os == osOK);
 #endif
-    char *buf     = NULL;
-    uint32_t read = 0;
-    uint32_t len  = xrbuf_get_full(&serial->data.rx_rbuf);
+    char *buf          = NULL;
+    uint32_t read      = 0;
+    xarena_mark_t mark = 0;
+    uint32_t len       = xrbuf_get_full(&serial->data.rx_rbuf);
     if (len == 0)
         goto exit;
 
-    buf = (char *)xmalloc(len + 1);
+    buf = (char *)xarena_scratch_alloc(len + 1, &mark);
     if (buf == NULL)
         goto exit;
 
@@ -363,7 +406,7 @@ uint32_t xserial_scanf(xhal_periph_t *self, const char *fmt, ...)
     ret = vsscanf(buf, fmt, args);
     va_end(args);
 
-    xfree(buf);
+    xarena_scratch_free(buf, mark);
 
 exit:
 
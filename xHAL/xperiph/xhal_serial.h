@@ -62,6 +62,7 @@ typedef struct xhal_serial_ops
     xhal_err_t (*init)(xhal_serial_t *self);
     xhal_err_t (*set_config)(xhal_serial_t *self,
                              const xhal_serial_config_t *config);
+    /* 将数据写入 tx_rbuf 并启动发送; size 为 0 时只启动已提交到 tx_rbuf 的数据 */
     uint32_t (*transmit)(xhal_serial_t *self, const void *buff, uint32_t size);
 } xhal_serial_ops_t;
 
@@ -109,6 +110,12 @@ uint32_t xserial_peek(xhal_periph_t *self, void *buff, uint32_t offset,
 uint32_t xserial_discard(xhal_periph_t *self, uint32_t size);
 uint8_t xserial_find(xhal_periph_t *self, const void *data, uint32_t size,
                      uint32_t offset, uint32_t *index);
+/*
+ * 从 cursor 处继续查找, 未找到时 cursor 跳过已排除的位置, 轮询等待结束符时
+ * 只扫描新收到的数据. cursor 相对读指针, 读出或丢弃 n 字节后需减去 n 或清零.
+ */
+uint8_t xserial_find_next(xhal_periph_t *self, const void *data, uint32_t size,
+                          uint32_t *cursor, uint32_t *index);
 xhal_err_t xserial_clear(xhal_periph_t *self);
 
 uint32_t xserial_term_scanf(xhal_periph_t *self, const char *fmt, ...);
@@ -14,6 +14,9 @@
 #include <stdarg.h>
 #include "shell.h"
 #include "shell_ext.h"
+#if SHELL_USING_CMD_HASH == 1
+#include "../../xlib/xhal_phash.h"
+#endif
 
 #if SHELL_USING_CMD_EXPORT == 1
 /**
@@ -191,6 +194,15 @@ static const char *shellText[] =
  */
 static Shell *shellList[SHELL_MAX_NUMBER] = {NULL};
 
+#if SHELL_USING_CMD_HASH == 1
+/**
+ * @brief 命令名称索引
+ *        命令表链接后即固定，首个shell初始化时建立；
+ *        只对建立索引所用的命令表生效，其余命令表的shell逐项匹配
+ */
+static xphash_t *shellCommandHash = NULL;
+static ShellCommand *shellCommandHashBase = NULL;
+#endif
 
 static void shellAdd(Shell *shell);
 static void shellWritePrompt(Shell *shell, unsigned char newline);
@@ -202,6 +214,9 @@ ShellCommand* shellSeekCommand(Shell *shell,
                                ShellCommand *base,
                                unsigned short compareLength);
 static void shellWriteCommandHelp(Shell *shell, char *cmd);
+#if SHELL_USING_CMD_HASH == 1
+static void shellBuildCommandHash(Shell *shell);
+#endif
 
 void shellEcho(Shell *shell, unsigned int enable)
 {
@@ -265,6 +280,10 @@ void shellInit(Shell *shell, char *buffer, unsigned short size)
     shell->commandList.count = shellCommandCount;
 #endif
 
+#if SHELL_USING_CMD_HASH == 1
+    shellBuildCommandHash(shell);
+#endif
+
     shellAdd(shell);
     shellSetUser(shell, shellSeekCommand(shell,
                                          SHELL_DEFAULT_USER,
@@ -1003,6 +1022,22 @@ ShellCommand* shellSeekCommand(Shell *shell,
     const char *name;
     unsigned short count = shell->commandList.count -
         ((shell_pointer_t)base - (shell_pointer_t)shell->commandList.base) / sizeof(ShellCommand);
+#if SHELL_USING_CMD_HASH == 1
+    if (!compareLength && base == shellCommandHashBase
+        && shellCommandHash != NULL && xphash_is_built(shellCommandHash))
+    {
+        int index = xphash_find(shellCommandHash, cmd);
+        if (index < 0)
+        {
+            return NULL;
+        }
+        if (shellCheckPermission(shell, &base[index]) == 0)
+        {
+            return &base[index];
+        }
+        /* 同名的首个命令无权限时，继续逐项查找后续同名命令 */
+    }
+#endif
     for (unsigned short i = 0; i < count; i++)
     {
         if (base[i].attr.attrs.type == SHELL_TYPE_KEY
@@ -1030,6 +1065,52 @@ ShellCommand* shellSeekCommand(Shell *shell,
 }
 
 
+#if SHELL_USING_CMD_HASH == 1
+/**
+ * @brief 获取命令索引的键
+ * 
+ * @param ctx 命令表基址
+ * @param index 命令序号
+ * @return const char* 命令名，按键类命令返回NULL
+ */
+static const char* shellCommandHashKey(void *ctx, uint32_t index)
+{
+    ShellCommand *base = (ShellCommand *)ctx;
+    if (base[index].attr.attrs.type == SHELL_TYPE_KEY)
+    {
+        return NULL;
+    }
+    return shellGetCommandName(&base[index]);
+}
+
+
+/**
+ * @brief 建立命令名称索引
+ *        建立失败时保持为空，shellSeekCommand退回逐项匹配
+ * 
+ * @param shell shell对象
+ */
+static void shellBuildCommandHash(Shell *shell)
+{
+    if (shellCommandHash != NULL || shell->commandList.count == 0)
+    {
+        return;
+    }
+    shellCommandHash = xphash_new(shell->commandList.count,
+                                  shellCommandHashKey,
+                                  shell->commandList.base);
+    if (shellCommandHash != NULL
+        && xphash_build(shellCommandHash, shell->commandList.count) != XHAL_OK)
+    {
+        xphash_destroy(shellCommandHash);
+        shellCommandHash = NULL;
+        return;
+    }
+    shellCommandHashBase = shell->commandList.base;
+}
+#endif
+
+
 /**
  * @brief shell 获取变量值
  * 
@@ -29,6 +29,13 @@
  */
 #define SHELL_USING_CMD_EXPORT      1
 
+/**
+ * @brief 是否使用命令名称索引
+ *        使能此宏后，初始化时为命令表建立完美哈希(占用少量xmalloc内存)，
+ *        按完整命令名查找时只需一次哈希和一次比较，建立失败时退回逐项匹配
+ */
+#define SHELL_USING_CMD_HASH        1
+
 /**
  * @brief 是否使用shell伴生对象
  *        一些扩展的组件(文件系统支持，日志工具等)需要使用伴生对象
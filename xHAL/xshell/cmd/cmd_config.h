@@ -6,6 +6,7 @@
 #define SHELL_CMD_ENABLE_TIME     (1)
 #define SHELL_CMD_ENABLE_DUMP     (1)
 #define SHELL_CMD_ENABLE_MEM      (1)
+#define SHELL_CMD_ENABLE_MEMTRACE (1)
 #define SHELL_CMD_ENABLE_LOG      (1)
 #define SHELL_CMD_ENABLE_VER      (1)
 #define SHELL_CMD_ENABLE_REBOOT   (1)
@@ -13,6 +14,7 @@
 #define SHELL_CMD_ENABLE_TASKS    (1)
 #define SHELL_CMD_ENABLE_KILL     (1)
 #define SHELL_CMD_ENABLE_USAGE     (1)
+#define SHELL_CMD_ENABLE_RBUF     (1)
 
 #define SHELL_CMD_IS_ENABLED(cmd) \
     (SHELL_CMD_ENABLE_ALL && SHELL_CMD_ENABLE_##cmd)
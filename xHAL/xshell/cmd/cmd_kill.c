@@ -1,3 +1,5 @@
+#include "../../xcore/xhal_malloc.h"
+#include "../../xlib/xhal_arena.h"
 #include "../../xos/xhal_os.h"
 #include "../xhal_shell.h"
 #include "cmd_config.h"
@@ -101,6 +103,14 @@ static int kill_cmd(int argc, char *argv[])
         }
     }
 
+    /* The kernel does not free the scratch arena or heap cache of a
+     * deleted thread */
+    osThreadSuspend(target_thread);
+    xarena_scratch_release_thread(target_thread);
+#if XMALLOC_THREAD_CACHE
+    xmem_cache_flush_thread(target_thread);
+#endif
+
     osStatus_t status = osThreadTerminate(target_thread);
 
     if (status == osOK)
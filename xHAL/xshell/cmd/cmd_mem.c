@@ -19,12 +19,26 @@ static int meminfo_cmd(int argc, char *argv[])
         return -1;
     }
 
-    uint32_t free_size = xmem_free_size();
-    uint16_t perused   = xmem_perused();
+    xmem_stats_t stats;
+    xmem_get_stats(&stats);
+
+    uint16_t perused = stats.perused;
 
     shellPrint(shell, "\r\n[ Memory Info ]\r\n");
     shellPrint(shell, "  FreeSize    : %lu bytes\r\n",
-               (unsigned long)free_size);
+               (unsigned long)stats.free_size);
+    shellPrint(shell, "  FreeMin     : %lu bytes\r\n",
+               (unsigned long)stats.free_min);
+    shellPrint(shell, "  LargestFree : %lu bytes\r\n",
+               (unsigned long)stats.largest_free);
+    shellPrint(shell, "  UsedBlocks  : %lu\r\n",
+               (unsigned long)stats.used_blocks);
+    shellPrint(shell, "  Alloc/Free  : %lu/%lu (failed %lu)\r\n",
+               (unsigned long)stats.alloc_count,
+               (unsigned long)stats.free_count,
+               (unsigned long)stats.fail_count);
+    shellPrint(shell, "  Fragment    : %d.%d%%\r\n", stats.frag / 10,
+               stats.frag % 10);
     shellPrint(shell, "  UsedPercent : %d.%d%%\r\n", perused / 10,
                perused % 10);
 
@@ -36,7 +50,33 @@ static int meminfo_cmd(int argc, char *argv[])
         else
             shellPrint(shell, ".");
     }
-    shellPrint(shell, "]\r\n\r\n");
+    shellPrint(shell, "]\r\n");
+
+    if (xmem_region_count() > 1)
+    {
+        shellPrint(shell, "\r\n[ Memory Regions ]\r\n");
+        shellPrint(shell, "  %-10s %-10s %-10s %-10s %-6s %s\r\n", "Name",
+                   "Base", "Total", "Free", "Used", "Caps");
+        for (uint8_t i = 0; i < xmem_region_count(); i++)
+        {
+            xmem_region_info_t info;
+            if (xmem_region_get_info(i, &info) != XHAL_OK)
+                continue;
+
+            shellPrint(shell,
+                       "  %-10s 0x%08lx %-10lu %-10lu %3d.%d%% %s%s%s%s\r\n",
+                       info.name == NULL ? "-" : info.name,
+                       (unsigned long)(xhal_pointer_t)info.base,
+                       (unsigned long)info.total_size,
+                       (unsigned long)info.free_size, info.perused / 10,
+                       info.perused % 10,
+                       (info.caps & XMEM_CAP_DEFAULT) ? "D" : "-",
+                       (info.caps & XMEM_CAP_FAST) ? "F" : "-",
+                       (info.caps & XMEM_CAP_DMA) ? "M" : "-",
+                       (info.caps & XMEM_CAP_RETAINED) ? "R" : "-");
+        }
+    }
+    shellPrint(shell, "\r\n");
 
     return 0;
 }
@@ -0,0 +1,187 @@
+#include "../../xcore/xhal_malloc.h"
+#include "../xhal_shell.h"
+#include "cmd_config.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define CMD_MEMTRACE_USAGE                                    \
+    "memtrace [-m | -l | -r]\r\n"                             \
+    " (none): top consumers by live bytes\r\n"                \
+    " -m: mark a snapshot for leak detection\r\n"             \
+    " -l: list blocks allocated since the mark and alive\r\n" \
+    " -r: reset peak and rate counters\r\n"
+
+#define CMD_MEMTRACE_TOP_NUM (10)
+
+#if SHELL_CMD_IS_ENABLED(MEMTRACE) && XMALLOC_TRACE_ENABLE
+static uint32_t memtrace_mark = 0;
+static uint32_t memtrace_mark_live[XMALLOC_TRACE_TAG_NUM];
+static uint8_t memtrace_marked = 0;
+
+static const char *memtrace_basename(const char *path)
+{
+    const char *name = path;
+
+    if (path == NULL)
+        return "-";
+
+    for (const char *p = path; *p != '\0'; p++)
+    {
+        if (*p == '/' || *p == '\\')
+            name = p + 1;
+    }
+
+    return name;
+}
+
+static void memtrace_top(Shell *shell)
+{
+    xmem_trace_tag_t tags[XMALLOC_TRACE_TAG_NUM];
+    uint8_t count = 0;
+
+    for (uint8_t i = 0; i < xmem_trace_tag_count(); i++)
+    {
+        if (xmem_trace_get_tag(i, &tags[count]) == XHAL_OK)
+            count++;
+    }
+
+    /* Insertion sort by live bytes, descending */
+    for (uint8_t i = 1; i < count; i++)
+    {
+        xmem_trace_tag_t key = tags[i];
+        uint8_t j            = i;
+        while (j > 0 && tags[j - 1].live_bytes < key.live_bytes)
+        {
+            tags[j] = tags[j - 1];
+            j--;
+        }
+        tags[j] = key;
+    }
+
+    shellPrint(shell, "\r\n[ Memory Trace ]\r\n");
+    shellPrint(shell, "  %-20s %-8s %-8s %-6s %-8s %s\r\n", "Tag", "Live",
+               "Peak", "Blocks", "Allocs", "Rate/s");
+    for (uint8_t i = 0; i < count && i < CMD_MEMTRACE_TOP_NUM; i++)
+    {
+        if (tags[i].live_bytes == 0 && tags[i].peak_bytes == 0)
+            continue;
+
+        shellPrint(shell, "  %-20s %-8lu %-8lu %-6lu %-8lu %lu\r\n",
+                   memtrace_basename(tags[i].tag),
+                   (unsigned long)tags[i].live_bytes,
+                   (unsigned long)tags[i].peak_bytes,
+                   (unsigned long)tags[i].live_count,
+                   (unsigned long)tags[i].alloc_count,
+                   (unsigned long)tags[i].rate);
+    }
+
+    if (xmem_trace_dropped() != 0)
+    {
+        shellPrint(shell, "  untracked blocks: %lu\r\n",
+                   (unsigned long)xmem_trace_dropped());
+    }
+    shellPrint(shell, "\r\n");
+}
+
+static void memtrace_set_mark(Shell *shell)
+{
+    xmem_trace_tag_t tag;
+
+    memtrace_mark = xmem_trace_snapshot();
+    memset(memtrace_mark_live, 0, sizeof(memtrace_mark_live));
+    for (uint8_t i = 0; i < xmem_trace_tag_count(); i++)
+    {
+        if (xmem_trace_get_tag(i, &tag) == XHAL_OK)
+            memtrace_mark_live[i] = tag.live_bytes;
+    }
+    memtrace_marked = 1;
+
+    shellPrint(shell, "snapshot marked at #%lu\r\n",
+               (unsigned long)memtrace_mark);
+}
+
+static void memtrace_leak(Shell *shell)
+{
+    xmem_trace_rec_t rec;
+    xmem_trace_tag_t tag;
+    uint32_t index = 0, blocks = 0, bytes = 0;
+
+    if (!memtrace_marked)
+    {
+        shellPrint(shell, "no snapshot, run 'memtrace -m' first\r\n");
+        return;
+    }
+
+    shellPrint(shell, "\r\n[ Alive Since #%lu ]\r\n",
+               (unsigned long)memtrace_mark);
+    shellPrint(shell, "  %-10s %-8s %-10s %s\r\n", "Addr", "Size", "Time",
+               "Site");
+    while (xmem_trace_get_rec(&index, memtrace_mark, &rec) == XHAL_OK)
+    {
+        shellPrint(shell, "  0x%08lx %-8lu %-10lu %s:%lu\r\n",
+                   (unsigned long)(xhal_pointer_t)rec.ptr,
+                   (unsigned long)rec.size, (unsigned long)rec.time,
+                   memtrace_basename(rec.tag), (unsigned long)rec.line);
+        blocks++;
+        bytes += rec.size;
+    }
+    shellPrint(shell, "  total: %lu blocks, %lu bytes\r\n",
+               (unsigned long)blocks, (unsigned long)bytes);
+
+    shellPrint(shell, "\r\n[ Growth Since Mark ]\r\n");
+    for (uint8_t i = 0; i < xmem_trace_tag_count(); i++)
+    {
+        if (xmem_trace_get_tag(i, &tag) != XHAL_OK)
+            continue;
+        if (tag.live_bytes <= memtrace_mark_live[i])
+            continue;
+
+        shellPrint(shell, "  %-20s +%lu bytes\r\n",
+                   memtrace_basename(tag.tag),
+                   (unsigned long)(tag.live_bytes - memtrace_mark_live[i]));
+    }
+    shellPrint(shell, "\r\n");
+}
+
+static int memtrace_cmd(int argc, char *argv[])
+{
+    Shell *shell = shellGetCurrent();
+    SHELL_ASSERT(shell, return -1);
+
+    if (argc == 1)
+    {
+        memtrace_top(shell);
+        return 0;
+    }
+
+    if (argc == 2)
+    {
+        if (strcmp(argv[1], "-m") == 0)
+        {
+            memtrace_set_mark(shell);
+            return 0;
+        }
+        else if (strcmp(argv[1], "-l") == 0)
+        {
+            memtrace_leak(shell);
+            return 0;
+        }
+        else if (strcmp(argv[1], "-r") == 0)
+        {
+            xmem_trace_reset();
+            shellPrint(shell, "memory trace counters reset\r\n");
+            return 0;
+        }
+
+        shellPrint(shell, "unknown parameter: %s\r\n", argv[1]);
+    }
+
+    shellPrint(shell, "usage:\r\n");
+    shellPrint(shell, CMD_MEMTRACE_USAGE);
+    return -1;
+}
+
+SHELL_EXPORT_CMD(SHELL_CMD_PERMISSION(0) | SHELL_CMD_TYPE(SHELL_TYPE_CMD_MAIN),
+                 memtrace, memtrace_cmd,
+                 "\r\nshow heap usage by call site\r\n" CMD_MEMTRACE_USAGE);
+#endif
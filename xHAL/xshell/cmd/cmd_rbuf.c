@@ -0,0 +1,71 @@
+#include "../../xlib/xhal_ringbuf.h"
+#include "../xhal_shell.h"
+#include "cmd_config.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CMD_RBUF_USAGE                              \
+    "rbuf [-r]\r\n"                                 \
+    " (none): list registered ring buffers\r\n"     \
+    " -r: reset peak, byte and event counters\r\n"
+
+#if SHELL_CMD_IS_ENABLED(RBUF) && XRBUF_STATS_ENABLE
+static void rbuf_list(Shell *shell)
+{
+    xrbuf_info_t info;
+
+    shellPrint(shell, "\r\n[ Ring Buffers ]\r\n");
+    shellPrint(shell, "  %-16s %-6s %-6s %-6s %-10s %-10s %-6s %-6s %s\r\n",
+               "Name", "Size", "Used", "Peak", "In", "Out", "Ovf", "Udf",
+               "Full(ms)");
+
+    for (uint32_t i = 0; xrbuf_registry_get(i, &info); i++)
+    {
+        char name[17];
+
+        snprintf(name, sizeof(name), "%s.%s",
+                 info.owner == NULL ? "-" : info.owner,
+                 info.name == NULL ? "-" : info.name);
+
+        shellPrint(shell,
+                   "  %-16s %-6lu %-6lu %-6lu %-10lu %-10lu %-6lu %-6lu "
+                   "%lu\r\n",
+                   name, (unsigned long)info.size, (unsigned long)info.used,
+                   (unsigned long)info.stats.used_max,
+                   (unsigned long)info.stats.bytes_in,
+                   (unsigned long)info.stats.bytes_out,
+                   (unsigned long)info.stats.overflow,
+                   (unsigned long)info.stats.underflow,
+                   (unsigned long)info.stats.full_ms);
+    }
+    shellPrint(shell, "\r\n");
+}
+
+static int rbuf_cmd(int argc, char *argv[])
+{
+    Shell *shell = shellGetCurrent();
+    SHELL_ASSERT(shell, return -1);
+
+    if (argc == 1)
+    {
+        rbuf_list(shell);
+        return 0;
+    }
+
+    if (argc == 2 && strcmp(argv[1], "-r") == 0)
+    {
+        xrbuf_registry_reset_stats();
+        shellPrint(shell, "ring buffer counters reset\r\n");
+        return 0;
+    }
+
+    shellPrint(shell, "usage:\r\n");
+    shellPrint(shell, CMD_RBUF_USAGE);
+    return -1;
+}
+
+SHELL_EXPORT_CMD(SHELL_CMD_PERMISSION(0) | SHELL_CMD_TYPE(SHELL_TYPE_CMD_MAIN),
+                 rbuf, rbuf_cmd,
+                 "\r\nshow ring buffer usage\r\n" CMD_RBUF_USAGE);
+#endif
@@ -0,0 +1,61 @@
+#ifndef __BENCH_COMMON_H
+#define __BENCH_COMMON_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* 主机端基准测试公共工具: 纳秒计时, 伪随机数, 分位数统计 */
+
+static inline uint64_t bench_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static inline uint32_t bench_rand(uint32_t *state)
+{
+    uint32_t x = *state;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+static inline int _bench_cmp_u64(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief  对样本排序后输出 p50/p90/p99/p999/max (单位 ns)
+ */
+static inline void bench_print_percentile(const char *name, uint64_t *samples,
+                                          size_t n)
+{
+    if (n == 0)
+    {
+        printf("%-24s no samples\n", name);
+        return;
+    }
+
+    qsort(samples, n, sizeof(samples[0]), _bench_cmp_u64);
+    printf("%-24s n=%-8zu p50=%-6llu p90=%-6llu p99=%-6llu p999=%-6llu "
+           "max=%llu\n",
+           name, n, (unsigned long long)samples[n * 50 / 100],
+           (unsigned long long)samples[n * 90 / 100],
+           (unsigned long long)samples[n * 99 / 100],
+           (unsigned long long)samples[n * 999 / 1000],
+           (unsigned long long)samples[n - 1]);
+}
+
+#endif /* __BENCH_COMMON_H */
@@ -0,0 +1,301 @@
+/*
+ * xcoro 就绪队列基准
+ *
+ * 对照组为按优先级有序插入的单链表, 即改造前 ready_list 的做法.
+ * - 批量唤醒: N 个协程以随机顺序、随机优先级被 xcoro_schedule, 再全部
+ *   取出运行, 统计每次唤醒+调度的耗时;
+ * - 常驻队列: 队列保持 N 个就绪协程, 每步取出最高优先级者并以新的随机
+ *   优先级重新挂入.
+ * 两组使用相同随机序列, 逐个比对取出顺序(优先级从高到低、同优先级先进
+ * 先出), 另检查同优先级 xcoro_yield 的轮转公平性.
+ */
+#include "../../xcore/xhal_coro.h"
+#include "../../xcore/xhal_malloc.h"
+#include "bench_common.h"
+
+#define BENCH_CORO_MAX (1024)
+#define BENCH_ROUNDS   (256)  /* 批量唤醒的轮数 */
+#define BENCH_STEPS    (1UL << 18)
+#define BENCH_RR_CORO  (16)   /* 轮转检查的同优先级协程数 */
+#define BENCH_RR_LOOP  (100)
+
+typedef struct bench_node
+{
+    struct bench_node *next;
+    uint32_t prio;
+    uint32_t id;
+} bench_node_t;
+
+static xcoro_manager_t mgr;
+static xcoro_handle_t handles[BENCH_CORO_MAX];
+static bench_node_t nodes[BENCH_CORO_MAX];
+static bench_node_t *list_head;
+
+static uint32_t order[BENCH_CORO_MAX];
+static uint32_t trace_new[BENCH_STEPS];
+static uint32_t trace_old[BENCH_STEPS];
+static uint32_t run_count[BENCH_RR_CORO + 1];
+
+/* 改造前的 _ready_list_insert */
+static void _list_insert(bench_node_t *node)
+{
+    bench_node_t **pp = &list_head;
+
+    while (*pp && (*pp)->prio >= node->prio)
+        pp = &(*pp)->next;
+
+    node->next = *pp;
+    *pp        = node;
+}
+
+static bench_node_t *_list_pop(void)
+{
+    bench_node_t *node = list_head;
+
+    if (node)
+    {
+        list_head  = node->next;
+        node->next = NULL;
+    }
+    return node;
+}
+
+static void _entry_nop(xcoro_handle_t *handle)
+{
+    (void)handle;
+}
+
+static void _entry_yield(xcoro_handle_t *handle)
+{
+    uint32_t id = (uint32_t)(handle - handles);
+
+    run_count[id]++;
+    if (handle->prio > XCORO_PRIO_IDLE)
+        xcoro_yield(handle);
+}
+
+static void _setup(uint32_t n, xcoro_entry_t entry)
+{
+    xcoro_manager_init(&mgr);
+    for (uint32_t i = 0; i < n; i++)
+    {
+        xmemset(&handles[i], 0, sizeof(handles[i]));
+        handles[i].entry = entry;
+        xcoro_register(&mgr, &handles[i]);
+    }
+
+    /* 注册时已入队, 清空后由测试自行唤醒 */
+    while (_get_next_ready(&mgr) != NULL)
+        ;
+    list_head = NULL;
+}
+
+static void _shuffle(uint32_t n, uint32_t *seed)
+{
+    for (uint32_t i = 0; i < n; i++)
+        order[i] = i;
+    for (uint32_t i = n - 1; i > 0; i--)
+    {
+        uint32_t j = bench_rand(seed) % (i + 1);
+        uint32_t t = order[i];
+        order[i]   = order[j];
+        order[j]   = t;
+    }
+}
+
+/* 批量唤醒, 返回每次唤醒+取出的 ns */
+static double _bench_batch_new(uint32_t n, uint32_t *trace)
+{
+    uint32_t seed = 0x2545F491U;
+    uint64_t ns   = 0;
+    uint32_t t    = 0;
+
+    _setup(n, _entry_nop);
+    for (uint32_t r = 0; r < BENCH_ROUNDS; r++)
+    {
+        _shuffle(n, &seed);
+        for (uint32_t i = 0; i < n; i++)
+            handles[i].prio = (xcoro_priority_t)(bench_rand(&seed) %
+                                                 XCORO_PRIO_MAX);
+
+        uint64_t t0 = bench_now_ns();
+        for (uint32_t i = 0; i < n; i++)
+            xcoro_schedule(&handles[order[i]]);
+
+        xcoro_handle_t *handle;
+        while ((handle = _get_next_ready(&mgr)) != NULL)
+        {
+            handle->entry(handle);
+            if (r == 0)
+                trace[t++] = (uint32_t)(handle - handles);
+        }
+        ns += bench_now_ns() - t0;
+    }
+
+    return (double)ns / ((double)n * BENCH_ROUNDS);
+}
+
+static double _bench_batch_old(uint32_t n, uint32_t *trace)
+{
+    uint32_t seed = 0x2545F491U;
+    uint64_t ns   = 0;
+    uint32_t t    = 0;
+
+    list_head = NULL;
+    for (uint32_t r = 0; r < BENCH_ROUNDS; r++)
+    {
+        _shuffle(n, &seed);
+        for (uint32_t i = 0; i < n; i++)
+        {
+            nodes[i].id   = i;
+            nodes[i].prio = bench_rand(&seed) % XCORO_PRIO_MAX;
+        }
+
+        uint64_t t0 = bench_now_ns();
+        for (uint32_t i = 0; i < n; i++)
+            _list_insert(&nodes[order[i]]);
+
+        bench_node_t *node;
+        while ((node = _list_pop()) != NULL)
+        {
+            if (r == 0)
+                trace[t++] = node->id;
+        }
+        ns += bench_now_ns() - t0;
+    }
+
+    return (double)ns / ((double)n * BENCH_ROUNDS);
+}
+
+/* 常驻队列, 返回每步的 ns */
+static double _bench_steady_new(uint32_t n, uint32_t *trace)
+{
+    uint32_t seed = 0x68E31DA4U;
+
+    _setup(n, _entry_nop);
+    for (uint32_t i = 0; i < n; i++)
+    {
+        handles[i].prio = (xcoro_priority_t)(bench_rand(&seed) %
+                                             XCORO_PRIO_MAX);
+        xcoro_schedule(&handles[i]);
+    }
+
+    uint64_t t0 = bench_now_ns();
+    for (uint32_t s = 0; s < BENCH_STEPS; s++)
+    {
+        xcoro_handle_t *handle = _get_next_ready(&mgr);
+
+        trace[s]     = (uint32_t)(handle - handles);
+        handle->prio = (xcoro_priority_t)(bench_rand(&seed) % XCORO_PRIO_MAX);
+        xcoro_schedule(handle);
+    }
+    uint64_t t1 = bench_now_ns();
+
+    return (double)(t1 - t0) / BENCH_STEPS;
+}
+
+static double _bench_steady_old(uint32_t n, uint32_t *trace)
+{
+    uint32_t seed = 0x68E31DA4U;
+
+    list_head = NULL;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        nodes[i].id   = i;
+        nodes[i].prio = bench_rand(&seed) % XCORO_PRIO_MAX;
+        _list_insert(&nodes[i]);
+    }
+
+    uint64_t t0 = bench_now_ns();
+    for (uint32_t s = 0; s < BENCH_STEPS; s++)
+    {
+        bench_node_t *node = _list_pop();
+
+        trace[s]   = node->id;
+        node->prio = bench_rand(&seed) % XCORO_PRIO_MAX;
+        _list_insert(node);
+    }
+    uint64_t t1 = bench_now_ns();
+
+    return (double)(t1 - t0) / BENCH_STEPS;
+}
+
+/*
+ * 同优先级的协程每次 yield 后排到队尾, 应严格轮流运行;
+ * 另挂一个 IDLE 协程, 在高优先级协程结束前不得运行.
+ */
+static uint64_t _check_round_robin(void)
+{
+    uint64_t errors = 0;
+
+    _setup(BENCH_RR_CORO + 1, _entry_yield);
+    xmemset(run_count, 0, sizeof(run_count));
+    for (uint32_t i = 0; i < BENCH_RR_CORO; i++)
+    {
+        handles[i].prio = XCORO_PRIO_NORMAL;
+        xcoro_schedule(&handles[i]);
+    }
+    handles[BENCH_RR_CORO].prio = XCORO_PRIO_IDLE;
+    xcoro_schedule(&handles[BENCH_RR_CORO]);
+
+    for (uint32_t s = 0; s < BENCH_RR_CORO * BENCH_RR_LOOP; s++)
+    {
+        xcoro_handle_t *handle = _get_next_ready(&mgr);
+
+        errors += (handle != &handles[s % BENCH_RR_CORO]);
+        if (handle)
+            handle->entry(handle);
+    }
+
+    for (uint32_t i = 0; i < BENCH_RR_CORO; i++)
+        errors += (run_count[i] != BENCH_RR_LOOP);
+    errors += (run_count[BENCH_RR_CORO] != 0);
+
+    /* 注销/结束的协程须从队列中摘除 */
+    errors += (xcoro_unregister(&handles[3]) != XHAL_OK);
+    xcoro_finish(&handles[BENCH_RR_CORO - 1]);
+
+    uint32_t left = 0;
+    xcoro_handle_t *handle;
+    while ((handle = _get_next_ready(&mgr)) != NULL)
+    {
+        errors += (handle == &handles[3]);
+        errors += (handle == &handles[BENCH_RR_CORO - 1]);
+        left++;
+    }
+    errors += (left != BENCH_RR_CORO - 1);
+
+    return errors;
+}
+
+int main(void)
+{
+    static const uint32_t sizes[] = {16, 64, 256, 1024};
+    uint64_t errors               = 0;
+
+    errors += _check_round_robin();
+
+    printf("%-6s %12s %12s %12s %12s\n", "coros", "batch_list", "batch_map",
+           "steady_list", "steady_map");
+    for (uint32_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+    {
+        uint32_t n = sizes[i];
+
+        double batch_old = _bench_batch_old(n, trace_old);
+        double batch_new = _bench_batch_new(n, trace_new);
+        errors += memcmp(trace_old, trace_new, n * sizeof(uint32_t)) != 0;
+
+        double steady_old = _bench_steady_old(n, trace_old);
+        double steady_new = _bench_steady_new(n, trace_new);
+        errors += memcmp(trace_old, trace_new, sizeof(trace_old)) != 0;
+
+        printf("%-6u %9.1f ns %9.1f ns %9.1f ns %9.1f ns\n", n, batch_old,
+               batch_new, steady_old, steady_new);
+    }
+
+    printf("errors=%llu\n", (unsigned long long)errors);
+    if (errors != 0)
+        printf("FAILED\n");
+
+    return errors != 0;
+}
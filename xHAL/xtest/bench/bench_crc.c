@@ -0,0 +1,300 @@
+/*
+ * xcrc32/xcrc8/xcrc16 吞吐与交叉校验基准
+ *
+ * 按 XCRC32_SLICE_BY 分别编译(1 即改造前的逐字节查表), 对 64B~64KB
+ * 各长度输出 MB/s, 并与逐位计算的参考实现比对:
+ * 标准校验值("123456789")、随机长度/起始地址/分段续算以及
+ * xcrc32_combine 分段合并的结果一致.
+ * 以 -DBENCH_CRC_HW_EMU 编译时用软件模拟 STM32F1 CRC 单元实现
+ * xcrc32_accel, 校验驱动中寄存器换算与续算的正确性
+ * (此时 crc32 一列吞吐无参考意义).
+ */
+#include "../../xlib/xhal_crc.h"
+#include "bench_common.h"
+
+#define BENCH_MAX_SIZE  (64 * 1024)
+#define BENCH_BYTES     (64ULL * 1024 * 1024) /* 每个测点累计计算量 */
+#define BENCH_CHECK_RUN (20000)               /* 随机交叉校验次数 */
+
+static uint8_t buf[BENCH_MAX_SIZE + 64];
+static xcrc8_t crc8_engine;
+static xcrc16_t ccitt_engine;
+static xcrc16_t modbus_engine;
+
+#ifdef BENCH_CRC_HW_EMU
+/* STM32F1 CRC 单元模型: 32 位字高位在前, 复位值 0xFFFFFFFF */
+static uint32_t hw_dr;
+
+static void _hw_write(uint32_t w)
+{
+    hw_dr ^= w;
+    for (uint8_t i = 0; i < 32; i++)
+    {
+        hw_dr = (hw_dr & 0x80000000U) ? (hw_dr << 1) ^ 0x04C11DB7U
+                                      : hw_dr << 1;
+    }
+}
+
+static uint32_t _rbit(uint32_t x)
+{
+    uint32_t r = 0;
+
+    for (uint8_t i = 0; i < 32; i++, x >>= 1)
+        r = (r << 1) | (x & 1U);
+
+    return r;
+}
+
+static uint32_t _unshift(uint32_t t)
+{
+    for (uint8_t i = 0; i < 32; i++)
+        t = (t & 1U) ? ((t ^ 0x04C11DB7U) >> 1) | 0x80000000U : t >> 1;
+
+    return t;
+}
+
+/* 与 drv_crc.c 相同的换算, 分块以覆盖续算路径 */
+xhal_err_t xcrc32_accel(uint32_t *state, const void *data, uint32_t size)
+{
+    const uint8_t *p = (const uint8_t *)data;
+    uint32_t crc     = _rbit(*state);
+
+    while (size > 0)
+    {
+        uint32_t n = size < 256 ? size : 256;
+
+        hw_dr = 0xFFFFFFFFU;
+        if (crc != 0xFFFFFFFFU)
+            _hw_write(~_unshift(crc));
+
+        for (uint32_t i = 0; i < n; i += 4)
+        {
+            uint32_t w;
+            memcpy(&w, p + i, sizeof(w));
+            _hw_write(_rbit(w));
+        }
+        crc = hw_dr;
+
+        p += n;
+        size -= n;
+    }
+
+    *state = _rbit(crc);
+
+    return XHAL_OK;
+}
+#endif
+
+/* 逐位参考实现 */
+static uint32_t _ref_crc32(uint32_t crc, const uint8_t *p, uint32_t size)
+{
+    crc = ~crc;
+    while (size--)
+    {
+        crc ^= *p++;
+        for (uint8_t i = 0; i < 8; i++)
+            crc = (crc & 1U) ? (crc >> 1) ^ 0xEDB88320U : crc >> 1;
+    }
+
+    return ~crc;
+}
+
+/* 改造前的 xcrc8 */
+static uint8_t _ref_crc8(uint8_t crc, const uint8_t *p, uint32_t size)
+{
+    while (size--)
+    {
+        crc ^= *p++;
+        for (uint8_t i = 0; i < 8; i++)
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ XCRC8_POLY)
+                               : (uint8_t)(crc << 1);
+    }
+
+    return crc ^ XCRC8_XOROUT;
+}
+
+/* 按参数逐位计算的通用 CRC16 */
+static uint16_t _ref_crc16(const xcrc_param_t *param, const uint8_t *p,
+                           uint32_t size)
+{
+    uint16_t crc = param->init;
+
+    while (size--)
+    {
+        uint8_t b = *p++;
+
+        if (param->reflect)
+        {
+            uint8_t r = 0;
+            for (uint8_t i = 0; i < 8; i++)
+                r |= (uint8_t)(((b >> i) & 1U) << (7 - i));
+            b = r;
+        }
+
+        crc ^= (uint16_t)(b << 8);
+        for (uint8_t i = 0; i < 8; i++)
+            crc = (crc & 0x8000U) ? (uint16_t)((crc << 1) ^ param->poly)
+                                  : (uint16_t)(crc << 1);
+    }
+
+    if (param->reflect)
+    {
+        uint16_t r = 0;
+        for (uint8_t i = 0; i < 16; i++)
+            r |= (uint16_t)(((crc >> i) & 1U) << (15 - i));
+        crc = r;
+    }
+
+    return crc ^ param->xorout;
+}
+
+static uint64_t _check_values(void)
+{
+    const uint8_t *s = (const uint8_t *)"123456789";
+    uint64_t errors  = 0;
+
+    errors += (xcrc32(XCRC32_INIT, s, 9) != 0xCBF43926U);
+    errors += (xcrc8(XCRC8_INIT, s, 9) != 0xF7);
+    errors += (xcrc8_calc(&crc8_engine, s, 9) != 0xF7);
+    errors += (xcrc16_calc(&ccitt_engine, s, 9) != 0x29B1);
+    errors += (xcrc16_calc(&modbus_engine, s, 9) != 0x4B37);
+
+    return errors;
+}
+
+static uint64_t _check_random(void)
+{
+    uint32_t seed   = 0x2545F491U;
+    uint64_t errors = 0;
+
+    for (uint32_t r = 0; r < BENCH_CHECK_RUN; r++)
+    {
+        uint32_t max = r < BENCH_CHECK_RUN / 2 ? 64 : 4096;
+        uint32_t len = bench_rand(&seed) % max;
+        uint32_t off = bench_rand(&seed) % 8;
+        uint32_t cut = len ? bench_rand(&seed) % (len + 1) : 0;
+        uint8_t *p   = buf + off;
+
+        uint32_t ref32 = _ref_crc32(0, p, len);
+        errors += (xcrc32(XCRC32_INIT, p, len) != ref32);
+        errors += (xcrc32(xcrc32(XCRC32_INIT, p, cut), p + cut, len - cut) !=
+                   ref32);
+        errors += (xcrc32_combine(xcrc32(XCRC32_INIT, p, cut),
+                                  xcrc32(XCRC32_INIT, p + cut, len - cut),
+                                  len - cut) != ref32);
+
+        uint8_t ref8 = _ref_crc8(XCRC8_INIT, p, len);
+        errors += (xcrc8(XCRC8_INIT, p, len) != ref8);
+        errors += (xcrc8(xcrc8(XCRC8_INIT, p, cut), p + cut, len - cut) !=
+                   ref8);
+        errors += (xcrc8_calc(&crc8_engine, p, len) != ref8);
+
+        uint16_t c = xcrc16_update(&ccitt_engine, xcrc16_start(&ccitt_engine),
+                                   p, cut);
+        c          = xcrc16_update(&ccitt_engine, c, p + cut, len - cut);
+        errors += (xcrc16_final(&ccitt_engine, c) !=
+                   _ref_crc16(&xcrc16_ccitt_param, p, len));
+        errors += (xcrc16_calc(&modbus_engine, p, len) !=
+                   _ref_crc16(&xcrc16_modbus_param, p, len));
+    }
+
+    return errors;
+}
+
+static double _rate(uint32_t size, uint32_t (*fn)(const uint8_t *, uint32_t))
+{
+    uint64_t loops = BENCH_BYTES / size;
+    volatile uint32_t sink;
+
+    uint64_t t0 = bench_now_ns();
+    for (uint64_t i = 0; i < loops; i++)
+        sink = fn(buf, size);
+    uint64_t t1 = bench_now_ns();
+    (void)sink;
+
+    return (double)(loops * size) / 1e6 / ((double)(t1 - t0) / 1e9);
+}
+
+/* 合并耗时与 len_b 的位数相关, 用随机 32 位长度取均值 */
+static double _combine_ns(void)
+{
+    uint32_t seed = 0x68E31DA4U;
+    uint32_t crc  = 0;
+
+    uint64_t t0 = bench_now_ns();
+    for (uint32_t i = 0; i < 1000000; i++)
+        crc = xcrc32_combine(crc, bench_rand(&seed), bench_rand(&seed));
+    uint64_t t1 = bench_now_ns();
+
+    volatile uint32_t sink = crc;
+    (void)sink;
+
+    return (double)(t1 - t0) / 1000000;
+}
+
+static uint32_t _run_crc32(const uint8_t *p, uint32_t n)
+{
+    return xcrc32(XCRC32_INIT, p, n);
+}
+
+static uint32_t _run_crc8_old(const uint8_t *p, uint32_t n)
+{
+    return _ref_crc8(XCRC8_INIT, p, n);
+}
+
+static uint32_t _run_crc8(const uint8_t *p, uint32_t n)
+{
+    return xcrc8(XCRC8_INIT, p, n);
+}
+
+static uint32_t _run_ccitt(const uint8_t *p, uint32_t n)
+{
+    return xcrc16_calc(&ccitt_engine, p, n);
+}
+
+static uint32_t _run_modbus(const uint8_t *p, uint32_t n)
+{
+    return xcrc16_calc(&modbus_engine, p, n);
+}
+
+int main(void)
+{
+    static const uint32_t sizes[] = {64, 1024, 64 * 1024};
+    uint32_t seed                 = 0x9E3779B9U;
+    uint64_t errors               = 0;
+
+    for (uint32_t i = 0; i < sizeof(buf); i++)
+        buf[i] = (uint8_t)bench_rand(&seed);
+
+    errors += (xcrc8_init(&crc8_engine, &xcrc8_param) != XHAL_OK);
+    errors += (xcrc16_init(&ccitt_engine, &xcrc16_ccitt_param) != XHAL_OK);
+    errors += (xcrc16_init(&modbus_engine, &xcrc16_modbus_param) != XHAL_OK);
+    errors += (xcrc16_init(&ccitt_engine, &xcrc8_param) != XHAL_ERR_INVALID);
+    errors += (xcrc16_init(&ccitt_engine, &xcrc16_ccitt_param) != XHAL_OK);
+
+    errors += _check_values();
+    errors += _check_random();
+
+#ifdef BENCH_CRC_HW_EMU
+    printf("xcrc32 with emulated STM32 CRC unit, threshold %u\n",
+           (unsigned)XCRC32_ACCEL_THRESHOLD);
+#else
+    printf("XCRC32_SLICE_BY=%u (MB/s)\n", (unsigned)XCRC32_SLICE_BY);
+#endif
+    printf("%-8s %10s %10s %10s %10s %10s\n", "size", "crc32", "crc8_old",
+           "crc8", "ccitt", "modbus");
+    for (uint32_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+    {
+        printf("%-8u %10.1f %10.1f %10.1f %10.1f %10.1f\n", sizes[i],
+               _rate(sizes[i], _run_crc32), _rate(sizes[i], _run_crc8_old),
+               _rate(sizes[i], _run_crc8), _rate(sizes[i], _run_ccitt),
+               _rate(sizes[i], _run_modbus));
+    }
+    printf("xcrc32_combine %.1f ns/op\n", _combine_ns());
+
+    printf("errors=%llu\n", (unsigned long long)errors);
+    if (errors != 0)
+        printf("FAILED\n");
+
+    return errors != 0;
+}
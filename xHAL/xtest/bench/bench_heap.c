@@ -0,0 +1,161 @@
+/*
+ * xheap 与有序单链表的定时器负载对比
+ *
+ * 模拟 N 个周期性定时器: 每步取出最早到期者, 以随机周期重新挂入;
+ * 每 8 步另取消并重挂一个随机定时器(相当于超时被提前唤醒).
+ * 对照组为按到期时间有序插入的单链表, 即协程睡眠链表的现有做法.
+ * 两组使用相同随机序列, 逐步比对取出的定时器, 不一致即判失败.
+ */
+#include "../../xlib/xhal_heap.h"
+#include "bench_common.h"
+
+#define BENCH_STEPS     (1UL << 18) /* 每种规模的步数 */
+#define BENCH_SIZE_MAX  (2048)
+#define BENCH_PERIOD    (1000)      /* 重挂周期上限 */
+#define BENCH_CANCEL    (8)         /* 每隔多少步取消一个定时器 */
+
+typedef struct bench_timer
+{
+    xheap_node_t node;
+    struct bench_timer *next; /* 对照组链表 */
+    uint32_t deadline;
+    uint32_t id;
+} bench_timer_t;
+
+static bench_timer_t heap_timers[BENCH_SIZE_MAX];
+static bench_timer_t list_timers[BENCH_SIZE_MAX];
+XHEAP_STORAGE(heap_storage, BENCH_SIZE_MAX);
+
+static uint8_t _bench_less(const xheap_node_t *a, const xheap_node_t *b)
+{
+    const bench_timer_t *x = XHEAP_ENTRY(a, bench_timer_t, node);
+    const bench_timer_t *y = XHEAP_ENTRY(b, bench_timer_t, node);
+
+    if (x->deadline != y->deadline)
+        return x->deadline < y->deadline;
+
+    return x->id < y->id;
+}
+
+static uint8_t _bench_before(const bench_timer_t *x, const bench_timer_t *y)
+{
+    return _bench_less(&x->node, &y->node);
+}
+
+static void _list_insert(bench_timer_t **head, bench_timer_t *t)
+{
+    bench_timer_t **pp = head;
+
+    while (*pp != NULL && !_bench_before(t, *pp))
+        pp = &(*pp)->next;
+
+    t->next = *pp;
+    *pp     = t;
+}
+
+static void _list_remove(bench_timer_t **head, bench_timer_t *t)
+{
+    bench_timer_t **pp = head;
+
+    while (*pp != t)
+        pp = &(*pp)->next;
+
+    *pp = t->next;
+}
+
+static double _bench_heap(uint32_t n, uint32_t *trace)
+{
+    xheap_t heap;
+    uint32_t seed = 0x2545F491U;
+    uint32_t now  = 0;
+
+    xheap_init(&heap, heap_storage, n, _bench_less);
+    for (uint32_t i = 0; i < n; i++)
+    {
+        heap_timers[i].id       = i;
+        heap_timers[i].deadline = bench_rand(&seed) % BENCH_PERIOD;
+        xheap_node_init(&heap_timers[i].node);
+        xheap_push(&heap, &heap_timers[i].node);
+    }
+
+    uint64_t t0 = bench_now_ns();
+    for (uint32_t s = 0; s < BENCH_STEPS; s++)
+    {
+        bench_timer_t *t = XHEAP_ENTRY(xheap_pop(&heap), bench_timer_t, node);
+        now              = t->deadline;
+        trace[s]         = t->id;
+        t->deadline      = now + 1 + bench_rand(&seed) % BENCH_PERIOD;
+        xheap_push(&heap, &t->node);
+
+        if (s % BENCH_CANCEL == 0)
+        {
+            t = &heap_timers[bench_rand(&seed) % n];
+            xheap_remove(&heap, &t->node);
+            t->deadline = now + 1 + bench_rand(&seed) % BENCH_PERIOD;
+            xheap_push(&heap, &t->node);
+        }
+    }
+    uint64_t t1 = bench_now_ns();
+
+    return (double)(t1 - t0) / BENCH_STEPS;
+}
+
+static double _bench_list(uint32_t n, const uint32_t *trace, uint64_t *errors)
+{
+    bench_timer_t *head = NULL;
+    uint32_t seed       = 0x2545F491U;
+    uint32_t now        = 0;
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        list_timers[i].id       = i;
+        list_timers[i].deadline = bench_rand(&seed) % BENCH_PERIOD;
+        _list_insert(&head, &list_timers[i]);
+    }
+
+    uint64_t t0 = bench_now_ns();
+    for (uint32_t s = 0; s < BENCH_STEPS; s++)
+    {
+        bench_timer_t *t = head;
+        head             = t->next;
+        now              = t->deadline;
+        *errors += (trace[s] != t->id);
+        t->deadline = now + 1 + bench_rand(&seed) % BENCH_PERIOD;
+        _list_insert(&head, t);
+
+        if (s % BENCH_CANCEL == 0)
+        {
+            t = &list_timers[bench_rand(&seed) % n];
+            _list_remove(&head, t);
+            t->deadline = now + 1 + bench_rand(&seed) % BENCH_PERIOD;
+            _list_insert(&head, t);
+        }
+    }
+    uint64_t t1 = bench_now_ns();
+
+    return (double)(t1 - t0) / BENCH_STEPS;
+}
+
+int main(void)
+{
+    static const uint32_t sizes[] = {8, 32, 128, 512, 2048};
+    static uint32_t trace[BENCH_STEPS];
+    uint64_t errors = 0;
+
+    printf("%-6s %12s %12s %8s\n", "timers", "heap ns/op", "list ns/op",
+           "speedup");
+    for (uint32_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+    {
+        double heap = _bench_heap(sizes[i], trace);
+        double list = _bench_list(sizes[i], trace, &errors);
+
+        printf("%-6u %12.1f %12.1f %7.2fx\n", sizes[i], heap, list,
+               list / heap);
+    }
+
+    printf("errors=%llu\n", (unsigned long long)errors);
+    if (errors != 0)
+        printf("FAILED\n");
+
+    return errors != 0;
+}
@@ -0,0 +1,44 @@
+/*
+ * xhtable 查找/插入/删除混合负载基准
+ *
+ * 候选键为 "dev/node_%u" 形式的键名, 线性一列为 strcmp 数组(即命令表、
+ * 外设表的现有查找方式). 负载与比对方式见 bench_table.h.
+ */
+#include "../../xlib/xhal_htable.h"
+
+#define BENCH_OPS      (1UL << 18) /* 每种负载的操作数 */
+#define BENCH_KEYS_MAX (2 * 1024)
+#define BENCH_KEY_LEN  (16)
+
+static char keys[BENCH_KEYS_MAX][BENCH_KEY_LEN];
+
+#define BENCH_KEY_T           const char *
+#define BENCH_KEY(k)          ((const char *)keys[k])
+#define BENCH_VALUE(k)        ((void *)keys[k])
+#define BENCH_KEY_EQ(a, b)    (strcmp((a), (b)) == 0)
+#define BENCH_SHOWN(n)        (n)
+
+#define bench_table_t         xhal_htable_t
+#define bench_table_data_t    xhal_htable_data_t
+#define bench_table_stats_t   xhal_htable_stats_t
+#define bench_table_new       xhtable_new
+#define bench_table_destroy   xhtable_destroy
+#define bench_table_init      xhtable_init
+#define bench_table_add       xhtable_add
+#define bench_table_get       xhtable_get
+#define bench_table_remove    xhtable_remove
+#define bench_table_count     xhtable_count
+#define bench_table_get_stats xhtable_get_stats
+
+#include "bench_table.h"
+
+int main(void)
+{
+    static const uint32_t sizes[] = {16, 64, 256, 1024, 2048};
+
+    for (uint32_t i = 0; i < BENCH_KEYS_MAX; i++)
+        snprintf(keys[i], sizeof(keys[i]), "dev/node_%u", (unsigned)i);
+
+    return bench_table_main(sizes, sizeof(sizes) / sizeof(sizes[0]), "keys",
+                            "strcmp");
+}
@@ -0,0 +1,46 @@
+/*
+ * xitable 整数键查找/插入/删除混合负载基准
+ *
+ * 候选键为连续 ID(偶数项预先在表中), 线性一列为 ID 数组(即按 ID 遍历
+ * 链表/数组的现有查找方式). 负载与比对方式见 bench_table.h.
+ */
+#include "../../xlib/xhal_itable.h"
+
+#define BENCH_OPS      (1UL << 17) /* 每种负载的操作数 */
+#define BENCH_KEYS_MAX (8 * 1024)
+
+static uint32_t keys[BENCH_KEYS_MAX];
+static uint8_t values[BENCH_KEYS_MAX];
+
+#define BENCH_KEY_T           uint32_t
+#define BENCH_KEY(k)          (keys[k])
+#define BENCH_VALUE(k)        ((void *)&values[k])
+#define BENCH_KEY_EQ(a, b)    ((a) == (b))
+#define BENCH_SHOWN(n)        ((n) / 2)
+
+#define bench_table_t         xhal_itable_t
+#define bench_table_data_t    xhal_itable_data_t
+#define bench_table_stats_t   xhal_itable_stats_t
+#define bench_table_new       xitable_new
+#define bench_table_destroy   xitable_destroy
+#define bench_table_init      xitable_init
+#define bench_table_add       xitable_add
+#define bench_table_get       xitable_get
+#define bench_table_remove    xitable_remove
+#define bench_table_count     xitable_count
+#define bench_table_get_stats xitable_get_stats
+
+#include "bench_table.h"
+
+int main(void)
+{
+    /* 表中 ID 数约为候选数的一半, 即 8 ~ 4096 */
+    static const uint32_t sizes[] = {16, 64, 256, 1024, 4096, 8192};
+
+    /* 连续 ID, 与 xkey/xcoro 的编号方式一致 */
+    for (uint32_t i = 0; i < BENCH_KEYS_MAX; i++)
+        keys[i] = i + 1;
+
+    return bench_table_main(sizes, sizeof(sizes) / sizeof(sizes[0]), "ids",
+                            "linear");
+}
@@ -0,0 +1,125 @@
+/*
+ * xmalloc 分配器延迟基准
+ *
+ * 同一份源码分别以 XMALLOC_USE_TLSF=0/1 编译, 对同一组随机分配/释放序列
+ * 统计单次 xmalloc/xfree 的延迟分位数, 用于对比分块映射表与 TLSF 后端.
+ */
+#include "../../xcore/xhal_malloc.h"
+#include "bench_common.h"
+
+#define BENCH_SLOTS (256)
+#define BENCH_OPS   (200000)
+
+#if XMALLOC_USE_TLSF
+#define BENCH_NAME "tlsf"
+#else
+#define BENCH_NAME "blockmap"
+#endif
+
+static void *slots[BENCH_SLOTS];
+static uint64_t alloc_ns[BENCH_OPS];
+static uint64_t free_ns[BENCH_OPS];
+
+/* 小块为主, 偶尔出现大块, 贴近嵌入式典型负载 */
+static uint32_t _bench_size(uint32_t *seed)
+{
+    uint32_t r = bench_rand(seed);
+
+    if ((r & 0xF) == 0)
+        return 256 + (r >> 8) % 1024;
+    return 8 + (r >> 8) % 120;
+}
+
+static void _bench_run(const char *phase, uint32_t seed, uint32_t fill)
+{
+    size_t n_alloc = 0, n_free = 0;
+    uint32_t failed = 0;
+
+    for (uint32_t i = 0; i < BENCH_OPS; i++)
+    {
+        uint32_t r    = bench_rand(&seed);
+        uint32_t slot = r % BENCH_SLOTS;
+
+        /* fill 控制分配倾向, 越大堆越满, 碎片越多 */
+        if (slots[slot] == NULL && (r >> 16) % 100 < fill)
+        {
+            uint32_t size = _bench_size(&seed);
+            uint64_t t0   = bench_now_ns();
+            slots[slot]   = xmalloc(size);
+            uint64_t t1   = bench_now_ns();
+
+            alloc_ns[n_alloc++] = t1 - t0;
+            if (slots[slot] == NULL)
+                failed++;
+            else
+                memset(slots[slot], (int)i, size);
+        }
+        else if (slots[slot] != NULL)
+        {
+            uint64_t t0 = bench_now_ns();
+            xfree(slots[slot]);
+            uint64_t t1 = bench_now_ns();
+
+            free_ns[n_free++] = t1 - t0;
+            slots[slot]       = NULL;
+        }
+    }
+
+    /* 满载状态下统计查询的耗时: 连续查询命中缓存 */
+    xmem_stats_t stats;
+    uint64_t t0 = bench_now_ns();
+    for (uint32_t i = 0; i < 1000; i++)
+        xmem_get_stats(&stats);
+    uint64_t stats_ns = (bench_now_ns() - t0) / 1000;
+
+    /*
+     * 每次查询前先分配再释放一块, 只计查询本身. 小块通常不会切分最大空闲段;
+     * 按最大空闲块大小分配则必然切分, 使分块映射表后端重扫整张映射表
+     */
+    uint64_t small_ns = 0, split_ns = 0;
+    for (uint32_t i = 0; i < 1000; i++)
+    {
+        xfree(xmalloc(1));
+        uint64_t t1 = bench_now_ns();
+        xmem_get_stats(&stats);
+        small_ns += bench_now_ns() - t1;
+
+        xfree(xmalloc(stats.largest_free));
+        t1 = bench_now_ns();
+        xmem_get_stats(&stats);
+        split_ns += bench_now_ns() - t1;
+    }
+    small_ns /= 1000;
+    split_ns /= 1000;
+
+    char name[48];
+    printf("[%s] %s: failed=%u free=%lu largest=%lu frag=%d.%d%% "
+           "xmem_get_stats=%lluns\n",
+           BENCH_NAME, phase, failed, (unsigned long)stats.free_size,
+           (unsigned long)stats.largest_free, stats.frag / 10, stats.frag % 10,
+           (unsigned long long)stats_ns);
+    printf("  xmem_get_stats after small alloc=%lluns, after largest split="
+           "%lluns\n",
+           (unsigned long long)small_ns, (unsigned long long)split_ns);
+    snprintf(name, sizeof(name), "  xmalloc");
+    bench_print_percentile(name, alloc_ns, n_alloc);
+    snprintf(name, sizeof(name), "  xfree");
+    bench_print_percentile(name, free_ns, n_free);
+
+    for (uint32_t i = 0; i < BENCH_SLOTS; i++)
+    {
+        xfree(slots[i]);
+        slots[i] = NULL;
+    }
+}
+
+int main(void)
+{
+    printf("heap=%u bytes, slots=%u, ops=%u\n", (unsigned)XMALLOC_MAX_SIZE,
+           (unsigned)BENCH_SLOTS, (unsigned)BENCH_OPS);
+
+    _bench_run("light", 0x12345678, 30);
+    _bench_run("heavy", 0x9E3779B9, 70);
+
+    return 0;
+}
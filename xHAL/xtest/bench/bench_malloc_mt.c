@@ -0,0 +1,97 @@
+/*
+ * xmalloc 多线程压力基准
+ *
+ * 同一份源码分别以 XMALLOC_THREAD_CACHE=0/1 编译. 1~8 个线程各自对私有
+ * 槽位做随机小块分配/释放, 统计总吞吐与每次操作的加锁次数. 加锁次数
+ * 反映堆锁上的竞争, 与主机核数无关.
+ */
+#include "../../xcore/xhal_malloc.h"
+#include "bench_common.h"
+#include <pthread.h>
+
+#define BENCH_THREADS_MAX (8)
+#define BENCH_SLOTS       (16)
+#define BENCH_OPS         (400000)
+
+#if XMALLOC_THREAD_CACHE
+#define BENCH_NAME "cache"
+#else
+#define BENCH_NAME "lock"
+#endif
+
+static pthread_mutex_t heap_mutex = PTHREAD_MUTEX_INITIALIZER;
+static uint64_t heap_locks        = 0; /* 在锁内累加 */
+
+__thread void *bench_heap_cache = NULL;
+
+void bench_heap_lock(void)
+{
+    pthread_mutex_lock(&heap_mutex);
+    heap_locks++;
+}
+
+void bench_heap_unlock(void)
+{
+    pthread_mutex_unlock(&heap_mutex);
+}
+
+static void *_bench_worker(void *arg)
+{
+    uint32_t seed = (uint32_t)(uintptr_t)arg * 2654435761U + 1;
+    void *slots[BENCH_SLOTS] = {0};
+
+    for (uint32_t i = 0; i < BENCH_OPS; i++)
+    {
+        uint32_t r = bench_rand(&seed);
+        uint32_t k = r % BENCH_SLOTS;
+
+        if (slots[k] != NULL)
+        {
+            xfree(slots[k]);
+            slots[k] = NULL;
+        }
+        else
+        {
+            /* 以小块为主, 覆盖全部缓存大小类 */
+            slots[k] = xmalloc(8 + (r >> 8) % 56);
+            if (slots[k] != NULL)
+                *(volatile uint8_t *)slots[k] = (uint8_t)r;
+        }
+    }
+
+    for (uint32_t k = 0; k < BENCH_SLOTS; k++)
+        xfree(slots[k]);
+#if XMALLOC_THREAD_CACHE
+    xmem_cache_flush();
+#endif
+
+    return NULL;
+}
+
+int main(void)
+{
+    pthread_t tid[BENCH_THREADS_MAX];
+    xmem_stats_t stats;
+
+    printf("[%s]\n", BENCH_NAME);
+    for (uint32_t n = 1; n <= BENCH_THREADS_MAX; n *= 2)
+    {
+        heap_locks  = 0;
+        uint64_t t0 = bench_now_ns();
+        for (uint32_t i = 0; i < n; i++)
+            pthread_create(&tid[i], NULL, _bench_worker,
+                           (void *)(uintptr_t)(i + 1));
+        for (uint32_t i = 0; i < n; i++)
+            pthread_join(tid[i], NULL);
+        uint64_t t1 = bench_now_ns();
+
+        uint64_t ops = (uint64_t)n * BENCH_OPS;
+        xmem_get_stats(&stats);
+        printf("threads=%u  %8.2f Mops/s  locks/op=%.3f  leaked=%lu\n", n,
+               (double)ops * 1000.0 / (double)(t1 - t0),
+               (double)heap_locks / (double)ops,
+               (unsigned long)stats.used_blocks);
+    }
+
+    return 0;
+}
@@ -0,0 +1,219 @@
+/*
+ * xmpsc 多生产者/单消费者竞争基准
+ *
+ * N 个生产者线程各自写入带编号与序号的变长记录, 一个消费者线程读出字节流,
+ * 按记录拆分后校验: 每条记录完整、未与其他写者交错, 且同一写者的序号连续.
+ * 对照组为 xrbuf 默认模式, 每次写入/读取持互斥锁(即现有日志、串口的用法).
+ */
+#include "../../xlib/xhal_mpscbuf.h"
+#include "bench_common.h"
+#include <pthread.h>
+#include <sched.h>
+
+#define BENCH_RECORDS    (1UL << 21) /* 每轮记录总数 */
+#define BENCH_WRITER_MAX (8)
+#define BENCH_HDR_SIZE   (6)         /* 编号(1) + 长度(1) + 序号(4) */
+#define BENCH_REC_MAX    (BENCH_HDR_SIZE + 58)
+#define BENCH_RING_SIZE  (4096)
+
+typedef struct bench_ctx
+{
+    xmpsc_t mpsc;
+    xrbuf_t rb;
+    uint8_t locked;  /* 对照组: xrbuf + mutex */
+    uint32_t writers;
+    uint32_t per_writer;
+    uint64_t errors; /* 校验失败记录数 */
+    uint64_t full;   /* 因空间不足重试的次数 */
+} bench_ctx_t;
+
+typedef struct bench_writer
+{
+    bench_ctx_t *ctx;
+    uint8_t id;
+} bench_writer_t;
+
+static pthread_mutex_t rb_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static inline uint8_t _bench_byte(uint8_t id, uint32_t seq, uint32_t i)
+{
+    return (uint8_t)(id * 31U + seq * 7U + i);
+}
+
+static uint32_t _bench_encode(uint8_t *rec, uint8_t id, uint32_t seq,
+                              uint32_t *seed)
+{
+    uint32_t len = BENCH_HDR_SIZE + bench_rand(seed) % (BENCH_REC_MAX -
+                                                        BENCH_HDR_SIZE + 1);
+
+    rec[0] = id;
+    rec[1] = (uint8_t)len;
+    memcpy(&rec[2], &seq, sizeof(seq));
+    for (uint32_t i = BENCH_HDR_SIZE; i < len; i++)
+        rec[i] = _bench_byte(id, seq, i);
+
+    return len;
+}
+
+static uint32_t _bench_put(bench_ctx_t *ctx, const uint8_t *rec, uint32_t len)
+{
+    if (!ctx->locked)
+        return xmpsc_write(&ctx->mpsc, rec, len);
+
+    uint32_t n = 0;
+    pthread_mutex_lock(&rb_mutex);
+    if (xrbuf_get_free(&ctx->rb) >= len)
+        n = xrbuf_write(&ctx->rb, rec, len);
+    pthread_mutex_unlock(&rb_mutex);
+
+    return n;
+}
+
+static uint32_t _bench_get(bench_ctx_t *ctx, uint8_t *buf, uint32_t len)
+{
+    if (!ctx->locked)
+        return xmpsc_read(&ctx->mpsc, buf, len);
+
+    pthread_mutex_lock(&rb_mutex);
+    uint32_t n = xrbuf_read(&ctx->rb, buf, len);
+    pthread_mutex_unlock(&rb_mutex);
+
+    return n;
+}
+
+static void *_bench_producer(void *arg)
+{
+    bench_writer_t *w = arg;
+    bench_ctx_t *ctx  = w->ctx;
+    uint32_t seed     = 0x12345678U + w->id;
+    uint8_t rec[BENCH_REC_MAX];
+
+    for (uint32_t seq = 0; seq < ctx->per_writer; seq++)
+    {
+        uint32_t len = _bench_encode(rec, w->id, seq, &seed);
+        while (_bench_put(ctx, rec, len) == 0)
+        {
+            __atomic_fetch_add(&ctx->full, 1, __ATOMIC_RELAXED);
+            sched_yield();
+        }
+    }
+
+    return NULL;
+}
+
+static void *_bench_consumer(void *arg)
+{
+    bench_ctx_t *ctx = arg;
+    uint32_t next_seq[BENCH_WRITER_MAX] = {0};
+    uint8_t buf[BENCH_RING_SIZE + BENCH_REC_MAX];
+    uint32_t fill = 0;
+    uint64_t left = (uint64_t)ctx->writers * ctx->per_writer;
+
+    while (left > 0)
+    {
+        uint32_t n = _bench_get(ctx, buf + fill, BENCH_RING_SIZE);
+        if (n == 0)
+        {
+            sched_yield();
+            continue;
+        }
+        fill += n;
+
+        /* 拆出完整记录 */
+        uint32_t off = 0;
+        while (fill - off >= BENCH_HDR_SIZE && fill - off >= buf[off + 1])
+        {
+            uint8_t *rec = &buf[off];
+            uint8_t id   = rec[0];
+            uint32_t len = rec[1];
+            uint32_t seq;
+
+            if (id >= ctx->writers || len < BENCH_HDR_SIZE)
+            {
+                /* 流已损坏, 无法再同步 */
+                ctx->errors += left;
+                return NULL;
+            }
+
+            memcpy(&seq, &rec[2], sizeof(seq));
+            uint8_t bad = (seq != next_seq[id]);
+            for (uint32_t i = BENCH_HDR_SIZE; i < len; i++)
+                bad |= (rec[i] != _bench_byte(id, seq, i));
+
+            ctx->errors += bad;
+            next_seq[id] = seq + 1;
+            off += len;
+            left--;
+        }
+
+        memmove(buf, buf + off, fill - off);
+        fill -= off;
+    }
+
+    return NULL;
+}
+
+static int _bench_run(uint32_t writers, uint8_t locked)
+{
+    static uint8_t mem[BENCH_RING_SIZE];
+    static bench_ctx_t ctx;
+    bench_writer_t w[BENCH_WRITER_MAX];
+    pthread_t prod[BENCH_WRITER_MAX], cons;
+
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.locked     = locked;
+    ctx.writers    = writers;
+    ctx.per_writer = BENCH_RECORDS / writers;
+    if (locked)
+        xrbuf_init(&ctx.rb, mem, sizeof(mem));
+    else
+        xmpsc_init(&ctx.mpsc, mem, sizeof(mem));
+
+    uint64_t t0 = bench_now_ns();
+    pthread_create(&cons, NULL, _bench_consumer, &ctx);
+    for (uint32_t i = 0; i < writers; i++)
+    {
+        w[i].ctx = &ctx;
+        w[i].id  = (uint8_t)i;
+        pthread_create(&prod[i], NULL, _bench_producer, &w[i]);
+    }
+    for (uint32_t i = 0; i < writers; i++)
+        pthread_join(prod[i], NULL);
+    pthread_join(cons, NULL);
+    uint64_t t1 = bench_now_ns();
+
+    double ns = (double)(t1 - t0) / (double)(ctx.per_writer * writers);
+    printf("%-6s writers=%u %7.1f ns/rec", locked ? "mutex" : "mpsc",
+           writers, ns);
+    if (!locked)
+    {
+        xmpsc_stats_t st;
+        xmpsc_get_stats(&ctx.mpsc, &st);
+        printf("  cas_retry=%-8u", st.retry_count);
+    }
+    else
+    {
+        printf("  %-19s", "");
+    }
+    printf(" full=%-8llu errors=%llu\n", (unsigned long long)ctx.full,
+           (unsigned long long)ctx.errors);
+
+    return ctx.errors == 0 ? 0 : -1;
+}
+
+int main(void)
+{
+    static const uint32_t writers[] = {1, 2, 4, 8};
+    int ret = 0;
+
+    for (uint32_t i = 0; i < sizeof(writers) / sizeof(writers[0]); i++)
+    {
+        ret |= _bench_run(writers[i], 0);
+        ret |= _bench_run(writers[i], 1);
+    }
+
+    if (ret != 0)
+        printf("FAILED\n");
+
+    return ret != 0;
+}
@@ -0,0 +1,19 @@
+#ifndef __BENCH_MT_PORT_H
+#define __BENCH_MT_PORT_H
+
+/*
+ * 多线程基准的堆锁与线程本地存储移植, 通过 -include 注入到 xhal_malloc.c:
+ * 以 pthread 互斥锁代替 OS 互斥锁, 以 __thread 变量代替 FreeRTOS 线程本地
+ * 存储指针.
+ */
+void bench_heap_lock(void);
+void bench_heap_unlock(void);
+
+extern __thread void *bench_heap_cache;
+
+#define XMALLOC_ENTER_CRITICAL()  bench_heap_lock()
+#define XMALLOC_EXIT_CRITICAL()   bench_heap_unlock()
+#define XMALLOC_CACHE_GET()       bench_heap_cache
+#define XMALLOC_CACHE_SET(cache)  (bench_heap_cache = (cache))
+
+#endif /* __BENCH_MT_PORT_H */
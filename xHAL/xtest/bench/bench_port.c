@@ -0,0 +1,76 @@
+/*
+ * 主机端移植层: 为基准测试提供时间与中断相关的桩函数
+ */
+#include "../../xcore/xhal_time.h"
+#include <stdio.h>
+#include <time.h>
+
+void __disable_irq(void);
+
+static uint64_t _bench_now_ms(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000U + (uint64_t)ts.tv_nsec / 1000000U;
+}
+
+void __disable_irq(void)
+{
+}
+
+#ifdef BENCH_VIRTUAL_TICK
+/* 由基准自行推进的虚拟时钟, 可从回绕前任意值开始 */
+xhal_tick_t bench_tick;
+
+xhal_tick_t xtime_get_tick_ms(void)
+{
+    return bench_tick;
+}
+#else
+xhal_tick_t xtime_get_tick_ms(void)
+{
+    return (xhal_tick_t)_bench_now_ms();
+}
+#endif
+
+xhal_uptime_t xtime_get_uptime_ms(void)
+{
+    return (xhal_uptime_t)_bench_now_ms();
+}
+
+void xtime_delay_us(uint32_t delay_us)
+{
+    struct timespec ts = {
+        .tv_sec  = delay_us / 1000000U,
+        .tv_nsec = (long)(delay_us % 1000000U) * 1000L,
+    };
+    nanosleep(&ts, NULL);
+}
+
+void xtime_delay_ms(uint32_t delay_ms)
+{
+    xtime_delay_us(delay_ms * 1000U);
+}
+
+void xtime_delay_s(uint32_t delay_s)
+{
+    xtime_delay_ms(delay_s * 1000U);
+}
+
+xhal_ts_t xtime_get_ts(void)
+{
+    return (xhal_ts_t)time(NULL);
+}
+
+xhal_err_t xtime_get_format_uptime(char *time_str, uint32_t buff_len)
+{
+    snprintf(time_str, buff_len, "%lu", (unsigned long)_bench_now_ms());
+    return XHAL_OK;
+}
+
+xhal_err_t xtime_get_format_time(char *time_str, uint32_t buff_len)
+{
+    snprintf(time_str, buff_len, "%lu", (unsigned long)time(NULL));
+    return XHAL_OK;
+}
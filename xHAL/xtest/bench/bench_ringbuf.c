@@ -0,0 +1,383 @@
+/*
+ * xrbuf 单生产者/单消费者压力与吞吐基准
+ *
+ * 生产者线程按随机长度写入一段可校验的字节流, 消费者线程读出并逐字节
+ * 校验. SPSC 模式的两端均不加锁; 对照组为默认模式, 每次操作持互斥锁.
+ * 另以 linear_block + advance/skip 模拟 DMA 收发路径, 以 reserve/commit
+ * 与 peek_seg/release 覆盖跨越缓冲区末尾的两段原地访问. 同一份源码分别
+ * 以 C11 原子与 XRBUF_DISABLE_ATOMIC(仅编译器屏障) 编译.
+ * 单线程部分对比同一容量下通用取模路径与 XRBUF_MODE_POW2 掩码路径的吞吐.
+ * 查找部分模拟按行协议轮询结束符: 每收到一小段数据查找一次, 对比逐字节
+ * 全量扫描、xrbuf_find 全量扫描与 xrbuf_find_next 增量扫描.
+ */
+#include "../../xlib/xhal_ringbuf.h"
+#include "bench_common.h"
+#include <pthread.h>
+#include <sched.h>
+
+#define BENCH_BYTES     (32UL * 1024 * 1024)
+#define BENCH_CHUNK_MAX (96)
+#define BENCH_ST_BYTES  (64UL * 1024 * 1024)
+
+#ifdef XRBUF_DISABLE_ATOMIC
+#define BENCH_NAME "barrier"
+#else
+#define BENCH_NAME "c11"
+#endif
+
+enum bench_path
+{
+    BENCH_PATH_COPY = 0, /* write/read 拷贝 */
+    BENCH_PATH_LINEAR,   /* linear_block + advance/skip */
+    BENCH_PATH_SEG,      /* reserve/commit + peek_seg/release */
+};
+
+typedef struct bench_ctx
+{
+    xrbuf_t rb;
+    uint8_t locked;  /* 每次操作持 mutex */
+    uint8_t path;    /* enum bench_path */
+    uint64_t errors; /* 校验失败字节数 */
+} bench_ctx_t;
+
+static pthread_mutex_t rb_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/* 流中第 pos 个字节的期望值 */
+static inline uint8_t _bench_byte(uint32_t pos)
+{
+    return (uint8_t)(pos ^ (pos >> 8) ^ (pos >> 16) ^ 0x5A);
+}
+
+static uint32_t _bench_put(bench_ctx_t *ctx, uint32_t pos, uint32_t len)
+{
+    uint8_t chunk[BENCH_CHUNK_MAX];
+    uint32_t n = 0;
+
+    if (ctx->locked)
+        pthread_mutex_lock(&rb_mutex);
+
+    if (ctx->path == BENCH_PATH_LINEAR)
+    {
+        /* 如 DMA 接收: 直接写入线性块后推进写指针 */
+        uint8_t *dst = xrbuf_get_linear_block_write_address(&ctx->rb);
+        n = xrbuf_get_linear_block_write_length(&ctx->rb);
+        n = n < len ? n : len;
+        for (uint32_t i = 0; i < n; i++)
+            dst[i] = _bench_byte(pos + i);
+        xrbuf_advance(&ctx->rb, n);
+    }
+    else if (ctx->path == BENCH_PATH_SEG)
+    {
+        xrbuf_seg_t seg;
+        n = xrbuf_reserve(&ctx->rb, len, &seg);
+        for (uint32_t i = 0; i < seg.len[0]; i++)
+            seg.ptr[0][i] = _bench_byte(pos + i);
+        for (uint32_t i = 0; i < seg.len[1]; i++)
+            seg.ptr[1][i] = _bench_byte(pos + seg.len[0] + i);
+        xrbuf_commit(&ctx->rb, n);
+    }
+    else
+    {
+        for (uint32_t i = 0; i < len; i++)
+            chunk[i] = _bench_byte(pos + i);
+        n = xrbuf_write(&ctx->rb, chunk, len);
+    }
+
+    if (ctx->locked)
+        pthread_mutex_unlock(&rb_mutex);
+
+    return n;
+}
+
+static void _bench_check(bench_ctx_t *ctx, const uint8_t *src, uint32_t pos,
+                         uint32_t len)
+{
+    for (uint32_t i = 0; i < len; i++)
+    {
+        if (src[i] != _bench_byte(pos + i))
+            ctx->errors++;
+    }
+}
+
+static uint32_t _bench_get(bench_ctx_t *ctx, uint32_t pos, uint32_t len)
+{
+    uint8_t chunk[BENCH_CHUNK_MAX];
+    uint32_t n = 0;
+
+    if (ctx->locked)
+        pthread_mutex_lock(&rb_mutex);
+
+    if (ctx->path == BENCH_PATH_LINEAR)
+    {
+        /* 如 DMA 发送: 直接读取线性块后跳过 */
+        n = xrbuf_get_linear_block_read_length(&ctx->rb);
+        n = n < len ? n : len;
+        _bench_check(ctx, xrbuf_get_linear_block_read_address(&ctx->rb), pos,
+                     n);
+        xrbuf_skip(&ctx->rb, n);
+    }
+    else if (ctx->path == BENCH_PATH_SEG)
+    {
+        xrbuf_seg_t seg;
+        n = xrbuf_peek_seg(&ctx->rb, len, &seg);
+        _bench_check(ctx, seg.ptr[0], pos, seg.len[0]);
+        _bench_check(ctx, seg.ptr[1], pos + seg.len[0], seg.len[1]);
+        xrbuf_release(&ctx->rb, n);
+    }
+    else
+    {
+        n = xrbuf_read(&ctx->rb, chunk, len);
+        _bench_check(ctx, chunk, pos, n);
+    }
+
+    if (ctx->locked)
+        pthread_mutex_unlock(&rb_mutex);
+
+    return n;
+}
+
+static void *_bench_producer(void *arg)
+{
+    bench_ctx_t *ctx = arg;
+    uint32_t seed    = 0x12345678;
+    uint32_t pos     = 0;
+
+    while (pos < BENCH_BYTES)
+    {
+        uint32_t len = 1 + bench_rand(&seed) % BENCH_CHUNK_MAX;
+        if (len > BENCH_BYTES - pos)
+            len = BENCH_BYTES - pos;
+
+        uint32_t n = _bench_put(ctx, pos, len);
+        if (n == 0)
+            sched_yield();
+        pos += n;
+    }
+
+    return NULL;
+}
+
+static void *_bench_consumer(void *arg)
+{
+    bench_ctx_t *ctx = arg;
+    uint32_t seed    = 0x9E3779B9;
+    uint32_t pos     = 0;
+
+    while (pos < BENCH_BYTES)
+    {
+        uint32_t len = 1 + bench_rand(&seed) % BENCH_CHUNK_MAX;
+
+        uint32_t n = _bench_get(ctx, pos, len);
+        if (n == 0)
+            sched_yield();
+        pos += n;
+    }
+
+    return NULL;
+}
+
+static int _bench_run(const char *name, uint32_t size, uint8_t mode,
+                      uint8_t locked, uint8_t path)
+{
+    static bench_ctx_t ctx;
+    pthread_t prod, cons;
+
+    uint8_t *mem = malloc(size);
+    if (mem == NULL)
+        return -1;
+
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.locked = locked;
+    ctx.path   = path;
+    xrbuf_init_ex(&ctx.rb, mem, size, mode);
+
+    uint64_t t0 = bench_now_ns();
+    pthread_create(&cons, NULL, _bench_consumer, &ctx);
+    pthread_create(&prod, NULL, _bench_producer, &ctx);
+    pthread_join(prod, NULL);
+    pthread_join(cons, NULL);
+    uint64_t t1 = bench_now_ns();
+
+    printf("%-14s size=%-5u %8.1f MB/s  errors=%llu  left=%u\n", name, size,
+           (double)BENCH_BYTES * 1000.0 / (double)(t1 - t0),
+           (unsigned long long)ctx.errors, xrbuf_get_full(&ctx.rb));
+
+    free(mem);
+    return ctx.errors == 0 && xrbuf_get_full(&ctx.rb) == 0 ? 0 : -1;
+}
+
+/* 单线程: 交替写入/读出固定长度块, 统计每字节耗时 */
+static int _bench_single(uint32_t size, uint8_t mode, uint32_t chunk)
+{
+    uint8_t in[BENCH_CHUNK_MAX], out[BENCH_CHUNK_MAX];
+    uint32_t cap    = (mode & XRBUF_MODE_POW2) ? size : size - 1;
+    uint64_t errors = 0;
+    xrbuf_t rb;
+
+    uint8_t *mem = malloc(size);
+    if (mem == NULL || !xrbuf_init_ex(&rb, mem, size, mode))
+    {
+        free(mem);
+        return -1;
+    }
+
+    for (uint32_t i = 0; i < chunk; i++)
+        in[i] = _bench_byte(i);
+
+    /* 预先填入约一半, 使读写指针错开并频繁跨越末尾 */
+    for (uint32_t i = 0; i < size / 2 / chunk; i++)
+        xrbuf_write(&rb, in, chunk);
+
+    uint64_t t0 = bench_now_ns();
+    for (uint32_t pos = 0; pos < BENCH_ST_BYTES; pos += chunk)
+    {
+        errors += xrbuf_write(&rb, in, chunk) != chunk;
+        errors += xrbuf_read(&rb, out, chunk) != chunk;
+        errors += out[0] != in[0];
+        errors += xrbuf_get_free(&rb) + xrbuf_get_full(&rb) != cap;
+    }
+    uint64_t t1 = bench_now_ns();
+
+    printf("%-14s size=%-5u chunk=%-3u %6.2f ns/B  errors=%llu\n",
+           (mode & XRBUF_MODE_POW2) ? "single pow2" : "single generic", size,
+           chunk, (double)(t1 - t0) / (double)BENCH_ST_BYTES,
+           (unsigned long long)errors);
+
+    free(mem);
+    return errors == 0 ? 0 : -1;
+}
+
+/* 原逐字节查找, 作为对照与校验基准 */
+static uint8_t _bench_find_ref(const xrbuf_t *rb, const uint8_t *needle,
+                               uint32_t len, uint32_t *idx)
+{
+    uint32_t full = xrbuf_get_full(rb);
+    uint32_t r    = rb->r_ptr;
+
+    for (uint32_t x = 0; x + len <= full; x++)
+    {
+        uint32_t i = 0;
+        while (i < len && rb->buff[(r + x + i) % rb->size] == needle[i])
+            i++;
+        if (i == len)
+        {
+            *idx = x;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+enum bench_find
+{
+    BENCH_FIND_REF = 0, /* 逐字节, 每次从头扫描 */
+    BENCH_FIND_FULL,    /* xrbuf_find, 每次从头扫描 */
+    BENCH_FIND_NEXT,    /* xrbuf_find_next, 从上次位置继续 */
+};
+
+/* 以 step 字节为单位写入一行 line_len 字节的文本(末尾为 needle), 每次写入后查找 */
+static int _bench_find(const char *needle, uint32_t line_len, uint32_t step,
+                       uint8_t method)
+{
+    static const char *names[] = {"ref", "find", "find_next"};
+    static uint8_t mem[16384];
+    uint8_t line[8192];
+    uint32_t len = (uint32_t)strlen(needle), lines = 0, errors = 0;
+    uint32_t seed = 0xC0FFEE;
+    xrbuf_t rb;
+
+    xrbuf_init(&rb, mem, sizeof(mem));
+    for (uint32_t i = 0; i < line_len - len; i++)
+    {
+        /* 只含与 needle 首字节不同的字符, 结束符前不会提前命中 */
+        line[i] = (uint8_t)('a' + bench_rand(&seed) % 26);
+        if (line[i] == (uint8_t)needle[0])
+            line[i] = '_';
+    }
+    memcpy(&line[line_len - len], needle, len);
+
+    uint64_t t0 = bench_now_ns();
+    for (uint32_t pass = 0; pass < 64; pass++)
+    {
+        uint32_t pos = 0, cursor = 0, idx = 0;
+        uint8_t found = 0;
+
+        while (!found && pos < line_len)
+        {
+            uint32_t n = step < line_len - pos ? step : line_len - pos;
+            xrbuf_write(&rb, &line[pos], n);
+            pos += n;
+
+            if (method == BENCH_FIND_REF)
+                found = _bench_find_ref(&rb, (const uint8_t *)needle, len,
+                                        &idx);
+            else if (method == BENCH_FIND_FULL)
+                found = xrbuf_find(&rb, needle, len, 0, &idx);
+            else
+                found = xrbuf_find_next(&rb, needle, len, &cursor, &idx);
+        }
+
+        errors += !found || pos != line_len || idx != line_len - len;
+        xrbuf_skip(&rb, line_len);
+        lines++;
+    }
+    uint64_t t1 = bench_now_ns();
+
+    printf("find %-9s needle=%-2u line=%-5u step=%-3u %9.1f us/line  "
+           "errors=%u\n",
+           names[method], len, line_len, step,
+           (double)(t1 - t0) / 1000.0 / lines, errors);
+
+    return errors == 0 ? 0 : -1;
+}
+
+int main(void)
+{
+    static const uint32_t sizes[] = {97, 1024, 16384};
+    int ret = 0;
+
+    printf("[%s]\n", BENCH_NAME);
+    for (uint32_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+    {
+        ret |= _bench_run("spsc copy", sizes[i], XRBUF_MODE_SPSC, 0,
+                          BENCH_PATH_COPY);
+        ret |= _bench_run("spsc linear", sizes[i], XRBUF_MODE_SPSC, 0,
+                          BENCH_PATH_LINEAR);
+        ret |= _bench_run("spsc segment", sizes[i], XRBUF_MODE_SPSC, 0,
+                          BENCH_PATH_SEG);
+        ret |= _bench_run("mutex copy", sizes[i], 0, 1, BENCH_PATH_COPY);
+        if ((sizes[i] & (sizes[i] - 1)) != 0)
+            continue;
+        ret |= _bench_run("pow2 copy", sizes[i],
+                          XRBUF_MODE_SPSC | XRBUF_MODE_POW2, 0,
+                          BENCH_PATH_COPY);
+        ret |= _bench_run("pow2 linear", sizes[i],
+                          XRBUF_MODE_SPSC | XRBUF_MODE_POW2, 0,
+                          BENCH_PATH_LINEAR);
+        ret |= _bench_run("pow2 segment", sizes[i],
+                          XRBUF_MODE_SPSC | XRBUF_MODE_POW2, 0,
+                          BENCH_PATH_SEG);
+    }
+
+    static const uint32_t chunks[] = {1, 7, 64};
+    for (uint32_t i = 0; i < sizeof(chunks) / sizeof(chunks[0]); i++)
+    {
+        ret |= _bench_single(1024, 0, chunks[i]);
+        ret |= _bench_single(1024, XRBUF_MODE_POW2, chunks[i]);
+    }
+
+    static const char *needles[] = {"\r\n", "--boundary"};
+    for (uint32_t i = 0; i < sizeof(needles) / sizeof(needles[0]); i++)
+    {
+        for (uint8_t m = BENCH_FIND_REF; m <= BENCH_FIND_NEXT; m++)
+        {
+            ret |= _bench_find(needles[i], 256, 16, m);
+            ret |= _bench_find(needles[i], 4096, 16, m);
+        }
+    }
+
+    if (ret != 0)
+        printf("FAILED\n");
+
+    return ret != 0;
+}
@@ -0,0 +1,205 @@
+#ifndef __BENCH_TABLE_H
+#define __BENCH_TABLE_H
+
+/*
+ * 开放寻址表查找/插入/删除混合负载基准的公共部分, 由 bench_htable.c 与
+ * bench_itable.c 包含.
+ *
+ * 以 2N 个候选键(其中约一半在表中)生成随机操作序列, 按比例混合查找、
+ * 插入与删除, 分别跑静态表(固定容量)、堆表(从最小容量开始扩容)与线性
+ * 数组. 三者执行同一序列, 逐次比对查找结果, 不一致即判失败.
+ *
+ * 包含前需定义:
+ *   BENCH_OPS, BENCH_KEYS_MAX   每种负载的操作数, 候选键上限
+ *   BENCH_KEY_T                 键类型
+ *   BENCH_KEY(k), BENCH_VALUE(k) 第 k 个候选键及其数据
+ *   BENCH_KEY_EQ(a, b)          线性数组的键比较
+ *   BENCH_SHOWN(n)              输出时第一列显示的数量
+ *   bench_table_t, bench_table_data_t, bench_table_stats_t
+ *   bench_table_new/destroy/init/add/get/remove/count/get_stats
+ */
+#include "bench_common.h"
+
+typedef struct bench_mix
+{
+    const char *name;
+    uint32_t get_pct; /* 查找占比, 其余插入与删除各半 */
+} bench_mix_t;
+
+typedef struct bench_list
+{
+    BENCH_KEY_T key[BENCH_KEYS_MAX];
+    void *data[BENCH_KEYS_MAX];
+    uint32_t count;
+} bench_list_t;
+
+enum
+{
+    OP_GET,
+    OP_ADD,
+    OP_DEL,
+};
+
+static uint8_t ops[BENCH_OPS];
+static uint16_t op_keys[BENCH_OPS];
+static void *results[3][BENCH_OPS];
+static bench_table_data_t static_slots[2 * BENCH_KEYS_MAX];
+static bench_list_t list;
+
+static void *_list_get(bench_list_t *l, BENCH_KEY_T key, uint32_t *at)
+{
+    for (uint32_t i = 0; i < l->count; i++)
+    {
+        if (BENCH_KEY_EQ(l->key[i], key))
+        {
+            *at = i;
+            return l->data[i];
+        }
+    }
+
+    return NULL;
+}
+
+static void _list_run(uint32_t n, void **out)
+{
+    uint32_t at = 0;
+
+    list.count = 0;
+    for (uint32_t i = 0; i < n; i += 2)
+    {
+        list.key[list.count]  = BENCH_KEY(i);
+        list.data[list.count] = BENCH_VALUE(i);
+        list.count++;
+    }
+
+    for (uint32_t s = 0; s < BENCH_OPS; s++)
+    {
+        uint32_t k  = op_keys[s];
+        void *found = _list_get(&list, BENCH_KEY(k), &at);
+
+        if (ops[s] == OP_GET)
+        {
+            out[s] = found;
+        }
+        else if (ops[s] == OP_ADD && found == NULL)
+        {
+            list.key[list.count]  = BENCH_KEY(k);
+            list.data[list.count] = BENCH_VALUE(k);
+            list.count++;
+        }
+        else if (ops[s] == OP_DEL && found != NULL)
+        {
+            list.count--;
+            list.key[at]  = list.key[list.count];
+            list.data[at] = list.data[list.count];
+        }
+    }
+}
+
+static void _table_run(bench_table_t *t, uint32_t n, void **out)
+{
+    for (uint32_t i = 0; i < n; i += 2)
+        bench_table_add(t, BENCH_KEY(i), BENCH_VALUE(i));
+
+    for (uint32_t s = 0; s < BENCH_OPS; s++)
+    {
+        uint32_t k = op_keys[s];
+
+        if (ops[s] == OP_GET)
+            out[s] = bench_table_get(t, BENCH_KEY(k));
+        else if (ops[s] == OP_ADD)
+            bench_table_add(t, BENCH_KEY(k), BENCH_VALUE(k));
+        else
+            bench_table_remove(t, BENCH_KEY(k));
+    }
+}
+
+static uint64_t _bench_mix(uint32_t n, const bench_mix_t *mix)
+{
+    bench_table_t st, *heap = bench_table_new(0);
+    bench_table_stats_t stats;
+    uint32_t seed   = 0x9E3779B9U ^ n;
+    uint64_t errors = 0;
+    double ns[3];
+
+    for (uint32_t s = 0; s < BENCH_OPS; s++)
+    {
+        uint32_t r = bench_rand(&seed) % 100;
+
+        ops[s]     = r < mix->get_pct                          ? OP_GET
+                     : r < mix->get_pct + (100 - mix->get_pct) / 2 ? OP_ADD
+                                                               : OP_DEL;
+        op_keys[s] = (uint16_t)(bench_rand(&seed) % n);
+    }
+    memset(results, 0, sizeof(results));
+
+    /* 静态表按 2N 槽, 候选键全部在表中时负载 50% */
+    bench_table_init(&st, static_slots, 2 * n);
+
+    uint64_t t0 = bench_now_ns();
+    _table_run(&st, n, results[0]);
+    uint64_t t1 = bench_now_ns();
+    _table_run(heap, n, results[1]);
+    uint64_t t2 = bench_now_ns();
+    _list_run(n, results[2]);
+    uint64_t t3 = bench_now_ns();
+
+    ns[0] = (double)(t1 - t0) / BENCH_OPS;
+    ns[1] = (double)(t2 - t1) / BENCH_OPS;
+    ns[2] = (double)(t3 - t2) / BENCH_OPS;
+
+    for (uint32_t s = 0; s < BENCH_OPS; s++)
+    {
+        errors += (results[0][s] != results[2][s]);
+        errors += (results[1][s] != results[2][s]);
+    }
+    errors += (bench_table_count(&st) != list.count);
+    errors += (bench_table_count(heap) != list.count);
+
+    bench_table_get_stats(heap, &stats);
+    printf("%-6u %-8s %10.1f %10.1f %10.1f  cap=%-5u tomb=%-4u "
+           "probe_avg=%.2f max=%-3u rehash=%u\n",
+           BENCH_SHOWN(n), mix->name, ns[0], ns[1], ns[2], stats.capacity,
+           stats.tombstones,
+           stats.count ? (double)stats.probe_total / stats.count : 0.0,
+           stats.probe_max, stats.rehashes);
+
+    bench_table_destroy(heap);
+
+    return errors;
+}
+
+/**
+ * @brief  按各规模跑读多、混合、高频增删三种负载
+ * @param  sizes   候选键数 2N 的列表
+ * @param  count   列表长度
+ * @param  unit    第一列标题
+ * @param  linear  线性数组一列的标题
+ * @retval 不一致的次数为 0 时返回 0
+ */
+static int bench_table_main(const uint32_t *sizes, uint32_t count,
+                            const char *unit, const char *linear)
+{
+    static const bench_mix_t mixes[] = {
+        {"read", 90},
+        {"mixed", 50},
+        {"churn", 10},
+    };
+    uint64_t errors = 0;
+
+    printf("%-6s %-8s %10s %10s %10s  (ns/op, heap table stats)\n", unit,
+           "mix", "static", "heap", linear);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        for (uint32_t m = 0; m < sizeof(mixes) / sizeof(mixes[0]); m++)
+            errors += _bench_mix(sizes[i], &mixes[m]);
+    }
+
+    printf("errors=%llu\n", (unsigned long long)errors);
+    if (errors != 0)
+        printf("FAILED\n");
+
+    return errors != 0;
+}
+
+#endif /* __BENCH_TABLE_H */
@@ -0,0 +1,335 @@
+/*
+ * xtwheel 分层时间轮与有序链表的协程延时负载对比
+ *
+ * 对照组为按到期时间有序插入的单链表, 即改造前 sleep_list 的做法.
+ * N 个定时器以 1~BENCH_DELAY_MAX 的随机延时循环重挂, 每个 tick 另有
+ * BENCH_CANCEL 个随机定时器被取消后重挂(相当于事件先于超时到达).
+ * 每隔 jump 个 tick 推进一次(模拟 tickless 休眠), 时钟从回绕前开始.
+ * 两组使用相同随机序列, 检查每个定时器恰在到期后的第一次推进时取出,
+ * 并比对两组取出结果的摘要.
+ *
+ * 另以虚拟时钟运行 N 个协程: 一半循环 XCORO_DELAY_MS, 一半带超时
+ * XCORO_WAIT_EVENT, 由随机置位的事件提前唤醒, 检查唤醒时刻准确.
+ */
+#include "../../xcore/xhal_coro.h"
+#include "../../xcore/xhal_malloc.h"
+#include "bench_common.h"
+
+#define BENCH_TIMER_MAX (8192)
+#define BENCH_TICKS     (1UL << 15)  /* 每种规模推进的 tick 数 */
+#define BENCH_DELAY_MAX (20000)
+#define BENCH_CANCEL    (2)
+#define BENCH_TICK_BASE (0xFFFFFFFFU - 10000U) /* 运行中途回绕 */
+
+typedef struct bench_timer
+{
+    xtwheel_node_t node;
+    struct bench_timer *next; /* 对照组链表 */
+    uint32_t expire;
+    uint32_t id;
+    uint8_t active;
+} bench_timer_t;
+
+typedef struct bench_result
+{
+    uint64_t fired;
+    uint64_t digest; /* 与取出顺序无关的 (id, tick) 摘要 */
+    uint64_t errors;
+    double ns;       /* 每 tick 耗时 */
+} bench_result_t;
+
+typedef struct bench_coro
+{
+    xhal_tick_t due;
+    uint32_t delay;
+} bench_coro_t;
+
+extern xhal_tick_t bench_tick;
+
+static bench_timer_t timers[BENCH_TIMER_MAX];
+static bench_timer_t *pending[BENCH_TIMER_MAX]; /* 待重挂 */
+static uint32_t pending_count;
+static bench_timer_t *list_head;
+static xtwheel_t wheel;
+
+static xhal_tick_t run_now;
+static xhal_tick_t run_prev;
+static bench_result_t *run_result;
+
+static xcoro_manager_t mgr;
+static xcoro_event_t coro_event;
+static xcoro_handle_t handles[BENCH_TIMER_MAX];
+static bench_coro_t coros[BENCH_TIMER_MAX];
+static uint32_t coro_seed;
+static uint64_t coro_errors;
+static uint64_t coro_wakeups;
+static uint64_t coro_timeouts;
+
+static void _list_insert(bench_timer_t *t)
+{
+    bench_timer_t **pp = &list_head;
+
+    while (*pp && TIME_BEFOR_EQ((*pp)->expire, t->expire))
+        pp = &(*pp)->next;
+
+    t->next = *pp;
+    *pp     = t;
+}
+
+static void _list_remove(bench_timer_t *t)
+{
+    bench_timer_t **pp = &list_head;
+
+    while (*pp != t)
+        pp = &(*pp)->next;
+
+    *pp = t->next;
+}
+
+/* 取出时检查: 到期时刻落在 (上次推进, 本次推进] 内 */
+static void _on_fire(bench_timer_t *t)
+{
+    bench_result_t *r = run_result;
+
+    r->errors += !t->active;
+    r->errors += TIME_AFTER(t->expire, run_now);
+    r->errors += TIME_BEFOR_EQ(t->expire, run_prev);
+    r->fired++;
+    r->digest += (uint64_t)(t->id * 0x9E3779B9U) * (run_now | 1U);
+    t->active = 0;
+
+    pending[pending_count++] = t;
+}
+
+static void _wheel_expired(xtwheel_node_t *node, void *arg)
+{
+    XHAL_UNUSED(arg);
+
+    _on_fire(XTWHEEL_ENTRY(node, bench_timer_t, node));
+}
+
+/* 延时只取决于 (id, tick), 与两组各自的取出顺序无关 */
+static uint32_t _delay(uint32_t id, xhal_tick_t now)
+{
+    uint32_t x = id * 0x9E3779B9U ^ now * 0x85EBCA6BU;
+
+    x ^= x >> 15;
+    x *= 0x2C1B3C6DU;
+    x ^= x >> 12;
+
+    return 1U + x % BENCH_DELAY_MAX;
+}
+
+static void _arm(uint8_t use_wheel, bench_timer_t *t)
+{
+    t->expire = run_now + _delay(t->id, run_now);
+    t->active = 1;
+
+    if (use_wheel)
+        xtwheel_add(&wheel, &t->node, t->expire);
+    else
+        _list_insert(t);
+}
+
+static void _run(uint8_t use_wheel, uint32_t n, uint32_t jump,
+                 bench_result_t *r)
+{
+    uint32_t seed = 0x2545F491U;
+
+    xmemset(r, 0, sizeof(*r));
+    run_result    = r;
+    run_now       = BENCH_TICK_BASE;
+    run_prev      = run_now;
+    list_head     = NULL;
+    pending_count = 0;
+    xtwheel_init(&wheel, run_now);
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        timers[i].id = i;
+        xtwheel_node_init(&timers[i].node);
+        _arm(use_wheel, &timers[i]);
+    }
+
+    uint64_t t0 = bench_now_ns();
+    for (uint32_t tick = 0; tick < BENCH_TICKS; tick += jump)
+    {
+        run_prev = run_now;
+        run_now += jump;
+
+        if (use_wheel)
+        {
+            xtwheel_advance(&wheel, run_now, _wheel_expired, NULL);
+        }
+        else
+        {
+            while (list_head && !TIME_AFTER(list_head->expire, run_now))
+            {
+                bench_timer_t *t = list_head;
+                list_head        = t->next;
+                _on_fire(t);
+            }
+        }
+
+        /* 取消若干定时器, 连同到期者一起以新的延时重挂 */
+        for (uint32_t c = 0; c < BENCH_CANCEL; c++)
+        {
+            bench_timer_t *t = &timers[bench_rand(&seed) % n];
+            if (!t->active)
+                continue;
+
+            if (use_wheel)
+                xtwheel_remove(&wheel, &t->node);
+            else
+                _list_remove(t);
+            t->active = 0;
+
+            pending[pending_count++] = t;
+        }
+
+        while (pending_count > 0)
+            _arm(use_wheel, pending[--pending_count]);
+    }
+    uint64_t t1 = bench_now_ns();
+
+    if (use_wheel)
+        r->errors += (xtwheel_count(&wheel) != n);
+    r->ns = (double)(t1 - t0) / (BENCH_TICKS / jump);
+}
+
+static void _coro_sleeper(xcoro_handle_t *handle)
+{
+    bench_coro_t *c = XCORO_USER_DATA(handle, bench_coro_t);
+
+    XCORO_BEGIN(handle);
+    while (1)
+    {
+        c->delay = 1U + bench_rand(&coro_seed) % BENCH_DELAY_MAX;
+        c->due   = bench_tick + c->delay;
+        XCORO_DELAY_MS(handle, c->delay);
+
+        coro_errors += (bench_tick != c->due);
+        coro_wakeups++;
+    }
+    XCORO_END(handle);
+}
+
+static void _coro_waiter(xcoro_handle_t *handle)
+{
+    bench_coro_t *c = XCORO_USER_DATA(handle, bench_coro_t);
+    uint32_t bit    = 1U << ((uint32_t)(handle - handles) % 32U);
+
+    XCORO_BEGIN(handle);
+    while (1)
+    {
+        c->delay = 1U + bench_rand(&coro_seed) % BENCH_DELAY_MAX;
+        c->due   = bench_tick + c->delay;
+        XCORO_WAIT_EVENT(handle, &coro_event, bit, XCORO_FLAGS_WAIT_ANY,
+                         c->delay);
+
+        if (XCORO_WAIT_TIMEOUT(handle))
+        {
+            coro_errors += (bench_tick != c->due);
+            coro_timeouts++;
+        }
+        else
+        {
+            coro_errors += !XCORO_WAIT_EVENT_SET(handle, bit);
+            coro_errors += !TIME_BEFOR(bench_tick, c->due);
+        }
+        coro_wakeups++;
+    }
+    XCORO_END(handle);
+}
+
+static void _drain_ready(void)
+{
+    xcoro_handle_t *handle;
+
+    while ((handle = _get_next_ready(&mgr)) != NULL)
+        handle->entry(handle);
+}
+
+/* 返回每 tick 耗时 */
+static double _run_coro(uint32_t n)
+{
+    bench_tick    = BENCH_TICK_BASE;
+    coro_seed     = 0x68E31DA4U;
+    coro_errors   = 0;
+    coro_wakeups  = 0;
+    coro_timeouts = 0;
+
+    xcoro_manager_init(&mgr);
+    xcoro_event_init(&coro_event);
+    for (uint32_t i = 0; i < n; i++)
+    {
+        xmemset(&handles[i], 0, sizeof(handles[i]));
+        handles[i].entry = (i & 1U) ? _coro_waiter : _coro_sleeper;
+        handles[i].prio  = XCORO_PRIO_NORMAL;
+        XCORO_SET_USER_DATA(&handles[i], &coros[i]);
+        xcoro_register(&mgr, &handles[i]);
+    }
+    _drain_ready();
+
+    uint64_t t0 = bench_now_ns();
+    for (uint32_t tick = 0; tick < BENCH_TICKS; tick++)
+    {
+        bench_tick++;
+        _wake_expired_sleepers(&mgr);
+        _drain_ready();
+
+        xcoro_set_event(&coro_event, 1U << (bench_rand(&coro_seed) % 32U));
+        _drain_ready();
+    }
+    uint64_t t1 = bench_now_ns();
+
+    /* 全部协程都应挂在时间轮上 */
+    coro_errors += (xtwheel_count(&mgr.timer) != n);
+
+    return (double)(t1 - t0) / BENCH_TICKS;
+}
+
+int main(void)
+{
+    static const uint32_t sizes[] = {256, 1024, 4096, 8192};
+    static const uint32_t jumps[] = {1, 50};
+    uint64_t errors               = 0;
+
+    printf("%-6s %-5s %12s %12s %10s\n", "timers", "jump", "list", "wheel",
+           "fired");
+    for (uint32_t j = 0; j < sizeof(jumps) / sizeof(jumps[0]); j++)
+    {
+        for (uint32_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+        {
+            bench_result_t list;
+            bench_result_t twheel;
+
+            _run(0, sizes[i], jumps[j], &list);
+            _run(1, sizes[i], jumps[j], &twheel);
+            errors += list.errors + twheel.errors;
+            errors += (list.fired != twheel.fired);
+            errors += (list.digest != twheel.digest);
+
+            printf("%-6u %-5u %9.1f ns %9.1f ns %10llu\n", sizes[i], jumps[j],
+                   list.ns, twheel.ns, (unsigned long long)twheel.fired);
+        }
+    }
+
+    printf("%-6s %12s %10s %10s\n", "coros", "per_tick", "wakeups",
+           "timeouts");
+    for (uint32_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+    {
+        double ns = _run_coro(sizes[i]);
+
+        errors += coro_errors;
+        printf("%-6u %9.1f ns %10llu %10llu\n", sizes[i], ns,
+               (unsigned long long)coro_wakeups,
+               (unsigned long long)coro_timeouts);
+    }
+
+    printf("errors=%llu\n", (unsigned long long)errors);
+    if (errors != 0)
+        printf("FAILED\n");
+
+    return errors != 0;
+}
@@ -0,0 +1,36 @@
+#ifndef __XHAL_CONFIG_H
+#define __XHAL_CONFIG_H
+
+/* 主机端基准测试配置 */
+
+#define FIRMWARE_NAME            "xhal_bench"
+#define HARDWARE_VERSION         "host"
+#define SOFTWARE_VERSION         "1.0.0"
+
+#define XOS_TICK_RATE_HZ         (1000)
+
+#define XASSERT_ENABLE           (1)
+#define XASSERT_FULL_PATH_ENABLE (0)
+#define XASSERT_FUNC_ENABLE      (1)
+#define XASSERT_BACKTRACE_ENABLE (0)
+#define XASSERT_USER_HOOK_ENABLE (0)
+
+#ifndef XMALLOC_BLOCK_SIZE
+#define XMALLOC_BLOCK_SIZE (16)
+#endif
+#ifndef XMALLOC_MAX_SIZE
+#define XMALLOC_MAX_SIZE (32 * 1024)
+#endif
+
+/* 主机无中断屏蔽 */
+#define XOBJ_POOL_IRQ_DISABLE()        (0)
+#define XOBJ_POOL_IRQ_RESTORE(primask) ((void)(primask))
+
+#define XLOG_COLOR_ENABLE        (0)
+#define XLOG_NEWLINE_ENABLE      (1)
+#define XLOG_FILEINFO_ENABLE     (1)
+#define XLOG_DEFAULT_TIME_MODE   (XLOG_TIME_MOD_NONE)
+#define XLOG_DEFAULT_LEVEL       (XLOG_LEVEL_WARNING)
+#define XLOG_COMPILE_LEVEL       (XLOG_LEVEL_WARNING)
+
+#endif /* __XHAL_CONFIG_H */
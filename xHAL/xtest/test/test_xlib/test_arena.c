@@ -0,0 +1,185 @@
+#include "../../../xlib/xhal_arena.h"
+#include "../../../xcore/xhal_malloc.h"
+#include "../../xhal_test.h"
+
+#define ARENA_SIZE (64)
+
+/* 按指针对齐, 以便按偏移检查对齐填充 */
+static void *arena_storage[ARENA_SIZE / sizeof(void *)];
+static uint8_t *const arena_buff = (uint8_t *)arena_storage;
+static xarena_t arena;
+static uint32_t heap_free;
+
+TEST_GROUP(arena);
+
+TEST_SETUP(arena)
+{
+    heap_free = xmem_free_size();
+    TEST_ASSERT_EQUAL(XHAL_OK,
+                      xarena_init(&arena, "test", arena_buff, ARENA_SIZE));
+}
+
+TEST_TEAR_DOWN(arena)
+{
+    /* 每个用例结束时释放 scratch, 堆应回到用例开始时的状态 */
+    xarena_scratch_release();
+    TEST_ASSERT_EQUAL_UINT32(heap_free, xmem_free_size());
+}
+
+TEST(arena, InitRejectsZeroSize)
+{
+    xarena_t bad;
+
+    TEST_ASSERT_EQUAL(XHAL_ERR_INVALID,
+                      xarena_init(&bad, "bad", arena_buff, 0));
+    TEST_ASSERT_NULL(xarena_new("bad", 0));
+}
+
+TEST(arena, AllocAlignsAndTracksUsage)
+{
+    uint8_t *a = xarena_alloc(&arena, 3);
+    uint8_t *b = xarena_alloc(&arena, 5);
+
+    TEST_ASSERT_TRUE(a == arena_buff);
+    TEST_ASSERT_EQUAL_UINT32(0, (xhal_pointer_t)b % XARENA_ALIGN);
+    TEST_ASSERT_EQUAL_UINT32(XARENA_ALIGN, (uint32_t)(b - a));
+    TEST_ASSERT_EQUAL_UINT32(XARENA_ALIGN + 5, xarena_mark(&arena));
+    TEST_ASSERT_EQUAL_UINT32(ARENA_SIZE - XARENA_ALIGN - 5,
+                             xarena_free_size(&arena));
+
+    uint8_t *c = xarena_alloc_aligned(&arena, 1, 32);
+    TEST_ASSERT_TRUE(c != NULL);
+    TEST_ASSERT_EQUAL_UINT32(0, (xhal_pointer_t)c % 32);
+    TEST_ASSERT_TRUE(xarena_contains(&arena, c));
+    TEST_ASSERT_FALSE(xarena_contains(&arena, arena_buff + ARENA_SIZE));
+}
+
+TEST(arena, MarkResetNested)
+{
+    xarena_mark_t outer = xarena_mark(&arena);
+    void *a             = xarena_alloc(&arena, 8);
+
+    xarena_mark_t inner = xarena_mark(&arena);
+    void *b             = xarena_alloc(&arena, 16);
+    TEST_ASSERT_NOT_NULL(b);
+
+    xarena_reset(&arena, inner);
+    TEST_ASSERT_EQUAL_UINT32(inner, xarena_mark(&arena));
+    TEST_ASSERT_TRUE(xarena_alloc(&arena, 16) == b);
+
+    xarena_reset(&arena, outer);
+    TEST_ASSERT_EQUAL_UINT32(0, xarena_mark(&arena));
+    TEST_ASSERT_TRUE(xarena_alloc(&arena, 8) == a);
+
+    /* 复位不回退高水位 */
+    TEST_ASSERT_EQUAL_UINT32(inner + 16, arena.used_max);
+}
+
+TEST(arena, AllocFailsWhenFull)
+{
+    TEST_ASSERT_NOT_NULL(xarena_alloc(&arena, ARENA_SIZE - 1));
+    xarena_mark_t mark = xarena_mark(&arena);
+
+    TEST_ASSERT_NULL(xarena_alloc(&arena, 1));
+    TEST_ASSERT_NULL(xarena_alloc(&arena, 0));
+    TEST_ASSERT_EQUAL_UINT32(2, arena.alloc_fail);
+    TEST_ASSERT_EQUAL_UINT32(mark, xarena_mark(&arena));
+
+    xarena_reset(&arena, 0);
+    TEST_ASSERT_NULL(xarena_alloc(&arena, ARENA_SIZE + 1));
+    TEST_ASSERT_NOT_NULL(xarena_alloc(&arena, ARENA_SIZE));
+}
+
+TEST(arena, HeapArena)
+{
+    xarena_t *heap_arena = xarena_new("heap", 100);
+
+    TEST_ASSERT_NOT_NULL(heap_arena);
+    TEST_ASSERT_TRUE(xmem_free_size() < heap_free);
+    TEST_ASSERT_EQUAL_UINT32(100, xarena_free_size(heap_arena));
+
+    void *p = xarena_alloc(heap_arena, 100);
+    TEST_ASSERT_TRUE(xarena_contains(heap_arena, p));
+
+    xarena_destroy(heap_arena);
+    TEST_ASSERT_EQUAL_UINT32(heap_free, xmem_free_size());
+}
+
+TEST(arena, ScratchFitsInArena)
+{
+    xarena_mark_t m1, m2;
+    void *a = xarena_scratch_alloc(32, &m1);
+
+    xarena_t *scratch = xarena_scratch();
+    TEST_ASSERT_NOT_NULL(scratch);
+    TEST_ASSERT_TRUE(xarena_contains(scratch, a));
+    TEST_ASSERT_EQUAL_UINT32(0, m1);
+    uint32_t heap_used = xmem_free_size();
+
+    void *b = xarena_scratch_alloc(32, &m2);
+    TEST_ASSERT_TRUE(xarena_contains(scratch, b));
+    TEST_ASSERT_EQUAL_UINT32(heap_used, xmem_free_size());
+
+    xarena_scratch_free(b, m2);
+    xarena_scratch_free(a, m1);
+    TEST_ASSERT_EQUAL_UINT32(0, xarena_mark(scratch));
+    TEST_ASSERT_TRUE(xarena_scratch() == scratch);
+}
+
+TEST(arena, ScratchFallsBackToHeap)
+{
+    xarena_mark_t m1, m2, m3;
+
+    /* 大于整个 scratch 的请求直接走堆 */
+    void *big = xarena_scratch_alloc(XARENA_SCRATCH_SIZE + 1, &m1);
+    xarena_t *scratch = xarena_scratch();
+    TEST_ASSERT_NOT_NULL(big);
+    TEST_ASSERT_FALSE(xarena_contains(scratch, big));
+    xarena_scratch_free(big, m1);
+
+    /* scratch 剩余空间不足时同样回退, 且不影响已分配部分 */
+    void *a = xarena_scratch_alloc(XARENA_SCRATCH_SIZE - 16, &m2);
+    TEST_ASSERT_TRUE(xarena_contains(scratch, a));
+    uint32_t heap_used = xmem_free_size();
+
+    void *b = xarena_scratch_alloc(32, &m3);
+    TEST_ASSERT_NOT_NULL(b);
+    TEST_ASSERT_FALSE(xarena_contains(scratch, b));
+    TEST_ASSERT_TRUE(xmem_free_size() < heap_used);
+    TEST_ASSERT_EQUAL_UINT32(XARENA_SCRATCH_SIZE - 16, xarena_mark(scratch));
+
+    xarena_scratch_free(b, m3);
+    TEST_ASSERT_EQUAL_UINT32(heap_used, xmem_free_size());
+    TEST_ASSERT_EQUAL_UINT32(XARENA_SCRATCH_SIZE - 16, xarena_mark(scratch));
+
+    xarena_scratch_free(a, m2);
+    TEST_ASSERT_EQUAL_UINT32(0, xarena_mark(scratch));
+}
+
+TEST(arena, ScratchRelease)
+{
+    xarena_mark_t mark;
+    void *p = xarena_scratch_alloc(8, &mark);
+
+    TEST_ASSERT_TRUE(xmem_free_size() < heap_free);
+    xarena_scratch_free(p, mark);
+
+    xarena_scratch_release();
+    TEST_ASSERT_EQUAL_UINT32(heap_free, xmem_free_size());
+
+    /* 释放后再次使用会重新创建 */
+    xarena_scratch_release();
+    TEST_ASSERT_NOT_NULL(xarena_scratch());
+}
+
+TEST_GROUP_RUNNER(arena)
+{
+    RUN_TEST_CASE(arena, InitRejectsZeroSize);
+    RUN_TEST_CASE(arena, AllocAlignsAndTracksUsage);
+    RUN_TEST_CASE(arena, MarkResetNested);
+    RUN_TEST_CASE(arena, AllocFailsWhenFull);
+    RUN_TEST_CASE(arena, HeapArena);
+    RUN_TEST_CASE(arena, ScratchFitsInArena);
+    RUN_TEST_CASE(arena, ScratchFallsBackToHeap);
+    RUN_TEST_CASE(arena, ScratchRelease);
+}
@@ -0,0 +1,137 @@
+#include "../../../xlib/xhal_crc.h"
+#include "../../xhal_test.h"
+
+/*
+ * 校验值取自 CRC 参数目录 (输入 "123456789"). Makefile 以 XCRC32_SLICE_BY
+ * 为 1, 4, 8 分别编译本组, 三种实现都要与逐位计算的参考结果一致.
+ */
+
+static const uint8_t check[] = "123456789";
+#define CHECK_LEN (9)
+
+static uint8_t data[300];
+
+/* 逐位计算的 CRC32, 多项式 0xEDB88320 (反射) */
+static uint32_t _crc32_ref(const uint8_t *p, uint32_t size)
+{
+    uint32_t crc = 0xFFFFFFFFU;
+
+    while (size--)
+    {
+        crc ^= *p++;
+        for (uint8_t bit = 0; bit < 8; bit++)
+            crc = (crc >> 1) ^ (0xEDB88320U & (0U - (crc & 1U)));
+    }
+
+    return crc ^ 0xFFFFFFFFU;
+}
+
+TEST_GROUP(crc);
+
+TEST_SETUP(crc)
+{
+    uint32_t seed = 7;
+
+    for (uint32_t i = 0; i < sizeof(data); i++)
+    {
+        seed    = seed * 1103515245U + 12345U;
+        data[i] = (uint8_t)(seed >> 16);
+    }
+}
+
+TEST_TEAR_DOWN(crc)
+{
+}
+
+TEST(crc, Crc32KnownVector)
+{
+    TEST_ASSERT_EQUAL_HEX32(0xCBF43926U,
+                            xcrc32(XCRC32_INIT, check, CHECK_LEN));
+    TEST_ASSERT_EQUAL_HEX32(0, xcrc32(XCRC32_INIT, NULL, 0));
+
+    /* 分段计算与一次计算一致 */
+    uint32_t crc = xcrc32(XCRC32_INIT, check, 4);
+    TEST_ASSERT_EQUAL_HEX32(0xCBF43926U, xcrc32(crc, check + 4, 5));
+}
+
+TEST(crc, Crc32MatchesBitwiseReference)
+{
+    /* 覆盖各种长度与未对齐的起点, 包括按字处理前后的零头 */
+    for (uint32_t offset = 0; offset < 8; offset++)
+    {
+        for (uint32_t len = 0; len + offset <= sizeof(data); len += 7)
+        {
+            TEST_ASSERT_EQUAL_HEX32(_crc32_ref(data + offset, len),
+                                    xcrc32(XCRC32_INIT, data + offset, len));
+        }
+    }
+}
+
+TEST(crc, Crc32Combine)
+{
+    for (uint32_t split = 0; split <= 64; split += 5)
+    {
+        uint32_t crc_a = xcrc32(XCRC32_INIT, data, split);
+        uint32_t crc_b = xcrc32(XCRC32_INIT, data + split, 64 - split);
+
+        TEST_ASSERT_EQUAL_HEX32(xcrc32(XCRC32_INIT, data, 64),
+                                xcrc32_combine(crc_a, crc_b, 64 - split));
+    }
+
+    /* 空的后半段不改变前半段 */
+    TEST_ASSERT_EQUAL_HEX32(0xCBF43926U, xcrc32_combine(0xCBF43926U, 0, 0));
+}
+
+TEST(crc, Crc8KnownVectors)
+{
+    static const uint8_t word[] = {0xBE, 0xEF};
+    xcrc8_t crc8;
+
+    TEST_ASSERT_EQUAL_HEX8(0xF7, xcrc8(XCRC8_INIT, check, CHECK_LEN));
+    /* Sensirion 数据手册中的示例 */
+    TEST_ASSERT_EQUAL_HEX8(0x92, xcrc8(XCRC8_INIT, word, sizeof(word)));
+
+    /* 按参数生成的表与内置表一致 */
+    TEST_ASSERT_EQUAL(XHAL_OK, xcrc8_init(&crc8, &xcrc8_param));
+    TEST_ASSERT_EQUAL_HEX8(0xF7, xcrc8_calc(&crc8, check, CHECK_LEN));
+    for (uint32_t len = 0; len <= 64; len += 9)
+        TEST_ASSERT_EQUAL_HEX8(xcrc8(XCRC8_INIT, data, len),
+                               xcrc8_calc(&crc8, data, len));
+}
+
+TEST(crc, Crc16KnownVectors)
+{
+    xcrc16_t ccitt, modbus;
+
+    TEST_ASSERT_EQUAL(XHAL_OK, xcrc16_init(&ccitt, &xcrc16_ccitt_param));
+    TEST_ASSERT_EQUAL(XHAL_OK, xcrc16_init(&modbus, &xcrc16_modbus_param));
+    TEST_ASSERT_EQUAL_HEX16(0x29B1, xcrc16_calc(&ccitt, check, CHECK_LEN));
+    TEST_ASSERT_EQUAL_HEX16(0x4B37, xcrc16_calc(&modbus, check, CHECK_LEN));
+
+    /* 流式计算与一次计算一致 */
+    uint16_t crc = xcrc16_start(&modbus);
+    crc          = xcrc16_update(&modbus, crc, check, 2);
+    crc          = xcrc16_update(&modbus, crc, check + 2, CHECK_LEN - 2);
+    TEST_ASSERT_EQUAL_HEX16(0x4B37, xcrc16_final(&modbus, crc));
+}
+
+TEST(crc, InitRejectsBadWidth)
+{
+    xcrc_param_t param = xcrc16_ccitt_param;
+    xcrc8_t crc8;
+    xcrc16_t crc16;
+
+    param.width = 12;
+    TEST_ASSERT_EQUAL(XHAL_ERR_INVALID, xcrc16_init(&crc16, &param));
+    TEST_ASSERT_EQUAL(XHAL_ERR_INVALID, xcrc8_init(&crc8, &param));
+}
+
+TEST_GROUP_RUNNER(crc)
+{
+    RUN_TEST_CASE(crc, Crc32KnownVector);
+    RUN_TEST_CASE(crc, Crc32MatchesBitwiseReference);
+    RUN_TEST_CASE(crc, Crc32Combine);
+    RUN_TEST_CASE(crc, Crc8KnownVectors);
+    RUN_TEST_CASE(crc, Crc16KnownVectors);
+    RUN_TEST_CASE(crc, InitRejectsBadWidth);
+}
@@ -0,0 +1,205 @@
+#include "../../../xlib/xhal_htable.h"
+#include "../../../xcore/xhal_malloc.h"
+#include "../../xhal_test.h"
+#include <stdio.h>
+
+#define HTABLE_CAP  (16)
+#define NAME_NUM    (128)
+
+static xhal_htable_data_t htable_slots[HTABLE_CAP];
+static xhal_htable_t htable;
+static char names[NAME_NUM][8];
+static uint32_t heap_free;
+
+/* 按名称下标给出数据, 不为 NULL */
+#define VALUE(i) ((void *)&names[i])
+
+/**
+ * 找出 n 个在 HTABLE_CAP 容量下落在同一起始槽的名称, 构造一条探测链.
+ * 起始槽由 xhtable_hash 的低位决定.
+ */
+static void _same_home(uint32_t *out, uint32_t n)
+{
+    for (uint32_t home = 0; home < HTABLE_CAP; home++)
+    {
+        uint32_t found = 0;
+
+        for (uint32_t i = 0; i < NAME_NUM && found < n; i++)
+        {
+            if ((xhtable_hash(names[i]) & (HTABLE_CAP - 1U)) == home)
+                out[found++] = i;
+        }
+        if (found == n)
+            return;
+    }
+    TEST_FAIL_MESSAGE("no probe chain");
+}
+
+static uint32_t _tombstones(void)
+{
+    xhal_htable_stats_t stats;
+
+    xhtable_get_stats(&htable, &stats);
+    return stats.tombstones;
+}
+
+TEST_GROUP(htable);
+
+TEST_SETUP(htable)
+{
+    for (uint32_t i = 0; i < NAME_NUM; i++)
+        snprintf(names[i], sizeof(names[i]), "k%u", (unsigned)i);
+
+    heap_free = xmem_free_size();
+    TEST_ASSERT_EQUAL(XHAL_OK, xhtable_init(&htable, htable_slots, HTABLE_CAP));
+}
+
+TEST_TEAR_DOWN(htable)
+{
+    TEST_ASSERT_EQUAL_UINT32(heap_free, xmem_free_size());
+}
+
+TEST(htable, InitRejectsBadCapacity)
+{
+    xhal_htable_t bad;
+
+    TEST_ASSERT_EQUAL(XHAL_ERR_INVALID, xhtable_init(&bad, htable_slots, 12));
+    TEST_ASSERT_EQUAL(XHAL_ERR_INVALID, xhtable_init(&bad, htable_slots, 1));
+}
+
+TEST(htable, AddGetReplaceRemove)
+{
+    int value = 0;
+
+    TEST_ASSERT_EQUAL(XHAL_OK, xhtable_add(&htable, names[1], VALUE(1)));
+    TEST_ASSERT_TRUE(xhtable_get(&htable, "k1") == VALUE(1));
+    TEST_ASSERT_TRUE(xhtable_existent(&htable, "k1"));
+    TEST_ASSERT_NULL(xhtable_get(&htable, "k2"));
+    TEST_ASSERT_EQUAL_INT32(XHAL_ERROR, xhtable_index(&htable, "k2"));
+
+    /* 已有的键替换数据, 不新增条目 */
+    TEST_ASSERT_EQUAL(XHAL_OK, xhtable_add(&htable, names[1], &value));
+    TEST_ASSERT_TRUE(xhtable_get(&htable, "k1") == &value);
+    TEST_ASSERT_EQUAL_UINT32(1, xhtable_count(&htable));
+
+    TEST_ASSERT_EQUAL(XHAL_OK, xhtable_remove(&htable, "k1"));
+    TEST_ASSERT_EQUAL(XHAL_ERR_NOT_FOUND, xhtable_remove(&htable, "k1"));
+    TEST_ASSERT_NULL(xhtable_get(&htable, "k1"));
+    TEST_ASSERT_EQUAL_UINT32(0, xhtable_count(&htable));
+}
+
+TEST(htable, TombstoneKeepsProbeChain)
+{
+    uint32_t k[4];
+
+    _same_home(k, 4);
+    for (uint32_t i = 0; i < 3; i++)
+        TEST_ASSERT_EQUAL(XHAL_OK, xhtable_add(&htable, names[k[i]],
+                                               VALUE(k[i])));
+
+    /* 链中间的删除留下墓碑, 其后的键仍可找到 */
+    TEST_ASSERT_EQUAL(XHAL_OK, xhtable_remove(&htable, names[k[1]]));
+    TEST_ASSERT_EQUAL_UINT32(1, _tombstones());
+    TEST_ASSERT_TRUE(xhtable_get(&htable, names[k[2]]) == VALUE(k[2]));
+    TEST_ASSERT_NULL(xhtable_get(&htable, names[k[1]]));
+
+    /* 插入复用墓碑 */
+    TEST_ASSERT_EQUAL(XHAL_OK, xhtable_add(&htable, names[k[3]], VALUE(k[3])));
+    TEST_ASSERT_EQUAL_UINT32(0, _tombstones());
+    TEST_ASSERT_EQUAL_INT32((xhtable_index(&htable, names[k[0]]) + 1) &
+                                (HTABLE_CAP - 1),
+                            xhtable_index(&htable, names[k[3]]));
+}
+
+TEST(htable, TrailingTombstonesCleared)
+{
+    uint32_t k[3];
+
+    _same_home(k, 3);
+    for (uint32_t i = 0; i < 3; i++)
+        TEST_ASSERT_EQUAL(XHAL_OK, xhtable_add(&htable, names[k[i]],
+                                               VALUE(k[i])));
+
+    TEST_ASSERT_EQUAL(XHAL_OK, xhtable_remove(&htable, names[k[1]]));
+    TEST_ASSERT_EQUAL_UINT32(1, _tombstones());
+
+    /* 链尾之后为空槽: 删除链尾时连同其前的墓碑一起清空 */
+    TEST_ASSERT_EQUAL(XHAL_OK, xhtable_remove(&htable, names[k[2]]));
+    TEST_ASSERT_EQUAL_UINT32(0, _tombstones());
+    TEST_ASSERT_TRUE(xhtable_get(&htable, names[k[0]]) == VALUE(k[0]));
+}
+
+TEST(htable, StaticTableRefusesOverLoad)
+{
+    uint32_t max = HTABLE_CAP * XHTABLE_LOAD_MAX / 100;
+
+    for (uint32_t i = 0; i < max; i++)
+        TEST_ASSERT_EQUAL(XHAL_OK, xhtable_add(&htable, names[i], VALUE(i)));
+    TEST_ASSERT_EQUAL(XHAL_ERR_FULL,
+                      xhtable_add(&htable, names[max], VALUE(max)));
+    TEST_ASSERT_EQUAL_UINT32(max, xhtable_count(&htable));
+
+    for (uint32_t i = 0; i < max; i++)
+        TEST_ASSERT_TRUE(xhtable_get(&htable, names[i]) == VALUE(i));
+}
+
+TEST(htable, ChurnRehashesInPlace)
+{
+    xhal_htable_stats_t stats;
+    uint32_t live = HTABLE_CAP / 2;
+
+    /* 窗口内保持 live 个键, 每步加入一个新键并删除最旧的键 */
+    for (uint32_t i = 0; i < live; i++)
+        TEST_ASSERT_EQUAL(XHAL_OK, xhtable_add(&htable, names[i], VALUE(i)));
+
+    for (uint32_t i = live; i < NAME_NUM; i++)
+    {
+        TEST_ASSERT_EQUAL(XHAL_OK, xhtable_add(&htable, names[i], VALUE(i)));
+        TEST_ASSERT_EQUAL(XHAL_OK, xhtable_remove(&htable, names[i - live]));
+
+        for (uint32_t j = i + 1 - live; j <= i; j++)
+            TEST_ASSERT_TRUE(xhtable_get(&htable, names[j]) == VALUE(j));
+        TEST_ASSERT_NULL(xhtable_get(&htable, names[i - live]));
+    }
+
+    xhtable_get_stats(&htable, &stats);
+    TEST_ASSERT_EQUAL_UINT32(HTABLE_CAP, stats.capacity);
+    TEST_ASSERT_EQUAL_UINT32(live, stats.count);
+    TEST_ASSERT_TRUE(stats.rehashes > 0);
+    TEST_ASSERT_TRUE((stats.count + stats.tombstones) * 200 <=
+                     HTABLE_CAP * (XHTABLE_LOAD_MAX + 100));
+}
+
+TEST(htable, HeapTableGrows)
+{
+    xhal_htable_t *heap = xhtable_new(0);
+    xhal_htable_stats_t stats;
+
+    TEST_ASSERT_NOT_NULL(heap);
+    for (uint32_t i = 0; i < NAME_NUM; i++)
+        TEST_ASSERT_EQUAL(XHAL_OK, xhtable_add(heap, names[i], VALUE(i)));
+
+    xhtable_get_stats(heap, &stats);
+    TEST_ASSERT_EQUAL_UINT32(NAME_NUM, stats.count);
+    TEST_ASSERT_TRUE(stats.capacity * XHTABLE_LOAD_MAX >= NAME_NUM * 100);
+    TEST_ASSERT_TRUE(stats.rehashes > 0);
+
+    for (uint32_t i = 0; i < NAME_NUM; i += 2)
+        TEST_ASSERT_EQUAL(XHAL_OK, xhtable_remove(heap, names[i]));
+    for (uint32_t i = 0; i < NAME_NUM; i++)
+        TEST_ASSERT_TRUE(xhtable_get(heap, names[i]) ==
+                         (i % 2 ? VALUE(i) : NULL));
+
+    xhtable_destroy(heap);
+}
+
+TEST_GROUP_RUNNER(htable)
+{
+    RUN_TEST_CASE(htable, InitRejectsBadCapacity);
+    RUN_TEST_CASE(htable, AddGetReplaceRemove);
+    RUN_TEST_CASE(htable, TombstoneKeepsProbeChain);
+    RUN_TEST_CASE(htable, TrailingTombstonesCleared);
+    RUN_TEST_CASE(htable, StaticTableRefusesOverLoad);
+    RUN_TEST_CASE(htable, ChurnRehashesInPlace);
+    RUN_TEST_CASE(htable, HeapTableGrows);
+}
@@ -0,0 +1,189 @@
+#include "../../../xlib/xhal_itable.h"
+#include "../../../xcore/xhal_malloc.h"
+#include "../../xhal_test.h"
+
+#define ITABLE_CAP  (16)
+#define KEY_NUM     (256)
+
+static xhal_itable_data_t itable_slots[ITABLE_CAP];
+static xhal_itable_t itable;
+static uint8_t values[KEY_NUM];
+static uint32_t heap_free;
+
+/* 按键给出数据, 不为 NULL */
+#define VALUE(key) ((void *)&values[(key) % KEY_NUM])
+
+/**
+ * 找出 n 个在 ITABLE_CAP 容量下落在同一起始槽的键, 构造一条探测链.
+ * 不复刻表内的散列: 在空表中先放入 out[0], 再放入候选键,
+ * 探测距离之和为 1 即说明两者起始槽相同.
+ */
+static void _same_home(uint32_t *out, uint32_t n)
+{
+    static xhal_itable_data_t slots[ITABLE_CAP];
+    xhal_itable_t probe;
+    xhal_itable_stats_t stats;
+    uint32_t found = 1;
+
+    out[0] = 1;
+    for (uint32_t key = 2; key < 4096 && found < n; key++)
+    {
+        xitable_init(&probe, slots, ITABLE_CAP);
+        xitable_add(&probe, out[0], VALUE(out[0]));
+        xitable_add(&probe, key, VALUE(key));
+        xitable_get_stats(&probe, &stats);
+        if (stats.probe_total == 1)
+            out[found++] = key;
+    }
+    TEST_ASSERT_EQUAL_UINT32(n, found);
+}
+
+static uint32_t _tombstones(void)
+{
+    xhal_itable_stats_t stats;
+
+    xitable_get_stats(&itable, &stats);
+    return stats.tombstones;
+}
+
+TEST_GROUP(itable);
+
+TEST_SETUP(itable)
+{
+    heap_free = xmem_free_size();
+    TEST_ASSERT_EQUAL(XHAL_OK, xitable_init(&itable, itable_slots, ITABLE_CAP));
+}
+
+TEST_TEAR_DOWN(itable)
+{
+    TEST_ASSERT_EQUAL_UINT32(heap_free, xmem_free_size());
+}
+
+TEST(itable, InitRejectsBadCapacity)
+{
+    xhal_itable_t bad;
+
+    TEST_ASSERT_EQUAL(XHAL_ERR_INVALID, xitable_init(&bad, itable_slots, 24));
+    TEST_ASSERT_EQUAL(XHAL_ERR_INVALID, xitable_init(&bad, itable_slots, 0));
+}
+
+TEST(itable, AddGetReplaceRemove)
+{
+    uint8_t other = 0;
+
+    /* 键 0 与其它键一样可用 */
+    TEST_ASSERT_EQUAL(XHAL_OK, xitable_add(&itable, 0, VALUE(0)));
+    TEST_ASSERT_EQUAL(XHAL_OK, xitable_add(&itable, 7, VALUE(7)));
+    TEST_ASSERT_TRUE(xitable_get(&itable, 0) == VALUE(0));
+    TEST_ASSERT_TRUE(xitable_existent(&itable, 7));
+    TEST_ASSERT_NULL(xitable_get(&itable, 8));
+
+    /* 已有的键替换数据, 不新增条目 */
+    TEST_ASSERT_EQUAL(XHAL_OK, xitable_add(&itable, 7, &other));
+    TEST_ASSERT_TRUE(xitable_get(&itable, 7) == &other);
+    TEST_ASSERT_EQUAL_UINT32(2, xitable_count(&itable));
+
+    TEST_ASSERT_EQUAL(XHAL_OK, xitable_remove(&itable, 7));
+    TEST_ASSERT_EQUAL(XHAL_ERR_NOT_FOUND, xitable_remove(&itable, 7));
+    TEST_ASSERT_NULL(xitable_get(&itable, 7));
+    TEST_ASSERT_EQUAL_UINT32(1, xitable_count(&itable));
+}
+
+TEST(itable, TombstoneKeepsProbeChain)
+{
+    uint32_t k[4];
+
+    _same_home(k, 4);
+    for (uint32_t i = 0; i < 3; i++)
+        TEST_ASSERT_EQUAL(XHAL_OK, xitable_add(&itable, k[i], VALUE(k[i])));
+
+    /* 链中间的删除留下墓碑, 其后的键仍可找到 */
+    TEST_ASSERT_EQUAL(XHAL_OK, xitable_remove(&itable, k[1]));
+    TEST_ASSERT_EQUAL_UINT32(1, _tombstones());
+    TEST_ASSERT_TRUE(xitable_get(&itable, k[2]) == VALUE(k[2]));
+    TEST_ASSERT_NULL(xitable_get(&itable, k[1]));
+
+    /* 插入复用墓碑; 删除链尾时连同其前的墓碑一起清空 */
+    TEST_ASSERT_EQUAL(XHAL_OK, xitable_add(&itable, k[3], VALUE(k[3])));
+    TEST_ASSERT_EQUAL_UINT32(0, _tombstones());
+    TEST_ASSERT_EQUAL(XHAL_OK, xitable_remove(&itable, k[3]));
+    TEST_ASSERT_EQUAL_UINT32(1, _tombstones());
+    TEST_ASSERT_EQUAL(XHAL_OK, xitable_remove(&itable, k[2]));
+    TEST_ASSERT_EQUAL_UINT32(0, _tombstones());
+    TEST_ASSERT_TRUE(xitable_get(&itable, k[0]) == VALUE(k[0]));
+}
+
+TEST(itable, ChurnMatchesReference)
+{
+    static uint8_t present[KEY_NUM];
+    xhal_itable_stats_t stats;
+    uint32_t count = 0;
+    uint32_t seed  = 1;
+
+    xmemset(present, 0, sizeof(present));
+
+    /* 随机增删, 每步与参考数组逐键比较 */
+    for (uint32_t step = 0; step < 2000; step++)
+    {
+        seed        = seed * 1103515245U + 12345U;
+        uint32_t key = (seed >> 16) % 32;
+
+        if (present[key])
+        {
+            TEST_ASSERT_EQUAL(XHAL_OK, xitable_remove(&itable, key));
+            present[key] = 0;
+            count--;
+        }
+        else if (count < ITABLE_CAP * XHTABLE_LOAD_MAX / 100)
+        {
+            TEST_ASSERT_EQUAL(XHAL_OK, xitable_add(&itable, key, VALUE(key)));
+            present[key] = 1;
+            count++;
+        }
+
+        for (uint32_t i = 0; i < 32; i++)
+            TEST_ASSERT_TRUE(xitable_get(&itable, i) ==
+                             (present[i] ? VALUE(i) : NULL));
+    }
+
+    xitable_get_stats(&itable, &stats);
+    TEST_ASSERT_EQUAL_UINT32(ITABLE_CAP, stats.capacity);
+    TEST_ASSERT_EQUAL_UINT32(count, stats.count);
+    TEST_ASSERT_TRUE(stats.rehashes > 0);
+}
+
+TEST(itable, HeapTableGrows)
+{
+    xhal_itable_t *heap = xitable_new(4);
+    xhal_itable_stats_t stats;
+
+    TEST_ASSERT_NOT_NULL(heap);
+    xitable_get_stats(heap, &stats);
+    TEST_ASSERT_EQUAL_UINT32(XITABLE_CAPACITY_MIN, stats.capacity);
+
+    /* 连续的键 */
+    for (uint32_t key = 0; key < KEY_NUM; key++)
+        TEST_ASSERT_EQUAL(XHAL_OK, xitable_add(heap, key, VALUE(key)));
+
+    xitable_get_stats(heap, &stats);
+    TEST_ASSERT_EQUAL_UINT32(KEY_NUM, stats.count);
+    TEST_ASSERT_TRUE(stats.capacity * XHTABLE_LOAD_MAX >= KEY_NUM * 100);
+    TEST_ASSERT_TRUE(stats.rehashes > 0);
+
+    for (uint32_t key = 0; key < KEY_NUM; key += 2)
+        TEST_ASSERT_EQUAL(XHAL_OK, xitable_remove(heap, key));
+    for (uint32_t key = 0; key < KEY_NUM; key++)
+        TEST_ASSERT_TRUE(xitable_get(heap, key) ==
+                         (key % 2 ? VALUE(key) : NULL));
+
+    xitable_destroy(heap);
+}
+
+TEST_GROUP_RUNNER(itable)
+{
+    RUN_TEST_CASE(itable, InitRejectsBadCapacity);
+    RUN_TEST_CASE(itable, AddGetReplaceRemove);
+    RUN_TEST_CASE(itable, TombstoneKeepsProbeChain);
+    RUN_TEST_CASE(itable, ChurnMatchesReference);
+    RUN_TEST_CASE(itable, HeapTableGrows);
+}
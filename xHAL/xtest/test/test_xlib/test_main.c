@@ -0,0 +1,39 @@
+#include "../../xhal_test.h"
+
+/*
+ * 主机端 xlib 单元测试入口, 一个测试组对应一个模块.
+ * 以 XHAL_OS_SUPPORTING 编译时只运行依赖 OS 的测试组.
+ * 用法: ./build/xlib_tests [-v] [-g 组名] [-n 用例名]
+ */
+
+int test_irq_depth;
+int test_irq_count;
+
+/* 断言失败时结束当前用例, 而不是停在 _xassert_func 的死循环里 */
+void xassert_user_hook(void)
+{
+    TEST_FAIL_MESSAGE("xassert failed");
+}
+
+static void _run_all_tests(void)
+{
+#ifdef XHAL_OS_SUPPORTING
+    RUN_TEST_GROUP(queue_os);
+#else
+    RUN_TEST_GROUP(twheel);
+    RUN_TEST_GROUP(queue);
+    RUN_TEST_GROUP(pool);
+    RUN_TEST_GROUP(arena);
+    RUN_TEST_GROUP(recbuf);
+    RUN_TEST_GROUP(mpsc);
+    RUN_TEST_GROUP(htable);
+    RUN_TEST_GROUP(itable);
+    RUN_TEST_GROUP(phash);
+    RUN_TEST_GROUP(crc);
+#endif
+}
+
+int main(int argc, const char *argv[])
+{
+    return UnityMain(argc, argv, _run_all_tests);
+}
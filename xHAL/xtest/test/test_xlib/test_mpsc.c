@@ -0,0 +1,144 @@
+#include "../../../xlib/xhal_mpscbuf.h"
+#include "../../../xcore/xhal_malloc.h"
+#include "../../xhal_test.h"
+
+#define MPSC_SIZE (16)
+
+static uint8_t mpsc_buff[MPSC_SIZE];
+static xmpsc_t mpsc;
+
+static void _fill(uint8_t *data, uint32_t len, uint8_t seq)
+{
+    for (uint32_t i = 0; i < len; i++)
+        data[i] = (uint8_t)(seq * 16 + i);
+}
+
+static void _seg_fill(const xrbuf_seg_t *seg, uint8_t seq)
+{
+    uint8_t data[MPSC_SIZE];
+
+    _fill(data, seg->len[0] + seg->len[1], seq);
+    xmemcpy(seg->ptr[0], data, seg->len[0]);
+    if (seg->len[1] > 0)
+        xmemcpy(seg->ptr[1], data + seg->len[0], seg->len[1]);
+}
+
+static void _read_check(uint32_t len, uint8_t seq)
+{
+    uint8_t expect[MPSC_SIZE], data[MPSC_SIZE];
+
+    _fill(expect, len, seq);
+    TEST_ASSERT_EQUAL_UINT32(len, xmpsc_read(&mpsc, data, len));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expect, data, len);
+}
+
+TEST_GROUP(mpsc);
+
+TEST_SETUP(mpsc)
+{
+    TEST_ASSERT_EQUAL(XHAL_OK, xmpsc_init(&mpsc, mpsc_buff, MPSC_SIZE));
+}
+
+TEST_TEAR_DOWN(mpsc)
+{
+}
+
+TEST(mpsc, InitRejectsBadSize)
+{
+    xmpsc_t bad;
+
+    TEST_ASSERT_EQUAL(XHAL_ERR_INVALID, xmpsc_init(&bad, mpsc_buff, 12));
+    TEST_ASSERT_EQUAL(XHAL_ERR_INVALID, xmpsc_init(&bad, mpsc_buff, 1));
+    TEST_ASSERT_TRUE(xmpsc_is_ready(&mpsc));
+}
+
+TEST(mpsc, WriteReadInOrderAcrossWrap)
+{
+    uint8_t data[MPSC_SIZE];
+
+    /* 5 与 16 互质, 每个起点都会轮到一次, 其中部分写入跨越末尾 */
+    for (uint8_t seq = 0; seq < 40; seq++)
+    {
+        _fill(data, 5, seq);
+        TEST_ASSERT_EQUAL_UINT32(5, xmpsc_write(&mpsc, data, 5));
+        if (seq > 0)
+            _read_check(5, (uint8_t)(seq - 1));
+    }
+    _read_check(5, 39);
+    TEST_ASSERT_EQUAL_UINT32(0, xmpsc_get_full(&mpsc));
+}
+
+TEST(mpsc, CommitPublishesWhenLastWriterDone)
+{
+    xrbuf_seg_t a, b;
+
+    TEST_ASSERT_EQUAL_UINT32(4, xmpsc_reserve(&mpsc, 4, &a));
+    TEST_ASSERT_EQUAL_UINT32(3, xmpsc_reserve(&mpsc, 3, &b));
+    TEST_ASSERT_EQUAL_UINT32(MPSC_SIZE - 7, xmpsc_get_free(&mpsc));
+
+    /* 后预留者先提交: 前面的预留仍在填写, 消费者什么也看不到 */
+    _seg_fill(&b, 2);
+    xmpsc_commit(&mpsc);
+    TEST_ASSERT_EQUAL_UINT32(0, xmpsc_get_full(&mpsc));
+
+    /* 最后一个提交者发布全部预留, 顺序与预留顺序一致 */
+    _seg_fill(&a, 1);
+    xmpsc_commit(&mpsc);
+    TEST_ASSERT_EQUAL_UINT32(7, xmpsc_get_full(&mpsc));
+    _read_check(4, 1);
+    _read_check(3, 2);
+}
+
+TEST(mpsc, ReserveSplitsAtEnd)
+{
+    uint8_t data[MPSC_SIZE];
+    xrbuf_seg_t seg;
+
+    _fill(data, 12, 0);
+    xmpsc_write(&mpsc, data, 12);
+    xmpsc_read(&mpsc, data, 12);
+
+    TEST_ASSERT_EQUAL_UINT32(8, xmpsc_reserve(&mpsc, 8, &seg));
+    TEST_ASSERT_TRUE(seg.ptr[0] == &mpsc_buff[12]);
+    TEST_ASSERT_EQUAL_UINT32(4, seg.len[0]);
+    TEST_ASSERT_TRUE(seg.ptr[1] == &mpsc_buff[0]);
+    TEST_ASSERT_EQUAL_UINT32(4, seg.len[1]);
+    _seg_fill(&seg, 3);
+    xmpsc_commit(&mpsc);
+
+    TEST_ASSERT_EQUAL_UINT32(8, xmpsc_peek_seg(&mpsc, MPSC_SIZE, &seg));
+    TEST_ASSERT_EQUAL_UINT32(4, seg.len[0]);
+    TEST_ASSERT_EQUAL_UINT32(4, seg.len[1]);
+    _read_check(8, 3);
+}
+
+TEST(mpsc, FullDropsWrite)
+{
+    uint8_t data[MPSC_SIZE];
+    xmpsc_stats_t stats;
+
+    _fill(data, MPSC_SIZE, 0);
+    TEST_ASSERT_EQUAL_UINT32(MPSC_SIZE, xmpsc_write(&mpsc, data, MPSC_SIZE));
+    TEST_ASSERT_EQUAL_UINT32(0, xmpsc_write(&mpsc, data, 1));
+    TEST_ASSERT_EQUAL_UINT32(0, xmpsc_write_isr(&mpsc, data, 1));
+    TEST_ASSERT_EQUAL_UINT32(0, xmpsc_write(&mpsc, data, 0));
+
+    xmpsc_get_stats(&mpsc, &stats);
+    TEST_ASSERT_EQUAL_UINT32(MPSC_SIZE, stats.size);
+    TEST_ASSERT_EQUAL_UINT32(MPSC_SIZE, stats.used);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.drop_count);
+
+    /* 释放一部分后可再次写入 */
+    xmpsc_release(&mpsc, 4);
+    TEST_ASSERT_EQUAL_UINT32(4, xmpsc_write(&mpsc, data, 4));
+    TEST_ASSERT_EQUAL_UINT32(MPSC_SIZE, xmpsc_get_full(&mpsc));
+}
+
+TEST_GROUP_RUNNER(mpsc)
+{
+    RUN_TEST_CASE(mpsc, InitRejectsBadSize);
+    RUN_TEST_CASE(mpsc, WriteReadInOrderAcrossWrap);
+    RUN_TEST_CASE(mpsc, CommitPublishesWhenLastWriterDone);
+    RUN_TEST_CASE(mpsc, ReserveSplitsAtEnd);
+    RUN_TEST_CASE(mpsc, FullDropsWrite);
+}
@@ -0,0 +1,73 @@
+/*
+ * 主机端 CMSIS-RTOS2 子集: 以 pthread 模拟调度器锁与计数信号量,
+ * 只实现 OS 模式下被测模块用到的接口.
+ */
+#include "../../../xos/xhal_os.h"
+#include <errno.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <stdlib.h>
+#include <time.h>
+
+static pthread_mutex_t kernel_lock = PTHREAD_MUTEX_INITIALIZER;
+
+int32_t osKernelLock(void)
+{
+    pthread_mutex_lock(&kernel_lock);
+    return 0;
+}
+
+int32_t osKernelRestoreLock(int32_t lock)
+{
+    (void)lock;
+    pthread_mutex_unlock(&kernel_lock);
+    return 0;
+}
+
+osSemaphoreId_t osSemaphoreNew(uint32_t max_count, uint32_t initial_count,
+                               const osSemaphoreAttr_t *attr)
+{
+    sem_t *sem = malloc(sizeof(sem_t));
+
+    (void)max_count;
+    (void)attr;
+    if (sem != NULL)
+        sem_init(sem, 0, initial_count);
+
+    return sem;
+}
+
+osStatus_t osSemaphoreAcquire(osSemaphoreId_t semaphore_id, uint32_t timeout)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_REALTIME, &ts);
+    ts.tv_sec += timeout / 1000U;
+    ts.tv_nsec += (long)(timeout % 1000U) * 1000000L;
+    if (ts.tv_nsec >= 1000000000L)
+    {
+        ts.tv_sec++;
+        ts.tv_nsec -= 1000000000L;
+    }
+
+    while (sem_timedwait((sem_t *)semaphore_id, &ts) != 0)
+    {
+        if (errno != EINTR)
+            return osErrorTimeout;
+    }
+
+    return osOK;
+}
+
+osStatus_t osSemaphoreRelease(osSemaphoreId_t semaphore_id)
+{
+    sem_post((sem_t *)semaphore_id);
+    return osOK;
+}
+
+osStatus_t osSemaphoreDelete(osSemaphoreId_t semaphore_id)
+{
+    sem_destroy((sem_t *)semaphore_id);
+    free(semaphore_id);
+    return osOK;
+}
@@ -0,0 +1,154 @@
+#include "../../../xlib/xhal_phash.h"
+#include "../../../xcore/xhal_malloc.h"
+#include "../../xhal_test.h"
+#include <stdio.h>
+
+#define PHASH_CAP   (64)
+#define REG_NUM     (80)
+
+XPHASH_STORAGE(phash, PHASH_CAP);
+static xphash_t phash;
+
+/* 模拟注册表: 按下标给出名称, 空位为 NULL */
+static char reg_names[REG_NUM][12];
+static const char *reg[REG_NUM];
+static uint32_t heap_free;
+
+static const char *_key(void *ctx, uint32_t index)
+{
+    const char **table = ctx;
+
+    return table[index];
+}
+
+/* 注册 n 个名称, 每隔 5 个留一个空位 */
+static void _reg_fill(uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++)
+        reg[i] = (i % 5 == 4) ? NULL : reg_names[i];
+}
+
+TEST_GROUP(phash);
+
+TEST_SETUP(phash)
+{
+    for (uint32_t i = 0; i < REG_NUM; i++)
+    {
+        snprintf(reg_names[i], sizeof(reg_names[i]), "dev%u", (unsigned)i);
+        reg[i] = NULL;
+    }
+
+    heap_free = xmem_free_size();
+    TEST_ASSERT_EQUAL(XHAL_OK, xphash_init(&phash, phash_disp, phash_slot,
+                                           PHASH_CAP, _key, reg));
+}
+
+TEST_TEAR_DOWN(phash)
+{
+    TEST_ASSERT_EQUAL_UINT32(heap_free, xmem_free_size());
+}
+
+TEST(phash, FindsEveryName)
+{
+    _reg_fill(PHASH_CAP);
+    TEST_ASSERT_EQUAL(XHAL_OK, xphash_build(&phash, PHASH_CAP));
+    TEST_ASSERT_TRUE(xphash_is_built(&phash));
+
+    for (uint32_t i = 0; i < PHASH_CAP; i++)
+    {
+        int32_t expect = reg[i] == NULL ? -1 : (int32_t)i;
+
+        TEST_ASSERT_EQUAL_INT32(expect, xphash_find(&phash, reg_names[i]));
+    }
+}
+
+TEST(phash, MissReturnsNone)
+{
+    _reg_fill(PHASH_CAP);
+    TEST_ASSERT_EQUAL(XHAL_OK, xphash_build(&phash, PHASH_CAP));
+
+    TEST_ASSERT_EQUAL_INT32(-1, xphash_find(&phash, ""));
+    TEST_ASSERT_EQUAL_INT32(-1, xphash_find(&phash, "dev"));
+    TEST_ASSERT_EQUAL_INT32(-1, xphash_find(&phash, "dev1x"));
+    for (uint32_t i = PHASH_CAP; i < REG_NUM; i++)
+        TEST_ASSERT_EQUAL_INT32(-1, xphash_find(&phash, reg_names[i]));
+}
+
+TEST(phash, DuplicateResolvesToLowestIndex)
+{
+    _reg_fill(8);
+    reg[6] = "dev2";
+    reg[9] = "dev2";
+
+    TEST_ASSERT_EQUAL(XHAL_OK, xphash_build(&phash, 10));
+    TEST_ASSERT_EQUAL_INT32(2, xphash_find(&phash, "dev2"));
+    TEST_ASSERT_EQUAL_INT32(7, xphash_find(&phash, "dev7"));
+
+    /* 最前的一个移除后, 重建落到下一个 */
+    reg[2] = NULL;
+    TEST_ASSERT_EQUAL(XHAL_OK, xphash_build(&phash, 10));
+    TEST_ASSERT_EQUAL_INT32(6, xphash_find(&phash, "dev2"));
+}
+
+TEST(phash, EmptyRegistryIsNotBuilt)
+{
+    TEST_ASSERT_EQUAL(XHAL_OK, xphash_build(&phash, REG_NUM));
+    TEST_ASSERT_FALSE(xphash_is_built(&phash));
+    TEST_ASSERT_EQUAL_INT32(-1, xphash_find(&phash, "dev0"));
+}
+
+TEST(phash, OverCapacityFails)
+{
+    for (uint32_t i = 0; i < REG_NUM; i++)
+        reg[i] = reg_names[i];
+
+    TEST_ASSERT_EQUAL(XHAL_ERR_NOT_ENOUGH, xphash_build(&phash, REG_NUM));
+    TEST_ASSERT_FALSE(xphash_is_built(&phash));
+}
+
+TEST(phash, DirtyRebuildsOnRefresh)
+{
+    _reg_fill(16);
+    xphash_mark_dirty(&phash, 16);
+    TEST_ASSERT_FALSE(xphash_is_built(&phash));
+    TEST_ASSERT_TRUE(xphash_refresh(&phash));
+    TEST_ASSERT_EQUAL_INT32(15, xphash_find(&phash, "dev15"));
+
+    /* 注册表变化后旧的结果作废, 直到下一次刷新 */
+    reg[16] = reg_names[16];
+    reg[15] = NULL;
+    xphash_mark_dirty(&phash, 17);
+    TEST_ASSERT_EQUAL_INT32(-1, xphash_find(&phash, "dev16"));
+    TEST_ASSERT_TRUE(xphash_refresh(&phash));
+    TEST_ASSERT_EQUAL_INT32(16, xphash_find(&phash, "dev16"));
+    TEST_ASSERT_EQUAL_INT32(-1, xphash_find(&phash, "dev15"));
+
+    /* 未变化时刷新不再重建 */
+    xphash_invalidate(&phash);
+    TEST_ASSERT_FALSE(xphash_refresh(&phash));
+}
+
+TEST(phash, HeapHandle)
+{
+    xphash_t *heap = xphash_new(PHASH_CAP, _key, reg);
+
+    TEST_ASSERT_NOT_NULL(heap);
+    TEST_ASSERT_TRUE(xmem_free_size() < heap_free);
+
+    _reg_fill(PHASH_CAP);
+    TEST_ASSERT_EQUAL(XHAL_OK, xphash_build(heap, PHASH_CAP));
+    TEST_ASSERT_EQUAL_INT32(33, xphash_find(heap, "dev33"));
+
+    xphash_destroy(heap);
+}
+
+TEST_GROUP_RUNNER(phash)
+{
+    RUN_TEST_CASE(phash, FindsEveryName);
+    RUN_TEST_CASE(phash, MissReturnsNone);
+    RUN_TEST_CASE(phash, DuplicateResolvesToLowestIndex);
+    RUN_TEST_CASE(phash, EmptyRegistryIsNotBuilt);
+    RUN_TEST_CASE(phash, OverCapacityFails);
+    RUN_TEST_CASE(phash, DirtyRebuildsOnRefresh);
+    RUN_TEST_CASE(phash, HeapHandle);
+}
@@ -0,0 +1,174 @@
+#include "../../../xlib/xhal_pool.h"
+#include "../../../xcore/xhal_malloc.h"
+#include "../../xhal_test.h"
+
+/* 大小不是指针整数倍的对象, 检验槽位取整与对齐 */
+typedef struct
+{
+    uint32_t id;
+    uint8_t data[5];
+} pool_obj_t;
+
+#define POOL_CAP (4)
+
+extern int test_irq_depth;
+extern int test_irq_count;
+
+XOBJ_POOL_STORAGE(pool_storage, pool_obj_t, POOL_CAP);
+
+static xobj_pool_t pool;
+
+TEST_GROUP(pool);
+
+TEST_SETUP(pool)
+{
+    test_irq_depth = 0;
+    test_irq_count = 0;
+    TEST_ASSERT_EQUAL(XHAL_OK, xobj_pool_init(&pool, "test", pool_storage,
+                                              sizeof(pool_obj_t), POOL_CAP, 0));
+}
+
+TEST_TEAR_DOWN(pool)
+{
+}
+
+TEST(pool, InitRejectsBadArgs)
+{
+    xobj_pool_t bad;
+
+    TEST_ASSERT_EQUAL(XHAL_ERR_INVALID,
+                      xobj_pool_init(&bad, "bad", pool_storage, 0, 1, 0));
+    TEST_ASSERT_EQUAL(XHAL_ERR_INVALID,
+                      xobj_pool_init(&bad, "bad", pool_storage, 8, 0, 0));
+    TEST_ASSERT_EQUAL(XHAL_ERR_INVALID,
+                      xobj_pool_init(&bad, "bad", (uint8_t *)pool_storage + 1,
+                                     8, 1, 0));
+}
+
+TEST(pool, AllocUntilExhausted)
+{
+    pool_obj_t *obj[POOL_CAP];
+    xobj_pool_stats_t stats;
+
+    for (uint32_t i = 0; i < POOL_CAP; i++)
+    {
+        obj[i] = xobj_pool_alloc(&pool);
+        TEST_ASSERT_NOT_NULL(obj[i]);
+        TEST_ASSERT_TRUE(xobj_pool_contains(&pool, obj[i]));
+        TEST_ASSERT_EQUAL_UINT32(0, (xhal_pointer_t)obj[i] % XOBJ_POOL_ALIGN);
+        for (uint32_t j = 0; j < i; j++)
+            TEST_ASSERT_TRUE(obj[i] != obj[j]);
+        xmemset(obj[i], (int)i, sizeof(pool_obj_t));
+    }
+
+    TEST_ASSERT_NULL(xobj_pool_alloc(&pool));
+    TEST_ASSERT_NULL(xobj_pool_alloc(&pool));
+    TEST_ASSERT_EQUAL_UINT32(0, xobj_pool_free_count(&pool));
+
+    xobj_pool_get_stats(&pool, &stats);
+    TEST_ASSERT_EQUAL_UINT32(POOL_CAP, stats.used);
+    TEST_ASSERT_EQUAL_UINT32(POOL_CAP, stats.used_max);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.alloc_fail);
+    TEST_ASSERT_EQUAL_UINT32(XOBJ_POOL_SLOT_SIZE(sizeof(pool_obj_t)),
+                             stats.obj_size);
+
+    /* 释放一个后可再次分配到同一槽位 */
+    TEST_ASSERT_EQUAL(XHAL_OK, xobj_pool_free(&pool, obj[2]));
+    TEST_ASSERT_TRUE(xobj_pool_alloc(&pool) == obj[2]);
+
+    for (uint32_t i = 0; i < POOL_CAP; i++)
+        TEST_ASSERT_EQUAL(XHAL_OK, xobj_pool_free(&pool, obj[i]));
+    TEST_ASSERT_EQUAL_UINT32(POOL_CAP, xobj_pool_free_count(&pool));
+
+    xobj_pool_reset_stats(&pool);
+    xobj_pool_get_stats(&pool, &stats);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.used_max);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.alloc_fail);
+}
+
+TEST(pool, FreeRejectsForeignAndDoubleFree)
+{
+    pool_obj_t outside;
+    pool_obj_t *a = xobj_pool_alloc(&pool);
+    pool_obj_t *b = xobj_pool_alloc(&pool);
+
+    TEST_ASSERT_EQUAL(XHAL_ERR_INVALID, xobj_pool_free(&pool, NULL));
+    TEST_ASSERT_EQUAL(XHAL_ERR_INVALID, xobj_pool_free(&pool, &outside));
+    TEST_ASSERT_EQUAL(XHAL_ERR_INVALID,
+                      xobj_pool_free(&pool, (uint8_t *)a + 1));
+
+    TEST_ASSERT_EQUAL(XHAL_OK, xobj_pool_free(&pool, a));
+    TEST_ASSERT_EQUAL(XHAL_ERR_INVALID, xobj_pool_free(&pool, a));
+    TEST_ASSERT_EQUAL_UINT32(POOL_CAP - 1, xobj_pool_free_count(&pool));
+
+    /* 拒绝后空闲链表仍完整, 可分配出全部剩余槽位 */
+    for (uint32_t i = 0; i < POOL_CAP - 1; i++)
+        TEST_ASSERT_NOT_NULL(xobj_pool_alloc(&pool));
+    TEST_ASSERT_NULL(xobj_pool_alloc(&pool));
+    TEST_ASSERT_TRUE(xobj_pool_contains(&pool, b));
+}
+
+TEST(pool, CallocZeroFills)
+{
+    pool_obj_t *obj = xobj_pool_alloc(&pool);
+
+    xmemset(obj, 0xA5, sizeof(*obj));
+    xobj_pool_free(&pool, obj);
+
+    obj = xobj_pool_calloc(&pool);
+    TEST_ASSERT_EQUAL_UINT32(0, obj->id);
+    TEST_ASSERT_EACH_EQUAL_UINT8(0, obj->data, sizeof(obj->data));
+}
+
+/* 非 ISR 池不屏蔽中断, ISR 池每次操作成对屏蔽与恢复 */
+TEST(pool, IsrPoolMasksInterrupts)
+{
+    xobj_pool_t isr_pool;
+
+    xobj_pool_free(&pool, xobj_pool_alloc(&pool));
+    TEST_ASSERT_EQUAL_INT(0, test_irq_count);
+
+    TEST_ASSERT_EQUAL(XHAL_OK,
+                      xobj_pool_init(&isr_pool, "isr", pool_storage,
+                                     sizeof(pool_obj_t), POOL_CAP,
+                                     XOBJ_POOL_FLAG_ISR));
+
+    void *obj = xobj_pool_alloc(&isr_pool);
+    TEST_ASSERT_NOT_NULL(obj);
+    TEST_ASSERT_EQUAL_INT(1, test_irq_count);
+    TEST_ASSERT_EQUAL_INT(0, test_irq_depth);
+
+    TEST_ASSERT_EQUAL(XHAL_OK, xobj_pool_free(&isr_pool, obj));
+    TEST_ASSERT_EQUAL_INT(2, test_irq_count);
+    TEST_ASSERT_EQUAL_INT(0, test_irq_depth);
+
+    TEST_ASSERT_EQUAL(XHAL_ERR_INVALID, xobj_pool_free(&isr_pool, obj));
+    TEST_ASSERT_EQUAL_INT(0, test_irq_depth);
+}
+
+TEST(pool, HeapPool)
+{
+    uint32_t free_before = xmem_free_size();
+    xobj_pool_t *heap_pool = xobj_pool_new("heap", 24, 8, 0);
+
+    TEST_ASSERT_NOT_NULL(heap_pool);
+    TEST_ASSERT_TRUE(xmem_free_size() < free_before);
+    TEST_ASSERT_NULL(xobj_pool_new("none", 0, 8, 0));
+
+    void *obj = xobj_pool_alloc(heap_pool);
+    TEST_ASSERT_TRUE(xobj_pool_contains(heap_pool, obj));
+    xobj_pool_free(heap_pool, obj);
+
+    xobj_pool_destroy(heap_pool);
+    TEST_ASSERT_EQUAL_UINT32(free_before, xmem_free_size());
+}
+
+TEST_GROUP_RUNNER(pool)
+{
+    RUN_TEST_CASE(pool, InitRejectsBadArgs);
+    RUN_TEST_CASE(pool, AllocUntilExhausted);
+    RUN_TEST_CASE(pool, FreeRejectsForeignAndDoubleFree);
+    RUN_TEST_CASE(pool, CallocZeroFills);
+    RUN_TEST_CASE(pool, IsrPoolMasksInterrupts);
+    RUN_TEST_CASE(pool, HeapPool);
+}
@@ -0,0 +1,183 @@
+#include "../../../xlib/xhal_queue.h"
+#include "../../../xcore/xhal_time.h"
+#include "../../xhal_test.h"
+
+/* 元素大小不为 1 且不整除缓冲区的结构体, 检验按元素拷贝 */
+typedef struct
+{
+    uint32_t seq;
+    uint8_t tag[3];
+} queue_elem_t;
+
+#define QUEUE_CAP (5)
+
+static xhal_queue_t queue;
+static queue_elem_t queue_buff[QUEUE_CAP];
+
+static void _fill(queue_elem_t *elem, uint32_t n, uint32_t seq)
+{
+    for (uint32_t i = 0; i < n; i++)
+    {
+        elem[i].seq    = seq + i;
+        elem[i].tag[0] = (uint8_t)(seq + i);
+        elem[i].tag[1] = 0xA5;
+        elem[i].tag[2] = (uint8_t)~(seq + i);
+    }
+}
+
+static void _check(const queue_elem_t *elem, uint32_t n, uint32_t seq)
+{
+    for (uint32_t i = 0; i < n; i++)
+    {
+        TEST_ASSERT_EQUAL_UINT32(seq + i, elem[i].seq);
+        TEST_ASSERT_EQUAL_UINT8((uint8_t)(seq + i), elem[i].tag[0]);
+        TEST_ASSERT_EQUAL_UINT8(0xA5, elem[i].tag[1]);
+        TEST_ASSERT_EQUAL_UINT8((uint8_t)~(seq + i), elem[i].tag[2]);
+    }
+}
+
+TEST_GROUP(queue);
+
+TEST_SETUP(queue)
+{
+    xqueue_init_elem(&queue, queue_buff, sizeof(queue_elem_t), QUEUE_CAP);
+}
+
+TEST_TEAR_DOWN(queue)
+{
+    xqueue_deinit(&queue);
+}
+
+TEST(queue, PushAllOrNone)
+{
+    queue_elem_t in[QUEUE_CAP + 1];
+
+    _fill(in, QUEUE_CAP + 1, 0);
+    TEST_ASSERT_EQUAL_INT32(XHAL_ERR_NOT_ENOUGH,
+                            xqueue_push(&queue, in, QUEUE_CAP + 1));
+    TEST_ASSERT_TRUE(xqueue_is_empty(&queue));
+
+    TEST_ASSERT_EQUAL_INT32(3, xqueue_push(&queue, in, 3));
+    TEST_ASSERT_EQUAL_INT32(XHAL_ERR_NOT_ENOUGH, xqueue_push(&queue, in, 3));
+    TEST_ASSERT_EQUAL_INT32(2, xqueue_push(&queue, in + 3, 2));
+    TEST_ASSERT_TRUE(xqueue_is_full(&queue));
+    TEST_ASSERT_EQUAL_UINT32(0, xqueue_free_size(&queue));
+    TEST_ASSERT_EQUAL_INT32(0, xqueue_push(&queue, NULL, 0));
+}
+
+TEST(queue, PullDoesNotPop)
+{
+    queue_elem_t in[3], out[3];
+
+    _fill(in, 3, 10);
+    xqueue_push(&queue, in, 3);
+
+    TEST_ASSERT_EQUAL_UINT32(2, xqueue_pull(&queue, out, 2));
+    _check(out, 2, 10);
+    TEST_ASSERT_EQUAL_UINT32(3, xqueue_count(&queue));
+
+    TEST_ASSERT_EQUAL_UINT32(1, xqueue_pop(&queue, 1));
+    TEST_ASSERT_EQUAL_UINT32(2, xqueue_pull(&queue, out, 3));
+    _check(out, 2, 11);
+}
+
+/* 每轮推入与取出的个数互质于容量, 读写位置遍历所有回绕情形 */
+TEST(queue, BulkWrapAround)
+{
+    queue_elem_t in[QUEUE_CAP], out[QUEUE_CAP];
+    uint32_t pushed = 0, pulled = 0;
+
+    for (uint32_t round = 0; round < 50; round++)
+    {
+        uint32_t n = 1 + round % 3;
+
+        if (xqueue_free_size(&queue) >= n)
+        {
+            _fill(in, n, pushed);
+            TEST_ASSERT_EQUAL_INT32((int32_t)n, xqueue_push(&queue, in, n));
+            pushed += n;
+        }
+
+        uint32_t m = xqueue_pull_pop(&queue, out, 1 + round % 4);
+        _check(out, m, pulled);
+        pulled += m;
+        TEST_ASSERT_EQUAL_UINT32(pushed - pulled, xqueue_count(&queue));
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(pushed - pulled,
+                             xqueue_pull_pop(&queue, out, QUEUE_CAP));
+    TEST_ASSERT_TRUE(xqueue_is_empty(&queue));
+}
+
+TEST(queue, ByteQueue)
+{
+    uint8_t buff[7], in[7], out[7];
+
+    xqueue_init(&queue, buff, sizeof(buff));
+    for (uint8_t i = 0; i < 7; i++)
+        in[i] = (uint8_t)(0x30 + i);
+
+    TEST_ASSERT_EQUAL_INT32(5, xqueue_push(&queue, in, 5));
+    TEST_ASSERT_EQUAL_UINT32(4, xqueue_pull_pop(&queue, out, 4));
+    TEST_ASSERT_EQUAL_INT32(6, xqueue_push(&queue, in, 6));
+    TEST_ASSERT_EQUAL_UINT32(7, xqueue_pull_pop(&queue, out, 7));
+    TEST_ASSERT_EQUAL_UINT8(in[4], out[0]);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(in, out + 1, 6);
+}
+
+TEST(queue, ClearEmpties)
+{
+    queue_elem_t in[2], out[2];
+
+    _fill(in, 2, 0);
+    xqueue_push(&queue, in, 2);
+    xqueue_clear(&queue);
+    TEST_ASSERT_TRUE(xqueue_is_empty(&queue));
+    TEST_ASSERT_EQUAL_UINT32(0, xqueue_pull_pop(&queue, out, 2));
+}
+
+TEST(queue, PushWaitTimesOutWhenFull)
+{
+    queue_elem_t in[QUEUE_CAP];
+
+    _fill(in, QUEUE_CAP, 0);
+    xqueue_push(&queue, in, QUEUE_CAP);
+
+    TEST_ASSERT_EQUAL(XHAL_ERR_TIMEOUT, xqueue_push_wait(&queue, in, 1, 0));
+
+    xhal_tick_t start = xtime_get_tick_ms();
+    TEST_ASSERT_EQUAL(XHAL_ERR_TIMEOUT, xqueue_push_wait(&queue, in, 1, 5));
+    TEST_ASSERT_TRUE(TIME_DIFF(xtime_get_tick_ms(), start) >= 5);
+
+    TEST_ASSERT_EQUAL(XHAL_ERR_INVALID,
+                      xqueue_push_wait(&queue, in, QUEUE_CAP + 1, 5));
+
+    xqueue_pop(&queue, 1);
+    TEST_ASSERT_EQUAL(XHAL_OK, xqueue_push_wait(&queue, in, 1, 0));
+}
+
+TEST(queue, PullPopWaitReturnsPartialOnTimeout)
+{
+    queue_elem_t in[2], out[4];
+
+    _fill(in, 2, 7);
+    xqueue_push(&queue, in, 2);
+
+    xhal_tick_t start = xtime_get_tick_ms();
+    TEST_ASSERT_EQUAL_UINT32(2, xqueue_pull_pop_wait(&queue, out, 4, 5));
+    TEST_ASSERT_TRUE(TIME_DIFF(xtime_get_tick_ms(), start) >= 5);
+    _check(out, 2, 7);
+
+    TEST_ASSERT_EQUAL_UINT32(0, xqueue_pull_pop_wait(&queue, out, 1, 0));
+}
+
+TEST_GROUP_RUNNER(queue)
+{
+    RUN_TEST_CASE(queue, PushAllOrNone);
+    RUN_TEST_CASE(queue, PullDoesNotPop);
+    RUN_TEST_CASE(queue, BulkWrapAround);
+    RUN_TEST_CASE(queue, ByteQueue);
+    RUN_TEST_CASE(queue, ClearEmpties);
+    RUN_TEST_CASE(queue, PushWaitTimesOutWhenFull);
+    RUN_TEST_CASE(queue, PullPopWaitReturnsPartialOnTimeout);
+}
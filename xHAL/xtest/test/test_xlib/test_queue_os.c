@@ -0,0 +1,126 @@
+#include "../../../xlib/xhal_queue.h"
+#include "../../../xcore/xhal_time.h"
+#include "../../xhal_test.h"
+#include <pthread.h>
+
+/*
+ * 多个线程阻塞在队列同一侧时, 对侧每腾出/放入一个元素都要唤醒其中一个,
+ * 不能因为等待者之间互相清除唤醒而睡到超时.
+ */
+
+#define QUEUE_OS_WAITERS (4)
+#define QUEUE_OS_TIMEOUT (2000)
+
+static xhal_queue_t queue;
+static uint32_t queue_buff[QUEUE_OS_WAITERS];
+
+typedef struct
+{
+    uint32_t value;
+    uint32_t ret;
+    xhal_tick_t elapsed;
+} waiter_t;
+
+static waiter_t waiters[QUEUE_OS_WAITERS];
+
+static void *_pusher(void *arg)
+{
+    waiter_t *w       = arg;
+    xhal_tick_t start = xtime_get_tick_ms();
+
+    w->ret = (uint32_t)xqueue_push_wait(&queue, &w->value, 1, QUEUE_OS_TIMEOUT);
+    w->elapsed = TIME_DIFF(xtime_get_tick_ms(), start);
+
+    return NULL;
+}
+
+static void *_puller(void *arg)
+{
+    waiter_t *w       = arg;
+    xhal_tick_t start = xtime_get_tick_ms();
+
+    w->ret     = xqueue_pull_pop_wait(&queue, &w->value, 1, QUEUE_OS_TIMEOUT);
+    w->elapsed = TIME_DIFF(xtime_get_tick_ms(), start);
+
+    return NULL;
+}
+
+static void _run_waiters(void *(*entry)(void *), void (*step)(uint32_t))
+{
+    pthread_t tid[QUEUE_OS_WAITERS];
+
+    for (uint32_t i = 0; i < QUEUE_OS_WAITERS; i++)
+    {
+        waiters[i].value = 100 + i;
+        pthread_create(&tid[i], NULL, entry, &waiters[i]);
+    }
+
+    /* 等所有线程阻塞后, 每次只给一个元素的空间或数据 */
+    for (uint32_t i = 0; i < QUEUE_OS_WAITERS; i++)
+    {
+        xtime_delay_ms(10);
+        step(i);
+    }
+
+    for (uint32_t i = 0; i < QUEUE_OS_WAITERS; i++)
+        pthread_join(tid[i], NULL);
+}
+
+static void _pop_one(uint32_t i)
+{
+    XHAL_UNUSED(i);
+    xqueue_pop(&queue, 1);
+}
+
+static void _push_one(uint32_t i)
+{
+    xqueue_push(&queue, &i, 1);
+}
+
+TEST_GROUP(queue_os);
+
+TEST_SETUP(queue_os)
+{
+    xqueue_init_elem(&queue, queue_buff, sizeof(uint32_t), QUEUE_OS_WAITERS);
+}
+
+TEST_TEAR_DOWN(queue_os)
+{
+    xqueue_deinit(&queue);
+}
+
+TEST(queue_os, EveryPusherWokenByPop)
+{
+    uint32_t fill[QUEUE_OS_WAITERS] = {0};
+
+    xqueue_push(&queue, fill, QUEUE_OS_WAITERS);
+    _run_waiters(_pusher, _pop_one);
+
+    for (uint32_t i = 0; i < QUEUE_OS_WAITERS; i++)
+    {
+        TEST_ASSERT_EQUAL_UINT32(XHAL_OK, waiters[i].ret);
+        TEST_ASSERT_TRUE(waiters[i].elapsed < QUEUE_OS_TIMEOUT / 2);
+    }
+    TEST_ASSERT_TRUE(xqueue_is_full(&queue));
+}
+
+TEST(queue_os, EveryPullerWokenByPush)
+{
+    _run_waiters(_puller, _push_one);
+
+    uint32_t seen = 0;
+    for (uint32_t i = 0; i < QUEUE_OS_WAITERS; i++)
+    {
+        TEST_ASSERT_EQUAL_UINT32(1, waiters[i].ret);
+        TEST_ASSERT_TRUE(waiters[i].elapsed < QUEUE_OS_TIMEOUT / 2);
+        seen |= 1U << waiters[i].value;
+    }
+    TEST_ASSERT_EQUAL_HEX32((1U << QUEUE_OS_WAITERS) - 1U, seen);
+    TEST_ASSERT_TRUE(xqueue_is_empty(&queue));
+}
+
+TEST_GROUP_RUNNER(queue_os)
+{
+    RUN_TEST_CASE(queue_os, EveryPusherWokenByPop);
+    RUN_TEST_CASE(queue_os, EveryPullerWokenByPush);
+}
@@ -0,0 +1,163 @@
+#include "../../../xlib/xhal_recbuf.h"
+#include "../../xhal_test.h"
+
+/* 3 条 5 字节记录的空间, 记录头与负载都会跨越缓冲区末尾 */
+#define RECBUF_SIZE XRECBUF_BUFF_SIZE(5, 3)
+
+static uint8_t recbuf_buff[RECBUF_SIZE];
+static xrecbuf_t recbuf;
+
+static void _fill(uint8_t *data, uint32_t len, uint8_t seq)
+{
+    for (uint32_t i = 0; i < len; i++)
+        data[i] = (uint8_t)(seq * 16 + i);
+}
+
+static void _pop_check(uint32_t len, uint8_t seq)
+{
+    uint8_t expect[32], data[32];
+    uint32_t got = 0;
+
+    _fill(expect, len, seq);
+    TEST_ASSERT_EQUAL(XHAL_OK, xrecbuf_pop(&recbuf, data, sizeof(data), &got));
+    TEST_ASSERT_EQUAL_UINT32(len, got);
+    if (len > 0)
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(expect, data, len);
+}
+
+static xhal_err_t _push(uint32_t len, uint8_t seq)
+{
+    uint8_t data[32];
+
+    _fill(data, len, seq);
+    return xrecbuf_push(&recbuf, data, len);
+}
+
+TEST_GROUP(recbuf);
+
+TEST_SETUP(recbuf)
+{
+    TEST_ASSERT_EQUAL(XHAL_OK,
+                      xrecbuf_init(&recbuf, recbuf_buff, RECBUF_SIZE, 0));
+}
+
+TEST_TEAR_DOWN(recbuf)
+{
+    xrecbuf_deinit(&recbuf);
+    TEST_ASSERT_FALSE(xrecbuf_is_ready(&recbuf));
+}
+
+TEST(recbuf, InitRejectsTinyBuffer)
+{
+    xrecbuf_t bad;
+
+    TEST_ASSERT_EQUAL(XHAL_ERR_INVALID,
+                      xrecbuf_init(&bad, recbuf_buff, XRECBUF_HDR_SIZE + 1, 0));
+}
+
+TEST(recbuf, PushPopKeepsBoundaries)
+{
+    TEST_ASSERT_EQUAL(XHAL_OK, _push(5, 1));
+    TEST_ASSERT_EQUAL(XHAL_OK, _push(0, 2));
+    TEST_ASSERT_EQUAL(XHAL_OK, _push(3, 3));
+    TEST_ASSERT_EQUAL_UINT32(3, xrecbuf_count(&recbuf));
+
+    _pop_check(5, 1);
+    _pop_check(0, 2);
+    _pop_check(3, 3);
+    TEST_ASSERT_EQUAL(XHAL_ERR_EMPTY, xrecbuf_pop(&recbuf, NULL, 0, NULL));
+    TEST_ASSERT_EQUAL_UINT32(0, xrecbuf_count(&recbuf));
+}
+
+TEST(recbuf, WrapAround)
+{
+    /* 记录占 3~7 字节轮换, 写位置逐次后移, 记录头与负载都会跨越末尾 */
+    for (uint8_t seq = 0; seq < 60; seq++)
+    {
+        uint32_t len = 1 + seq % 5;
+
+        TEST_ASSERT_EQUAL(XHAL_OK, _push(len, seq));
+        if (seq > 0)
+            _pop_check(1 + (seq - 1) % 5, (uint8_t)(seq - 1));
+    }
+    _pop_check(1 + 59 % 5, 59);
+    TEST_ASSERT_EQUAL_UINT32(0, xrecbuf_count(&recbuf));
+}
+
+TEST(recbuf, FullRefusesWithoutDropOldest)
+{
+    xrecbuf_stats_t stats;
+
+    for (uint8_t seq = 0; seq < 3; seq++)
+        TEST_ASSERT_EQUAL(XHAL_OK, _push(5, seq));
+    TEST_ASSERT_EQUAL(XHAL_ERR_FULL, _push(1, 3));
+    TEST_ASSERT_EQUAL(XHAL_ERR_INVALID, _push(RECBUF_SIZE, 4));
+
+    xrecbuf_get_stats(&recbuf, &stats);
+    TEST_ASSERT_EQUAL_UINT32(3, stats.count);
+    TEST_ASSERT_EQUAL_UINT32(RECBUF_SIZE - 1, stats.used);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.fail_count);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.drop_count);
+
+    /* 已存记录不受影响 */
+    _pop_check(5, 0);
+}
+
+TEST(recbuf, DropOldestMakesRoom)
+{
+    xrecbuf_stats_t stats;
+
+    xrecbuf_init(&recbuf, recbuf_buff, RECBUF_SIZE, XRECBUF_FLAG_DROP_OLDEST);
+    for (uint8_t seq = 0; seq < 3; seq++)
+        TEST_ASSERT_EQUAL(XHAL_OK, _push(5, seq));
+
+    /* 一条 12 字节的记录需要丢掉最旧的两条 */
+    TEST_ASSERT_EQUAL(XHAL_OK, _push(12, 3));
+    xrecbuf_get_stats(&recbuf, &stats);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.count);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.drop_count);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.fail_count);
+
+    _pop_check(5, 2);
+    _pop_check(12, 3);
+    TEST_ASSERT_EQUAL_UINT32(0, xrecbuf_count(&recbuf));
+}
+
+TEST(recbuf, PopTooSmallKeepsRecord)
+{
+    uint8_t data[2];
+    uint32_t len = 0;
+
+    TEST_ASSERT_EQUAL(XHAL_OK, _push(4, 7));
+    TEST_ASSERT_EQUAL(XHAL_ERR_NOT_ENOUGH,
+                      xrecbuf_pop(&recbuf, data, sizeof(data), &len));
+    TEST_ASSERT_EQUAL_UINT32(4, len);
+    TEST_ASSERT_EQUAL_UINT32(1, xrecbuf_count(&recbuf));
+
+    _pop_check(4, 7);
+}
+
+TEST(recbuf, ResetClearsRecordsAndCounters)
+{
+    xrecbuf_stats_t stats;
+
+    TEST_ASSERT_EQUAL(XHAL_OK, _push(5, 0));
+    xrecbuf_reset(&recbuf);
+
+    xrecbuf_get_stats(&recbuf, &stats);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.count);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.used);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.push_count);
+    TEST_ASSERT_EQUAL(XHAL_ERR_EMPTY, xrecbuf_pop(&recbuf, NULL, 0, NULL));
+}
+
+TEST_GROUP_RUNNER(recbuf)
+{
+    RUN_TEST_CASE(recbuf, InitRejectsTinyBuffer);
+    RUN_TEST_CASE(recbuf, PushPopKeepsBoundaries);
+    RUN_TEST_CASE(recbuf, WrapAround);
+    RUN_TEST_CASE(recbuf, FullRefusesWithoutDropOldest);
+    RUN_TEST_CASE(recbuf, DropOldestMakesRoom);
+    RUN_TEST_CASE(recbuf, PopTooSmallKeepsRecord);
+    RUN_TEST_CASE(recbuf, ResetClearsRecordsAndCounters);
+}
@@ -0,0 +1,138 @@
+#include "../../../xlib/xhal_twheel.h"
+#include "../../xhal_test.h"
+
+/* 以回调记录到期顺序, 节点按下标区分 */
+#define TWHEEL_NODES (8)
+
+static xtwheel_t wheel;
+static xtwheel_node_t nodes[TWHEEL_NODES];
+static int fired_order[TWHEEL_NODES];
+static uint32_t fired_count;
+
+static void _on_expire(xtwheel_node_t *node, void *arg)
+{
+    XHAL_UNUSED(arg);
+
+    fired_order[fired_count++] = (int)(node - nodes);
+}
+
+/* 回调中把同一节点以已到期的时刻重新加入 */
+static void _on_expire_readd(xtwheel_node_t *node, void *arg)
+{
+    _on_expire(node, arg);
+    xtwheel_add(&wheel, node, node->expire);
+}
+
+TEST_GROUP(twheel);
+
+TEST_SETUP(twheel)
+{
+    xtwheel_init(&wheel, 0);
+    for (uint32_t i = 0; i < TWHEEL_NODES; i++)
+    {
+        xtwheel_node_init(&nodes[i]);
+        fired_order[i] = -1;
+    }
+    fired_count = 0;
+}
+
+TEST_TEAR_DOWN(twheel)
+{
+}
+
+TEST(twheel, FiresInExpireOrder)
+{
+    xtwheel_add(&wheel, &nodes[0], 30);
+    xtwheel_add(&wheel, &nodes[1], 10);
+    xtwheel_add(&wheel, &nodes[2], 5000);
+    TEST_ASSERT_EQUAL_UINT32(3, xtwheel_count(&wheel));
+
+    TEST_ASSERT_EQUAL_UINT32(0, xtwheel_advance(&wheel, 9, _on_expire, NULL));
+    TEST_ASSERT_EQUAL_UINT32(1, xtwheel_advance(&wheel, 10, _on_expire, NULL));
+    TEST_ASSERT_EQUAL_UINT32(1, xtwheel_advance(&wheel, 4999, _on_expire, NULL));
+    TEST_ASSERT_EQUAL_UINT32(1, xtwheel_advance(&wheel, 5000, _on_expire, NULL));
+
+    TEST_ASSERT_EQUAL_INT(1, fired_order[0]);
+    TEST_ASSERT_EQUAL_INT(0, fired_order[1]);
+    TEST_ASSERT_EQUAL_INT(2, fired_order[2]);
+    TEST_ASSERT_EQUAL_UINT32(0, xtwheel_count(&wheel));
+}
+
+TEST(twheel, RemoveStopsTimer)
+{
+    xtwheel_add(&wheel, &nodes[0], 20);
+    xtwheel_remove(&wheel, &nodes[0]);
+    TEST_ASSERT_FALSE(xtwheel_is_active(&nodes[0]));
+
+    TEST_ASSERT_EQUAL_UINT32(0, xtwheel_advance(&wheel, 100, _on_expire, NULL));
+    TEST_ASSERT_EQUAL_UINT32(0, xtwheel_count(&wheel));
+}
+
+/* 已推进过的时刻上加入的定时器, 在下一次推进时立即到期, 不晚一个 tick */
+TEST(twheel, AlreadyDueFiresOnNextAdvance)
+{
+    xhal_tick_t next;
+
+    xtwheel_advance(&wheel, 100, _on_expire, NULL);
+
+    xtwheel_add(&wheel, &nodes[0], 100);
+    xtwheel_add(&wheel, &nodes[1], 40);
+    TEST_ASSERT_EQUAL(XHAL_OK, xtwheel_next_expire(&wheel, &next));
+    TEST_ASSERT_EQUAL_UINT32(100, next);
+
+    TEST_ASSERT_EQUAL_UINT32(2, xtwheel_advance(&wheel, 100, _on_expire, NULL));
+    TEST_ASSERT_EQUAL_INT(0, fired_order[0]);
+    TEST_ASSERT_EQUAL_INT(1, fired_order[1]);
+    TEST_ASSERT_EQUAL(XHAL_ERR_EMPTY, xtwheel_next_expire(&wheel, &next));
+
+    /* 未推进到的时刻仍按时到期 */
+    xtwheel_add(&wheel, &nodes[2], 101);
+    TEST_ASSERT_EQUAL_UINT32(0, xtwheel_advance(&wheel, 100, _on_expire, NULL));
+    TEST_ASSERT_EQUAL_UINT32(1, xtwheel_advance(&wheel, 101, _on_expire, NULL));
+}
+
+/* 回调里再次加入已到期的定时器, 留到下一次推进, 不在本次推进中循环 */
+TEST(twheel, ReaddFromCallbackWaitsForNextAdvance)
+{
+    xtwheel_add(&wheel, &nodes[0], 10);
+
+    TEST_ASSERT_EQUAL_UINT32(1, xtwheel_advance(&wheel, 10, _on_expire_readd,
+                                                NULL));
+    TEST_ASSERT_TRUE(xtwheel_is_active(&nodes[0]));
+    TEST_ASSERT_EQUAL_UINT32(1, xtwheel_advance(&wheel, 10, _on_expire, NULL));
+    TEST_ASSERT_FALSE(xtwheel_is_active(&nodes[0]));
+}
+
+TEST(twheel, RestartMovesRunningTimer)
+{
+    xtwheel_add(&wheel, &nodes[0], 10);
+    xtwheel_add(&wheel, &nodes[0], 300);
+    TEST_ASSERT_EQUAL_UINT32(1, xtwheel_count(&wheel));
+
+    TEST_ASSERT_EQUAL_UINT32(0, xtwheel_advance(&wheel, 299, _on_expire, NULL));
+    TEST_ASSERT_EQUAL_UINT32(1, xtwheel_advance(&wheel, 300, _on_expire, NULL));
+}
+
+TEST(twheel, TickWrapAround)
+{
+    xtwheel_init(&wheel, 0xFFFFFFF0U);
+    xtwheel_add(&wheel, &nodes[0], 0xFFFFFFF8U);
+    xtwheel_add(&wheel, &nodes[1], 0x00000010U);
+
+    TEST_ASSERT_EQUAL_UINT32(1, xtwheel_advance(&wheel, 0xFFFFFFFFU,
+                                                _on_expire, NULL));
+    TEST_ASSERT_EQUAL_UINT32(0, xtwheel_advance(&wheel, 0x0000000FU,
+                                                _on_expire, NULL));
+    TEST_ASSERT_EQUAL_UINT32(1, xtwheel_advance(&wheel, 0x00000010U,
+                                                _on_expire, NULL));
+}
+
+TEST_GROUP_RUNNER(twheel)
+{
+    RUN_TEST_CASE(twheel, FiresInExpireOrder);
+    RUN_TEST_CASE(twheel, RemoveStopsTimer);
+    RUN_TEST_CASE(twheel, AlreadyDueFiresOnNextAdvance);
+    RUN_TEST_CASE(twheel, ReaddFromCallbackWaitsForNextAdvance);
+    RUN_TEST_CASE(twheel, RestartMovesRunningTimer);
+    RUN_TEST_CASE(twheel, TickWrapAround);
+}
@@ -0,0 +1,41 @@
+#ifndef __XHAL_CONFIG_H
+#define __XHAL_CONFIG_H
+
+/* 主机端单元测试配置 */
+
+#define FIRMWARE_NAME            "xhal_test"
+#define HARDWARE_VERSION         "host"
+#define SOFTWARE_VERSION         "1.0.0"
+
+#define XOS_TICK_RATE_HZ         (1000)
+
+/* 断言失败经用户钩子转为测试失败, 不再死循环 */
+#define XASSERT_ENABLE           (1)
+#define XASSERT_FULL_PATH_ENABLE (0)
+#define XASSERT_FUNC_ENABLE      (1)
+#define XASSERT_BACKTRACE_ENABLE (0)
+#define XASSERT_USER_HOOK_ENABLE (1)
+
+#define XMALLOC_BLOCK_SIZE       (16)
+#define XMALLOC_MAX_SIZE         (32 * 1024)
+
+/* 主机无中断屏蔽, 只记录屏蔽次数与嵌套以便测试检查 */
+extern int test_irq_depth;
+extern int test_irq_count;
+#define XOBJ_POOL_IRQ_DISABLE() \
+    (test_irq_count++, (uint32_t)test_irq_depth++)
+#define XOBJ_POOL_IRQ_RESTORE(primask) (test_irq_depth = (int)(primask))
+#define XMPSC_IRQ_DISABLE() \
+    (test_irq_count++, (uint32_t)test_irq_depth++)
+#define XMPSC_IRQ_RESTORE(primask) (test_irq_depth = (int)(primask))
+
+#define XOBJ_POOL_FREE_CHECK_ENABLE (1)
+
+#define XLOG_COLOR_ENABLE        (0)
+#define XLOG_NEWLINE_ENABLE      (1)
+#define XLOG_FILEINFO_ENABLE     (1)
+#define XLOG_DEFAULT_TIME_MODE   (XLOG_TIME_MOD_NONE)
+#define XLOG_DEFAULT_LEVEL       (XLOG_LEVEL_ERROR)
+#define XLOG_COMPILE_LEVEL       (XLOG_LEVEL_ERROR)
+
+#endif /* __XHAL_CONFIG_H */